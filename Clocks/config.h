@@ -21,6 +21,7 @@
 #define GET_INTERVAL
 #define ACTIVATE_MODEL_PARTITION
 #define N_INPUT_CLOCKS 3
+#define INPUT_CLOCKS vr_inClock1, vr_inClock2, vr_inClock3
 
 #define FIXED_SOLVER_STEP 1
 
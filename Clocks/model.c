@@ -3,6 +3,13 @@
 #include <math.h>
 #include <stdlib.h>
 
+/*
+The model partitions may run in parallel. Every variable is written by a single partition or the importer,
+except for the shared variables totalInClockTicks and outClock and the handshake variables inClock3_qualifier
+and input2, which are accessed atomically (see model.h) instead of with the lockPreemption() and
+unlockPreemption() callbacks.
+*/
+
 /*
 
 time        0 1 2 3 4 5 6 7 8 9
@@ -14,6 +21,20 @@ time        0 1 2 3 4 5 6 7 8 9
 
 */
 
+/* outClock = !outClock && totalInClockTicks % 5 == 0 as one atomic update (like the sequential model, an activation
+   that finds outClock still set clears it) */
+static bool updateOutClock(ModelInstance* comp, int totalInClockTicks) {
+
+    int outClock, newOutClock;
+
+    do {
+        outClock = ATOMIC_LOAD(&M(outClock));
+        newOutClock = !outClock && totalInClockTicks % 5 == 0;
+    } while (!ATOMIC_COMPARE_EXCHANGE(&M(outClock), outClock, newOutClock));
+
+    return newOutClock;
+}
+
 /**************************************
 ModelPartition 1 does the following:
   - increments the clock tick counters
@@ -22,24 +43,20 @@ ModelPartition 1 does the following:
 **************************************/
 static void activateModelPartition1(ModelInstance* comp, double time) {
 
-    /* Note: model partition of highest priority
-        -> no interruption by other model partitions possible
-        -> no lock preemption needed
-    */
-
     // increment the counters
-    M(inClock1Ticks)++;
-    M(totalInClockTicks)++;
+    ATOMIC_INCREMENT(&M(inClock1Ticks));
+
+    const int totalInClockTicks = ATOMIC_INCREMENT(&M(totalInClockTicks));
 
     // set countdown and output clocks
     if ((int)time == 4) {
-        M(inClock3_qualifier)= 2; // fmi3IntervalChanged
         M(inClock3_interval) = 0.0;
+        ATOMIC_STORE(&M(inClock3_qualifier), 2); // fmi3IntervalChanged
     }
 
-    M(outClock) = ((M(outClock) == false) && (M(totalInClockTicks) % 5 == 0));
+    const bool outClock = updateOutClock(comp, totalInClockTicks);
 
-    if (M(inClock3_qualifier) == 2 || M(outClock)) {
+    if (ATOMIC_LOAD(&M(inClock3_qualifier)) == 2 || outClock) {
         comp->clockUpdate(comp->componentEnvironment);
     }
 }
@@ -54,25 +71,16 @@ static void activateModelPartition2(ModelInstance* comp, double time) {
 
     UNUSED(time);
 
-    if (comp->lockPreemption) {
-        comp->lockPreemption();
-    }
-
     // increment the counters
-    M(inClock2Ticks)++;
-    M(totalInClockTicks)++;
+    ATOMIC_INCREMENT(&M(inClock2Ticks));
 
-    M(result2) += M(input2);
-    M(input2) = 0;
+    const int totalInClockTicks = ATOMIC_INCREMENT(&M(totalInClockTicks));
 
-    // set output clocks
-    M(outClock) = ((M(outClock) == false) && (M(totalInClockTicks) % 5 == 0));
-
-    if (comp->unlockPreemption) {
-        comp->unlockPreemption();
-    }
+    // consume the input (result2 is only written by this partition)
+    ATOMIC_STORE(&M(result2), M(result2) + ATOMIC_EXCHANGE(&M(input2), 0));
 
-    if (M(outClock)) {
+    // set output clocks
+    if (updateOutClock(comp, totalInClockTicks)) {
         comp->clockUpdate(comp->componentEnvironment);
     }
 }
@@ -89,7 +97,7 @@ static void activateModelPartition3(ModelInstance *comp, double time) {
     UNUSED(time);
 
     // increment the counters
-    M(inClock3Ticks)++;
+    ATOMIC_INCREMENT(&M(inClock3Ticks));
 
     // This partition is supposed to consume a bit of time on a low prio ...
     unsigned long sum = 0;
@@ -98,20 +106,11 @@ static void activateModelPartition3(ModelInstance *comp, double time) {
     }
     (void)sum; // use variable to avoid compiler warnings
 
-    M(output3) = 1000;
-
-    if (comp->lockPreemption) {
-        comp->lockPreemption();
-    }
+    ATOMIC_STORE(&M(output3), 1000);
 
-    M(totalInClockTicks)++;
-    M(outClock) = ((M(outClock) == false) && (M(totalInClockTicks) % 5 == 0));
-
-    if (comp->unlockPreemption) {
-        comp->unlockPreemption();
-    }
+    const int totalInClockTicks = ATOMIC_INCREMENT(&M(totalInClockTicks));
 
-    if (M(outClock)) {
+    if (updateOutClock(comp, totalInClockTicks)) {
         comp->clockUpdate(comp->componentEnvironment);
     }
 }
@@ -175,7 +174,7 @@ Status setInt32(ModelInstance* comp, ValueReference vr, const int32_t values[],
 
     switch (vr) {
     case vr_input2:
-        M(input2) = values[(*index)++];
+        ATOMIC_STORE(&M(input2), values[(*index)++]);
         return OK;
     default:
         logError(comp, "Set Int32 is not allowed for value reference %u.", vr);
@@ -189,25 +188,25 @@ Status getInt32(ModelInstance* comp, ValueReference vr, int32_t values[], size_t
 
     switch (vr) {
     case vr_inClock1Ticks:
-        values[(*index)++] = M(inClock1Ticks);
+        values[(*index)++] = ATOMIC_LOAD(&M(inClock1Ticks));
         return OK;
     case vr_inClock2Ticks:
-        values[(*index)++] = M(inClock2Ticks);
+        values[(*index)++] = ATOMIC_LOAD(&M(inClock2Ticks));
         return OK;
     case vr_inClock3Ticks:
-        values[(*index)++] = M(inClock3Ticks);
+        values[(*index)++] = ATOMIC_LOAD(&M(inClock3Ticks));
         return OK;
     case vr_totalInClockTicks:
-        values[(*index)++] = M(totalInClockTicks);
+        values[(*index)++] = ATOMIC_LOAD(&M(totalInClockTicks));
         return OK;
     case vr_result2:
-        values[(*index)++] = M(result2);
+        values[(*index)++] = ATOMIC_LOAD(&M(result2));
         return OK;
     case vr_input2:
-        values[(*index)++] = M(input2);
+        values[(*index)++] = ATOMIC_LOAD(&M(input2));
         return OK;
     case vr_output3:
-        values[(*index)++] = M(output3);
+        values[(*index)++] = ATOMIC_LOAD(&M(output3));
         return OK;
     default:
         logError(comp, "Get Int32 is not allowed for value reference %u.", vr);
@@ -219,8 +218,7 @@ Status getClock(ModelInstance* comp, ValueReference vr, _Bool *value) {
 
     switch (vr) {
     case vr_outClock:
-        *value = M(outClock);
-        M(outClock) = false;
+        *value = ATOMIC_EXCHANGE(&M(outClock), false);
         return OK;
     default:
         logError(comp, "Get Clock is not allowed for value reference %u.", vr);
@@ -231,10 +229,11 @@ Status getClock(ModelInstance* comp, ValueReference vr, _Bool *value) {
 Status getInterval(ModelInstance* comp, ValueReference vr, double* interval, int* qualifier) {
     switch (vr) {
     case vr_inClock3:
-        *qualifier = M(inClock3_qualifier);
-        if (*qualifier == 2) {                  // fmi3IntervalChanged
+        if (ATOMIC_COMPARE_EXCHANGE(&M(inClock3_qualifier), 2, 1)) {  // fmi3IntervalChanged -> fmi3IntervalUnchanged
+            *qualifier = 2;
             *interval = M(inClock3_interval);
-            M(inClock3_qualifier) = 1;          // fmi3IntervalUnchanged
+        } else {
+            *qualifier = ATOMIC_LOAD(&M(inClock3_qualifier));
         }
         return OK;
     default:
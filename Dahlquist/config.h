@@ -11,6 +11,7 @@
 #define MAX_CONTINUOUS_STATES 1
 
 #define SET_FLOAT64
+#define GET_OUTPUT_DERIVATIVE
 
 #define FIXED_SOLVER_STEP 0.1
 #define DEFAULT_STOP_TIME 10
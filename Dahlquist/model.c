@@ -135,3 +135,19 @@ Status getDerivatives(ModelInstance *comp, double dx[], size_t nx) {
 
     return OK;
 }
+
+Status getOutputDerivative(ModelInstance *comp, ValueReference valueReference, int order, double *value) {
+    ASSERT_NOT_NULL2(comp);
+    ASSERT_NOT_NULL2(value);
+
+    if (order != 1 || valueReference != vr_x) {
+        logError(comp, "The output derivative order %d for value reference %u is not available.", order, valueReference);
+        return Error;
+    }
+
+    calculateValues(comp);
+
+    *value = M(der_x);
+
+    return OK;
+}
@@ -40,6 +40,11 @@
 #define SET_STRING
 #define SET_BINARY
 
+#define GET_PARTIAL_DERIVATIVE
+#define GET_OUTPUT_DERIVATIVE
+
+#define MAX_INPUT_DERIVATIVES 1
+
 #define EVENT_UPDATE
 
 #define FIXED_SOLVER_STEP 0.1
@@ -809,6 +809,41 @@ Status setBinary(ModelInstance* comp, ValueReference vr, const size_t size[], co
     return OK;
 }
 
+Status getPartialDerivative(ModelInstance *comp, ValueReference unknown, ValueReference known, double *partialDerivative) {
+    ASSERT_NOT_NULL2(comp);
+    ASSERT_NOT_NULL2(partialDerivative);
+
+    if (unknown == vr_Float64_continuous_output && known == vr_Float64_continuous_input) {
+        *partialDerivative = 1;
+    } else if (unknown == vr_Float64_discrete_output && known == vr_Float64_discrete_input) {
+        *partialDerivative = 1;
+    } else {
+        *partialDerivative = 0;
+    }
+
+    return OK;
+}
+
+Status getOutputDerivative(ModelInstance *comp, ValueReference valueReference, int order, double *value) {
+    ASSERT_NOT_NULL2(comp);
+    ASSERT_NOT_NULL2(value);
+
+    if (order != 1) {
+        logError(comp, "The output derivative order %d for value reference %u is not available.", order, valueReference);
+        return Error;
+    }
+
+    // the continuous output follows the input
+    if (valueReference != vr_Float64_continuous_output) {
+        logError(comp, "The output derivative for value reference %u is not available.", valueReference);
+        return Error;
+    }
+
+    *value = getInputDerivative(comp, vr_Float64_continuous_input, 1);
+
+    return OK;
+}
+
 Status eventUpdate(ModelInstance *comp) {
     ASSERT_NOT_NULL2(comp);
 
@@ -44,7 +44,7 @@ Status calculateValues(ModelInstance *comp) {
         return Error;
     }
 #else
-    strncpy(path, comp->resourceLocation, MAX_PATH_LENGTH);
+    strncpy(path, comp->resourceLocation, MAX_PATH_LENGTH - 1);
 #endif
 
 #if FMI_VERSION == 2
@@ -89,7 +89,7 @@ Status calculateValues(ModelInstance *comp) {
 
     *dst = '\0';
 #else
-    strncpy(path, comp->resourceLocation, MAX_PATH_LENGTH);
+    strncpy(path, comp->resourceLocation, MAX_PATH_LENGTH - 1);
 #endif
 
 #if FMI_VERSION == 2
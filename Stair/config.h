@@ -13,6 +13,8 @@
 
 #define EVENT_UPDATE
 
+#define MAX_TIME_EVENTS 1
+
 #define FIXED_SOLVER_STEP 0.2
 #define DEFAULT_STOP_TIME 10
 
@@ -4,10 +4,8 @@
 Status setStartValues(ModelInstance *comp) {
     M(counter) = 1;
 
-    comp->nextEventTime        = 1;
-    comp->nextEventTimeDefined = true;
-
-    return OK;
+    // increment the counter every second
+    return scheduleTimeEvent(comp, 0, 1, 1);
 }
 
 Status calculateValues(ModelInstance *comp) {
@@ -86,9 +84,10 @@ Status setInt32(ModelInstance* comp, ValueReference vr, const int32_t values[],
 Status eventUpdate(ModelInstance *comp) {
     ASSERT_NOT_NULL2(comp);
 
-    if (comp->nextEventTimeDefined && isClose(comp->time, comp->nextEventTime)) {
+    int id;
+
+    while (popTimeEvent(comp, &id)) {
         M(counter)++;
-        comp->nextEventTime += 1;
     }
 
     if (M(counter) > 10) {
@@ -99,7 +98,6 @@ Status eventUpdate(ModelInstance *comp) {
     comp->valuesOfContinuousStatesChanged   = false;
     comp->nominalsOfContinuousStatesChanged = false;
     comp->terminateSimulation               = M(counter) >= 10;
-    comp->nextEventTimeDefined              = true;
 
     return OK;
 }
@@ -7,7 +7,8 @@
 #define MODEL_IDENTIFIER StateSpace
 #define INSTANTIATION_TOKEN "{D773325B-AB94-4630-BF85-643EB24FCB78}"
 
-#define MAX_CONTINUOUS_STATES 5
+// the number of continuous states is the structural parameter n
+#define MAX_CONTINUOUS_STATES 1
 
 #define CO_SIMULATION
 #define MODEL_EXCHANGE
@@ -20,10 +21,6 @@
 #define FIXED_SOLVER_STEP 1e-3
 #define DEFAULT_STOP_TIME 10
 
-#define M_MAX 5
-#define N_MAX 5
-#define R_MAX 5
-
 typedef enum {
     vr_time,
     vr_m,
@@ -40,19 +37,11 @@ typedef enum {
     vr_der_x
 } ValueReference;
 
+// the matrices and vectors are stored in the arena of the instance (see model.c)
 typedef struct {
     uint64_t m;
     uint64_t n;
     uint64_t r;
-    double A[M_MAX][N_MAX];
-    double B[M_MAX][N_MAX];
-    double C[M_MAX][N_MAX];
-    double D[M_MAX][N_MAX];
-    double x0[N_MAX];
-    double u[N_MAX];
-    double y[N_MAX];
-    double x[N_MAX];
-    double der_x[N_MAX];
 } ModelData;
 
 #endif /* config_h */
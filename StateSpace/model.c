@@ -1,34 +1,171 @@
+#include <string.h>  // for memcpy(), memmove(), memset()
 #include "config.h"
 #include "model.h"
 
+/*
+The matrices and vectors are stored row by row in the arena of the instance
+
+    A (n x n) | B (n x m) | C (r x n) | D (r x m) | x0 (n) | u (m) | y (r) | x (n) | der(x) (n)
+
+which is the order of the serialized array variables in FMI, so they are copied as one block.
+When the dimensions are changed, the arena grows geometrically (but never shrinks) and the elements
+that are part of the old and the new dimensions are moved in place. New elements are set to 0.
+*/
+
+// larger dimensions could overflow the size of the arena
+#define MAX_DIMENSION (1 << 20)
+
+#define N_ARRAYS 9
+
+typedef enum {
+    array_A,
+    array_B,
+    array_C,
+    array_D,
+    array_x0,
+    array_u,
+    array_y,
+    array_x,
+    array_der_x
+} Array;
+
+typedef struct {
+    size_t rows[N_ARRAYS];
+    size_t cols[N_ARRAYS];
+    size_t offsets[N_ARRAYS];
+    size_t size;
+} Layout;
+
+static size_t minSize(size_t a, size_t b) {
+    return a < b ? a : b;
+}
+
+static void getLayout(size_t m, size_t n, size_t r, Layout* layout) {
+
+    const size_t rows[N_ARRAYS] = { n, n, r, r, 1, 1, 1, 1, 1 };
+    const size_t cols[N_ARRAYS] = { n, m, n, m, n, m, r, n, n };
+
+    size_t offset = 0;
+
+    for (size_t k = 0; k < N_ARRAYS; k++) {
+        layout->rows[k]    = rows[k];
+        layout->cols[k]    = cols[k];
+        layout->offsets[k] = offset;
+        offset += rows[k] * cols[k];
+    }
+
+    layout->size = offset;
+}
+
+static double* array(ModelInstance* comp, Array k) {
+
+    Layout layout;
+
+    getLayout((size_t)M(m), (size_t)M(n), (size_t)M(r), &layout);
+
+    return (double*)comp->arena + layout.offsets[k];
+}
+
+/* Move the elements that are part of both layouts from layout "from" to layout "to". If no dimension shrinks
+   (grow = true) every row moves to a higher address, so the rows are moved starting from the end and the new
+   elements are set to 0. If no dimension grows, the rows move to lower addresses and are moved from the start. */
+static void moveArrays(double* arena, const Layout* from, const Layout* to, bool grow) {
+
+    for (size_t l = 0; l < N_ARRAYS; l++) {
+
+        const size_t k = grow ? N_ARRAYS - 1 - l : l;
+
+        const size_t rows = minSize(from->rows[k], to->rows[k]);
+        const size_t cols = minSize(from->cols[k], to->cols[k]);
+
+        if (grow) {
+            memset(arena + to->offsets[k] + rows * to->cols[k], 0, (to->rows[k] - rows) * to->cols[k] * sizeof(double));
+        }
+
+        for (size_t s = 0; s < rows; s++) {
+
+            const size_t i = grow ? rows - 1 - s : s;
+
+            double* target = arena + to->offsets[k] + i * to->cols[k];
+            const double* source = arena + from->offsets[k] + i * from->cols[k];
+
+            if (target != source) {
+                memmove(target, source, cols * sizeof(double));
+            }
+
+            if (grow) {
+                memset(target + cols, 0, (to->cols[k] - cols) * sizeof(double));
+            }
+        }
+    }
+}
+
+static Status setDimensions(ModelInstance* comp, uint64_t m, uint64_t n, uint64_t r) {
+
+    Layout from, overlap, to;
+
+    getLayout((size_t)M(m), (size_t)M(n), (size_t)M(r), &from);
+    getLayout((size_t)(m < M(m) ? m : M(m)), (size_t)(n < M(n) ? n : M(n)), (size_t)(r < M(r) ? r : M(r)), &overlap);
+    getLayout((size_t)m, (size_t)n, (size_t)r, &to);
+
+    if (to.size > from.size) {
+        const Status status = resizeArena(comp, to.size * sizeof(double));
+        if (status > Warning) {
+            return status;
+        }
+    }
+
+    if (comp->arena) {
+        // first shrink and then grow the dimensions that change
+        moveArrays((double*)comp->arena, &from, &overlap, false);
+        moveArrays((double*)comp->arena, &overlap, &to, true);
+    }
+
+    if (to.size < from.size) {
+        resizeArena(comp, to.size * sizeof(double));
+    }
+
+    M(m) = m;
+    M(n) = n;
+    M(r) = r;
+
+    comp->isDirtyValues = true;
+
+    return OK;
+}
 
 Status setStartValues(ModelInstance *comp) {
     ASSERT_NOT_NULL2(comp);
 
-    M(m) = 3;
-    M(n) = 3;
-    M(r) = 3;
+    const Status status = setDimensions(comp, 3, 3, 3);
 
-    // identity matrix
-    for (int i = 0; i < M_MAX; i++)
-    for (int j = 0; j < N_MAX; j++) {
-        M(A)[i][j] = i == j ? 1 : 0;
-        M(B)[i][j] = i == j ? 1 : 0;
-        M(C)[i][j] = i == j ? 1 : 0;
-        M(D)[i][j] = i == j ? 1 : 0;
+    if (status > Warning) {
+        return status;
     }
 
-    for (int i = 0; i < M_MAX; i++) {
-        M(u)[i] = i + 1;
-    }
+    double* A  = array(comp, array_A);
+    double* B  = array(comp, array_B);
+    double* C  = array(comp, array_C);
+    double* D  = array(comp, array_D);
+    double* x0 = array(comp, array_x0);
+    double* u  = array(comp, array_u);
+    double* y  = array(comp, array_y);
+    double* x  = array(comp, array_x);
 
-    for (int i = 0; i < N_MAX; i++) {
-        M(y)[i] = 0;
+    // identity matrix
+    for (size_t i = 0; i < 3; i++)
+    for (size_t j = 0; j < 3; j++) {
+        A[i * 3 + j] = i == j ? 1 : 0;
+        B[i * 3 + j] = i == j ? 1 : 0;
+        C[i * 3 + j] = i == j ? 1 : 0;
+        D[i * 3 + j] = i == j ? 1 : 0;
     }
 
-    for (int i = 0; i < N_MAX; i++) {
-        M(x)[i] = M(x0)[i];
-        M(x)[i] = 0;
+    for (size_t i = 0; i < 3; i++) {
+        x0[i] = 0;
+        u[i] = (double)(i + 1);
+        y[i] = 0;
+        x[i] = x0[i];
     }
 
     comp->isDirtyValues = true;
@@ -39,37 +176,44 @@ Status setStartValues(ModelInstance *comp) {
 Status calculateValues(ModelInstance *comp) {
     ASSERT_NOT_NULL2(comp);
 
+    const size_t m = (size_t)M(m);
+    const size_t n = (size_t)M(n);
+    const size_t r = (size_t)M(r);
+
+    const double* A = array(comp, array_A);
+    const double* B = array(comp, array_B);
+    const double* C = array(comp, array_C);
+    const double* D = array(comp, array_D);
+    const double* u = array(comp, array_u);
+    const double* x = array(comp, array_x);
+    double* y       = array(comp, array_y);
+    double* der_x   = array(comp, array_der_x);
+
     // der(x) = Ax + Bu
-    for (size_t i = 0; i < M(n); i++) {
+    for (size_t i = 0; i < n; i++) {
 
-        M(der_x)[i] = 0;
+        der_x[i] = 0;
 
-        for (size_t j = 0; j < M(n); j++) {
-            M(der_x)[i] += M(A)[i][j] * M(x)[j];
+        for (size_t j = 0; j < n; j++) {
+            der_x[i] += A[i * n + j] * x[j];
         }
-    }
-
-    for (size_t i = 0; i < M(n); i++) {
 
-        for (size_t j = 0; j < M(r); j++) {
-            M(der_x)[i] += M(B)[i][j] * M(u)[j];
+        for (size_t j = 0; j < m; j++) {
+            der_x[i] += B[i * m + j] * u[j];
         }
     }
 
     // y = Cx + Du
-    for (size_t i = 0; i < M(r); i++) {
+    for (size_t i = 0; i < r; i++) {
 
-        M(y)[i] = 0;
+        y[i] = 0;
 
-        for (size_t j = 0; j < M(n); j++) {
-            M(y)[i] += M(C)[i][j] * M(x)[j];
+        for (size_t j = 0; j < n; j++) {
+            y[i] += C[i * n + j] * x[j];
         }
-    }
 
-    for (size_t i = 0; i < M(r); i++) {
-
-        for (size_t j = 0; j < M(m); j++) {
-            M(y)[i] += M(D)[i][j] * M(u)[j];
+        for (size_t j = 0; j < m; j++) {
+            y[i] += D[i * m + j] * u[j];
         }
     }
 
@@ -78,12 +222,36 @@ Status calculateValues(ModelInstance *comp) {
     return OK;
 }
 
+/* the number of elements of the array variable vr */
+static size_t arraySize(ModelInstance* comp, ValueReference vr) {
+
+    const size_t m = (size_t)M(m);
+    const size_t n = (size_t)M(n);
+    const size_t r = (size_t)M(r);
+
+    switch (vr) {
+        case vr_A:     return n * n;
+        case vr_B:     return n * m;
+        case vr_C:     return r * n;
+        case vr_D:     return r * m;
+        case vr_u:     return m;
+        case vr_y:     return r;
+        default:       return n;  // x0, x, der(x)
+    }
+}
+
+static Array arrayOf(ValueReference vr) {
+    return (Array)(vr - vr_A);
+}
+
 Status getFloat64(ModelInstance* comp, ValueReference vr, double values[], size_t nValues, size_t* index) {
     ASSERT_NOT_NULL2(comp);
     ASSERT_NOT_NULL2(values);
     ASSERT_NOT_NULL2(index);
 
-    calculateValues(comp);
+    if (comp->isDirtyValues) {
+        calculateValues(comp);
+    }
 
     switch (vr) {
         case vr_time:
@@ -91,67 +259,20 @@ Status getFloat64(ModelInstance* comp, ValueReference vr, double values[], size_
             values[(*index)++] = comp->time;
             return OK;
         case vr_A:
-            ASSERT_NVALUES((size_t)(M(n) * M(n)));
-            for (size_t i = 0; i < M(n); i++) {
-                for (size_t j = 0; j < M(n); j++) {
-                    values[(*index)++] = M(A)[i][j];
-                }
-            }
-            return OK;
         case vr_B:
-            ASSERT_NVALUES((size_t)(M(m) * M(n)));
-            for (size_t i = 0; i < M(m); i++) {
-                for (size_t j = 0; j < M(n); j++) {
-                    values[(*index)++] = M(B)[i][j];
-                }
-            }
-            return OK;
         case vr_C:
-            ASSERT_NVALUES((size_t)(M(r) * M(n)));
-            for (size_t i = 0; i < M(r); i++) {
-                for (size_t j = 0; j < M(n); j++) {
-                    values[(*index)++] = M(C)[i][j];
-                }
-            }
-            return OK;
         case vr_D:
-            ASSERT_NVALUES((size_t)(M(r) * M(m)));
-            for (size_t i = 0; i < M(r); i++) {
-                for (size_t j = 0; j < M(m); j++) {
-                    values[(*index)++] = M(D)[i][j];
-                }
-            }
-            return OK;
         case vr_x0:
-            ASSERT_NVALUES((size_t)M(n));
-            for (size_t i = 0; i < M(n); i++) {
-                values[(*index)++] = M(x0)[i];
-            }
-            return OK;
         case vr_u:
-            ASSERT_NVALUES((size_t)M(m));
-            for (size_t i = 0; i < M(m); i++) {
-                values[(*index)++] = M(u)[i];
-            }
-            return OK;
         case vr_y:
-            ASSERT_NVALUES((size_t)M(r));
-            for (size_t i = 0; i < M(r); i++) {
-                values[(*index)++] = M(y)[i];
-            }
-            return OK;
         case vr_x:
-            ASSERT_NVALUES((size_t)M(n));
-            for (size_t i = 0; i < M(n); i++) {
-                values[(*index)++] = M(x)[i];
-            }
-            return OK;
-        case vr_der_x:
-            ASSERT_NVALUES((size_t)M(n));
-            for (size_t i = 0; i < M(n); i++) {
-                values[(*index)++] = M(der_x)[i];
-            }
+        case vr_der_x: {
+            const size_t size = arraySize(comp, vr);
+            ASSERT_NVALUES(size);
+            memcpy(&values[*index], array(comp, arrayOf(vr)), size * sizeof(double));
+            *index += size;
             return OK;
+        }
         default:
             logError(comp, "Get Float64 is not allowed for value reference %u.", vr);
             return Error;
@@ -164,65 +285,34 @@ Status setFloat64(ModelInstance* comp, ValueReference vr, const double values[],
     ASSERT_NOT_NULL2(index);
 
     switch (vr) {
-    case vr_A:
-        ASSERT_NVALUES((size_t)(M(n) * M(n)));
-        for (size_t i = 0; i < M(n); i++) {
-            for (size_t j = 0; j < M(n); j++) {
-                M(A)[i][j] = values[(*index)++];
-            }
-        }
-        break;
-    case vr_B:
-        ASSERT_NVALUES((size_t)(M(n) * M(m)));
-        for (size_t i = 0; i < M(n); i++) {
-            for (size_t j = 0; j < M(m); j++) {
-                M(B)[i][j] = values[(*index)++];
-            }
-        }
-        break;
-    case vr_C:
-        ASSERT_NVALUES((size_t)(M(r) * M(n)));
-        for (size_t i = 0; i < M(r); i++) {
-            for (size_t j = 0; j < M(n); j++) {
-                M(C)[i][j] = values[(*index)++];
-            }
-        }
-        break;
-    case vr_D:
-        ASSERT_NVALUES((size_t)(M(r) * M(m)));
-        for (size_t i = 0; i < M(r); i++) {
-            for (size_t j = 0; j < M(m); j++) {
-                M(D)[i][j] = values[(*index)++];
-            }
-        }
-        break;
-    case vr_x0:
-        ASSERT_NVALUES((size_t)M(n));
-        for (size_t i = 0; i < M(n); i++) {
-            M(x0)[i] = values[(*index)++];
-        }
-        break;
-    case vr_u:
-        ASSERT_NVALUES((size_t)M(m));
-        for (size_t i = 0; i < M(m); i++) {
-            M(u)[i] = values[(*index)++];
-        }
-        break;
     case vr_x:
         if (comp->state != ContinuousTimeMode && comp->state != EventMode) {
             logError(comp, "Variable \"x\" can only be set in Continuous Time Mode and Event Mode.");
             return Error;
         }
-        ASSERT_NVALUES((size_t)M(n));
-        for (size_t i = 0; i < M(n); i++) {
-            M(x)[i] = values[(*index)++];
-        }
+        // fall through
+    case vr_A:
+    case vr_B:
+    case vr_C:
+    case vr_D:
+    case vr_x0:
+    case vr_u: {
+        const size_t size = arraySize(comp, vr);
+        ASSERT_NVALUES(size);
+        memcpy(array(comp, arrayOf(vr)), &values[*index], size * sizeof(double));
+        *index += size;
         break;
+    }
     default:
         logError(comp, "Set Float64 is not allowed for value reference %u.", vr);
         return Error;
     }
 
+    // the initial state can only be changed before the initialization is finished
+    if (vr == vr_x0 && (comp->state == Instantiated || comp->state == InitializationMode)) {
+        memcpy(array(comp, array_x), array(comp, array_x0), (size_t)M(n) * sizeof(double));
+    }
+
     comp->isDirtyValues = true;
 
     return OK;
@@ -262,41 +352,26 @@ Status setUInt64(ModelInstance* comp, ValueReference vr, const uint64_t values[]
         return Error;
     }
 
+    ASSERT_NVALUES(1);
+
     const uint64_t v = values[(*index)++];
 
+    if (v > MAX_DIMENSION) {
+        logError(comp, "The dimension %llu is too large.", (unsigned long long)v);
+        return Error;
+    }
+
     switch (vr) {
         case vr_m:
-            if (v > M_MAX) {
-                logError(comp, "Variable m must not be greater than " xstr(M_MAX) ".");
-                return Error;
-            }
-            ASSERT_NVALUES(1);
-            M(m) = v;
-            break;
+            return setDimensions(comp, v, M(n), M(r));
         case vr_n:
-            if (v > N_MAX) {
-                logError(comp, "Variable n must not be greater than " xstr(N_MAX) ".");
-                return Error;
-            }
-            ASSERT_NVALUES(1);
-            M(n) = v;
-            break;
+            return setDimensions(comp, M(m), v, M(r));
         case vr_r:
-            if (v > R_MAX) {
-                logError(comp, "Variable r must not be greater than " xstr(R_MAX) ".");
-                return Error;
-            }
-            ASSERT_NVALUES(1);
-            M(r) = v;
-            break;
+            return setDimensions(comp, M(m), M(n), v);
         default:
             logError(comp, "Set UInt64 is not allowed for value reference %u.", vr);
             return Error;
     }
-
-    comp->isDirtyValues = true;
-
-    return OK;
 }
 
 Status eventUpdate(ModelInstance *comp) {
@@ -324,9 +399,7 @@ Status getContinuousStates(ModelInstance* comp, double x[], size_t nx) {
         return Error;
     }
 
-    for (size_t i = 0; i < M(n); i++) {
-        x[i] = M(x)[i];
-    }
+    memcpy(x, array(comp, array_x), nx * sizeof(double));
 
     return OK;
 }
@@ -356,9 +429,7 @@ Status setContinuousStates(ModelInstance* comp, const double x[], size_t nx) {
         return Error;
     }
 
-    for (size_t i = 0; i < M(n); i++) {
-        M(x)[i] = x[i];
-    }
+    memcpy(array(comp, array_x), x, nx * sizeof(double));
 
     comp->isDirtyValues = true;
 
@@ -374,11 +445,11 @@ Status getDerivatives(ModelInstance* comp, double dx[], size_t nx) {
         return Error;
     }
 
-    calculateValues(comp);
-
-    for (size_t i = 0; i < M(n); i++) {
-        dx[i] = M(der_x)[i];
+    if (comp->isDirtyValues) {
+        calculateValues(comp);
     }
 
+    memcpy(dx, array(comp, array_der_x), nx * sizeof(double));
+
     return OK;
 }
@@ -11,6 +11,7 @@
 #define MAX_CONTINUOUS_STATES 2
 
 #define SET_FLOAT64
+#define GET_OUTPUT_DERIVATIVE
 
 #define GET_PARTIAL_DERIVATIVE
 
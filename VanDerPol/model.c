@@ -176,6 +176,30 @@ Status getPartialDerivative(ModelInstance *comp, ValueReference unknown, ValueRe
     return OK;
 }
 
+Status getOutputDerivative(ModelInstance *comp, ValueReference valueReference, int order, double *value) {
+    ASSERT_NOT_NULL2(comp);
+    ASSERT_NOT_NULL2(value);
+
+    if (order != 1) {
+        logError(comp, "The output derivative order %d for value reference %u is not available.", order, valueReference);
+        return Error;
+    }
+
+    calculateValues(comp);
+
+    switch (valueReference) {
+    case vr_x0:
+        *value = M(der_x0);
+        return OK;
+    case vr_x1:
+        *value = M(der_x1);
+        return OK;
+    default:
+        logError(comp, "The output derivative for value reference %u is not available.", valueReference);
+        return Error;
+    }
+}
+
 Status eventUpdate(ModelInstance *comp) {
     ASSERT_NOT_NULL2(comp);
 
@@ -21,6 +21,11 @@ parser.add_argument(
     default='Visual Studio 17 2022',
     help="CMake generator for Windows"
 )
+parser.add_argument(
+    '--static-models',
+    action='store_true',
+    help="Build the models as static libraries and link them into fmusim_<model>"
+)
 args, _ = parser.parse_known_args()
 
 
@@ -92,6 +97,7 @@ def build_fmus(fmi_version):
         '-D', f'CMAKE_INSTALL_PREFIX={install_dir}',
         '-D', f'FMI_VERSION={fmi_version}',
         '-D', f'FMI_ARCHITECTURE={fmi_architecture}',
+        '-D', f'BUILD_STATIC_MODELS={"ON" if args.static_models else "OFF"}',
         '-B', build_dir,
         parent_dir.parent
     ]
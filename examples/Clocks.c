@@ -1,4 +1,15 @@
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#include <time.h>
+#endif
+
 #include "util.h"
+#include "fmi3Extensions.h"
 
 
 FILE *createOutputFile(const char *filename) {
@@ -24,3 +35,57 @@ FMIStatus recordVariables(FMIInstance *S, double time, FILE *outputFile) {
 
     return getStatus;
 }
+
+double wallClockTime(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + 1e-9 * (double)t.tv_nsec;
+#endif
+}
+
+FMIStatus printClockStatistics(FMIInstance *S) {
+
+    // fmi3GetClockStatistics() is an extension of the Reference FMUs and not part of the FMIInstance
+#ifdef _WIN32
+    fmi3GetClockStatisticsTYPE *getClockStatistics = (fmi3GetClockStatisticsTYPE *)GetProcAddress(S->libraryHandle, "fmi3GetClockStatistics");
+#else
+    fmi3GetClockStatisticsTYPE *getClockStatistics = (fmi3GetClockStatisticsTYPE *)dlsym(S->libraryHandle, "fmi3GetClockStatistics");
+#endif
+
+    if (!getClockStatistics) {
+        printf("The FMU does not provide fmi3GetClockStatistics().\n");
+        return FMIError;
+    }
+
+    const fmi3ValueReference inputClocks[N_INPUT_CLOCKS] = { vr_inClock1, vr_inClock2, vr_inClock3 };
+
+    for (size_t i = 0; i < N_INPUT_CLOCKS; i++) {
+
+        fmi3ClockStatistics statistics;
+
+        const FMIStatus getStatus = (FMIStatus)getClockStatistics(S->component, inputClocks[i], &statistics);
+
+        if (getStatus > FMIOK) {
+            return getStatus;
+        }
+
+        if (statistics.nActivations == 0) {
+            continue;
+        }
+
+        printf("FMU: Model Partition %zu: %llu activations, mean execution time = %.3g us, max execution time = %.3g us, max latency = %.3g us\n",
+            i + 1,
+            (unsigned long long)statistics.nActivations,
+            1e6 * statistics.totalExecutionTime / statistics.nActivations,
+            1e6 * statistics.maxExecutionTime,
+            1e6 * statistics.maxLatency);
+    }
+
+    return FMIOK;
+}
@@ -17,6 +17,24 @@ else ()
     set(LIBRARIES ${CMAKE_DL_LIBS})
 endif()
 
+# model_description
+add_executable(model_description
+    include/FMI.h
+    include/FMIModelDescription.h
+    src/FMI.c
+    src/FMIModelDescription.c
+    examples/model_description.c
+)
+add_dependencies(model_description BouncingBall)
+set_target_properties(model_description PROPERTIES FOLDER examples)
+target_include_directories(model_description PRIVATE include)
+target_link_libraries(model_description ${LIBRARIES})
+set_target_properties(model_description PROPERTIES
+    RUNTIME_OUTPUT_DIRECTORY         temp
+    RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+    RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+)
+
 if (${FMI_VERSION} EQUAL 3)
 
     # import_static_library
@@ -41,6 +59,30 @@ if (${FMI_VERSION} EQUAL 3)
         RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
     )
 
+    # cs_batched_steps
+    add_executable(cs_batched_steps
+        include/cosimulation.h
+        include/fmi3Extensions.h
+        include/fmi3Functions.h
+        include/fmi3FunctionTypes.h
+        include/fmi3PlatformTypes.h
+        include/model.h
+        Feedthrough/config.h
+        src/fmi3Functions.c
+        Feedthrough/model.c
+        src/cosimulation.c
+        examples/cs_batched_steps.c
+    )
+    set_target_properties (cs_batched_steps PROPERTIES FOLDER examples)
+    target_compile_definitions(cs_batched_steps PRIVATE FMI_VERSION=${FMI_VERSION})
+    target_include_directories(cs_batched_steps PRIVATE include Feedthrough)
+    target_link_libraries(cs_batched_steps ${LIBRARIES})
+    set_target_properties(cs_batched_steps PROPERTIES
+        RUNTIME_OUTPUT_DIRECTORY         temp
+        RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+        RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+    )
+
     # import_shared_library
     add_executable(import_shared_library
         include/fmi3FunctionTypes.h
@@ -153,6 +195,8 @@ if (${FMI_VERSION} EQUAL 3)
     # scs_synchronous
     add_executable (scs_synchronous
         ${EXAMPLE_SOURCES}
+        include/FMIClockScheduler.h
+        src/FMIClockScheduler.c
         Clocks/config.h
         examples/Clocks.c
         examples/scs_synchronous.c
@@ -168,26 +212,78 @@ if (${FMI_VERSION} EQUAL 3)
         RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
     )
 
+    # scs_parallel
+    find_package(Threads REQUIRED)
+    add_executable (scs_parallel
+        ${EXAMPLE_SOURCES}
+        Clocks/config.h
+        fmusim/FMIThread.h
+        fmusim/FMIThread.c
+        fmusim/FMIThreadPool.h
+        fmusim/FMIThreadPool.c
+        examples/Clocks.c
+        examples/scs_parallel.c
+    )
+    add_dependencies(scs_parallel Clocks)
+    set_target_properties(scs_parallel PROPERTIES FOLDER examples)
+    target_compile_definitions(scs_parallel PRIVATE FMI_VERSION=${FMI_VERSION})
+    target_include_directories(scs_parallel PRIVATE include Clocks fmusim)
+    target_link_libraries(scs_parallel ${LIBRARIES} Threads::Threads)
+    set_target_properties(scs_parallel PROPERTIES
+        RUNTIME_OUTPUT_DIRECTORY         temp
+        RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+        RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+    )
+
+    # scs_threaded
     if (WIN32)
-        add_executable (scs_threaded
-            ${EXAMPLE_SOURCES}
-            Clocks/config.h
-            examples/scs_threaded.c
-        )
-        add_dependencies(scs_threaded Clocks)
-        set_target_properties(scs_threaded PROPERTIES FOLDER examples)
-        target_compile_definitions(scs_threaded PRIVATE FMI_VERSION=${FMI_VERSION})
-        target_include_directories(scs_threaded PRIVATE include Clocks)
-        target_link_libraries(scs_threaded ${LIBRARIES})
-        set_target_properties(scs_threaded PROPERTIES
-            RUNTIME_OUTPUT_DIRECTORY         temp
-            RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
-            RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
-        )
+        set(SCS_THREADED_SOURCE examples/scs_threaded.c)
+    else ()
+        set(SCS_THREADED_SOURCE examples/scs_threaded_posix.c examples/Clocks.c)
     endif ()
 
+    add_executable (scs_threaded
+        ${EXAMPLE_SOURCES}
+        Clocks/config.h
+        ${SCS_THREADED_SOURCE}
+    )
+    add_dependencies(scs_threaded Clocks)
+    set_target_properties(scs_threaded PROPERTIES FOLDER examples)
+    target_compile_definitions(scs_threaded PRIVATE FMI_VERSION=${FMI_VERSION})
+    target_include_directories(scs_threaded PRIVATE include Clocks)
+    target_link_libraries(scs_threaded ${LIBRARIES})
+    if (NOT WIN32)
+        target_link_libraries(scs_threaded Threads::Threads)
+    endif ()
+    set_target_properties(scs_threaded PROPERTIES
+        RUNTIME_OUTPUT_DIRECTORY         temp
+        RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+        RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+    )
+
 endif()
 
+if (${FMI_VERSION} EQUAL 2)
+
+    # cs_asynchronous
+    add_executable(cs_asynchronous
+        ${EXAMPLE_SOURCES}
+        BouncingBall/config.h
+        examples/cs_asynchronous.c
+    )
+    add_dependencies(cs_asynchronous BouncingBall)
+    set_target_properties(cs_asynchronous PROPERTIES FOLDER examples)
+    target_compile_definitions(cs_asynchronous PRIVATE FMI_VERSION=${FMI_VERSION} DISABLE_PREFIX)
+    target_include_directories(cs_asynchronous PRIVATE include BouncingBall)
+    target_link_libraries(cs_asynchronous ${LIBRARIES})
+    set_target_properties(cs_asynchronous PROPERTIES
+        RUNTIME_OUTPUT_DIRECTORY         temp
+        RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+        RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+    )
+
+endif ()
+
 # Examples
 set(MODEL_NAMES BouncingBall Dahlquist Feedthrough Resource Stair VanDerPol)
 
@@ -28,19 +28,25 @@ FMIStatus recordVariables(FMIInstance *S, double time, FILE *outputFile) {
 
     const fmi3ValueReference vr_y_ = vr_y;
 
-    fmi3Float64 y[R_MAX] = { 0 };
+    // the number of outputs can be changed in Configuration Mode
+    fmi3Float64 *y = calloc((size_t)r + 1, sizeof(fmi3Float64));
+
+    if (!y) return FMIError;
 
     status = FMI3GetFloat64(S, &vr_y_, 1, y, r);
 
-    if (status > FMIWarning) return status;
+    if (status <= FMIWarning) {
+
+        fprintf(outputFile, "%g,", time);
 
-    fprintf(outputFile, "%g,", time);
+        for (size_t i = 0; i < r; i++) {
+            fprintf(outputFile, i == 0 ? "%g" : " %g", y[i]);
+        }
 
-    for (size_t i = 0; i < r; i++) {
-        fprintf(outputFile, i == 0 ? "%g" : " %g", y[i]);
+        fputc('\n', outputFile);
     }
 
-    fputc('\n', outputFile);
+    free(y);
 
     return status;
 }
@@ -0,0 +1,139 @@
+/* This example steps several instances of BouncingBall from a single thread with asynchronous fmi2DoStep() calls.
+   The steps of all instances are started first and run in parallel on the worker threads of the instances while
+   the master polls their status with fmi2GetStatus(). An additional instance is stepped synchronously to check
+   the results. */
+
+#include "util.h"
+
+
+#define N_INSTANCES 4
+
+#define STEP_SIZE 0.1
+
+
+static void cb_stepFinished(fmi2ComponentEnvironment componentEnvironment, fmi2Status status) {
+    // called on the worker thread of the instance (the status is polled with fmi2GetStatus())
+}
+
+int main(int argc, char* argv[]) {
+
+    // the last instance is stepped synchronously
+    FMIInstance *instances[N_INSTANCES + 1] = { NULL };
+
+    for (size_t i = 0; i <= N_INSTANCES; i++) {
+
+        char name[32];
+
+        snprintf(name, sizeof(name), "instance%zu", i + 1);
+
+        FMIInstance *instance = FMICreateInstance(name, logMessage, NULL);
+
+        if (!instance) {
+            printf("Failed to create FMU instance.\n");
+            status = FMIError;
+            goto TERMINATE;
+        }
+
+        instances[i] = instance;
+
+        CALL(FMILoadPlatformBinary(instance, PLATFORM_BINARY));
+
+        if (i < N_INSTANCES) {
+            // pass the stepFinished callback to run fmi2DoStep() asynchronously
+            CALL(FMI2InstantiateAsynchronous(instance, resourceURI(), INSTANTIATION_TOKEN, fmi2False, fmi2False, cb_stepFinished));
+        } else {
+            CALL(FMI2Instantiate(instance, resourceURI(), fmi2CoSimulation, INSTANTIATION_TOKEN, fmi2False, fmi2False));
+        }
+
+        CALL(FMI2SetupExperiment(instance, fmi2False, 0, startTime, fmi2True, stopTime));
+        CALL(FMI2EnterInitializationMode(instance));
+        CALL(FMI2ExitInitializationMode(instance));
+    }
+
+    size_t nPolls = 0;
+
+    for (uint64_t step = 0; step * STEP_SIZE < stopTime - 1e-10; step++) {
+
+        const fmi2Real time = step * STEP_SIZE;
+
+        // start the steps of all instances
+        for (size_t i = 0; i < N_INSTANCES; i++) {
+
+            const FMIStatus doStepStatus = FMI2DoStep(instances[i], time, STEP_SIZE, fmi2True);
+
+            if (doStepStatus != FMIPending) {
+                printf("Expected fmi2DoStep() to return fmi2Pending but was %d.\n", doStepStatus);
+                status = FMIError;
+                goto TERMINATE;
+            }
+        }
+
+        CALL(FMI2DoStep(instances[N_INSTANCES], time, STEP_SIZE, fmi2True));
+
+        // wait for the steps to finish
+        for (size_t i = 0; i < N_INSTANCES; i++) {
+
+            fmi2Status doStepStatus = fmi2Pending;
+
+            while (doStepStatus == fmi2Pending) {
+                CALL(FMI2GetStatus(instances[i], fmi2DoStepStatus, &doStepStatus));
+                nPolls++;
+            }
+
+            CALL((FMIStatus)doStepStatus);
+
+            fmi2Real lastSuccessfulTime;
+
+            CALL(FMI2GetRealStatus(instances[i], fmi2LastSuccessfulTime, &lastSuccessfulTime));
+
+            if (fabs(lastSuccessfulTime - (time + STEP_SIZE)) > 1e-10) {
+                printf("Expected lastSuccessfulTime = %g but was %g.\n", time + STEP_SIZE, lastSuccessfulTime);
+                status = FMIError;
+                goto TERMINATE;
+            }
+        }
+    }
+
+    // the results of the asynchronous steps are the same
+    const fmi2ValueReference valueReferences[2] = { vr_h, vr_v };
+
+    fmi2Real expected[2];
+
+    CALL(FMI2GetReal(instances[N_INSTANCES], valueReferences, 2, expected));
+
+    for (size_t i = 0; i < N_INSTANCES; i++) {
+
+        fmi2Real values[2];
+
+        CALL(FMI2GetReal(instances[i], valueReferences, 2, values));
+
+        if (values[0] != expected[0] || values[1] != expected[1]) {
+            printf("Expected h = %g, v = %g for %s but was h = %g, v = %g.\n", expected[0], expected[1], instances[i]->name, values[0], values[1]);
+            status = FMIError;
+        }
+    }
+
+    printf("Stepped %d instances asynchronously to t = %g (%zu status polls).\n", N_INSTANCES, stopTime, nPolls);
+
+TERMINATE:
+
+    for (size_t i = 0; i <= N_INSTANCES; i++) {
+
+        FMIInstance *instance = instances[i];
+
+        if (!instance) {
+            continue;
+        }
+
+        if (instance->component) {
+            if (status < FMIError) {
+                FMI2Terminate(instance);
+            }
+            FMI2FreeInstance(instance);
+        }
+
+        FMIFreeInstance(instance);
+    }
+
+    return status;
+}
@@ -0,0 +1,126 @@
+/* This example demonstrates how to advance several communication steps in one call with fmi3DoSteps() and checks
+   that the results are identical to calling fmi3SetFloat64(), fmi3DoStep() and fmi3GetFloat64() for every step */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// FMI function prefix (from XML)
+#define FMI3_FUNCTION_PREFIX Feedthrough_
+#include "fmi3Functions.h"
+#include "fmi3Extensions.h"
+#undef FMI3_FUNCTION_PREFIX
+
+#define INSTANTIATION_TOKEN "{37B954F1-CC86-4D8F-B97F-C7C36F6670D2}"
+
+#define N_STEPS   100
+#define STEP_SIZE 0.01
+
+#define UNUSED(x) (void)(x)
+
+#define CALL(f) do { if ((f) > fmi3OK) { printf("%s failed.\n", #f); goto TERMINATE; } } while (0)
+
+static const fmi3ValueReference inputValueReferences[]  = { 7 };    // Float64_continuous_input
+static const fmi3ValueReference outputValueReferences[] = { 0, 8 }; // time, Float64_continuous_output
+
+static void cb_logMessage(fmi3InstanceEnvironment instanceEnvironment, fmi3Status status, fmi3String category, fmi3String message) {
+    UNUSED(instanceEnvironment);
+    UNUSED(status);
+    UNUSED(category);
+    printf("%s\n", message);
+}
+
+static fmi3Instance instantiate(fmi3String instanceName) {
+
+    fmi3Instance instance = Feedthrough_fmi3InstantiateCoSimulation(
+        instanceName,        // instance name
+        INSTANTIATION_TOKEN, // instantiation token (from XML)
+        NULL,                // resource location
+        fmi3False,           // visible
+        fmi3False,           // debug logging disabled
+        fmi3False,           // event mode used
+        fmi3False,           // early return allowed
+        NULL,                // required intermediate variables
+        0,                   // number of required intermediate variables
+        NULL,                // instance environment
+        cb_logMessage,       // logger callback
+        NULL);               // intermediate update callback
+
+    if (!instance) {
+        return NULL;
+    }
+
+    if (Feedthrough_fmi3EnterInitializationMode(instance, fmi3False, 0, 0, fmi3True, N_STEPS * STEP_SIZE) > fmi3OK ||
+        Feedthrough_fmi3ExitInitializationMode(instance) > fmi3OK) {
+        Feedthrough_fmi3FreeInstance(instance);
+        return NULL;
+    }
+
+    return instance;
+}
+
+int main(int argc, char* argv[]) {
+
+    UNUSED(argc);
+    UNUSED(argv);
+
+    int result = EXIT_FAILURE;
+
+    fmi3Float64 inputValues[N_STEPS];
+    fmi3Float64 expectedValues[N_STEPS * 2];
+    fmi3Float64 outputValues[N_STEPS * 2];
+
+    fmi3Boolean eventHandlingNeeded, terminateSimulation, earlyReturn;
+    fmi3Float64 lastSuccessfulTime;
+    size_t nStepsCompleted;
+
+    for (size_t k = 0; k < N_STEPS; k++) {
+        inputValues[k] = (k % 10) * 0.5;
+    }
+
+    fmi3Instance s1 = instantiate("single_steps");
+    fmi3Instance s2 = instantiate("batched_steps");
+
+    if (!s1 || !s2) {
+        goto TERMINATE;
+    }
+
+    // reference: one call per step
+    for (size_t k = 0; k < N_STEPS; k++) {
+        CALL(Feedthrough_fmi3SetFloat64(s1, inputValueReferences, 1, &inputValues[k], 1));
+        CALL(Feedthrough_fmi3DoStep(s1, k * STEP_SIZE, STEP_SIZE, fmi3True, &eventHandlingNeeded, &terminateSimulation, &earlyReturn, &lastSuccessfulTime));
+        CALL(Feedthrough_fmi3GetFloat64(s1, outputValueReferences, 2, &expectedValues[k * 2], 2));
+    }
+
+    // all steps in one call
+    CALL(Feedthrough_fmi3DoSteps(s2, 0, STEP_SIZE, N_STEPS,
+        inputValueReferences, 1, inputValues,
+        outputValueReferences, 2, outputValues,
+        &nStepsCompleted, &eventHandlingNeeded, &terminateSimulation, &earlyReturn, &lastSuccessfulTime));
+
+    if (nStepsCompleted != N_STEPS) {
+        printf("Expected %d completed steps but was %zu.\n", N_STEPS, nStepsCompleted);
+        goto TERMINATE;
+    }
+
+    if (memcmp(expectedValues, outputValues, sizeof(outputValues))) {
+        printf("The outputs of fmi3DoSteps() differ from the outputs of fmi3DoStep().\n");
+        goto TERMINATE;
+    }
+
+    printf("Completed %zu steps until t = %g.\n", nStepsCompleted, lastSuccessfulTime);
+
+    result = EXIT_SUCCESS;
+
+TERMINATE:
+
+    if (s1) {
+        Feedthrough_fmi3FreeInstance(s1);
+    }
+
+    if (s2) {
+        Feedthrough_fmi3FreeInstance(s2);
+    }
+
+    return result;
+}
@@ -16,8 +16,8 @@ int main(int argc, char* argv[]) {
     fmi3Boolean eventEncountered, terminateSimulation, earlyReturn;
 
     fmi3ValueReference vr[3];
-    fmi3Float64 D[R_MAX * M_MAX];
-    fmi3Float64 u[M_MAX];
+    fmi3Float64 D[3 * 3];
+    fmi3Float64 u[3];
     fmi3UInt64 p[3];
 
     CALL(setUp());
@@ -86,7 +86,7 @@ int main(int argc, char* argv[]) {
             CALL(FMI3SetFloat64(S, vr, 1, D, 9));
         }
 
-        for (size_t i = 0; i < M_MAX; i++) {
+        for (size_t i = 0; i < 3; i++) {
             u[i] = time + stepSize + i;
         }
 
@@ -0,0 +1,81 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "FMIModelDescription.h"
+
+
+#define N_RUNS 1000
+
+int main(int argc, char* argv[]) {
+
+    const char* filename = argc > 1 ? argv[1] : "BouncingBall/modelDescription.xml";
+
+    // tag::ReadModelDescription[]
+    FMIModelDescription* modelDescription = FMIReadModelDescription(filename);
+
+    if (!modelDescription) {
+        printf("Failed to read %s.\n", filename);
+        return EXIT_FAILURE;
+    }
+
+    printf("Model Name: %s\n", modelDescription->modelName);
+    printf("FMI Version: %s\n", modelDescription->fmiVersion);
+    printf("Derivatives: %zu\n", modelDescription->nDerivatives);
+    printf("Event Indicators: %zu\n", modelDescription->nEventIndicators);
+    printf("\n");
+
+    printf("%-20s %-8s %-6s %-20s %-12s %s\n", "Name", "Type", "VR", "Causality", "Variability", "Start");
+
+    for (size_t i = 0; i < modelDescription->nModelVariables; i++) {
+
+        const FMIModelVariable* variable = &modelDescription->modelVariables[i];
+
+        printf("%-20s %-8s %-6u %-20s %-12s %s\n",
+            variable->name,
+            FMIVariableTypeToString(variable->type),
+            variable->valueReference,
+            FMICausalityToString(variable->causality),
+            FMIVariabilityToString(variable->variability),
+            variable->start ? variable->start : "");
+    }
+    // end::ReadModelDescription[]
+
+    // look up all variables by name and value reference
+    for (size_t i = 0; i < modelDescription->nModelVariables; i++) {
+
+        const FMIModelVariable* variable = &modelDescription->modelVariables[i];
+
+        if (FMIModelVariableForName(modelDescription, variable->name) != variable ||
+            FMIModelVariableForValueReference(modelDescription, variable->type, variable->valueReference) != variable) {
+            printf("Failed to look up variable %s.\n", variable->name);
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (size_t i = 0; i < modelDescription->nDerivatives; i++) {
+
+        const FMIModelVariable* derivative = modelDescription->derivatives[i].modelVariable;
+
+        if (!derivative->derivative) {
+            printf("Variable %s is not a state derivative.\n", derivative->name);
+            return EXIT_FAILURE;
+        }
+    }
+
+    FMIFreeModelDescription(modelDescription);
+
+    // measure the parse time
+    const clock_t start = clock();
+
+    for (size_t i = 0; i < N_RUNS; i++) {
+        FMIFreeModelDescription(FMIReadModelDescription(filename));
+    }
+
+    const double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("\nAverage parse time: %.1f us\n", 1e6 * elapsed / N_RUNS);
+
+    return EXIT_SUCCESS;
+}
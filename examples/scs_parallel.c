@@ -0,0 +1,167 @@
+/* This example runs the model partitions of the Clocks model in parallel on a thread pool and measures the latency
+   of Model Partition 1 while Model Partition 3 is busy. The partitions share no lock, the shared counters of the
+   model are updated atomically. */
+
+#include "util.h"
+#include "FMIThread.h"
+#include "FMIThreadPool.h"
+
+
+// number of activations of Model Partition 1 without load
+#define N_ACTIVATIONS 1000
+
+typedef struct {
+    size_t n;
+    double sum;
+    double max;
+} Latency;
+
+static const fmi3ValueReference vrOutClock[1] = { vr_outClock };
+static const fmi3ValueReference vrCountdownClock[1] = { vr_inClock3 };
+
+static FMIMutex mutex;
+static bool partition3Finished = false;
+
+static Latency latencyWithoutLoad = { 0 };
+static Latency latencyWithLoad = { 0 };
+
+static fmi3Status status1 = fmi3OK;
+static fmi3Status status3 = fmi3OK;
+
+
+// the FMU is called through its function pointers, because the FMIInstance wrapper is not thread-safe
+
+static void cb_clockUpdate(fmi3InstanceEnvironment instanceEnvironment) {
+
+    fmi3Clock outClock;
+    fmi3Float64 interval;
+    fmi3IntervalQualifier qualifier;
+
+    // reset the clocks (the countdown clock is not activated in this example)
+    S->fmi3Functions->fmi3GetClock(S->component, vrOutClock, 1, &outClock);
+    S->fmi3Functions->fmi3GetIntervalDecimal(S->component, vrCountdownClock, 1, &interval, &qualifier);
+}
+
+static fmi3Status activatePartition1(Latency* latency) {
+
+    const double start = wallClockTime();
+
+    const fmi3Status status = S->fmi3Functions->fmi3ActivateModelPartition(S->component, vr_inClock1, 0);
+
+    const double duration = wallClockTime() - start;
+
+    latency->n++;
+    latency->sum += duration;
+
+    if (duration > latency->max) {
+        latency->max = duration;
+    }
+
+    return status;
+}
+
+static bool isPartition3Finished(void) {
+
+    FMILockMutex(&mutex);
+    const bool finished = partition3Finished;
+    FMIUnlockMutex(&mutex);
+
+    return finished;
+}
+
+static void runPartition(void* arg, size_t index) {
+
+    if (index == 0) {
+
+        // busy for a while
+        status3 = S->fmi3Functions->fmi3ActivateModelPartition(S->component, vr_inClock3, 0);
+
+        FMILockMutex(&mutex);
+        partition3Finished = true;
+        FMIUnlockMutex(&mutex);
+
+    } else {
+
+        // activate Model Partition 1 until Model Partition 3 has finished
+        do {
+            status1 = activatePartition1(&latencyWithLoad);
+        } while (status1 == fmi3OK && !isPartition3Finished());
+    }
+}
+
+static void printLatency(const char* label, const Latency* latency) {
+    printf("Latency of Model Partition 1 %s: mean = %.3g us, max = %.3g us (%zu activations)\n",
+        label, 1e6 * latency->sum / latency->n, 1e6 * latency->max, latency->n);
+}
+
+int main(int argc, char* argv[]) {
+
+    FMIThreadPool* pool = NULL;
+
+    FMIInitMutex(&mutex);
+
+    // function calls are not logged because the log buffer of the instance is shared by all threads
+    S = FMICreateInstance("instance1", logMessage, NULL);
+
+    if (!S) {
+        printf("Failed to create FMU instance.\n");
+        return EXIT_FAILURE;
+    }
+
+    CALL(FMILoadPlatformBinary(S, PLATFORM_BINARY));
+
+    CALL(FMI3InstantiateScheduledExecution(S,
+        INSTANTIATION_TOKEN,   // instantiationToken
+        NULL,                  // resourceLocation
+        fmi3False,             // visible
+        fmi3False,             // loggingOn
+        NULL,                  // requiredIntermediateVariables
+        0,                     // nRequiredIntermediateVariables
+        cb_clockUpdate,        // clockUpdate
+        NULL,                  // lockPreemption
+        NULL                   // unlockPreemption
+    ));
+
+    CALL(FMI3EnterInitializationMode(S, fmi3False, 0, 0, fmi3False, 0));
+    CALL(FMI3ExitInitializationMode(S));
+
+    for (size_t i = 0; i < N_ACTIVATIONS; i++) {
+        CALL(activatePartition1(&latencyWithoutLoad));
+    }
+
+    pool = FMICreateThreadPool(2);
+
+    if (!pool) {
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    // run Model Partition 3 and Model Partition 1 in parallel
+    FMIRunTasks(pool, runPartition, NULL, 2);
+
+    CALL(status1);
+    CALL(status3);
+
+    printLatency("without load", &latencyWithoutLoad);
+    printLatency("while Model Partition 3 is busy", &latencyWithLoad);
+
+    CALL(printClockStatistics(S));
+
+    // check that no increment of the shared counter has been lost
+    const fmi3ValueReference valueReferences[4] = { vr_inClock1Ticks, vr_inClock2Ticks, vr_inClock3Ticks, vr_totalInClockTicks };
+    fmi3Int32 values[4];
+
+    CALL(FMI3GetInt32(S, valueReferences, 4, values, 4));
+
+    if (values[0] + values[1] + values[2] != values[3]) {
+        printf("Expected totalInClockTicks = %d but was %d.\n", values[0] + values[1] + values[2], values[3]);
+        status = FMIError;
+    }
+
+TERMINATE:
+    FMIFreeThreadPool(pool);
+
+    FMIDestroyMutex(&mutex);
+
+    return tearDown();
+}
@@ -2,19 +2,19 @@
 #define LOG_FILE     "scs_synchronous_log.txt"
 
 #include "util.h"
+#include "FMIClockScheduler.h"
 
 
-fmi3Float64 countdownClockIntervals[1] = { 0.0 };
-fmi3IntervalQualifier countdownClocksQualifier[1] = { fmi3IntervalNotYetKnown };
-fmi3ValueReference vr_countdownClocks[1] = { vr_inClock3 };
-fmi3ValueReference outClockVRs[1] = { vr_outClock };
-fmi3Clock outClockValues[2];
+static FMIClockScheduler* scheduler = NULL;
 
 
 static void cb_clockUpdate(fmi3InstanceEnvironment instanceEnvironment) {
-    countdownClockIntervals[0] = 0.0;
-    countdownClocksQualifier[0] = fmi3IntervalNotYetKnown;
-    FMI3GetIntervalDecimal(S, vr_countdownClocks, 1, countdownClockIntervals, countdownClocksQualifier);
+    // schedule the countdown clocks and read the output clocks
+    FMIClockSchedulerClockUpdate(scheduler);
+}
+
+static void cb_outputClockTicked(FMIClockScheduler* clockScheduler, FMIValueReference valueReference, double time, void* userData) {
+    printf("Output clock %u ticked at t=%g.\n", valueReference, time);
 }
 
 
@@ -34,37 +34,49 @@ int main(int argc, char* argv[]) {
         NULL                   // unlockPreemption
     ));
 
-    //environment.S = S;
-    //environment.s = s;
+    // the clocks and their priorities from the modelDescription.xml
+    scheduler = FMICreateClockScheduler(S, 1, cb_outputClockTicked, NULL);
 
-    CALL(FMI3EnterInitializationMode(S, fmi3False, 0, 0, fmi3False, 0));
-    CALL(FMI3ExitInitializationMode(S));
+    if (!scheduler) {
+        status = FMIError;
+        goto TERMINATE;
+    }
 
-    int time = 0;
+    // Model Partition 1 is active every second
+    CALL(FMIAddClock(scheduler, vr_inClock1, FMIPeriodicClock, 0, 1, 0, false));
 
-    // simulation loop
-    while (time < 10) {
+    // Model Partition 2 is triggered by the importer
+    CALL(FMIAddClock(scheduler, vr_inClock2, FMITriggeredClock, 1, 0, 0, false));
 
-        // Model Partition 1 is active every second
-        CALL(FMI3ActivateModelPartition(S, vr_inClock1, time));
+    // Model Partition 3 is scheduled by Model Partition 1
+    CALL(FMIAddClock(scheduler, vr_inClock3, FMICountdownClock, 2, 0, 0, false));
 
-        // Model Partition 2 is active at 0, 1, 8, and 9
-        if (time % 8 == 0 || (time - 1) % 8 == 0) {
-            CALL(FMI3ActivateModelPartition(S, vr_inClock2, time));
-        }
+    CALL(FMIAddClock(scheduler, vr_outClock, FMIOutputClock, 0, 0, 0, false));
 
-        if (countdownClocksQualifier[0] == fmi3IntervalChanged) {
-            CALL(FMI3ActivateModelPartition(S, vr_inClock3, time));
-            countdownClocksQualifier[0] = fmi3IntervalUnchanged;
-        }
+    CALL(FMI3EnterInitializationMode(S, fmi3False, 0, 0, fmi3False, 0));
+    CALL(FMI3ExitInitializationMode(S));
 
-        CALL(FMI3GetClock(S, outClockVRs, 1, outClockValues));
+    CALL(FMIStartClockScheduler(scheduler, 0));
 
-        CALL(recordVariables(S, time, outputFile));
+    // Model Partition 2 is active at 0, 1, 8, and 9
+    CALL(FMITriggerClock(scheduler, vr_inClock2, 0));
+    CALL(FMITriggerClock(scheduler, vr_inClock2, 1));
+    CALL(FMITriggerClock(scheduler, vr_inClock2, 8));
+    CALL(FMITriggerClock(scheduler, vr_inClock2, 9));
+
+    // simulation loop
+    for (int time = 0; time < 10; time++) {
+
+        // activate the model partitions of all clocks that tick at time
+        CALL(FMIAdvanceClockScheduler(scheduler, time));
 
-        time++;
+        CALL(recordVariables(S, time, outputFile));
     }
 
+    CALL(printClockStatistics(S));
+
 TERMINATE:
+    FMIFreeClockScheduler(scheduler);
+
     return tearDown();
 }
@@ -0,0 +1,402 @@
+/* This example runs the model partitions of the Clocks model in threads with the priorities of their clocks.
+   If permitted, the threads are scheduled with SCHED_FIFO, otherwise the priorities are mapped to nice levels.
+   All threads are pinned to the CPU of the main thread, so the partitions preempt each other as they would
+   on a single core real-time target. */
+
+#define _GNU_SOURCE // for pthread_setaffinity_np() and CPU_SET()
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
+
+#define OUTPUT_FILE  "scs_threaded_out.csv"
+
+#include "util.h"
+
+
+#define STOP_TIME 10
+
+// maximum number of partition threads that can be active at the same time
+#define MAX_THREADS 16
+
+typedef struct {
+    fmi3ValueReference clockReference;
+    fmi3Float64 activationTime;
+    fmi3Int32 priority;
+    FMIStatus status;
+    double requestTime;
+} PartitionArgs;
+
+// activation statistics of a clock measured by the importer
+typedef struct {
+    size_t nActivations;
+    double totalLatency;
+    double maxLatency;
+    double totalExecutionTime;
+    double maxExecutionTime;
+} ActivationStatistics;
+
+// the priorities of inClock1, inClock2 and inClock3 from the modelDescription.xml (lower value means higher priority)
+static const fmi3Int32 clockPriorities[N_INPUT_CLOCKS] = { 0, 1, 2 };
+
+static const fmi3ValueReference vrCountdownClocks[1] = { vr_inClock3 };
+static const fmi3ValueReference vrOutputClocks[1] = { vr_outClock };
+
+static const fmi3ValueReference vrInputs2[1] = { vr_input2 };
+static const fmi3ValueReference vrOutputs3[1] = { vr_output3 };
+
+// the output of partition 3 is the input of partition 2
+static fmi3Int32 input2 = 0;
+
+static fmi3Float64 currentTime = 0;
+
+// protects the critical sections of the model (with priority inheritance, so a lower priority holder is boosted)
+static pthread_mutex_t preemptionLock;
+
+// the running partition threads
+static pthread_mutex_t threadsLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t threads[MAX_THREADS];
+static PartitionArgs threadArgs[MAX_THREADS];
+static size_t nThreads = 0;
+
+static bool realTimeScheduling = true;
+
+// protected by threadsLock
+static ActivationStatistics activationStatistics[N_INPUT_CLOCKS];
+
+#ifdef __linux__
+static cpu_set_t cpuSet;
+#endif
+
+
+static void cb_lockPreemption(void) {
+    pthread_mutex_lock(&preemptionLock);
+}
+
+static void cb_unlockPreemption(void) {
+    pthread_mutex_unlock(&preemptionLock);
+}
+
+/* record the latency from the request to the start of the thread and the execution time of the partition */
+static void recordActivation(const PartitionArgs* args, double startTime, double endTime) {
+
+    const double latency = startTime - args->requestTime;
+    const double executionTime = endTime - startTime;
+
+    pthread_mutex_lock(&threadsLock);
+
+    ActivationStatistics* statistics = &activationStatistics[args->clockReference - vr_inClock1];
+
+    statistics->nActivations++;
+    statistics->totalLatency += latency;
+    statistics->totalExecutionTime += executionTime;
+
+    if (latency > statistics->maxLatency) {
+        statistics->maxLatency = latency;
+    }
+
+    if (executionTime > statistics->maxExecutionTime) {
+        statistics->maxExecutionTime = executionTime;
+    }
+
+    pthread_mutex_unlock(&threadsLock);
+}
+
+static void printActivationStatistics(void) {
+
+    for (size_t i = 0; i < N_INPUT_CLOCKS; i++) {
+
+        const ActivationStatistics* statistics = &activationStatistics[i];
+
+        if (statistics->nActivations == 0) {
+            continue;
+        }
+
+        printf("Importer: Model Partition %zu: %zu activations, mean latency = %.3g us, max latency = %.3g us, "
+            "mean execution time = %.3g us, max execution time = %.3g us\n",
+            i + 1,
+            statistics->nActivations,
+            1e6 * statistics->totalLatency / statistics->nActivations,
+            1e6 * statistics->maxLatency,
+            1e6 * statistics->totalExecutionTime / statistics->nActivations,
+            1e6 * statistics->maxExecutionTime);
+    }
+}
+
+static void* activateModelPartition(void* data) {
+
+    PartitionArgs* args = (PartitionArgs*)data;
+
+    const double startTime = wallClockTime();
+
+#ifdef __linux__
+    if (!realTimeScheduling) {
+        // nice levels apply to the calling thread on Linux
+        setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), 5 * args->priority);
+    }
+#endif
+
+    FMIStatus status = FMIOK;
+
+    switch (args->clockReference) {
+
+    case vr_inClock2:
+        cb_lockPreemption();
+        status = FMI3SetInt32(S, vrInputs2, 1, &input2, 1);
+        input2 = 0;
+        cb_unlockPreemption();
+        if (status == FMIOK) {
+            status = FMI3ActivateModelPartition(S, args->clockReference, args->activationTime);
+        }
+        break;
+
+    case vr_inClock3:
+        status = FMI3ActivateModelPartition(S, args->clockReference, args->activationTime);
+        if (status == FMIOK) {
+            cb_lockPreemption();
+            status = FMI3GetInt32(S, vrOutputs3, 1, &input2, 1);
+            cb_unlockPreemption();
+        }
+        break;
+
+    default:
+        status = FMI3ActivateModelPartition(S, args->clockReference, args->activationTime);
+        break;
+    }
+
+    const double endTime = wallClockTime();
+
+    args->status = status;
+
+    recordActivation(args, startTime, endTime);
+
+    return NULL;
+}
+
+static int createThread(pthread_t* thread, PartitionArgs* args) {
+
+    pthread_attr_t attr;
+    int error;
+
+    pthread_attr_init(&attr);
+
+#ifdef __linux__
+    pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &cpuSet);
+#endif
+
+    if (realTimeScheduling) {
+
+        struct sched_param param = { 0 };
+
+        param.sched_priority = sched_get_priority_max(SCHED_FIFO) - args->priority;
+
+        pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+        pthread_attr_setschedparam(&attr, &param);
+
+        error = pthread_create(thread, &attr, activateModelPartition, args);
+
+        if (error != EPERM) {
+            goto END;
+        }
+
+        printf("SCHED_FIFO is not permitted. Falling back to nice levels.\n");
+
+        realTimeScheduling = false;
+
+        // use the scheduling policy of the main thread
+        pthread_attr_setinheritsched(&attr, PTHREAD_INHERIT_SCHED);
+    }
+
+    error = pthread_create(thread, &attr, activateModelPartition, args);
+
+END:
+    pthread_attr_destroy(&attr);
+
+    return error;
+}
+
+static FMIStatus startPartition(fmi3ValueReference clockReference, fmi3Float64 activationTime) {
+
+    FMIStatus status = FMIOK;
+
+    pthread_mutex_lock(&threadsLock);
+
+    if (nThreads == MAX_THREADS) {
+        printf("Too many active partitions.\n");
+        status = FMIFatal;
+        goto END;
+    }
+
+    PartitionArgs* args = &threadArgs[nThreads];
+
+    args->clockReference = clockReference;
+    args->activationTime = activationTime;
+    args->priority       = clockPriorities[clockReference - vr_inClock1];
+    args->status         = FMIOK;
+    args->requestTime    = wallClockTime();
+
+    if (createThread(&threads[nThreads], args)) {
+        printf("Failed to create the thread for clock %u.\n", clockReference);
+        status = FMIFatal;
+        goto END;
+    }
+
+    nThreads++;
+
+END:
+    pthread_mutex_unlock(&threadsLock);
+
+    return status;
+}
+
+/* wait for all partitions including the ones that have been started by other partitions */
+static FMIStatus joinPartitions(void) {
+
+    FMIStatus status = FMIOK;
+
+    pthread_mutex_lock(&threadsLock);
+
+    for (size_t i = 0; i < nThreads; i++) {
+
+        const pthread_t thread = threads[i];
+
+        pthread_mutex_unlock(&threadsLock);
+        pthread_join(thread, NULL);
+        pthread_mutex_lock(&threadsLock);
+
+        if (threadArgs[i].status > status) {
+            status = threadArgs[i].status;
+        }
+    }
+
+    nThreads = 0;
+
+    pthread_mutex_unlock(&threadsLock);
+
+    return status;
+}
+
+static void cb_clockUpdate(fmi3InstanceEnvironment instanceEnvironment) {
+
+    fmi3Float64 interval = 0;
+    fmi3IntervalQualifier qualifier = fmi3IntervalNotYetKnown;
+    fmi3Clock outClock = fmi3ClockInactive;
+
+    // reading the clocks resets them
+    cb_lockPreemption();
+    FMI3GetIntervalDecimal(S, vrCountdownClocks, 1, &interval, &qualifier);
+    FMI3GetClock(S, vrOutputClocks, 1, &outClock);
+    cb_unlockPreemption();
+
+    if (qualifier == fmi3IntervalChanged) {
+        startPartition(vr_inClock3, currentTime + interval);
+    }
+
+    if (outClock) {
+        printf("Output clock ticked at t=%g.\n", currentTime);
+    }
+}
+
+static int initializePreemptionLock(void) {
+
+    pthread_mutexattr_t attr;
+
+    pthread_mutexattr_init(&attr);
+
+    // the FMU locks the preemption from within the calls that the importer makes while holding the lock
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+
+#if defined(_POSIX_THREAD_PRIO_INHERIT) && _POSIX_THREAD_PRIO_INHERIT > 0
+    pthread_mutexattr_setprotocol(&attr, PTHREAD_PRIO_INHERIT);
+#endif
+
+    const int error = pthread_mutex_init(&preemptionLock, &attr);
+
+    pthread_mutexattr_destroy(&attr);
+
+    return error;
+}
+
+int main(int argc, char* argv[]) {
+
+    if (initializePreemptionLock()) {
+        printf("Failed to initialize the preemption lock.\n");
+        return EXIT_FAILURE;
+    }
+
+#ifdef __linux__
+    // run all partitions on the current CPU
+    CPU_ZERO(&cpuSet);
+    CPU_SET(sched_getcpu(), &cpuSet);
+#endif
+
+    // function calls are not logged because the log buffer of the instance is shared by all threads
+    outputFile = createOutputFile(OUTPUT_FILE);
+
+    if (!outputFile) {
+        printf("Failed to open %s.\n", OUTPUT_FILE);
+        return EXIT_FAILURE;
+    }
+
+    S = FMICreateInstance("instance1", logMessage, NULL);
+
+    if (!S) {
+        printf("Failed to create FMU instance.\n");
+        return EXIT_FAILURE;
+    }
+
+    CALL(FMILoadPlatformBinary(S, PLATFORM_BINARY));
+
+    CALL(FMI3InstantiateScheduledExecution(S,
+        INSTANTIATION_TOKEN,   // instantiationToken
+        NULL,                  // resourceLocation
+        fmi3False,             // visible
+        fmi3False,             // loggingOn
+        NULL,                  // requiredIntermediateVariables
+        0,                     // nRequiredIntermediateVariables
+        cb_clockUpdate,        // clockUpdate
+        cb_lockPreemption,     // lockPreemption
+        cb_unlockPreemption    // unlockPreemption
+    ));
+
+    CALL(FMI3EnterInitializationMode(S, fmi3False, 0, 0, fmi3False, 0));
+    CALL(FMI3ExitInitializationMode(S));
+
+    for (int tick = 0; tick < STOP_TIME; tick++) {
+
+        currentTime = tick;
+
+        // start the partitions in the order of their priority
+
+        // Model Partition 1 is active every second
+        CALL(startPartition(vr_inClock1, currentTime));
+
+        // Model Partition 2 is active at 0, 1, 8, and 9
+        if (tick % 8 == 0 || (tick - 1) % 8 == 0) {
+            CALL(startPartition(vr_inClock2, currentTime));
+        }
+
+        CALL(joinPartitions());
+
+        CALL(recordVariables(S, currentTime, outputFile));
+    }
+
+    printActivationStatistics();
+
+    CALL(printClockStatistics(S));
+
+TERMINATE:
+    joinPartitions();
+
+    printf("Finished with %s scheduling.\n", realTimeScheduling ? "SCHED_FIFO" : "nice level");
+
+    return tearDown();
+}
@@ -132,6 +132,13 @@ FMIStatus applyDiscreteInputs(FMIInstance *S, double time);
 
 FMIStatus recordVariables(FMIInstance *S, double time, FILE *outputFile);
 
+#if FMI_VERSION == 3
+// monotonic wall clock time in seconds and the activation statistics of the input clocks (Clocks examples)
+double wallClockTime(void);
+
+FMIStatus printClockStatistics(FMIInstance *S);
+#endif
+
 static void logMessage(FMIInstance *instance, FMIStatus status, const char *category, const char *message) {
 
         switch (status) {
@@ -0,0 +1,596 @@
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FMIUtil.h"
+#include "FMIRootFinder.h"
+#include "FMIBDF.h"
+
+
+#define CALL(f) do { status = f; if (status > FMIWarning) return status; } while (0)
+
+// relative tolerance if the FMU does not define one
+#define DEFAULT_TOLERANCE 1e-6
+
+// maximum number of Newton iterations per step
+#define MAX_NEWTON_ITERATIONS 4
+
+struct FMISolverImpl {
+
+    FMISolverParameters p;
+
+    double tolerance;
+
+    // the last accepted step from previousTime to time and the proposed size of the next step
+    double previousTime;
+    double time;
+    double h;
+
+    // the continuous states and their derivatives at time and previousTime
+    double* x;
+    double* f;
+    double* x1;
+    double* f1;
+
+    // predictor, corrector, Newton update and derivatives at the corrector
+    double* xp;
+    double* xc;
+    double* dx;
+    double* fc;
+    double* psi;
+
+    double* nominals;
+
+    // the Jacobian of the derivatives (row major), the Newton matrix I - beta * J and the pivots
+    double* J;
+    double* M;
+    size_t* pivots;
+
+    // value references for the directional derivatives (NULL if finite differences are used)
+    FMIValueReference* stateValueReferences;
+    FMIValueReference* derivativeValueReferences;
+    double* seed;
+
+    // the event indicators at time, before the change of sign and at the trial points of the root finder
+    double* z;
+    double* prez;
+    double* zt;
+
+    // x1 and f1 are valid and the next step uses the second order formula
+    bool history;
+
+    // f holds the derivatives at time
+    bool derivativesValid;
+
+    // J has been calculated since the last reset
+    bool jacobianValid;
+
+    // the FMU is at time and x
+    bool instanceAtTime;
+
+    // an event indicator has changed its sign at eventTime in the last step
+    bool stateEvent;
+    double eventTime;
+
+};
+
+static void freeSolver(FMISolver* solver) {
+
+    if (!solver) {
+        return;
+    }
+
+    free(solver->x);
+    free(solver->f);
+    free(solver->x1);
+    free(solver->f1);
+    free(solver->xp);
+    free(solver->xc);
+    free(solver->dx);
+    free(solver->fc);
+    free(solver->psi);
+    free(solver->nominals);
+    free(solver->J);
+    free(solver->M);
+    free(solver->pivots);
+    free(solver->stateValueReferences);
+    free(solver->derivativeValueReferences);
+    free(solver->seed);
+    free(solver->z);
+    free(solver->prez);
+    free(solver->zt);
+    free(solver);
+}
+
+/* use the directional derivatives if the FMU provides them for all (scalar) states */
+static FMIStatus initializeDirectionalDerivatives(FMISolver* solver) {
+
+    const FMISolverParameters* p = &solver->p;
+    const FMIModelDescription* modelDescription = p->modelDescription;
+
+    if (!p->getDirectionalDerivative || !modelDescription || !modelDescription->modelExchange ||
+        !modelDescription->modelExchange->providesDirectionalDerivatives || modelDescription->nDerivatives != p->nx) {
+        return FMIOK;
+    }
+
+    for (size_t i = 0; i < modelDescription->nDerivatives; i++) {
+
+        const FMIModelVariable* derivative = modelDescription->derivatives[i].modelVariable;
+
+        if (derivative->nDimensions > 0 || !derivative->derivative) {
+            return FMIOK;
+        }
+    }
+
+    if (FMICalloc((void**)&solver->stateValueReferences, p->nx, sizeof(FMIValueReference)) != FMIOK ||
+        FMICalloc((void**)&solver->derivativeValueReferences, p->nx, sizeof(FMIValueReference)) != FMIOK) {
+        return FMIError;
+    }
+
+    for (size_t i = 0; i < p->nx; i++) {
+        const FMIModelVariable* derivative = modelDescription->derivatives[i].modelVariable;
+        solver->derivativeValueReferences[i] = derivative->valueReference;
+        solver->stateValueReferences[i] = derivative->derivative->valueReference;
+    }
+
+    return FMIOK;
+}
+
+FMISolver* FMIBDFCreate(const FMISolverParameters* parameters) {
+
+    FMISolver* solver = NULL;
+
+    if (FMICalloc((void**)&solver, 1, sizeof(FMISolver)) != FMIOK) {
+        return NULL;
+    }
+
+    solver->p = *parameters;
+    solver->tolerance = parameters->tolerance > 0 ? parameters->tolerance : DEFAULT_TOLERANCE;
+
+    const size_t nx = parameters->nx;
+    const size_t nz = parameters->nz;
+
+    if (FMICalloc((void**)&solver->x, nx + 1, sizeof(double)) != FMIOK ||
+        FMICalloc((void**)&solver->f, nx + 1, sizeof(double)) != FMIOK ||
+        FMICalloc((void**)&solver->x1, nx + 1, sizeof(double)) != FMIOK ||
+        FMICalloc((void**)&solver->f1, nx + 1, sizeof(double)) != FMIOK ||
+        FMICalloc((void**)&solver->xp, nx + 1, sizeof(double)) != FMIOK ||
+        FMICalloc((void**)&solver->xc, nx + 1, sizeof(double)) != FMIOK ||
+        FMICalloc((void**)&solver->dx, nx + 1, sizeof(double)) != FMIOK ||
+        FMICalloc((void**)&solver->fc, nx + 1, sizeof(double)) != FMIOK ||
+        FMICalloc((void**)&solver->psi, nx + 1, sizeof(double)) != FMIOK ||
+        FMICalloc((void**)&solver->nominals, nx + 1, sizeof(double)) != FMIOK ||
+        FMICalloc((void**)&solver->J, nx * nx + 1, sizeof(double)) != FMIOK ||
+        FMICalloc((void**)&solver->M, nx * nx + 1, sizeof(double)) != FMIOK ||
+        FMICalloc((void**)&solver->pivots, nx + 1, sizeof(size_t)) != FMIOK ||
+        FMICalloc((void**)&solver->seed, nx + 1, sizeof(double)) != FMIOK ||
+        FMICalloc((void**)&solver->z, nz + 1, sizeof(double)) != FMIOK ||
+        FMICalloc((void**)&solver->prez, nz + 1, sizeof(double)) != FMIOK ||
+        FMICalloc((void**)&solver->zt, nz + 1, sizeof(double)) != FMIOK ||
+        initializeDirectionalDerivatives(solver) != FMIOK ||
+        FMIBDFReset(solver, parameters->startTime) > FMIWarning) {
+        freeSolver(solver);
+        return NULL;
+    }
+
+    return solver;
+}
+
+void FMIBDFFree(FMISolver* solver) {
+    freeSolver(solver);
+}
+
+/* set the time, continuous inputs and states */
+static FMIStatus setStates(FMISolver* solver, double time, const double x[]) {
+
+    FMIStatus status = FMIOK;
+
+    const FMISolverParameters* p = &solver->p;
+
+    CALL(p->setTime(p->instance, time));
+    CALL(p->applyInput(p->instance, p->input, time, false, true, false));
+
+    if (p->nx > 0) {
+        CALL(p->setContinuousStates(p->instance, x, p->nx));
+    }
+
+    return status;
+}
+
+static FMIStatus evaluate(FMISolver* solver, double time, const double x[], double dx[]) {
+
+    FMIStatus status = FMIOK;
+
+    const FMISolverParameters* p = &solver->p;
+
+    CALL(setStates(solver, time, x));
+
+    solver->instanceAtTime = false;
+
+    return p->getContinuousStateDerivatives(p->instance, dx, p->nx);
+}
+
+/* the weighted RMS norm of v with the absolute tolerances scaled by the nominals */
+static double norm(const FMISolver* solver, const double v[], const double x0[], const double x1[]) {
+
+    const size_t nx = solver->p.nx;
+
+    double sum = 0;
+
+    for (size_t i = 0; i < nx; i++) {
+        const double scale = solver->tolerance * solver->nominals[i] + solver->tolerance * fmax(fabs(x0[i]), fabs(x1[i]));
+        sum += (v[i] / scale) * (v[i] / scale);
+    }
+
+    return sqrt(sum / (double)nx);
+}
+
+/* get the event indicators and detect a change of sign since the last accepted step */
+static FMIStatus detectStateEvent(FMISolver* solver, bool* stateEvent) {
+
+    FMIStatus status = FMIOK;
+
+    const FMISolverParameters* p = &solver->p;
+
+    *stateEvent = false;
+
+    if (p->nz == 0) {
+        return FMIOK;
+    }
+
+    CALL(p->getEventIndicators(p->instance, solver->z, p->nz));
+
+    for (size_t i = 0; i < p->nz; i++) {
+        if ((solver->prez[i] <= 0 && solver->z[i] > 0) || (solver->prez[i] > 0 && solver->z[i] <= 0)) {
+            *stateEvent = true;
+        }
+    }
+
+    // keep the event indicators before the change of sign
+    if (!*stateEvent) {
+        memcpy(solver->prez, solver->z, p->nz * sizeof(double));
+    }
+
+    return status;
+}
+
+/* set the FMU to the states at time (interpolated with a cubic Hermite polynomial if time is before the end of the last step) */
+static FMIStatus moveTo(FMISolver* solver, double time) {
+
+    const size_t nx = solver->p.nx;
+
+    if (time == solver->time) {
+
+        if (solver->instanceAtTime) {
+            return FMIOK;
+        }
+
+        solver->instanceAtTime = true;
+
+        return setStates(solver, time, solver->x);
+    }
+
+    const double H = solver->time - solver->previousTime;
+    const double theta = (time - solver->previousTime) / H;
+    const double theta2 = theta * theta;
+    const double theta3 = theta2 * theta;
+
+    const double h00 = 2 * theta3 - 3 * theta2 + 1;
+    const double h10 = theta3 - 2 * theta2 + theta;
+    const double h01 = -2 * theta3 + 3 * theta2;
+    const double h11 = theta3 - theta2;
+
+    for (size_t j = 0; j < nx; j++) {
+        solver->xp[j] = h00 * solver->x1[j] + h10 * H * solver->f1[j] + h01 * solver->x[j] + h11 * H * solver->f[j];
+    }
+
+    solver->instanceAtTime = false;
+
+    return setStates(solver, time, solver->xp);
+}
+
+/* calculate the Jacobian of the derivatives at time with directional derivatives or finite differences */
+static FMIStatus updateJacobian(FMISolver* solver) {
+
+    FMIStatus status = FMIOK;
+
+    const FMISolverParameters* p = &solver->p;
+    const size_t nx = p->nx;
+
+    for (size_t j = 0; j < nx; j++) {
+
+        double* column = solver->fc;
+
+        if (solver->stateValueReferences) {
+
+            CALL(moveTo(solver, solver->time));
+
+            memset(solver->seed, 0, nx * sizeof(double));
+
+            solver->seed[j] = 1;
+
+            CALL(p->getDirectionalDerivative(p->instance, solver->derivativeValueReferences, nx, solver->stateValueReferences, nx, solver->seed, column));
+
+        } else {
+
+            const double delta = sqrt(DBL_EPSILON) * fmax(fabs(solver->x[j]), solver->nominals[j]);
+
+            memcpy(solver->xc, solver->x, nx * sizeof(double));
+
+            solver->xc[j] += delta;
+
+            CALL(evaluate(solver, solver->time, solver->xc, column));
+
+            for (size_t i = 0; i < nx; i++) {
+                column[i] = (column[i] - solver->f[i]) / delta;
+            }
+        }
+
+        for (size_t i = 0; i < nx; i++) {
+            solver->J[i * nx + j] = column[i];
+        }
+    }
+
+    solver->jacobianValid = true;
+
+    return status;
+}
+
+/* initial step size estimate h = 0.01 * ||x|| / ||dx|| */
+static double initialStepSize(const FMISolver* solver) {
+
+    const double d0 = norm(solver, solver->x, solver->x, solver->x);
+    const double d1 = norm(solver, solver->f, solver->x, solver->x);
+
+    return (d0 < 1e-5 || d1 < 1e-5) ? 1e-6 : 0.01 * d0 / d1;
+}
+
+/* take one accepted step that does not go beyond maxTime */
+static FMIStatus doStep(FMISolver* solver, double maxTime) {
+
+    FMIStatus status = FMIOK;
+
+    const size_t nx = solver->p.nx;
+
+    if (!solver->derivativesValid) {
+
+        CALL(evaluate(solver, solver->time, solver->x, solver->f));
+
+        solver->instanceAtTime = true;
+        solver->derivativesValid = true;
+
+        if (solver->h <= 0) {
+            solver->h = initialStepSize(solver);
+        }
+    }
+
+    for (;;) {
+
+        const bool lastStep = solver->time + solver->h >= maxTime;
+        const double h = lastStep ? maxTime - solver->time : solver->h;
+        const double nextTime = lastStep ? maxTime : solver->time + h;
+
+        const int order = solver->history ? 2 : 1;
+
+        double beta;
+
+        if (order == 2) {
+
+            // variable step size BDF2: x - beta * f(x) = psi
+            const double hPrevious = solver->time - solver->previousTime;
+            const double omega = h / hPrevious;
+            const double a1 = (1 + omega) * (1 + omega) / (1 + 2 * omega);
+            const double a2 = omega * omega / (1 + 2 * omega);
+
+            beta = h * (1 + omega) / (1 + 2 * omega);
+
+            for (size_t i = 0; i < nx; i++) {
+
+                solver->psi[i] = a1 * solver->x[i] - a2 * solver->x1[i];
+
+                // quadratic predictor through x1, x and f
+                const double c2 = (solver->x1[i] - solver->x[i] + solver->f[i] * hPrevious) / (hPrevious * hPrevious);
+
+                solver->xp[i] = solver->x[i] + h * solver->f[i] + c2 * h * h;
+            }
+
+        } else {
+
+            // implicit Euler
+            beta = h;
+
+            for (size_t i = 0; i < nx; i++) {
+                solver->psi[i] = solver->x[i];
+                solver->xp[i] = solver->x[i] + h * solver->f[i];
+            }
+        }
+
+        bool newJacobian = false;
+
+        if (!solver->jacobianValid) {
+            CALL(updateJacobian(solver));
+            newJacobian = true;
+        }
+
+        for (size_t i = 0; i < nx; i++) {
+            for (size_t j = 0; j < nx; j++) {
+                solver->M[i * nx + j] = (i == j ? 1 : 0) - beta * solver->J[i * nx + j];
+            }
+        }
+
+        bool converged = FMILUFactorize(nx, solver->M, solver->pivots);
+
+        // simplified Newton iteration
+        if (converged) {
+
+            converged = false;
+
+            memcpy(solver->xc, solver->xp, nx * sizeof(double));
+
+            for (size_t k = 0; k < MAX_NEWTON_ITERATIONS && !converged; k++) {
+
+                CALL(evaluate(solver, nextTime, solver->xc, solver->fc));
+
+                for (size_t i = 0; i < nx; i++) {
+                    solver->dx[i] = solver->psi[i] + beta * solver->fc[i] - solver->xc[i];
+                }
+
+                FMILUSolve(nx, solver->M, solver->pivots, solver->dx);
+
+                for (size_t i = 0; i < nx; i++) {
+                    solver->xc[i] += solver->dx[i];
+                }
+
+                converged = norm(solver, solver->dx, solver->x, solver->xc) <= 0.01;
+            }
+        }
+
+        if (!converged) {
+
+            if (!newJacobian) {
+                // retry with a new Jacobian
+                solver->jacobianValid = false;
+                continue;
+            }
+
+            solver->h = 0.25 * h;
+
+            if (solver->h < 1e-14 * fmax(1, fabs(solver->time))) {
+                FMILogError("The Newton iteration did not converge at t=%g.", solver->time);
+                return FMIError;
+            }
+
+            continue;
+        }
+
+        // the local error estimated from the difference between corrector and predictor
+        const double errorConstant = order == 2 ? 0.4 : 0.5;
+
+        for (size_t i = 0; i < nx; i++) {
+            solver->dx[i] = errorConstant * (solver->xc[i] - solver->xp[i]);
+        }
+
+        const double err = norm(solver, solver->dx, solver->x, solver->xc);
+
+        // limit the ratio of consecutive steps to keep BDF2 zero-stable
+        const double factor = err > 0 ? fmin(2, fmax(0.2, 0.9 * pow(err, -1.0 / (order + 1)))) : 2;
+
+        if (err > 1) {
+
+            solver->h = h * factor;
+
+            if (solver->h < 1e-14 * fmax(1, fabs(solver->time))) {
+                FMILogError("The step size became too small at t=%g.", solver->time);
+                return FMIError;
+            }
+
+            continue;
+        }
+
+        // accept the step and calculate the derivatives from the BDF formula
+        double* x1 = solver->x1;
+        double* f1 = solver->f1;
+
+        solver->x1 = solver->x;
+        solver->f1 = solver->f;
+        solver->x = x1;
+        solver->f = f1;
+
+        for (size_t i = 0; i < nx; i++) {
+            solver->x[i] = solver->xc[i];
+            solver->f[i] = (solver->xc[i] - solver->psi[i]) / beta;
+        }
+
+        solver->previousTime = solver->time;
+        solver->time = nextTime;
+        solver->history = true;
+        solver->instanceAtTime = false;
+
+        // don't reduce the step size after a step that has been shortened to reach maxTime
+        solver->h = lastStep ? fmax(solver->h, h * factor) : h * factor;
+
+        if (solver->p.nz == 0) {
+            return FMIOK;
+        }
+
+        CALL(moveTo(solver, solver->time));
+        CALL(detectStateEvent(solver, &solver->stateEvent));
+
+        if (solver->stateEvent) {
+            CALL(FMIFindRoot(solver, &solver->p, moveTo, solver->previousTime, solver->prez, solver->time, solver->z, solver->zt, &solver->eventTime));
+        }
+
+        return status;
+    }
+}
+
+FMIStatus FMIBDFStep(FMISolver* solver, double nextTime, double maxTime, double* timeReached, bool* stateEvent) {
+
+    FMIStatus status = FMIOK;
+
+    const FMISolverParameters* p = &solver->p;
+
+    *stateEvent = false;
+
+    if (p->nx == 0) {
+
+        // nothing to integrate
+        solver->previousTime = solver->time;
+        solver->time = nextTime;
+
+        CALL(setStates(solver, nextTime, NULL));
+        CALL(detectStateEvent(solver, stateEvent));
+
+        if (*stateEvent) {
+            CALL(FMIFindRoot(solver, p, moveTo, solver->previousTime, solver->prez, solver->time, solver->z, solver->zt, &nextTime));
+        }
+
+        *timeReached = nextTime;
+
+        return status;
+    }
+
+    while (solver->time < nextTime && !solver->stateEvent) {
+        CALL(doStep(solver, fmax(maxTime, nextTime)));
+    }
+
+    // report the event if it has been located before nextTime
+    if (solver->stateEvent && solver->eventTime <= nextTime) {
+        *stateEvent = true;
+        solver->stateEvent = false;
+        nextTime = solver->eventTime;
+    }
+
+    CALL(moveTo(solver, nextTime));
+
+    *timeReached = nextTime;
+
+    return status;
+}
+
+FMIStatus FMIBDFReset(FMISolver* solver, double time) {
+
+    FMIStatus status = FMIOK;
+
+    const FMISolverParameters* p = &solver->p;
+
+    solver->previousTime = time;
+    solver->time = time;
+    solver->history = false;
+    solver->derivativesValid = false;
+    solver->jacobianValid = false;
+    solver->instanceAtTime = true;
+    solver->stateEvent = false;
+
+    if (p->nx > 0) {
+        CALL(p->getContinuousStates(p->instance, solver->x, p->nx));
+        CALL(p->getNominalsOfContinuousStates(p->instance, solver->nominals, p->nx));
+    }
+
+    if (p->nz > 0) {
+        CALL(p->getEventIndicators(p->instance, solver->prez, p->nz));
+    }
+
+    return status;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "FMISolver.h"
+
+
+/* implicit backward differentiation formula of order 1 and 2 with variable step size and dense output for stiff systems */
+FMISolver* FMIBDFCreate(const FMISolverParameters* parameters);
+
+void FMIBDFFree(FMISolver* solver);
+
+FMIStatus FMIBDFStep(FMISolver* solver, double nextTime, double maxTime, double* timeReached, bool* stateEvent);
+
+FMIStatus FMIBDFReset(FMISolver* solver, double time);
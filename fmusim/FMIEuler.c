@@ -0,0 +1,182 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FMIEuler.h"
+#include "FMIRootFinder.h"
+
+
+#define CALL(f) do { status = f; if (status > FMIWarning) return status; } while (0)
+
+struct FMISolverImpl {
+
+    FMISolverParameters p;
+
+    double previousTime;
+    double time;
+
+    // the continuous states at time and previousTime, the interpolated states and the derivatives
+    double* x;
+    double* x0;
+    double* xi;
+    double* dx;
+
+    // the event indicators at time, before the change of sign and at the trial points of the root finder
+    double* z;
+    double* prez;
+    double* zt;
+
+};
+
+FMISolver* FMIEulerCreate(const FMISolverParameters* parameters) {
+
+    FMISolver* solver = NULL;
+
+    if (FMICalloc((void**)&solver, 1, sizeof(FMISolver)) != FMIOK) {
+        return NULL;
+    }
+
+    solver->p = *parameters;
+
+    if (FMICalloc((void**)&solver->x, parameters->nx, sizeof(double)) != FMIOK ||
+        FMICalloc((void**)&solver->x0, parameters->nx, sizeof(double)) != FMIOK ||
+        FMICalloc((void**)&solver->xi, parameters->nx, sizeof(double)) != FMIOK ||
+        FMICalloc((void**)&solver->dx, parameters->nx, sizeof(double)) != FMIOK ||
+        FMICalloc((void**)&solver->z, parameters->nz, sizeof(double)) != FMIOK ||
+        FMICalloc((void**)&solver->prez, parameters->nz, sizeof(double)) != FMIOK ||
+        FMICalloc((void**)&solver->zt, parameters->nz, sizeof(double)) != FMIOK) {
+        FMIEulerFree(solver);
+        return NULL;
+    }
+
+    if (FMIEulerReset(solver, parameters->startTime) > FMIWarning) {
+        FMIEulerFree(solver);
+        return NULL;
+    }
+
+    return solver;
+}
+
+void FMIEulerFree(FMISolver* solver) {
+
+    if (!solver) {
+        return;
+    }
+
+    free(solver->x);
+    free(solver->x0);
+    free(solver->xi);
+    free(solver->dx);
+    free(solver->z);
+    free(solver->prez);
+    free(solver->zt);
+    free(solver);
+}
+
+/* set the FMU to the states at time (linearly interpolated within the last step) */
+static FMIStatus moveTo(FMISolver* solver, double time) {
+
+    FMIStatus status = FMIOK;
+
+    const FMISolverParameters* p = &solver->p;
+
+    const double theta = (time - solver->previousTime) / (solver->time - solver->previousTime);
+
+    for (size_t i = 0; i < p->nx; i++) {
+        solver->xi[i] = solver->x0[i] + theta * (solver->x[i] - solver->x0[i]);
+    }
+
+    CALL(p->setTime(p->instance, time));
+
+    CALL(p->applyInput(p->instance, p->input, time, false, true, false));
+
+    if (p->nx > 0) {
+        CALL(p->setContinuousStates(p->instance, solver->xi, p->nx));
+    }
+
+    return status;
+}
+
+FMIStatus FMIEulerStep(FMISolver* solver, double nextTime, double maxTime, double* timeReached, bool* stateEvent) {
+
+    FMIStatus status = FMIOK;
+
+    const FMISolverParameters* p = &solver->p;
+
+    // the fixed step is always taken to nextTime
+    (void)maxTime;
+
+    const double h = nextTime - solver->time;
+
+    if (p->nx > 0) {
+
+        CALL(p->getContinuousStateDerivatives(p->instance, solver->dx, p->nx));
+
+        memcpy(solver->x0, solver->x, p->nx * sizeof(double));
+
+        for (size_t i = 0; i < p->nx; i++) {
+
+            solver->x[i] += h * solver->dx[i];
+
+            if (!isfinite(solver->x[i])) {
+                FMILogError("The continuous state %zu is not finite at t=%g.", i, nextTime);
+                return FMIError;
+            }
+        }
+    }
+
+    solver->previousTime = solver->time;
+    solver->time = nextTime;
+
+    CALL(p->setTime(p->instance, solver->time));
+
+    CALL(p->applyInput(p->instance, p->input, solver->time, false, true, false));
+
+    if (p->nx > 0) {
+        CALL(p->setContinuousStates(p->instance, solver->x, p->nx));
+    }
+
+    *stateEvent = false;
+
+    *timeReached = solver->time;
+
+    if (p->nz > 0) {
+
+        CALL(p->getEventIndicators(p->instance, solver->z, p->nz));
+
+        for (size_t i = 0; i < p->nz; i++) {
+            if ((solver->prez[i] <= 0 && solver->z[i] > 0) || (solver->prez[i] > 0 && solver->z[i] <= 0)) {
+                *stateEvent = true;
+            }
+        }
+
+        if (*stateEvent) {
+            // locate the event within the step
+            CALL(FMIFindRoot(solver, p, moveTo, solver->previousTime, solver->prez, solver->time, solver->z, solver->zt, timeReached));
+        } else {
+            memcpy(solver->prez, solver->z, p->nz * sizeof(double));
+        }
+    }
+
+    return status;
+}
+
+FMIStatus FMIEulerReset(FMISolver* solver, double time) {
+
+    FMIStatus status = FMIOK;
+
+    const FMISolverParameters* p = &solver->p;
+
+    solver->previousTime = time;
+    solver->time = time;
+
+    if (p->nx > 0) {
+        CALL(p->getContinuousStates(p->instance, solver->x, p->nx));
+    }
+
+    if (p->nz > 0) {
+        CALL(p->getEventIndicators(p->instance, solver->prez, p->nz));
+    }
+
+    return status;
+}
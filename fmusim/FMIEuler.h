@@ -0,0 +1,12 @@
+#pragma once
+
+#include "FMISolver.h"
+
+
+FMISolver* FMIEulerCreate(const FMISolverParameters* parameters);
+
+void FMIEulerFree(FMISolver* solver);
+
+FMIStatus FMIEulerStep(FMISolver* solver, double nextTime, double maxTime, double* timeReached, bool* stateEvent);
+
+FMIStatus FMIEulerReset(FMISolver* solver, double time);
@@ -0,0 +1,768 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FMI2.h"
+#include "FMIUtil.h"
+#include "FMIInputTable.h"
+
+
+// initial size of the read buffer
+#define CHUNK_SIZE (1024 * 1024)
+
+// maximum number of rows to read ahead when looking for the next event
+#define MAX_LOOKAHEAD 65536
+
+typedef struct {
+
+    const FMIModelVariable* variable;
+
+    // set in Continuous-Time Mode
+    bool continuous;
+
+    // linearly interpolated between rows
+    bool interpolate;
+
+    // number of values per row (known after the first row)
+    bool initialized;
+    size_t nValues;
+
+    // size of a value in bytes
+    size_t size;
+
+    // rowsSize * nValues values
+    void* values;
+
+    // rowsSize sizes of binary values
+    size_t* sizes;
+
+    // interpolated values
+    void* buffer;
+
+} Column;
+
+struct FMIInputTable {
+
+    FMIMajorVersion fmiMajorVersion;
+
+    // read buffer
+    FILE* file;
+    char* chunk;
+    size_t chunkSize;
+    size_t chunkLength;
+    size_t position;
+    bool endOfFile;
+    size_t lineNumber;
+
+    size_t maxFields;
+    char** fields;
+
+    // buffered rows
+    size_t nRows;
+    size_t rowsSize;
+    double* time;
+
+    size_t nColumns;
+    Column* columns;
+
+    // pending events
+    size_t nEvents;
+    size_t eventsSize;
+    double* events;
+
+};
+
+/* the next line (outside of quotes) in the read buffer or NULL at the end of the file */
+static FMIStatus readLine(FMIInputTable* input, char** line) {
+
+    *line = NULL;
+
+    for (;;) {
+
+        bool quoted = false;
+
+        for (size_t i = input->position; i < input->chunkLength; i++) {
+
+            const char c = input->chunk[i];
+
+            if (c == '"') {
+                quoted = !quoted;
+            } else if (c == '\n' && !quoted) {
+                input->chunk[i] = '\0';
+                *line = &input->chunk[input->position];
+                input->position = i + 1;
+                input->lineNumber++;
+                return FMIOK;
+            }
+        }
+
+        if (input->endOfFile) {
+
+            if (input->position < input->chunkLength) {
+                // last line without a line break
+                input->chunk[input->chunkLength] = '\0';
+                *line = &input->chunk[input->position];
+                input->position = input->chunkLength;
+                input->lineNumber++;
+            }
+
+            return FMIOK;
+        }
+
+        // move the incomplete line to the beginning of the buffer and read the next chunk
+        const size_t remaining = input->chunkLength - input->position;
+
+        memmove(input->chunk, &input->chunk[input->position], remaining);
+
+        input->chunkLength = remaining;
+        input->position = 0;
+
+        if (input->chunkLength == input->chunkSize) {
+
+            input->chunkSize *= 2;
+
+            if (FMIRealloc((void**)&input->chunk, input->chunkSize + 1) != FMIOK) {
+                return FMIError;
+            }
+        }
+
+        const size_t n = fread(&input->chunk[input->chunkLength], 1, input->chunkSize - input->chunkLength, input->file);
+
+        if (n == 0) {
+
+            if (ferror(input->file)) {
+                FMILogError("Failed to read the input file.");
+                return FMIError;
+            }
+
+            input->endOfFile = true;
+        }
+
+        input->chunkLength += n;
+    }
+}
+
+/* split the line into fields in place and return the number of fields */
+static size_t splitLine(char* s, char** fields, size_t maxFields) {
+
+    size_t nFields = 0;
+
+    for (;;) {
+
+        char* field = s;
+
+        if (*s == '"') {
+
+            // quoted field with "" as escaped quote
+            char* w = ++s;
+            field = w;
+
+            while (*s) {
+                if (s[0] == '"' && s[1] == '"') {
+                    *w++ = '"';
+                    s += 2;
+                } else if (s[0] == '"') {
+                    s++;
+                    break;
+                } else {
+                    *w++ = *s++;
+                }
+            }
+
+            while (*s && *s != ',' && *s != '\r') {
+                s++;
+            }
+
+            *w = '\0';
+
+        } else {
+
+            while (*s && *s != ',' && *s != '\r') {
+                s++;
+            }
+        }
+
+        const char c = *s;
+
+        *s++ = '\0';
+
+        if (nFields < maxFields) {
+            fields[nFields] = field;
+        }
+
+        nFields++;
+
+        if (c != ',') {
+            break;
+        }
+    }
+
+    return nFields;
+}
+
+static void freeRows(Column* column, size_t first, size_t n) {
+
+    if (column->variable->type != FMIStringType && column->variable->type != FMIBinaryType) {
+        return;
+    }
+
+    void** values = (void**)column->values;
+
+    for (size_t i = first * column->nValues; i < (first + n) * column->nValues; i++) {
+        free(values[i]);
+    }
+}
+
+static bool rowsDiffer(const Column* column, size_t i, size_t j) {
+
+    const size_t rowSize = column->nValues * column->size;
+
+    switch (column->variable->type) {
+    case FMIStringType:
+        for (size_t k = 0; k < column->nValues; k++) {
+            if (strcmp(((char**)column->values)[i * column->nValues + k], ((char**)column->values)[j * column->nValues + k])) {
+                return true;
+            }
+        }
+        return false;
+    case FMIBinaryType:
+        return column->sizes[i] != column->sizes[j] ||
+            memcmp(((unsigned char**)column->values)[i], ((unsigned char**)column->values)[j], column->sizes[i]);
+    default:
+        return memcmp((char*)column->values + i * rowSize, (char*)column->values + j * rowSize, rowSize) != 0;
+    }
+}
+
+static FMIStatus addEvent(FMIInputTable* input, double time) {
+
+    if (input->nEvents > 0 && input->events[input->nEvents - 1] == time) {
+        return FMIOK;
+    }
+
+    if (input->nEvents == input->eventsSize) {
+
+        input->eventsSize = input->eventsSize ? 2 * input->eventsSize : 16;
+
+        if (FMIRealloc((void**)&input->events, input->eventsSize * sizeof(double)) != FMIOK) {
+            return FMIError;
+        }
+    }
+
+    input->events[input->nEvents++] = time;
+
+    return FMIOK;
+}
+
+static FMIStatus growRows(FMIInputTable* input) {
+
+    input->rowsSize = input->rowsSize ? 2 * input->rowsSize : 64;
+
+    if (FMIRealloc((void**)&input->time, input->rowsSize * sizeof(double)) != FMIOK) {
+        return FMIError;
+    }
+
+    for (size_t i = 0; i < input->nColumns; i++) {
+
+        Column* column = &input->columns[i];
+
+        if (column->initialized && FMIRealloc(&column->values, input->rowsSize * column->nValues * column->size) != FMIOK) {
+            return FMIError;
+        }
+
+        if (column->variable->type == FMIBinaryType && FMIRealloc((void**)&column->sizes, input->rowsSize * sizeof(size_t)) != FMIOK) {
+            return FMIError;
+        }
+    }
+
+    return FMIOK;
+}
+
+static FMIStatus parseCell(FMIInputTable* input, Column* column, size_t row, const char* literal) {
+
+    const FMIVariableType type = column->variable->type;
+
+    if (column->initialized && type != FMIStringType && type != FMIBinaryType) {
+
+        // parse directly into the buffer
+        void* values = (char*)column->values + row * column->nValues * column->size;
+
+        size_t nValues;
+
+        if (FMIParseNumericValues(input->fmiMajorVersion, type, literal, values, column->nValues, &nValues) != FMIOK) {
+            return FMIError;
+        }
+
+        if (nValues != column->nValues) {
+            FMILogError("Expected %zu values for %s in line %zu but found %zu.", column->nValues, column->variable->name, input->lineNumber, nValues);
+            return FMIError;
+        }
+
+        return FMIOK;
+    }
+
+    size_t nValues;
+    void* values;
+    size_t* sizes;
+
+    if (FMIParseValues(input->fmiMajorVersion, type, literal, &nValues, &values, type == FMIBinaryType ? &sizes : NULL) != FMIOK) {
+        return FMIError;
+    }
+
+    if (!column->initialized) {
+
+        // the first row determines the number of values
+        column->nValues = nValues ? nValues : 1;
+        column->initialized = true;
+
+        if (FMICalloc(&column->values, input->rowsSize * column->nValues, column->size) != FMIOK ||
+            FMICalloc(&column->buffer, column->nValues, column->size) != FMIOK) {
+            FMIFreeValues(type, nValues, values, type == FMIBinaryType ? sizes : NULL);
+            return FMIError;
+        }
+    }
+
+    if (nValues != column->nValues) {
+        FMILogError("Expected %zu values for %s in line %zu but found %zu.", column->nValues, column->variable->name, input->lineNumber, nValues);
+        FMIFreeValues(type, nValues, values, type == FMIBinaryType ? sizes : NULL);
+        return FMIError;
+    }
+
+    memcpy((char*)column->values + row * nValues * column->size, values, nValues * column->size);
+
+    if (type == FMIBinaryType) {
+        column->sizes[row] = sizes[0];
+        free(sizes);
+    }
+
+    // the string and binary values are now owned by the column
+    free(values);
+
+    return FMIOK;
+}
+
+/* read the next row into the buffer and set *read to false at the end of the file */
+static FMIStatus readRow(FMIInputTable* input, bool* read) {
+
+    char* line;
+
+    *read = false;
+
+    do {
+
+        if (readLine(input, &line) != FMIOK) {
+            return FMIError;
+        }
+
+        if (!line) {
+            return FMIOK;
+        }
+
+    } while (*line == '\0' || *line == '\r');
+
+    const size_t nFields = splitLine(line, input->fields, input->maxFields);
+
+    if (nFields != input->nColumns + 1) {
+        FMILogError("Expected %zu fields in line %zu but found %zu.", input->nColumns + 1, input->lineNumber, nFields);
+        return FMIError;
+    }
+
+    if (input->nRows == input->rowsSize && growRows(input) != FMIOK) {
+        return FMIError;
+    }
+
+    const size_t row = input->nRows;
+
+    char* end;
+
+    input->time[row] = FMIParseDouble(input->fields[0], &end);
+
+    if (end == input->fields[0]) {
+        FMILogError("Failed to parse the time \"%s\" in line %zu.", input->fields[0], input->lineNumber);
+        return FMIError;
+    }
+
+    if (row > 0 && input->time[row] < input->time[row - 1]) {
+        FMILogError("The time in the input must be monotonically increasing (line %zu).", input->lineNumber);
+        return FMIError;
+    }
+
+    for (size_t i = 0; i < input->nColumns; i++) {
+
+        if (parseCell(input, &input->columns[i], row, input->fields[i + 1]) != FMIOK) {
+            for (size_t j = 0; j < i; j++) {
+                freeRows(&input->columns[j], row, 1);
+            }
+            return FMIError;
+        }
+    }
+
+    input->nRows++;
+
+    // a repeated time or a changed value that is not interpolated is a discontinuity
+    if (row > 0) {
+
+        bool event = input->time[row] == input->time[row - 1];
+
+        for (size_t i = 0; i < input->nColumns && !event; i++) {
+
+            const Column* column = &input->columns[i];
+
+            event = !column->interpolate && rowsDiffer(column, row, row - 1);
+        }
+
+        if (event && addEvent(input, input->time[row]) != FMIOK) {
+            return FMIError;
+        }
+    }
+
+    *read = true;
+
+    return FMIOK;
+}
+
+/* read rows until the last buffered row is after time */
+static FMIStatus readRowsAfter(FMIInputTable* input, double time) {
+
+    bool read = true;
+
+    while (read && (input->nRows == 0 || input->time[input->nRows - 1] <= time)) {
+
+        if (readRow(input, &read) != FMIOK) {
+            return FMIError;
+        }
+    }
+
+    return FMIOK;
+}
+
+FMIInputTable* FMIReadInput(const FMIModelDescription* modelDescription, const char* filename, FMIInterpolation interpolation) {
+
+    FMIInputTable* input = NULL;
+
+    if (FMICalloc((void**)&input, 1, sizeof(FMIInputTable)) != FMIOK) {
+        return NULL;
+    }
+
+    input->fmiMajorVersion = modelDescription->fmiMajorVersion;
+
+    input->file = fopen(filename, "rb");
+
+    if (!input->file) {
+        FMILogError("Failed to open %s.", filename);
+        goto FAIL;
+    }
+
+    input->chunkSize = CHUNK_SIZE;
+
+    if (FMICalloc((void**)&input->chunk, input->chunkSize + 1, 1) != FMIOK) {
+        goto FAIL;
+    }
+
+    char* header;
+
+    if (readLine(input, &header) != FMIOK) {
+        goto FAIL;
+    }
+
+    if (!header) {
+        FMILogError("The input file %s is empty.", filename);
+        goto FAIL;
+    }
+
+    // count the columns
+    input->maxFields = 1;
+
+    for (const char* c = header; *c; c++) {
+        if (*c == ',') {
+            input->maxFields++;
+        }
+    }
+
+    if (FMICalloc((void**)&input->fields, input->maxFields, sizeof(char*)) != FMIOK) {
+        goto FAIL;
+    }
+
+    const size_t nFields = splitLine(header, input->fields, input->maxFields);
+
+    input->nColumns = nFields - 1;
+
+    if (FMICalloc((void**)&input->columns, input->nColumns, sizeof(Column)) != FMIOK) {
+        goto FAIL;
+    }
+
+    for (size_t i = 0; i < input->nColumns; i++) {
+
+        Column* column = &input->columns[i];
+
+        column->variable = FMIModelVariableForName(modelDescription, input->fields[i + 1]);
+
+        if (!column->variable) {
+            FMILogError("Variable %s from the input file does not exist.", input->fields[i + 1]);
+            goto FAIL;
+        }
+
+        column->continuous = column->variable->variability == FMIContinuous &&
+            (column->variable->type == FMIFloat32Type || column->variable->type == FMIFloat64Type);
+
+        column->interpolate = column->continuous && interpolation == FMILinearInterpolation;
+
+        column->size = FMISizeOfVariableType(column->variable->type, modelDescription->fmiMajorVersion);
+    }
+
+    if (growRows(input) != FMIOK) {
+        goto FAIL;
+    }
+
+    return input;
+
+FAIL:
+    FMIFreeInput(input);
+
+    return NULL;
+}
+
+void FMIFreeInput(FMIInputTable* input) {
+
+    if (!input) {
+        return;
+    }
+
+    for (size_t i = 0; i < input->nColumns; i++) {
+
+        Column* column = &input->columns[i];
+
+        if (column->values) {
+            freeRows(column, 0, input->nRows);
+        }
+
+        free(column->values);
+        free(column->sizes);
+        free(column->buffer);
+    }
+
+    if (input->file) {
+        fclose(input->file);
+    }
+
+    free(input->chunk);
+    free(input->fields);
+    free(input->columns);
+    free(input->time);
+    free(input->events);
+    free(input);
+}
+
+/* index of the last row before time (or at time if afterEvent) */
+static size_t rowIndex(const FMIInputTable* input, double time, bool afterEvent) {
+
+    size_t lo = 0, hi = input->nRows;
+
+    while (lo < hi) {
+
+        const size_t mid = lo + (hi - lo) / 2;
+
+        if (input->time[mid] < time || (afterEvent && input->time[mid] == time)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo > 0 ? lo - 1 : 0;
+}
+
+FMIStatus FMINextInputEventTime(FMIInputTable* input, double time, double* nextEventTime, bool* isEvent) {
+
+    *nextEventTime = INFINITY;
+    *isEvent = false;
+
+    if (!input) {
+        return FMIOK;
+    }
+
+    // remove the past events
+    size_t past = 0;
+
+    while (past < input->nEvents && input->events[past] <= time) {
+        past++;
+    }
+
+    if (past > 0) {
+        input->nEvents -= past;
+        memmove(input->events, &input->events[past], input->nEvents * sizeof(double));
+    }
+
+    // read ahead until the next event or the end of the lookahead
+    const size_t lookahead = rowIndex(input, time, true) + MAX_LOOKAHEAD;
+
+    bool read = !input->endOfFile || input->position < input->chunkLength;
+
+    while (input->nEvents == 0 && read && input->nRows < lookahead) {
+
+        if (readRow(input, &read) != FMIOK) {
+            return FMIError;
+        }
+    }
+
+    if (input->nEvents > 0) {
+        *nextEventTime = input->events[0];
+        *isEvent = true;
+    } else if (read && input->nRows > 0 && input->time[input->nRows - 1] > time) {
+        // stop at the last buffered row since later rows might start with a discontinuity
+        *nextEventTime = input->time[input->nRows - 1];
+    }
+
+    return FMIOK;
+}
+
+FMIStatus FMIDiscardInput(FMIInputTable* input, double time) {
+
+    if (!input) {
+        return FMIOK;
+    }
+
+    // keep the row before time and the rows at time (left limit)
+    const size_t first = rowIndex(input, time, false);
+
+    // only move the rows when at least half of the buffer can be released
+    if (first == 0 || 2 * first < input->nRows) {
+        return FMIOK;
+    }
+
+    const size_t n = input->nRows - first;
+
+    memmove(input->time, &input->time[first], n * sizeof(double));
+
+    for (size_t i = 0; i < input->nColumns; i++) {
+
+        Column* column = &input->columns[i];
+
+        if (!column->initialized) {
+            continue;
+        }
+
+        const size_t rowSize = column->nValues * column->size;
+
+        freeRows(column, 0, first);
+
+        memmove(column->values, (char*)column->values + first * rowSize, n * rowSize);
+
+        if (column->sizes) {
+            memmove(column->sizes, &column->sizes[first], n * sizeof(size_t));
+        }
+    }
+
+    input->nRows = n;
+
+    return FMIOK;
+}
+
+FMIStatus FMIApplyInput(FMIInstance* instance, FMIInputTable* input, double time, bool discrete, bool continuous, bool afterEvent) {
+
+    if (!input) {
+        return FMIOK;
+    }
+
+    FMIStatus status = readRowsAfter(input, time);
+
+    if (status > FMIWarning || input->nRows == 0) {
+        return status;
+    }
+
+    const size_t row = rowIndex(input, time, afterEvent);
+
+    for (size_t i = 0; i < input->nColumns; i++) {
+
+        const Column* column = &input->columns[i];
+
+        if ((column->continuous && !continuous) || (!column->continuous && !discrete)) {
+            continue;
+        }
+
+        const size_t nValues = column->nValues;
+
+        const void* values = (char*)column->values + row * nValues * column->size;
+
+        if (column->interpolate && row + 1 < input->nRows && input->time[row + 1] > input->time[row] && time > input->time[row]) {
+
+            const double t0 = input->time[row];
+            const double t1 = input->time[row + 1];
+            const double w = time >= t1 ? 1 : (time - t0) / (t1 - t0);
+
+            if (column->variable->type == FMIFloat64Type) {
+                const double* v0 = (double*)values;
+                const double* v1 = v0 + nValues;
+                double* buffer = (double*)column->buffer;
+                for (size_t j = 0; j < nValues; j++) {
+                    buffer[j] = v0[j] + w * (v1[j] - v0[j]);
+                }
+            } else {
+                const float* v0 = (float*)values;
+                const float* v1 = v0 + nValues;
+                float* buffer = (float*)column->buffer;
+                for (size_t j = 0; j < nValues; j++) {
+                    buffer[j] = (float)(v0[j] + w * (v1[j] - v0[j]));
+                }
+            }
+
+            values = column->buffer;
+        }
+
+        const size_t* sizes = column->sizes ? &column->sizes[row] : NULL;
+
+        const FMIStatus s = FMISetValues(instance, column->variable->type, &column->variable->valueReference, 1, values, sizes, nValues);
+
+        status = s > status ? s : status;
+
+        if (status > FMIWarning) {
+            break;
+        }
+    }
+
+    return status;
+}
+
+FMIStatus FMIApplyInputDerivatives(FMIInstance* instance, FMIInputTable* input, double time) {
+
+    if (!input || input->fmiMajorVersion != FMIMajorVersion2) {
+        return FMIOK;
+    }
+
+    FMIStatus status = readRowsAfter(input, time);
+
+    if (status > FMIWarning || input->nRows == 0) {
+        return status;
+    }
+
+    const size_t row = rowIndex(input, time, true);
+
+    for (size_t i = 0; i < input->nColumns; i++) {
+
+        const Column* column = &input->columns[i];
+
+        if (!column->interpolate || column->variable->type != FMIFloat64Type || column->nValues != 1) {
+            continue;
+        }
+
+        // the slope of the segment that starts at time (zero after the last row)
+        double derivative = 0;
+
+        if (row + 1 < input->nRows && input->time[row + 1] > input->time[row] && time >= input->time[row]) {
+            const double* v = (double*)column->values + row;
+            derivative = (v[1] - v[0]) / (input->time[row + 1] - input->time[row]);
+        }
+
+        const fmi2Integer order = 1;
+
+        const FMIStatus s = FMI2SetRealInputDerivatives(instance, &column->variable->valueReference, 1, &order, &derivative);
+
+        status = s > status ? s : status;
+
+        if (status > FMIWarning) {
+            break;
+        }
+    }
+
+    return status;
+}
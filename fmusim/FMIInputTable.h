@@ -0,0 +1,29 @@
+#pragma once
+
+#include "FMIModelDescription.h"
+
+
+typedef enum {
+    FMILinearInterpolation,
+    FMIStepInterpolation
+} FMIInterpolation;
+
+typedef struct FMIInputTable FMIInputTable;
+
+/* open a CSV file with the variable names in the header and read the rows in chunks as the simulation advances */
+FMIInputTable* FMIReadInput(const FMIModelDescription* modelDescription, const char* filename, FMIInterpolation interpolation);
+
+void FMIFreeInput(FMIInputTable* input);
+
+/* the time of the next discontinuity after time or INFINITY (if no discontinuity is found within the
+   lookahead *nextEventTime is the time of the last buffered row and *isEvent is false) */
+FMIStatus FMINextInputEventTime(FMIInputTable* input, double time, double* nextEventTime, bool* isEvent);
+
+/* release the rows that are not required to apply the input at time or later */
+FMIStatus FMIDiscardInput(FMIInputTable* input, double time);
+
+/* set the discrete and/or continuous inputs at time (left or right limit) */
+FMIStatus FMIApplyInput(FMIInstance* instance, FMIInputTable* input, double time, bool discrete, bool continuous, bool afterEvent);
+
+/* set the first derivatives of the linearly interpolated scalar Real inputs at time (FMI 2.0 Co-Simulation) */
+FMIStatus FMIApplyInputDerivatives(FMIInstance* instance, FMIInputTable* input, double time);
@@ -0,0 +1,355 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FMI3.h"
+#include "FMIUtil.h"
+#include "FMILoopSolver.h"
+
+
+#define CALL(f) do { status = f; if (status > FMIWarning) goto TERMINATE; } while (0)
+
+struct FMILoopSolver {
+
+    FMISystem* system;
+
+    double tolerance;
+    size_t maxIterations;
+
+    // the connections in algebraic loops and the index of their first value in the vectors
+    size_t nConnections;
+    FMIConnection** connections;
+    size_t* offsets;
+
+    // true if all components in the loops provide directional derivatives
+    bool exactJacobian;
+
+    // the number of unknowns
+    size_t n;
+
+    // the values of the inputs, the residuals (outputs - inputs) and their changes
+    double* v;
+    double* r;
+    double* dv;
+    double* dr;
+
+    // the Jacobian of the residuals (row major), its LU decomposition and the pivots
+    double* J;
+    double* LU;
+    size_t* pivots;
+
+    // buffers for the directional derivatives
+    double* seed;
+    double* sensitivity;
+};
+
+static size_t componentIndex(const FMISystem* system, const FMIComponent* component) {
+    return (size_t)(component - system->components);
+}
+
+static bool providesDirectionalDerivatives(const FMIComponent* component) {
+    return component->modelDescription->coSimulation->providesDirectionalDerivatives;
+}
+
+FMILoopSolver* FMICreateLoopSolver(FMISystem* system, double tolerance, size_t maxIterations) {
+
+    FMILoopSolver* solver = NULL;
+    bool* reachable = NULL;
+
+    const size_t nComponents = system->nComponents;
+
+    if (FMICalloc((void**)&solver, 1, sizeof(FMILoopSolver)) != FMIOK ||
+        FMICalloc((void**)&reachable, nComponents * nComponents, sizeof(bool)) != FMIOK ||
+        FMICalloc((void**)&solver->connections, system->nConnections + 1, sizeof(FMIConnection*)) != FMIOK ||
+        FMICalloc((void**)&solver->offsets, system->nConnections + 1, sizeof(size_t)) != FMIOK) {
+        goto FAIL;
+    }
+
+    solver->system = system;
+    solver->tolerance = tolerance;
+    solver->maxIterations = maxIterations;
+    solver->exactJacobian = true;
+
+    // the transitive closure of the Float64 connections between the components (Warshall's algorithm)
+    for (size_t i = 0; i < system->nConnections; i++) {
+
+        const FMIConnection* connection = &system->connections[i];
+
+        if (connection->startVariable->type == FMIFloat64Type) {
+            reachable[componentIndex(system, connection->startComponent) * nComponents + componentIndex(system, connection->endComponent)] = true;
+        }
+    }
+
+    for (size_t k = 0; k < nComponents; k++) {
+        for (size_t i = 0; i < nComponents; i++) {
+            if (reachable[i * nComponents + k]) {
+                for (size_t j = 0; j < nComponents; j++) {
+                    reachable[i * nComponents + j] |= reachable[k * nComponents + j];
+                }
+            }
+        }
+    }
+
+    // a connection is part of a loop if its end component can reach its start component
+    for (size_t i = 0; i < system->nConnections; i++) {
+
+        FMIConnection* connection = &system->connections[i];
+
+        const size_t start = componentIndex(system, connection->startComponent);
+        const size_t end = componentIndex(system, connection->endComponent);
+
+        if (connection->startVariable->type != FMIFloat64Type || !reachable[end * nComponents + start]) {
+            continue;
+        }
+
+        solver->connections[solver->nConnections] = connection;
+        solver->offsets[solver->nConnections] = solver->n;
+        solver->nConnections++;
+
+        solver->n += connection->nValues;
+
+        solver->exactJacobian &= providesDirectionalDerivatives(connection->startComponent);
+    }
+
+    const size_t n = solver->n;
+
+    if (FMICalloc((void**)&solver->v, n + 1, sizeof(double)) != FMIOK ||
+        FMICalloc((void**)&solver->r, n + 1, sizeof(double)) != FMIOK ||
+        FMICalloc((void**)&solver->dv, n + 1, sizeof(double)) != FMIOK ||
+        FMICalloc((void**)&solver->dr, n + 1, sizeof(double)) != FMIOK ||
+        FMICalloc((void**)&solver->J, n * n + 1, sizeof(double)) != FMIOK ||
+        FMICalloc((void**)&solver->LU, n * n + 1, sizeof(double)) != FMIOK ||
+        FMICalloc((void**)&solver->pivots, n + 1, sizeof(size_t)) != FMIOK ||
+        FMICalloc((void**)&solver->seed, n + 1, sizeof(double)) != FMIOK ||
+        FMICalloc((void**)&solver->sensitivity, n + 1, sizeof(double)) != FMIOK) {
+        goto FAIL;
+    }
+
+    free(reachable);
+
+    return solver;
+
+FAIL:
+    free(reachable);
+    FMIFreeLoopSolver(solver);
+    return NULL;
+}
+
+void FMIFreeLoopSolver(FMILoopSolver* solver) {
+
+    if (!solver) {
+        return;
+    }
+
+    free(solver->connections);
+    free(solver->offsets);
+    free(solver->v);
+    free(solver->r);
+    free(solver->dv);
+    free(solver->dr);
+    free(solver->J);
+    free(solver->LU);
+    free(solver->pivots);
+    free(solver->seed);
+    free(solver->sensitivity);
+    free(solver);
+}
+
+size_t FMILoopSolverConnections(const FMILoopSolver* solver) {
+    return solver->nConnections;
+}
+
+/* set the inputs to v and calculate the residuals r = outputs - v */
+static FMIStatus evaluate(FMILoopSolver* solver) {
+
+    FMIStatus status = FMIOK;
+
+    // set all inputs before the outputs are retrieved
+    for (size_t i = 0; i < solver->nConnections; i++) {
+
+        const FMIConnection* connection = solver->connections[i];
+
+        CALL(FMI3SetFloat64(connection->endComponent->instance, &connection->endVariable->valueReference, 1, &solver->v[solver->offsets[i]], connection->nValues));
+    }
+
+    for (size_t i = 0; i < solver->nConnections; i++) {
+
+        const FMIConnection* connection = solver->connections[i];
+
+        CALL(FMI3GetFloat64(connection->startComponent->instance, &connection->startVariable->valueReference, 1, &solver->r[solver->offsets[i]], connection->nValues));
+    }
+
+    for (size_t i = 0; i < solver->n; i++) {
+        solver->r[i] -= solver->v[i];
+    }
+
+TERMINATE:
+    return status;
+}
+
+/* the residuals relative to the tolerance */
+static double residualNorm(const FMILoopSolver* solver) {
+
+    double norm = 0;
+
+    for (size_t i = 0; i < solver->n; i++) {
+        norm = fmax(norm, fabs(solver->r[i]) / (solver->tolerance + solver->tolerance * fabs(solver->v[i])));
+    }
+
+    return norm;
+}
+
+/* assemble the Jacobian of the residuals from the directional derivatives of the components (the other entries are zero) */
+static FMIStatus assembleJacobian(FMILoopSolver* solver) {
+
+    FMIStatus status = FMIOK;
+
+    const size_t n = solver->n;
+
+    memset(solver->J, 0, n * n * sizeof(double));
+
+    for (size_t i = 0; i < n; i++) {
+        solver->J[i * n + i] = -1;
+    }
+
+    for (size_t i = 0; i < solver->nConnections; i++) {
+
+        const FMIConnection* output = solver->connections[i];
+
+        if (!providesDirectionalDerivatives(output->startComponent)) {
+            continue;
+        }
+
+        for (size_t j = 0; j < solver->nConnections; j++) {
+
+            const FMIConnection* input = solver->connections[j];
+
+            if (input->endComponent != output->startComponent) {
+                continue;
+            }
+
+            for (size_t k = 0; k < input->nValues; k++) {
+
+                memset(solver->seed, 0, input->nValues * sizeof(double));
+
+                solver->seed[k] = 1;
+
+                CALL(FMI3GetDirectionalDerivative(output->startComponent->instance,
+                    &output->startVariable->valueReference, 1,
+                    &input->endVariable->valueReference, 1,
+                    solver->seed, input->nValues,
+                    solver->sensitivity, output->nValues));
+
+                for (size_t l = 0; l < output->nValues; l++) {
+                    solver->J[(solver->offsets[i] + l) * n + solver->offsets[j] + k] += solver->sensitivity[l];
+                }
+            }
+        }
+    }
+
+TERMINATE:
+    return status;
+}
+
+/* Broyden's update J += (dr - J * dv) * dv' / (dv' * dv) */
+static void updateJacobian(FMILoopSolver* solver) {
+
+    const size_t n = solver->n;
+
+    double dv2 = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        dv2 += solver->dv[i] * solver->dv[i];
+    }
+
+    if (dv2 == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+
+        double y = solver->dr[i];
+
+        for (size_t j = 0; j < n; j++) {
+            y -= solver->J[i * n + j] * solver->dv[j];
+        }
+
+        for (size_t j = 0; j < n; j++) {
+            solver->J[i * n + j] += y * solver->dv[j] / dv2;
+        }
+    }
+}
+
+FMIStatus FMISolveLoops(FMILoopSolver* solver, size_t* nIterations, bool* converged) {
+
+    FMIStatus status = FMIOK;
+
+    *nIterations = 0;
+    *converged = false;
+
+    if (solver->n == 0) {
+        *converged = true;
+        return FMIOK;
+    }
+
+    // start with the values of the connections
+    for (size_t i = 0; i < solver->nConnections; i++) {
+        memcpy(&solver->v[solver->offsets[i]], solver->connections[i]->values, solver->connections[i]->nValues * sizeof(double));
+    }
+
+    CALL(evaluate(solver));
+
+    for (;;) {
+
+        if (residualNorm(solver) <= 1) {
+            *converged = true;
+            break;
+        }
+
+        if (*nIterations == solver->maxIterations) {
+            break;
+        }
+
+        // the secant updates start with the available derivatives
+        if (*nIterations == 0 || solver->exactJacobian) {
+            CALL(assembleJacobian(solver));
+        }
+
+        memcpy(solver->LU, solver->J, solver->n * solver->n * sizeof(double));
+
+        if (!FMILUFactorize(solver->n, solver->LU, solver->pivots)) {
+            break;
+        }
+
+        for (size_t i = 0; i < solver->n; i++) {
+            solver->dv[i] = -solver->r[i];
+        }
+
+        FMILUSolve(solver->n, solver->LU, solver->pivots, solver->dv);
+
+        for (size_t i = 0; i < solver->n; i++) {
+            solver->v[i] += solver->dv[i];
+            solver->dr[i] = -solver->r[i];
+        }
+
+        CALL(evaluate(solver));
+
+        (*nIterations)++;
+
+        if (!solver->exactJacobian) {
+
+            for (size_t i = 0; i < solver->n; i++) {
+                solver->dr[i] += solver->r[i];
+            }
+
+            updateJacobian(solver);
+        }
+    }
+
+    for (size_t i = 0; i < solver->nConnections; i++) {
+        memcpy(solver->connections[i]->values, &solver->v[solver->offsets[i]], solver->connections[i]->nValues * sizeof(double));
+    }
+
+TERMINATE:
+    return status;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "FMISystem.h"
+
+
+typedef struct FMILoopSolver FMILoopSolver;
+
+/* create a solver for the Float64 connections that are part of a cycle of connected components */
+FMILoopSolver* FMICreateLoopSolver(FMISystem* system, double tolerance, size_t maxIterations);
+
+void FMIFreeLoopSolver(FMILoopSolver* solver);
+
+/* the number of connections in algebraic loops */
+size_t FMILoopSolverConnections(const FMILoopSolver* solver);
+
+/*
+Find the values of the inputs in the algebraic loops that are equal to the connected outputs
+starting with the values of the connections. The solver uses Newton's method if all components
+in the loops provide directional derivatives and Broyden's (secant) method otherwise.
+*/
+FMIStatus FMISolveLoops(FMILoopSolver* solver, size_t* nIterations, bool* converged);
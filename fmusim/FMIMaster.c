@@ -0,0 +1,738 @@
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifndef _WIN32
+#include <time.h>
+#endif
+
+#include "FMI3.h"
+#include "FMIUtil.h"
+#include "FMILoopSolver.h"
+#include "FMIResult.h"
+#include "FMIThreadPool.h"
+#include "FMIMaster.h"
+
+
+#define CALL(f) do { status = f; if (status > FMIWarning) goto TERMINATE; } while (0)
+
+// number of rows that are written at once
+#define BLOCK_SIZE 1024
+
+double FMIWallClockTime(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + 1e-9 * (double)t.tv_nsec;
+#endif
+}
+
+typedef struct {
+    FMISystem* system;
+    double time;
+    double stepSize;
+} StepArgs;
+
+static void doStep(void* arg, size_t index) {
+
+    const StepArgs* args = (StepArgs*)arg;
+
+    FMIComponent* component = &args->system->components[index];
+
+    fmi3Boolean eventHandlingNeeded = fmi3False;
+    fmi3Boolean terminateSimulation = fmi3False;
+    fmi3Boolean earlyReturn = fmi3False;
+    fmi3Float64 lastSuccessfulTime = args->time;
+
+    component->status = FMI3DoStep(component->instance, args->time, args->stepSize, fmi3True, &eventHandlingNeeded, &terminateSimulation, &earlyReturn, &lastSuccessfulTime);
+
+    component->terminateSimulation = terminateSimulation;
+}
+
+/* get the values of the outputs and set them to the inputs */
+static FMIStatus exchange(FMIConnectionGroup* group) {
+
+    FMIStatus status = FMIGetValues(group->startComponent->instance, group->type, group->startValueReferences, group->nValueReferences, group->values, group->sizes, group->nValues);
+
+    if (status > FMIWarning) {
+        return status;
+    }
+
+    // strings and binaries are passed by pointer because they are valid until the next call on the start component
+    const FMIStatus s = FMISetValues(group->endComponent->instance, group->type, group->endValueReferences, group->nValueReferences, group->values, group->sizes, group->nValues);
+
+    return s > status ? s : status;
+}
+
+/* exchange the values of the connections that start at component (or all connections if component is NULL) */
+static FMIStatus exchangeValues(FMISystem* system, const FMIComponent* component) {
+
+    FMIStatus status = FMIOK;
+
+    for (size_t i = 0; i < system->nConnectionGroups; i++) {
+
+        FMIConnectionGroup* group = &system->connectionGroups[i];
+
+        if (component && group->startComponent != component) {
+            continue;
+        }
+
+        const FMIStatus s = exchange(group);
+
+        status = s > status ? s : status;
+
+        if (status > FMIWarning) {
+            break;
+        }
+    }
+
+    return status;
+}
+
+static bool isFloatConnection(const FMIConnection* connection) {
+    return connection->startVariable->type == FMIFloat32Type || connection->startVariable->type == FMIFloat64Type;
+}
+
+/* the size of the values of a group in the arena (a multiple of the largest value size) */
+static size_t alignedSize(size_t size) {
+    const size_t alignment = sizeof(double) > sizeof(void*) ? sizeof(double) : sizeof(void*);
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+/* group the connections by components and type and lay out their values in one contiguous arena */
+static FMIStatus createArena(FMISystem* system) {
+
+    FMIStatus status = FMIError;
+
+    // the group of each connection and the offsets of the groups
+    size_t* groupIndices = NULL;
+    size_t* offsets = NULL;
+    size_t* sizeOffsets = NULL;
+    size_t* nFilledValues = NULL;
+
+    if (FMICalloc((void**)&groupIndices, system->nConnections + 1, sizeof(size_t)) != FMIOK ||
+        FMICalloc((void**)&offsets, system->nConnections + 1, sizeof(size_t)) != FMIOK ||
+        FMICalloc((void**)&sizeOffsets, system->nConnections + 1, sizeof(size_t)) != FMIOK ||
+        FMICalloc((void**)&nFilledValues, system->nConnections + 1, sizeof(size_t)) != FMIOK ||
+        FMICalloc((void**)&system->connectionGroups, system->nConnections + 1, sizeof(FMIConnectionGroup)) != FMIOK) {
+        goto TERMINATE;
+    }
+
+    for (size_t i = 0; i < system->nConnections; i++) {
+
+        FMIConnection* connection = &system->connections[i];
+
+        size_t nStartValues = 0;
+        size_t nEndValues = 0;
+
+        // the sizes of the variables are fixed after the structural parameters have been set
+        if (FMIGetVariableSize(connection->startComponent->instance, connection->startVariable, &nStartValues) != FMIOK ||
+            FMIGetVariableSize(connection->endComponent->instance, connection->endVariable, &nEndValues) != FMIOK) {
+            goto TERMINATE;
+        }
+
+        if (nStartValues != nEndValues) {
+            FMILogError("The variables %s.%s and %s.%s have different sizes.",
+                connection->startComponent->name, connection->startVariable->name,
+                connection->endComponent->name, connection->endVariable->name);
+            goto TERMINATE;
+        }
+
+        connection->nValues = nStartValues;
+
+        const FMIVariableType type = connection->startVariable->type;
+
+        size_t j = 0;
+
+        while (j < system->nConnectionGroups) {
+
+            const FMIConnectionGroup* group = &system->connectionGroups[j];
+
+            if (group->startComponent == connection->startComponent && group->endComponent == connection->endComponent && group->type == type) {
+                break;
+            }
+
+            j++;
+        }
+
+        FMIConnectionGroup* group = &system->connectionGroups[j];
+
+        if (j == system->nConnectionGroups) {
+            group->startComponent = connection->startComponent;
+            group->endComponent = connection->endComponent;
+            group->type = type;
+            system->nConnectionGroups++;
+        }
+
+        group->nValueReferences++;
+        group->nValues += connection->nValues;
+
+        groupIndices[i] = j;
+    }
+
+    size_t nSizes = 0;
+
+    for (size_t i = 0; i < system->nConnectionGroups; i++) {
+
+        FMIConnectionGroup* group = &system->connectionGroups[i];
+
+        if (FMICalloc((void**)&group->startValueReferences, group->nValueReferences, sizeof(FMIValueReference)) != FMIOK ||
+            FMICalloc((void**)&group->endValueReferences, group->nValueReferences, sizeof(FMIValueReference)) != FMIOK) {
+            goto TERMINATE;
+        }
+
+        // filled with the connections below
+        group->nValueReferences = 0;
+
+        offsets[i] = system->valuesSize;
+        system->valuesSize += alignedSize(group->nValues * FMISizeOfVariableType(group->type, FMIMajorVersion3));
+
+        if (group->type == FMIBinaryType) {
+            sizeOffsets[i] = nSizes;
+            nSizes += group->nValues;
+        }
+    }
+
+    if (FMICalloc(&system->values, system->valuesSize + 1, 1) != FMIOK ||
+        FMICalloc(&system->previousValues, system->valuesSize + 1, 1) != FMIOK ||
+        FMICalloc((void**)&system->sizes, nSizes + 1, sizeof(size_t)) != FMIOK) {
+        goto TERMINATE;
+    }
+
+    for (size_t i = 0; i < system->nConnectionGroups; i++) {
+
+        FMIConnectionGroup* group = &system->connectionGroups[i];
+
+        group->values = (char*)system->values + offsets[i];
+        group->sizes = group->type == FMIBinaryType ? &system->sizes[sizeOffsets[i]] : NULL;
+    }
+
+    for (size_t i = 0; i < system->nConnections; i++) {
+
+        FMIConnection* connection = &system->connections[i];
+
+        const size_t j = groupIndices[i];
+
+        FMIConnectionGroup* group = &system->connectionGroups[j];
+
+        group->startValueReferences[group->nValueReferences] = connection->startVariable->valueReference;
+        group->endValueReferences[group->nValueReferences] = connection->endVariable->valueReference;
+        group->nValueReferences++;
+
+        const size_t offset = nFilledValues[j] * FMISizeOfVariableType(group->type, FMIMajorVersion3);
+
+        connection->values = (char*)group->values + offset;
+        connection->previousValues = (char*)system->previousValues + offsets[j] + offset;
+        connection->sizes = group->sizes ? &group->sizes[nFilledValues[j]] : NULL;
+
+        nFilledValues[j] += connection->nValues;
+    }
+
+    status = FMIOK;
+
+TERMINATE:
+
+    free(groupIndices);
+    free(offsets);
+    free(sizeOffsets);
+    free(nFilledValues);
+
+    return status;
+}
+
+static FMIStatus writeBlock(FILE* file, const FMIResultHeader* header, FMIResultBlock* block) {
+
+    const FMIStatus status = FMIWriteResultBlock(file, FMICSVFormat, header, block);
+
+    block->nRows = 0;
+
+    for (size_t i = 0; i < block->nColumns; i++) {
+        block->columns[i].length = 0;
+    }
+
+    return status;
+}
+
+/* append the values of the connections to the block and write it if it is full */
+static FMIStatus sample(const FMISystem* system, double time, FILE* file, const FMIResultHeader* header, FMIResultBlock* block) {
+
+    if (!file) {
+        return FMIOK;
+    }
+
+    for (size_t i = 0; i < system->nConnections; i++) {
+
+        const FMIConnection* connection = &system->connections[i];
+
+        if (FMIAppendResultValues(header, block, i, connection->values, connection->sizes, connection->nValues) != FMIOK) {
+            return FMIError;
+        }
+    }
+
+    block->time[block->nRows++] = time;
+
+    if (block->nRows == block->capacity) {
+        return writeBlock(file, header, block);
+    }
+
+    return FMIOK;
+}
+
+static FMIResultHeader* createResultHeader(const FMISystem* system) {
+
+    const FMIModelVariable** variables = NULL;
+
+    if (FMICalloc((void**)&variables, system->nConnections + 1, sizeof(FMIModelVariable*)) != FMIOK) {
+        return NULL;
+    }
+
+    for (size_t i = 0; i < system->nConnections; i++) {
+        variables[i] = system->connections[i].startVariable;
+    }
+
+    FMIResultHeader* header = FMICreateResultHeader(FMIMajorVersion3, system->nConnections, variables);
+
+    free(variables);
+
+    if (!header) {
+        return NULL;
+    }
+
+    // the columns are named COMPONENT.VARIABLE
+    for (size_t i = 0; i < system->nConnections; i++) {
+
+        const FMIConnection* connection = &system->connections[i];
+
+        const size_t length = strlen(connection->startComponent->name) + strlen(connection->startVariable->name) + 2;
+
+        char* name = NULL;
+
+        if (FMICalloc((void**)&name, length, sizeof(char)) != FMIOK) {
+            FMIFreeResultHeader(header);
+            return NULL;
+        }
+
+        snprintf(name, length, "%s.%s", connection->startComponent->name, connection->startVariable->name);
+
+        free(header->names[i]);
+        header->names[i] = name;
+    }
+
+    return header;
+}
+
+/* step the components from time to time + stepSize and exchange the values */
+static FMIStatus doMacroStep(FMISystem* system, FMIMasterAlgorithm algorithm, FMIThreadPool* pool, double time, double stepSize) {
+
+    FMIStatus status = FMIOK;
+
+    StepArgs args = { system, time, stepSize };
+
+    if (algorithm == FMIJacobi) {
+
+        FMIRunTasks(pool, doStep, &args, system->nComponents);
+
+        for (size_t i = 0; i < system->nComponents; i++) {
+            status = system->components[i].status > status ? system->components[i].status : status;
+        }
+
+        if (status > FMIWarning) {
+            return status;
+        }
+
+        const FMIStatus s = exchangeValues(system, NULL);
+
+        return s > status ? s : status;
+    }
+
+    for (size_t i = 0; i < system->nComponents; i++) {
+
+        doStep(&args, i);
+
+        status = system->components[i].status > status ? system->components[i].status : status;
+
+        if (status > FMIWarning) {
+            return status;
+        }
+
+        const FMIStatus s = exchangeValues(system, &system->components[i]);
+
+        status = s > status ? s : status;
+
+        if (status > FMIWarning) {
+            return status;
+        }
+    }
+
+    return status;
+}
+
+/* solve the algebraic loops and propagate the solution to the other connections */
+static FMIStatus solveLoops(FMISystem* system, FMILoopSolver* solver, FMIMasterStatistics* statistics, bool* converged) {
+
+    *converged = true;
+
+    if (!solver) {
+        return FMIOK;
+    }
+
+    size_t nIterations = 0;
+
+    const FMIStatus status = FMISolveLoops(solver, &nIterations, converged);
+
+    statistics->nLoopIterations += nIterations;
+
+    if (status > FMIWarning) {
+        return status;
+    }
+
+    const FMIStatus s = exchangeValues(system, NULL);
+
+    return s > status ? s : status;
+}
+
+/* save the FMU states to the snapshots of the components (which are reused after the first call) */
+static FMIStatus saveStates(FMISystem* system, FMIMasterStatistics* statistics) {
+
+    FMIStatus status = FMIOK;
+
+    const double startTime = FMIWallClockTime();
+
+    for (size_t i = 0; i < system->nComponents && status <= FMIWarning; i++) {
+
+        FMIComponent* component = &system->components[i];
+
+        const FMIStatus s = FMI3GetFMUState(component->instance, &component->state);
+
+        status = s > status ? s : status;
+    }
+
+    statistics->saveStateTime += FMIWallClockTime() - startTime;
+
+    return status;
+}
+
+static FMIStatus restoreStates(FMISystem* system, FMIMasterStatistics* statistics) {
+
+    FMIStatus status = FMIOK;
+
+    const double startTime = FMIWallClockTime();
+
+    for (size_t i = 0; i < system->nComponents && status <= FMIWarning; i++) {
+
+        FMIComponent* component = &system->components[i];
+
+        const FMIStatus s = FMI3SetFMUState(component->instance, component->state);
+
+        status = s > status ? s : status;
+    }
+
+    statistics->restoreStateTime += FMIWallClockTime() - startTime;
+
+    return status;
+}
+
+/* remember the values of the connections at the start of the step */
+static void savePreviousValues(FMISystem* system) {
+    memcpy(system->previousValues, system->values, system->valuesSize);
+}
+
+/* the change of the float connections during the step (i.e. the error of the inputs that have been held constant) relative to the tolerance */
+static double estimateError(const FMISystem* system, double tolerance) {
+
+    double error = 0;
+
+    for (size_t i = 0; i < system->nConnections; i++) {
+
+        const FMIConnection* connection = &system->connections[i];
+
+        if (!isFloatConnection(connection)) {
+            continue;
+        }
+
+        for (size_t j = 0; j < connection->nValues; j++) {
+
+            double previous, current;
+
+            if (connection->startVariable->type == FMIFloat32Type) {
+                previous = ((float*)connection->previousValues)[j];
+                current = ((float*)connection->values)[j];
+            } else {
+                previous = ((double*)connection->previousValues)[j];
+                current = ((double*)connection->values)[j];
+            }
+
+            const double scale = tolerance + tolerance * fmax(fabs(previous), fabs(current));
+
+            error = fmax(error, fabs(current - previous) / scale);
+        }
+    }
+
+    return error;
+}
+
+/* check that the components can reject steps */
+static FMIStatus checkVariableStepSize(const FMISystem* system) {
+
+    for (size_t i = 0; i < system->nComponents; i++) {
+
+        const FMIComponent* component = &system->components[i];
+
+        const FMICoSimulationInterface* coSimulation = component->modelDescription->coSimulation;
+
+        if (!coSimulation->canGetAndSetFMUState || !coSimulation->canHandleVariableCommunicationStepSize) {
+            FMILogError("%s cannot get and set the FMU state or handle a variable communication step size.", component->name);
+            return FMIError;
+        }
+    }
+
+    return FMIOK;
+}
+
+FMIStatus FMISimulateSystem(FMISystem* system, const FMIMasterSettings* settings, FMIMasterStatistics* statistics) {
+
+    FMIStatus status = FMIOK;
+
+    size_t nInstances = 0;
+
+    FMIThreadPool* pool = NULL;
+    FMILoopSolver* loopSolver = NULL;
+    FMIResultHeader* header = NULL;
+    FMIResultBlock* block = NULL;
+
+    double time = settings->startTime;
+
+    bool converged = true;
+
+    memset(statistics, 0, sizeof(FMIMasterStatistics));
+
+    if (settings->variableStepSize && checkVariableStepSize(system) != FMIOK) {
+        return FMIError;
+    }
+
+    if (settings->algorithm == FMIJacobi) {
+
+        const size_t nThreads = settings->nThreads > 0 ? settings->nThreads : system->nComponents;
+
+        pool = FMICreateThreadPool(nThreads);
+
+        if (!pool) {
+            return FMIError;
+        }
+    }
+
+    for (size_t i = 0; i < system->nComponents; i++) {
+
+        FMIComponent* component = &system->components[i];
+
+        CALL(FMI3InstantiateCoSimulation(component->instance,
+            component->modelDescription->instantiationToken, // instantiationToken
+            component->resourcePath,                         // resourcePath
+            fmi3False,                                       // visible
+            fmi3False,                                       // loggingOn
+            fmi3False,                                       // eventModeUsed
+            fmi3False,                                       // earlyReturnAllowed
+            NULL,                                            // requiredIntermediateVariables
+            0,                                               // nRequiredIntermediateVariables
+            NULL                                             // intermediateUpdate
+        ));
+
+        nInstances++;
+
+        CALL(FMIApplyStartValues(component->instance, component->nStartValues, component->startVariables, component->startValues));
+
+        CALL(FMI3EnterInitializationMode(component->instance, fmi3False, 0, time, fmi3True, settings->stopTime));
+    }
+
+    CALL(createArena(system));
+
+    // propagate the initial values in the order of the connections
+    CALL(exchangeValues(system, NULL));
+
+    if (settings->solveLoops) {
+
+        loopSolver = FMICreateLoopSolver(system, settings->loopTolerance, settings->maxLoopIterations);
+
+        if (!loopSolver) {
+            status = FMIError;
+            goto TERMINATE;
+        }
+
+        CALL(solveLoops(system, loopSolver, statistics, &converged));
+
+        if (!converged) {
+            FMILogError("The algebraic loops did not converge during the initialization.");
+            status = FMIError;
+            goto TERMINATE;
+        }
+    }
+
+    for (size_t i = 0; i < system->nComponents; i++) {
+        CALL(FMI3ExitInitializationMode(system->components[i].instance));
+    }
+
+    if (settings->outputFile) {
+
+        header = createResultHeader(system);
+
+        if (!header) {
+            status = FMIError;
+            goto TERMINATE;
+        }
+
+        block = FMICreateResultBlock(header, BLOCK_SIZE);
+
+        if (!block) {
+            status = FMIError;
+            goto TERMINATE;
+        }
+
+        CALL(FMIWriteResultHeader(settings->outputFile, FMICSVFormat, header));
+    }
+
+    CALL(sample(system, time, settings->outputFile, header, block));
+
+    if (settings->timingFile) {
+        fprintf(settings->timingFile, "step,time,wallClockTime\n");
+    }
+
+    statistics->minStepTime = INFINITY;
+
+    // the proposed step size for the variable step size
+    double stepSize = settings->stepSize;
+
+    for (;;) {
+
+        bool terminateSimulation = false;
+
+        for (size_t i = 0; i < system->nComponents; i++) {
+            terminateSimulation |= system->components[i].terminateSimulation;
+        }
+
+        if (terminateSimulation || time >= settings->stopTime) {
+            break;
+        }
+
+        double nextCommunicationPoint;
+
+        const double startTime = FMIWallClockTime();
+
+        if (settings->variableStepSize) {
+
+            double h = fmin(stepSize, settings->stopTime - time);
+
+            CALL(saveStates(system, statistics));
+
+            savePreviousValues(system);
+
+            for (;;) {
+
+                CALL(doMacroStep(system, settings->algorithm, pool, time, h));
+
+                CALL(solveLoops(system, loopSolver, statistics, &converged));
+
+                if (!converged && h <= settings->minStepSize) {
+                    FMILogError("The algebraic loops did not converge at t=%g with the minimum step size.", time + h);
+                    status = FMIError;
+                    goto TERMINATE;
+                }
+
+                // reject the step if the loops did not converge
+                const double error = converged ? estimateError(system, settings->tolerance) : INFINITY;
+
+                if (error <= 1 || h <= settings->minStepSize) {
+                    // the error is proportional to the step size
+                    const double factor = error > 0 ? fmin(2, fmax(0.2, 0.9 / error)) : 2;
+                    stepSize = fmin(settings->maxStepSize, fmax(settings->minStepSize, h * factor));
+                    break;
+                }
+
+                statistics->nRejectedSteps++;
+
+                CALL(restoreStates(system, statistics));
+
+                // restore the buffers and the inputs at the start of the step
+                CALL(exchangeValues(system, NULL));
+
+                h = fmax(settings->minStepSize, h * fmax(0.2, 0.9 / error));
+            }
+
+            nextCommunicationPoint = time + h;
+
+        } else {
+
+            nextCommunicationPoint = fmin(settings->startTime + (statistics->nSteps + 1) * settings->stepSize, settings->stopTime);
+
+            CALL(doMacroStep(system, settings->algorithm, pool, time, nextCommunicationPoint - time));
+
+            CALL(solveLoops(system, loopSolver, statistics, &converged));
+
+            if (!converged) {
+                FMILogError("The algebraic loops did not converge at t=%g.", nextCommunicationPoint);
+                status = FMIError;
+                goto TERMINATE;
+            }
+        }
+
+        const double stepTime = FMIWallClockTime() - startTime;
+
+        time = nextCommunicationPoint;
+
+        statistics->nSteps++;
+        statistics->totalStepTime += stepTime;
+        statistics->minStepTime = fmin(statistics->minStepTime, stepTime);
+        statistics->maxStepTime = fmax(statistics->maxStepTime, stepTime);
+
+        if (settings->timingFile) {
+            fprintf(settings->timingFile, "%" PRIu64 ",%.16g,%.9f\n", statistics->nSteps, time, stepTime);
+        }
+
+        CALL(sample(system, time, settings->outputFile, header, block));
+    }
+
+    if (block && block->nRows > 0) {
+        CALL(writeBlock(settings->outputFile, header, block));
+    }
+
+TERMINATE:
+
+    if (statistics->nSteps == 0) {
+        statistics->minStepTime = 0;
+    }
+
+    for (size_t i = 0; i < nInstances; i++) {
+
+        FMIComponent* component = &system->components[i];
+        FMIInstance* instance = component->instance;
+
+        if (component->state && status != FMIFatal) {
+            FMI3FreeFMUState(instance, &component->state);
+        }
+
+        if (status < FMIError) {
+
+            const FMIStatus terminateStatus = FMI3Terminate(instance);
+
+            if (terminateStatus > status) {
+                status = terminateStatus;
+            }
+        }
+
+        if (status != FMIFatal) {
+            FMI3FreeInstance(instance);
+        }
+    }
+
+    FMIFreeResultBlock(block);
+    FMIFreeResultHeader(header);
+    FMIFreeThreadPool(pool);
+    FMIFreeLoopSolver(loopSolver);
+
+    return status;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "FMISystem.h"
+
+
+typedef enum {
+    FMIJacobi,      // step all components concurrently with the inputs from the last communication point
+    FMIGaussSeidel  // step the components one after another in the order of the system file
+} FMIMasterAlgorithm;
+
+typedef struct {
+
+    FMIMasterAlgorithm algorithm;
+
+    double startTime;
+    double stopTime;
+    double stepSize;
+
+    // number of threads for the Jacobi algorithm (0 = one per component)
+    size_t nThreads;
+
+    // adapt the step size (starting with stepSize) to the change of the connected Float32 and Float64 values
+    bool variableStepSize;
+    double tolerance;
+    double minStepSize;
+    double maxStepSize;
+
+    // solve the algebraic loops of Float64 connections at the communication points
+    bool solveLoops;
+    double loopTolerance;
+    size_t maxLoopIterations;
+
+    // the values of the connections as CSV (or NULL)
+    FILE* outputFile;
+
+    // the wall-clock time of every macro step as CSV (or NULL)
+    FILE* timingFile;
+
+} FMIMasterSettings;
+
+typedef struct {
+
+    // accepted and rejected steps
+    uint64_t nSteps;
+    uint64_t nRejectedSteps;
+
+    // wall-clock time of the macro steps in seconds
+    double totalStepTime;
+    double minStepTime;
+    double maxStepTime;
+
+    // wall-clock time spent to get and set the FMU states in seconds
+    double saveStateTime;
+    double restoreStateTime;
+
+    // iterations of the algebraic loop solver
+    uint64_t nLoopIterations;
+
+} FMIMasterStatistics;
+
+/* simulate the system with a fixed or variable communication step size */
+FMIStatus FMISimulateSystem(FMISystem* system, const FMIMasterSettings* settings, FMIMasterStatistics* statistics);
+
+/* the wall-clock time in seconds (relative to an arbitrary point in time) */
+double FMIWallClockTime(void);
@@ -0,0 +1,469 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "FMI3.h"
+#include "FMIUtil.h"
+#include "FMIResult.h"
+#include "FMIThread.h"
+#include "FMIRecorder.h"
+
+
+#define OUTPUT_BUFFER_SIZE (1024 * 1024)
+
+// number of rows per block
+#define BLOCK_SIZE 1024
+
+// number of preallocated blocks
+#define N_BLOCKS 4
+
+/* variables of the same type that are retrieved with a single call */
+typedef struct {
+
+    FMIVariableType type;
+
+    size_t nVariables;
+    const FMIModelVariable** variables;
+    FMIValueReference* valueReferences;
+
+    // number and offset of the values of each variable
+    size_t* nValues;
+    size_t* offsets;
+    bool hasVariableSize;
+
+    size_t nTotalValues;
+    size_t valuesSize;
+    void* values;
+    size_t* sizes;
+
+} VariableGroup;
+
+struct FMIRecorder {
+
+    FMIInstance* instance;
+
+    FMIResultFormat format;
+
+    FILE* file;
+    char* fileBuffer;
+
+    size_t nVariables;
+    const FMIModelVariable** variables;
+
+    size_t nGroups;
+    VariableGroup* groups;
+
+    // group and offset of the values of each variable
+    size_t* groupIndices;
+    size_t* variableIndices;
+
+    bool initialized;
+
+    // decimation
+    double interval;
+    double startTime;
+    uint64_t nIntervals;
+    double nextTime;
+
+    FMIResultHeader* header;
+
+    // the block that is currently filled
+    FMIResultBlock* block;
+
+    // blocks that are ready to be written (ring buffer) and empty blocks (stack)
+    FMIResultBlock* blocks[N_BLOCKS];
+    FMIResultBlock* pending[N_BLOCKS];
+    size_t firstPending;
+    size_t nPending;
+    FMIResultBlock* available[N_BLOCKS];
+    size_t nAvailable;
+
+    // writer thread
+    FMIThread thread;
+    bool threadStarted;
+    FMIMutex mutex;
+    FMICondition condition;
+    bool writing;
+    bool stop;
+    FMIStatus writerStatus;
+
+};
+
+static FMIStatus updateSizes(FMIRecorder* recorder, VariableGroup* group) {
+
+    group->nTotalValues = 0;
+
+    for (size_t i = 0; i < group->nVariables; i++) {
+
+        if (FMIGetVariableSize(recorder->instance, group->variables[i], &group->nValues[i]) > FMIWarning) {
+            return FMIError;
+        }
+
+        group->offsets[i] = group->nTotalValues;
+        group->nTotalValues += group->nValues[i];
+    }
+
+    if (group->nTotalValues > group->valuesSize) {
+
+        group->valuesSize = group->nTotalValues;
+
+        if (FMIRealloc(&group->values, group->valuesSize * FMISizeOfVariableType(group->type, recorder->instance->fmiMajorVersion)) != FMIOK ||
+            FMIRealloc((void**)&group->sizes, group->valuesSize * sizeof(size_t)) != FMIOK) {
+            return FMIError;
+        }
+    }
+
+    return FMIOK;
+}
+
+static void writeBlocks(void* arg) {
+
+    FMIRecorder* recorder = (FMIRecorder*)arg;
+
+    FMILockMutex(&recorder->mutex);
+
+    for (;;) {
+
+        while (recorder->nPending == 0 && !recorder->stop) {
+            FMIWaitCondition(&recorder->condition, &recorder->mutex);
+        }
+
+        if (recorder->nPending == 0) {
+            break;
+        }
+
+        FMIResultBlock* block = recorder->pending[recorder->firstPending];
+
+        recorder->writing = true;
+
+        FMIUnlockMutex(&recorder->mutex);
+
+        // format and write the block without holding the lock
+        const FMIStatus status = recorder->writerStatus == FMIOK ?
+            FMIWriteResultBlock(recorder->file, recorder->format, recorder->header, block) : FMIError;
+
+        FMILockMutex(&recorder->mutex);
+
+        if (status != FMIOK) {
+            recorder->writerStatus = status;
+        }
+
+        recorder->firstPending = (recorder->firstPending + 1) % N_BLOCKS;
+        recorder->nPending--;
+        recorder->available[recorder->nAvailable++] = block;
+        recorder->writing = false;
+
+        FMIBroadcastCondition(&recorder->condition);
+    }
+
+    FMIUnlockMutex(&recorder->mutex);
+}
+
+/* hand the current block to the writer thread and continue with an empty block */
+static FMIStatus submitBlock(FMIRecorder* recorder) {
+
+    FMILockMutex(&recorder->mutex);
+
+    recorder->pending[(recorder->firstPending + recorder->nPending) % N_BLOCKS] = recorder->block;
+    recorder->nPending++;
+
+    FMIBroadcastCondition(&recorder->condition);
+
+    while (recorder->nAvailable == 0) {
+        FMIWaitCondition(&recorder->condition, &recorder->mutex);
+    }
+
+    recorder->block = recorder->available[--recorder->nAvailable];
+
+    const FMIStatus status = recorder->writerStatus;
+
+    FMIUnlockMutex(&recorder->mutex);
+
+    recorder->block->nRows = 0;
+
+    for (size_t i = 0; i < recorder->block->nColumns; i++) {
+        recorder->block->columns[i].length = 0;
+    }
+
+    return status;
+}
+
+FMIRecorder* FMICreateRecorder(FMIInstance* instance, size_t nVariables, const FMIModelVariable** variables, FMIResultFormat format, double interval, const char* filename) {
+
+    FMIRecorder* recorder = NULL;
+
+    if (FMICalloc((void**)&recorder, 1, sizeof(FMIRecorder)) != FMIOK) {
+        return NULL;
+    }
+
+    recorder->instance = instance;
+    recorder->format = format;
+    recorder->interval = interval;
+    recorder->nVariables = nVariables;
+
+    FMIInitMutex(&recorder->mutex);
+    FMIInitCondition(&recorder->condition);
+
+    if (FMICalloc((void**)&recorder->variables, nVariables + 1, sizeof(FMIModelVariable*)) != FMIOK ||
+        FMICalloc((void**)&recorder->groups, FMIClockType + 1, sizeof(VariableGroup)) != FMIOK ||
+        FMICalloc((void**)&recorder->groupIndices, nVariables + 1, sizeof(size_t)) != FMIOK ||
+        FMICalloc((void**)&recorder->variableIndices, nVariables + 1, sizeof(size_t)) != FMIOK) {
+        goto FAIL;
+    }
+
+    if (nVariables > 0) {
+        memcpy(recorder->variables, variables, nVariables * sizeof(FMIModelVariable*));
+    }
+
+    // group the variables by type
+    for (size_t i = 0; i < nVariables; i++) {
+
+        const FMIModelVariable* variable = variables[i];
+
+        size_t j;
+
+        for (j = 0; j < recorder->nGroups; j++) {
+            if (recorder->groups[j].type == variable->type) {
+                break;
+            }
+        }
+
+        VariableGroup* group = &recorder->groups[j];
+
+        if (j == recorder->nGroups) {
+
+            group->type = variable->type;
+
+            if (FMICalloc((void**)&group->variables, nVariables, sizeof(FMIModelVariable*)) != FMIOK ||
+                FMICalloc((void**)&group->valueReferences, nVariables, sizeof(FMIValueReference)) != FMIOK ||
+                FMICalloc((void**)&group->nValues, nVariables, sizeof(size_t)) != FMIOK ||
+                FMICalloc((void**)&group->offsets, nVariables, sizeof(size_t)) != FMIOK) {
+                goto FAIL;
+            }
+
+            recorder->nGroups++;
+        }
+
+        recorder->groupIndices[i] = j;
+        recorder->variableIndices[i] = group->nVariables;
+
+        group->variables[group->nVariables] = variable;
+        group->valueReferences[group->nVariables] = variable->valueReference;
+        group->nVariables++;
+
+        for (size_t k = 0; k < variable->nDimensions; k++) {
+            group->hasVariableSize |= variable->dimensions[k].variable != NULL;
+        }
+    }
+
+    recorder->header = FMICreateResultHeader(instance->fmiMajorVersion, nVariables, variables);
+
+    if (!recorder->header) {
+        goto FAIL;
+    }
+
+    for (size_t i = 0; i < N_BLOCKS; i++) {
+
+        recorder->blocks[i] = FMICreateResultBlock(recorder->header, BLOCK_SIZE);
+
+        if (!recorder->blocks[i]) {
+            goto FAIL;
+        }
+
+        recorder->available[recorder->nAvailable++] = recorder->blocks[i];
+    }
+
+    recorder->block = recorder->available[--recorder->nAvailable];
+
+    if (filename) {
+
+        recorder->file = fopen(filename, format == FMIBinaryFormat ? "wb" : "w");
+
+        if (!recorder->file) {
+            FMILogError("Failed to open %s.", filename);
+            goto FAIL;
+        }
+
+        if (FMICalloc((void**)&recorder->fileBuffer, OUTPUT_BUFFER_SIZE, 1) != FMIOK) {
+            goto FAIL;
+        }
+
+        setvbuf(recorder->file, recorder->fileBuffer, _IOFBF, OUTPUT_BUFFER_SIZE);
+
+    } else if (format == FMIBinaryFormat) {
+        FMILogError("The binary format requires an output file.");
+        goto FAIL;
+    } else {
+        recorder->file = stdout;
+    }
+
+    if (FMIWriteResultHeader(recorder->file, format, recorder->header) != FMIOK) {
+        goto FAIL;
+    }
+
+    if (FMICreateThread(&recorder->thread, writeBlocks, recorder) != FMIOK) {
+        goto FAIL;
+    }
+
+    recorder->threadStarted = true;
+
+    return recorder;
+
+FAIL:
+    FMIFreeRecorder(recorder);
+    return NULL;
+}
+
+FMIStatus FMIFlushRecorder(FMIRecorder* recorder) {
+
+    FMIStatus status = FMIOK;
+
+    if (recorder->block->nRows > 0) {
+        status = submitBlock(recorder);
+    }
+
+    FMILockMutex(&recorder->mutex);
+
+    // wait for the writer thread
+    while (recorder->nPending > 0 || recorder->writing) {
+        FMIWaitCondition(&recorder->condition, &recorder->mutex);
+    }
+
+    if (recorder->writerStatus > status) {
+        status = recorder->writerStatus;
+    }
+
+    FMIUnlockMutex(&recorder->mutex);
+
+    if (fflush(recorder->file)) {
+        FMILogError("Failed to write the result.");
+        status = FMIError;
+    }
+
+    return status;
+}
+
+void FMIFreeRecorder(FMIRecorder* recorder) {
+
+    if (!recorder) {
+        return;
+    }
+
+    if (recorder->threadStarted) {
+
+        FMIFlushRecorder(recorder);
+
+        FMILockMutex(&recorder->mutex);
+        recorder->stop = true;
+        FMIBroadcastCondition(&recorder->condition);
+        FMIUnlockMutex(&recorder->mutex);
+
+        FMIJoinThread(recorder->thread);
+    }
+
+    if (recorder->file && recorder->file != stdout) {
+        fclose(recorder->file);
+    }
+
+    if (recorder->groups) {
+        for (size_t i = 0; i < recorder->nGroups; i++) {
+            VariableGroup* group = &recorder->groups[i];
+            free(group->variables);
+            free(group->valueReferences);
+            free(group->nValues);
+            free(group->offsets);
+            free(group->values);
+            free(group->sizes);
+        }
+    }
+
+    for (size_t i = 0; i < N_BLOCKS; i++) {
+        FMIFreeResultBlock(recorder->blocks[i]);
+    }
+
+    FMIFreeResultHeader(recorder->header);
+
+    FMIDestroyCondition(&recorder->condition);
+    FMIDestroyMutex(&recorder->mutex);
+
+    free(recorder->fileBuffer);
+    free(recorder->groups);
+    free(recorder->groupIndices);
+    free(recorder->variableIndices);
+    free(recorder->variables);
+    free(recorder);
+}
+
+FMIStatus FMISample(FMIInstance* instance, double time, FMIRecorder* recorder, bool force) {
+
+    FMIStatus status = FMIOK;
+
+    // skip the samples between the output points
+    if (recorder->interval > 0) {
+
+        if (!recorder->initialized) {
+            recorder->startTime = time;
+            recorder->nextTime = time;
+        }
+
+        const bool due = time >= recorder->nextTime - 1e-9 * recorder->interval;
+
+        if (!due && !force) {
+            return FMIOK;
+        }
+
+        while (recorder->nextTime <= time + 1e-9 * recorder->interval) {
+            recorder->nextTime = recorder->startTime + (double)(++recorder->nIntervals) * recorder->interval;
+        }
+    }
+
+    for (size_t i = 0; i < recorder->nGroups; i++) {
+
+        VariableGroup* group = &recorder->groups[i];
+
+        if ((!recorder->initialized || group->hasVariableSize) && updateSizes(recorder, group) != FMIOK) {
+            return FMIError;
+        }
+
+        if (group->type == FMIClockType) {
+            // clocks cannot be retrieved outside of Event Mode
+            memset(group->values, 0, group->nTotalValues * sizeof(fmi3Clock));
+            continue;
+        }
+
+        const FMIStatus s = FMIGetValues(instance, group->type, group->valueReferences, group->nVariables, group->values, group->sizes, group->nTotalValues);
+
+        status = s > status ? s : status;
+
+        if (status > FMIWarning) {
+            return status;
+        }
+    }
+
+    recorder->initialized = true;
+
+    FMIResultBlock* block = recorder->block;
+
+    for (size_t i = 0; i < recorder->nVariables; i++) {
+
+        const VariableGroup* group = &recorder->groups[recorder->groupIndices[i]];
+
+        const size_t index = recorder->variableIndices[i];
+        const size_t offset = group->offsets[index];
+        const size_t size = FMISizeOfVariableType(group->type, instance->fmiMajorVersion);
+
+        if (FMIAppendResultValues(recorder->header, block, i, (char*)group->values + offset * size, group->sizes ? &group->sizes[offset] : NULL, group->nValues[index]) != FMIOK) {
+            return FMIError;
+        }
+    }
+
+    block->time[block->nRows++] = time;
+
+    if (block->nRows == block->capacity) {
+
+        const FMIStatus s = submitBlock(recorder);
+
+        status = s > status ? s : status;
+    }
+
+    return status;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stdio.h>
+
+#include "FMIModelDescription.h"
+#include "FMIResult.h"
+
+
+typedef struct FMIRecorder FMIRecorder;
+
+/* record the variables to a CSV or binary file (or CSV to stdout if filename is NULL) every interval (0 = every sample) */
+FMIRecorder* FMICreateRecorder(FMIInstance* instance, size_t nVariables, const FMIModelVariable** variables, FMIResultFormat format, double interval, const char* filename);
+
+/* wait until all samples have been written */
+FMIStatus FMIFlushRecorder(FMIRecorder* recorder);
+
+void FMIFreeRecorder(FMIRecorder* recorder);
+
+/* get the values of the recorded variables and append them to the current block (force to record between the output points, e.g. at events) */
+FMIStatus FMISample(FMIInstance* instance, double time, FMIRecorder* recorder, bool force);
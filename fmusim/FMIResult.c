@@ -0,0 +1,582 @@
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FMI2.h"
+#include "FMI3.h"
+#include "FMIUtil.h"
+#include "FMIResult.h"
+
+
+#define MAGIC "FMIRSLT1"
+
+#define BYTE_ORDER_MARK 0x01020304
+
+#define VARIABLE_SIZE UINT32_MAX
+
+FMIResultHeader* FMICreateResultHeader(FMIMajorVersion fmiMajorVersion, size_t nColumns, const FMIModelVariable** variables) {
+
+    FMIResultHeader* header = NULL;
+
+    if (FMICalloc((void**)&header, 1, sizeof(FMIResultHeader)) != FMIOK) {
+        return NULL;
+    }
+
+    header->fmiMajorVersion = fmiMajorVersion;
+    header->nColumns = nColumns;
+
+    if (FMICalloc((void**)&header->types, nColumns + 1, sizeof(FMIVariableType)) != FMIOK ||
+        FMICalloc((void**)&header->names, nColumns + 1, sizeof(char*)) != FMIOK) {
+        FMIFreeResultHeader(header);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < nColumns; i++) {
+
+        header->types[i] = variables[i]->type;
+        header->names[i] = strdup(variables[i]->name);
+
+        if (!header->names[i]) {
+            FMIFreeResultHeader(header);
+            return NULL;
+        }
+    }
+
+    return header;
+}
+
+void FMIFreeResultHeader(FMIResultHeader* header) {
+
+    if (!header) {
+        return;
+    }
+
+    if (header->names) {
+        for (size_t i = 0; i < header->nColumns; i++) {
+            free(header->names[i]);
+        }
+    }
+
+    free(header->types);
+    free(header->names);
+    free(header);
+}
+
+static FMIStatus reserveRows(FMIResultBlock* block, size_t capacity) {
+
+    if (capacity <= block->capacity) {
+        return FMIOK;
+    }
+
+    block->capacity = capacity;
+
+    if (FMIRealloc((void**)&block->time, capacity * sizeof(double)) != FMIOK) {
+        return FMIError;
+    }
+
+    for (size_t i = 0; i < block->nColumns; i++) {
+        if (FMIRealloc((void**)&block->columns[i].nValues, capacity * sizeof(size_t)) != FMIOK) {
+            return FMIError;
+        }
+    }
+
+    return FMIOK;
+}
+
+static FMIStatus reserveData(FMIResultColumn* column, size_t length) {
+
+    if (column->length + length <= column->size) {
+        return FMIOK;
+    }
+
+    size_t size = column->size ? column->size : 64;
+
+    while (size < column->length + length) {
+        size *= 2;
+    }
+
+    if (FMIRealloc((void**)&column->data, size) != FMIOK) {
+        return FMIError;
+    }
+
+    column->size = size;
+
+    return FMIOK;
+}
+
+FMIResultBlock* FMICreateResultBlock(const FMIResultHeader* header, size_t capacity) {
+
+    FMIResultBlock* block = NULL;
+
+    if (FMICalloc((void**)&block, 1, sizeof(FMIResultBlock)) != FMIOK) {
+        return NULL;
+    }
+
+    block->nColumns = header->nColumns;
+
+    if (FMICalloc((void**)&block->columns, header->nColumns + 1, sizeof(FMIResultColumn)) != FMIOK ||
+        reserveRows(block, capacity) != FMIOK) {
+        FMIFreeResultBlock(block);
+        return NULL;
+    }
+
+    // preallocate the data for scalar values
+    for (size_t i = 0; i < header->nColumns; i++) {
+        if (reserveData(&block->columns[i], capacity * FMISizeOfVariableType(header->types[i], header->fmiMajorVersion)) != FMIOK) {
+            FMIFreeResultBlock(block);
+            return NULL;
+        }
+    }
+
+    return block;
+}
+
+void FMIFreeResultBlock(FMIResultBlock* block) {
+
+    if (!block) {
+        return;
+    }
+
+    if (block->columns) {
+        for (size_t i = 0; i < block->nColumns; i++) {
+            free(block->columns[i].nValues);
+            free(block->columns[i].data);
+        }
+    }
+
+    free(block->columns);
+    free(block->time);
+    free(block);
+}
+
+FMIStatus FMIAppendResultValues(const FMIResultHeader* header, FMIResultBlock* block, size_t column, const void* values, const size_t sizes[], size_t nValues) {
+
+    FMIResultColumn* c = &block->columns[column];
+
+    const FMIVariableType type = header->types[column];
+
+    c->nValues[block->nRows] = nValues;
+
+    if (type == FMIStringType) {
+
+        for (size_t i = 0; i < nValues; i++) {
+
+            const char* value = ((const char**)values)[i];
+
+            if (!value) {
+                value = "";
+            }
+
+            const size_t length = strlen(value) + 1;
+
+            if (reserveData(c, length) != FMIOK) {
+                return FMIError;
+            }
+
+            memcpy(&c->data[c->length], value, length);
+            c->length += length;
+        }
+
+    } else if (type == FMIBinaryType) {
+
+        for (size_t i = 0; i < nValues; i++) {
+
+            const uint32_t size = (uint32_t)sizes[i];
+
+            if (reserveData(c, sizeof(size) + size) != FMIOK) {
+                return FMIError;
+            }
+
+            memcpy(&c->data[c->length], &size, sizeof(size));
+            c->length += sizeof(size);
+
+            if (size > 0) {
+                memcpy(&c->data[c->length], ((const void**)values)[i], size);
+                c->length += size;
+            }
+        }
+
+    } else {
+
+        const size_t length = nValues * FMISizeOfVariableType(type, header->fmiMajorVersion);
+
+        if (reserveData(c, length) != FMIOK) {
+            return FMIError;
+        }
+
+        if (length > 0) {
+            memcpy(&c->data[c->length], values, length);
+            c->length += length;
+        }
+    }
+
+    return FMIOK;
+}
+
+static FMIStatus writeBytes(FILE* file, const void* data, size_t length) {
+
+    if (length > 0 && fwrite(data, 1, length, file) != length) {
+        FMILogError("Failed to write the result.");
+        return FMIError;
+    }
+
+    return FMIOK;
+}
+
+static FMIStatus writeUInt32(FILE* file, uint32_t value) {
+    return writeBytes(file, &value, sizeof(value));
+}
+
+static void writeCSVString(FILE* file, const char* s) {
+
+    fputc('"', file);
+
+    for (; *s; s++) {
+        if (*s == '"') {
+            fputc('"', file);
+        }
+        fputc(*s, file);
+    }
+
+    fputc('"', file);
+}
+
+/* write a value and return the number of bytes consumed */
+static size_t writeCSVValue(FILE* file, FMIMajorVersion fmiMajorVersion, FMIVariableType type, const char* data) {
+
+    switch (type) {
+    case FMIFloat32Type: {
+        float v;
+        memcpy(&v, data, sizeof(v));
+        fprintf(file, "%.7g", v);
+        return sizeof(v);
+    }
+    case FMIFloat64Type: {
+        double v;
+        memcpy(&v, data, sizeof(v));
+        fprintf(file, "%.16g", v);
+        return sizeof(v);
+    }
+    case FMIInt8Type:
+        fprintf(file, "%" PRId8, *(const int8_t*)data);
+        return sizeof(int8_t);
+    case FMIUInt8Type:
+        fprintf(file, "%" PRIu8, *(const uint8_t*)data);
+        return sizeof(uint8_t);
+    case FMIInt16Type: {
+        int16_t v;
+        memcpy(&v, data, sizeof(v));
+        fprintf(file, "%" PRId16, v);
+        return sizeof(v);
+    }
+    case FMIUInt16Type: {
+        uint16_t v;
+        memcpy(&v, data, sizeof(v));
+        fprintf(file, "%" PRIu16, v);
+        return sizeof(v);
+    }
+    case FMIInt32Type: {
+        int32_t v;
+        memcpy(&v, data, sizeof(v));
+        fprintf(file, "%" PRId32, v);
+        return sizeof(v);
+    }
+    case FMIUInt32Type: {
+        uint32_t v;
+        memcpy(&v, data, sizeof(v));
+        fprintf(file, "%" PRIu32, v);
+        return sizeof(v);
+    }
+    case FMIInt64Type: {
+        int64_t v;
+        memcpy(&v, data, sizeof(v));
+        fprintf(file, "%" PRId64, v);
+        return sizeof(v);
+    }
+    case FMIUInt64Type: {
+        uint64_t v;
+        memcpy(&v, data, sizeof(v));
+        fprintf(file, "%" PRIu64, v);
+        return sizeof(v);
+    }
+    case FMIBooleanType:
+    case FMIClockType:
+        if (fmiMajorVersion == FMIMajorVersion2) {
+            fmi2Boolean v;
+            memcpy(&v, data, sizeof(v));
+            fprintf(file, "%d", v != 0);
+            return sizeof(v);
+        } else {
+            fprintf(file, "%d", *(const fmi3Boolean*)data != 0);
+            return sizeof(fmi3Boolean);
+        }
+    case FMIStringType:
+        writeCSVString(file, data);
+        return strlen(data) + 1;
+    case FMIBinaryType: {
+        uint32_t size;
+        memcpy(&size, data, sizeof(size));
+        for (uint32_t i = 0; i < size; i++) {
+            fprintf(file, "%02x", (unsigned char)data[sizeof(size) + i]);
+        }
+        return sizeof(size) + size;
+    }
+    default:
+        return 0;
+    }
+}
+
+FMIStatus FMIWriteResultHeader(FILE* file, FMIResultFormat format, const FMIResultHeader* header) {
+
+    if (format == FMICSVFormat) {
+
+        fputs("time", file);
+
+        for (size_t i = 0; i < header->nColumns; i++) {
+            fprintf(file, ",%s", header->names[i]);
+        }
+
+        fputc('\n', file);
+
+        return ferror(file) ? FMIError : FMIOK;
+    }
+
+    FMIStatus status = writeBytes(file, MAGIC, 8);
+
+    if (status == FMIOK) status = writeUInt32(file, BYTE_ORDER_MARK);
+    if (status == FMIOK) status = writeUInt32(file, (uint32_t)header->fmiMajorVersion);
+    if (status == FMIOK) status = writeUInt32(file, (uint32_t)header->nColumns);
+
+    for (size_t i = 0; i < header->nColumns && status == FMIOK; i++) {
+
+        const size_t length = strlen(header->names[i]);
+
+        status = writeUInt32(file, (uint32_t)header->types[i]);
+
+        if (status == FMIOK) status = writeUInt32(file, (uint32_t)length);
+        if (status == FMIOK) status = writeBytes(file, header->names[i], length);
+    }
+
+    return status;
+}
+
+FMIStatus FMIWriteResultBlock(FILE* file, FMIResultFormat format, const FMIResultHeader* header, const FMIResultBlock* block) {
+
+    if (block->nRows == 0) {
+        return FMIOK;
+    }
+
+    if (format == FMICSVFormat) {
+
+        // read position in the data of each column
+        size_t* offsets = NULL;
+
+        if (FMICalloc((void**)&offsets, header->nColumns + 1, sizeof(size_t)) != FMIOK) {
+            return FMIError;
+        }
+
+        for (size_t i = 0; i < block->nRows; i++) {
+
+            fprintf(file, "%.16g", block->time[i]);
+
+            for (size_t j = 0; j < header->nColumns; j++) {
+
+                const FMIResultColumn* column = &block->columns[j];
+
+                fputc(',', file);
+
+                for (size_t k = 0; k < column->nValues[i]; k++) {
+
+                    if (k > 0) {
+                        fputc(' ', file);
+                    }
+
+                    offsets[j] += writeCSVValue(file, header->fmiMajorVersion, header->types[j], &column->data[offsets[j]]);
+                }
+            }
+
+            fputc('\n', file);
+        }
+
+        free(offsets);
+
+        if (ferror(file)) {
+            FMILogError("Failed to write the result.");
+            return FMIError;
+        }
+
+        return FMIOK;
+    }
+
+    FMIStatus status = writeUInt32(file, (uint32_t)block->nRows);
+
+    if (status == FMIOK) status = writeBytes(file, block->time, block->nRows * sizeof(double));
+
+    for (size_t i = 0; i < block->nColumns && status == FMIOK; i++) {
+
+        const FMIResultColumn* column = &block->columns[i];
+
+        bool fixedSize = true;
+
+        for (size_t j = 1; j < block->nRows; j++) {
+            if (column->nValues[j] != column->nValues[0]) {
+                fixedSize = false;
+                break;
+            }
+        }
+
+        if (fixedSize) {
+            status = writeUInt32(file, (uint32_t)column->nValues[0]);
+        } else {
+            status = writeUInt32(file, VARIABLE_SIZE);
+            for (size_t j = 0; j < block->nRows && status == FMIOK; j++) {
+                status = writeUInt32(file, (uint32_t)column->nValues[j]);
+            }
+        }
+
+        const uint64_t length = column->length;
+
+        if (status == FMIOK) status = writeBytes(file, &length, sizeof(length));
+        if (status == FMIOK) status = writeBytes(file, column->data, column->length);
+    }
+
+    return status;
+}
+
+static FMIStatus readBytes(FILE* file, void* data, size_t length) {
+
+    if (length > 0 && fread(data, 1, length, file) != length) {
+        FMILogError("Unexpected end of the result file.");
+        return FMIError;
+    }
+
+    return FMIOK;
+}
+
+static FMIStatus readUInt32(FILE* file, uint32_t* value) {
+    return readBytes(file, value, sizeof(uint32_t));
+}
+
+FMIResultHeader* FMIReadResultHeader(FILE* file) {
+
+    char magic[8];
+    uint32_t byteOrderMark, fmiMajorVersion, nColumns;
+
+    if (readBytes(file, magic, 8) != FMIOK || memcmp(magic, MAGIC, 8)) {
+        FMILogError("The file is not a binary result file.");
+        return NULL;
+    }
+
+    if (readUInt32(file, &byteOrderMark) != FMIOK ||
+        readUInt32(file, &fmiMajorVersion) != FMIOK ||
+        readUInt32(file, &nColumns) != FMIOK) {
+        return NULL;
+    }
+
+    if (byteOrderMark != BYTE_ORDER_MARK) {
+        FMILogError("The result file was written with a different byte order.");
+        return NULL;
+    }
+
+    FMIResultHeader* header = NULL;
+
+    if (FMICalloc((void**)&header, 1, sizeof(FMIResultHeader)) != FMIOK) {
+        return NULL;
+    }
+
+    header->fmiMajorVersion = (FMIMajorVersion)fmiMajorVersion;
+    header->nColumns = nColumns;
+
+    if (FMICalloc((void**)&header->types, nColumns + 1, sizeof(FMIVariableType)) != FMIOK ||
+        FMICalloc((void**)&header->names, nColumns + 1, sizeof(char*)) != FMIOK) {
+        goto FAIL;
+    }
+
+    for (size_t i = 0; i < nColumns; i++) {
+
+        uint32_t type, length;
+
+        if (readUInt32(file, &type) != FMIOK || readUInt32(file, &length) != FMIOK) {
+            goto FAIL;
+        }
+
+        if (type > FMIClockType) {
+            FMILogError("Illegal variable type %" PRIu32 " in the result file.", type);
+            goto FAIL;
+        }
+
+        header->types[i] = (FMIVariableType)type;
+
+        if (FMICalloc((void**)&header->names[i], (size_t)length + 1, 1) != FMIOK ||
+            readBytes(file, header->names[i], length) != FMIOK) {
+            goto FAIL;
+        }
+    }
+
+    return header;
+
+FAIL:
+    FMIFreeResultHeader(header);
+    return NULL;
+}
+
+FMIStatus FMIReadResultBlock(FILE* file, const FMIResultHeader* header, FMIResultBlock* block) {
+
+    uint32_t nRows;
+
+    block->nRows = 0;
+
+    for (size_t i = 0; i < block->nColumns; i++) {
+        block->columns[i].length = 0;
+    }
+
+    if (fread(&nRows, 1, sizeof(nRows), file) != sizeof(nRows)) {
+        // end of the file
+        return FMIOK;
+    }
+
+    if (reserveRows(block, nRows) != FMIOK || readBytes(file, block->time, nRows * sizeof(double)) != FMIOK) {
+        return FMIError;
+    }
+
+    for (size_t i = 0; i < header->nColumns; i++) {
+
+        FMIResultColumn* column = &block->columns[i];
+
+        uint32_t nValues;
+        uint64_t length;
+
+        if (readUInt32(file, &nValues) != FMIOK) {
+            return FMIError;
+        }
+
+        for (size_t j = 0; j < nRows; j++) {
+
+            if (nValues == VARIABLE_SIZE) {
+
+                uint32_t n;
+
+                if (readUInt32(file, &n) != FMIOK) {
+                    return FMIError;
+                }
+
+                column->nValues[j] = n;
+
+            } else {
+                column->nValues[j] = nValues;
+            }
+        }
+
+        if (readBytes(file, &length, sizeof(length)) != FMIOK ||
+            reserveData(column, (size_t)length) != FMIOK ||
+            readBytes(file, column->data, (size_t)length) != FMIOK) {
+            return FMIError;
+        }
+
+        column->length = (size_t)length;
+    }
+
+    block->nRows = nRows;
+
+    return FMIOK;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <stdio.h>
+
+#include "FMIModelDescription.h"
+
+/*
+Binary result format (in the byte order of the writer):
+
+    char     magic[8]          "FMIRSLT1"
+    uint32   byteOrderMark     0x01020304
+    uint32   fmiMajorVersion
+    uint32   nColumns
+    nColumns times:
+        uint32   type          FMIVariableType
+        uint32   nameLength
+        char     name[nameLength]
+
+followed by blocks until the end of the file:
+
+    uint32   nRows
+    float64  time[nRows]
+    nColumns times:
+        uint32   nValues       number of values per row or UINT32_MAX if the number differs between rows
+        uint32   nValues[nRows] (only if the number differs between rows)
+        uint64   length
+        uint8    data[length]  the values of all rows (String: NUL-terminated, Binary: uint32 size + bytes,
+                               Boolean and Clock: fmi2Boolean or fmi3Boolean)
+*/
+
+typedef enum {
+    FMICSVFormat,
+    FMIBinaryFormat
+} FMIResultFormat;
+
+typedef struct {
+
+    FMIMajorVersion fmiMajorVersion;
+
+    size_t nColumns;
+    FMIVariableType* types;
+    char** names;
+
+} FMIResultHeader;
+
+/* the encoded values of a column */
+typedef struct {
+
+    // number of values per row
+    size_t* nValues;
+
+    size_t length;
+    size_t size;
+    char* data;
+
+} FMIResultColumn;
+
+/* a block of rows stored by column */
+typedef struct {
+
+    size_t capacity;
+    size_t nRows;
+    double* time;
+
+    size_t nColumns;
+    FMIResultColumn* columns;
+
+} FMIResultBlock;
+
+FMIResultHeader* FMICreateResultHeader(FMIMajorVersion fmiMajorVersion, size_t nColumns, const FMIModelVariable** variables);
+
+void FMIFreeResultHeader(FMIResultHeader* header);
+
+FMIResultBlock* FMICreateResultBlock(const FMIResultHeader* header, size_t capacity);
+
+void FMIFreeResultBlock(FMIResultBlock* block);
+
+/* append the values of a column to the row block->nRows (call for all columns before incrementing nRows) */
+FMIStatus FMIAppendResultValues(const FMIResultHeader* header, FMIResultBlock* block, size_t column, const void* values, const size_t sizes[], size_t nValues);
+
+FMIStatus FMIWriteResultHeader(FILE* file, FMIResultFormat format, const FMIResultHeader* header);
+
+FMIStatus FMIWriteResultBlock(FILE* file, FMIResultFormat format, const FMIResultHeader* header, const FMIResultBlock* block);
+
+/* read the header of a binary result file */
+FMIResultHeader* FMIReadResultHeader(FILE* file);
+
+/* read the next block of a binary result file (block->nRows is 0 at the end of the file) */
+FMIStatus FMIReadResultBlock(FILE* file, const FMIResultHeader* header, FMIResultBlock* block);
@@ -0,0 +1,80 @@
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+#include "FMIRootFinder.h"
+
+
+#define CALL(f) do { status = f; if (status > FMIWarning) return status; } while (0)
+
+// maximum number of event indicator evaluations
+#define MAX_ITERATIONS 100
+
+static bool signChanged(double z0, double z1) {
+    return (z0 <= 0 && z1 > 0) || (z0 > 0 && z1 <= 0);
+}
+
+static bool anySignChanged(size_t nz, const double z0[], const double z1[]) {
+
+    for (size_t i = 0; i < nz; i++) {
+        if (signChanged(z0[i], z1[i])) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+FMIStatus FMIFindRoot(FMISolver* solver, const FMISolverParameters* parameters, FMIRootFinderMoveTo* moveTo,
+    double t0, double z0[], double t1, double z1[], double z[], double* eventTime) {
+
+    FMIStatus status = FMIOK;
+
+    const size_t nz = parameters->nz;
+
+    const double tolerance = 100 * DBL_EPSILON * (fabs(t0) + fabs(t1 - t0));
+
+    // the weight of z0 in the secant (Illinois modification) and the bound that was replaced last (-1: t0, 1: t1)
+    double alpha = 1;
+    int side = 0;
+
+    for (size_t iteration = 0; iteration < MAX_ITERATIONS && t1 - t0 > tolerance; iteration++) {
+
+        // the earliest secant estimate of the indicators that have changed their sign
+        double t = t1;
+
+        for (size_t i = 0; i < nz; i++) {
+            if (signChanged(z0[i], z1[i])) {
+                t = fmin(t, t1 - (t1 - t0) * z1[i] / (z1[i] - alpha * z0[i]));
+            }
+        }
+
+        // move trial points that are too close to the bounds into the bracket (e.g. if an indicator is zero at t0)
+        const double fraction = (t1 - t0) / tolerance > 5 ? 0.1 : 0.5 * tolerance / (t1 - t0);
+
+        if (t - t0 < tolerance / 2) {
+            t = t0 + fraction * (t1 - t0);
+        } else if (t1 - t < tolerance / 2) {
+            t = t1 - fraction * (t1 - t0);
+        }
+
+        CALL(moveTo(solver, t));
+        CALL(parameters->getEventIndicators(parameters->instance, z, nz));
+
+        if (anySignChanged(nz, z0, z)) {
+            t1 = t;
+            memcpy(z1, z, nz * sizeof(double));
+            alpha = side == 1 ? alpha / 2 : 1;
+            side = 1;
+        } else {
+            t0 = t;
+            memcpy(z0, z, nz * sizeof(double));
+            alpha = side == -1 ? alpha * 2 : 1;
+            side = -1;
+        }
+    }
+
+    *eventTime = t1;
+
+    return moveTo(solver, t1);
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "FMISolver.h"
+
+
+/* set the FMU to the (interpolated) continuous states at time within the last step of the solver */
+typedef FMIStatus FMIRootFinderMoveTo(FMISolver* solver, double time);
+
+/* locate the first change of sign of the event indicators in [t0, t1] with the Illinois method. z0 and z1 are the
+   event indicators at t0 and t1 and are overwritten with the values at the bounds of the bracket, z is a buffer of
+   the same size. On return the FMU is at eventTime, the earliest time found at which an event indicator has changed
+   its sign. */
+FMIStatus FMIFindRoot(FMISolver* solver, const FMISolverParameters* parameters, FMIRootFinderMoveTo* moveTo,
+    double t0, double z0[], double t1, double z1[], double z[], double* eventTime);
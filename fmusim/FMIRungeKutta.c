@@ -0,0 +1,437 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FMIRootFinder.h"
+#include "FMIRungeKutta.h"
+
+
+#define CALL(f) do { status = f; if (status > FMIWarning) return status; } while (0)
+
+// relative tolerance if the FMU does not define one
+#define DEFAULT_TOLERANCE 1e-6
+
+#define N_STAGES 7
+
+// Dormand-Prince 5(4) coefficients (Hairer, Norsett, Wanner: Solving Ordinary Differential Equations I)
+static const double c[N_STAGES] = { 0, 1.0 / 5, 3.0 / 10, 4.0 / 5, 8.0 / 9, 1, 1 };
+
+static const double a[N_STAGES][N_STAGES - 1] = {
+    { 0 },
+    { 1.0 / 5 },
+    { 3.0 / 40, 9.0 / 40 },
+    { 44.0 / 45, -56.0 / 15, 32.0 / 9 },
+    { 19372.0 / 6561, -25360.0 / 2187, 64448.0 / 6561, -212.0 / 729 },
+    { 9017.0 / 3168, -355.0 / 33, 46732.0 / 5247, 49.0 / 176, -5103.0 / 18656 },
+    { 35.0 / 384, 0, 500.0 / 1113, 125.0 / 192, -2187.0 / 6784, 11.0 / 84 }
+};
+
+// difference between the 5th and 4th order weights
+static const double e[N_STAGES] = { 71.0 / 57600, 0, -71.0 / 16695, 71.0 / 1920, -17253.0 / 339200, 22.0 / 525, -1.0 / 40 };
+
+// coefficients of the continuous extension of order 4
+static const double d[N_STAGES] = {
+    -12715105075.0 / 11282082432, 0, 87487479700.0 / 32700410799, -10690763975.0 / 1880347072,
+    701980252875.0 / 199316789632, -1453857185.0 / 822651844, 69997945.0 / 29380423
+};
+
+struct FMISolverImpl {
+
+    FMISolverParameters p;
+
+    double tolerance;
+
+    // the last accepted step from previousTime to time and the proposed size of the next step
+    double previousTime;
+    double time;
+    double h;
+
+    // the continuous states at time, the stage states and the derivatives of the stages
+    double* x;
+    double* xs;
+    double* k[N_STAGES];
+
+    double* nominals;
+
+    // coefficients of the interpolation polynomial of the last step
+    double* r[5];
+
+    // the event indicators at time, before the change of sign and at the trial points of the root finder
+    double* z;
+    double* prez;
+    double* zt;
+
+    // k[0] holds the derivatives at time
+    bool fsal;
+
+    // the FMU is at time and x
+    bool instanceAtTime;
+
+    // an event indicator has changed its sign at eventTime in the last step
+    bool stateEvent;
+    double eventTime;
+
+};
+
+static void freeSolver(FMISolver* solver) {
+
+    if (!solver) {
+        return;
+    }
+
+    free(solver->x);
+    free(solver->xs);
+
+    for (size_t i = 0; i < N_STAGES; i++) {
+        free(solver->k[i]);
+    }
+
+    free(solver->nominals);
+
+    for (size_t i = 0; i < 5; i++) {
+        free(solver->r[i]);
+    }
+
+    free(solver->z);
+    free(solver->prez);
+    free(solver->zt);
+    free(solver);
+}
+
+FMISolver* FMIRungeKuttaCreate(const FMISolverParameters* parameters) {
+
+    FMISolver* solver = NULL;
+
+    if (FMICalloc((void**)&solver, 1, sizeof(FMISolver)) != FMIOK) {
+        return NULL;
+    }
+
+    solver->p = *parameters;
+    solver->tolerance = parameters->tolerance > 0 ? parameters->tolerance : DEFAULT_TOLERANCE;
+
+    const size_t nx = parameters->nx;
+    const size_t nz = parameters->nz;
+
+    bool allocated =
+        FMICalloc((void**)&solver->x, nx + 1, sizeof(double)) == FMIOK &&
+        FMICalloc((void**)&solver->xs, nx + 1, sizeof(double)) == FMIOK &&
+        FMICalloc((void**)&solver->nominals, nx + 1, sizeof(double)) == FMIOK &&
+        FMICalloc((void**)&solver->z, nz + 1, sizeof(double)) == FMIOK &&
+        FMICalloc((void**)&solver->prez, nz + 1, sizeof(double)) == FMIOK &&
+        FMICalloc((void**)&solver->zt, nz + 1, sizeof(double)) == FMIOK;
+
+    for (size_t i = 0; i < N_STAGES; i++) {
+        allocated &= FMICalloc((void**)&solver->k[i], nx + 1, sizeof(double)) == FMIOK;
+    }
+
+    for (size_t i = 0; i < 5; i++) {
+        allocated &= FMICalloc((void**)&solver->r[i], nx + 1, sizeof(double)) == FMIOK;
+    }
+
+    if (!allocated || FMIRungeKuttaReset(solver, parameters->startTime) > FMIWarning) {
+        freeSolver(solver);
+        return NULL;
+    }
+
+    return solver;
+}
+
+void FMIRungeKuttaFree(FMISolver* solver) {
+    freeSolver(solver);
+}
+
+/* set the time, continuous inputs and states */
+static FMIStatus setStates(FMISolver* solver, double time, const double x[]) {
+
+    FMIStatus status = FMIOK;
+
+    const FMISolverParameters* p = &solver->p;
+
+    CALL(p->setTime(p->instance, time));
+    CALL(p->applyInput(p->instance, p->input, time, false, true, false));
+
+    if (p->nx > 0) {
+        CALL(p->setContinuousStates(p->instance, x, p->nx));
+    }
+
+    return status;
+}
+
+static FMIStatus evaluate(FMISolver* solver, double time, const double x[], double dx[]) {
+
+    FMIStatus status = FMIOK;
+
+    const FMISolverParameters* p = &solver->p;
+
+    CALL(setStates(solver, time, x));
+
+    solver->instanceAtTime = false;
+
+    return p->getContinuousStateDerivatives(p->instance, dx, p->nx);
+}
+
+/* the weighted RMS norm of v with the absolute tolerances scaled by the nominals */
+static double norm(const FMISolver* solver, const double v[], const double x0[], const double x1[]) {
+
+    const size_t nx = solver->p.nx;
+
+    double sum = 0;
+
+    for (size_t i = 0; i < nx; i++) {
+        const double scale = solver->tolerance * solver->nominals[i] + solver->tolerance * fmax(fabs(x0[i]), fabs(x1[i]));
+        sum += (v[i] / scale) * (v[i] / scale);
+    }
+
+    return sqrt(sum / (double)nx);
+}
+
+/* get the event indicators and detect a change of sign since the last accepted step */
+static FMIStatus detectStateEvent(FMISolver* solver, bool* stateEvent) {
+
+    FMIStatus status = FMIOK;
+
+    const FMISolverParameters* p = &solver->p;
+
+    *stateEvent = false;
+
+    if (p->nz == 0) {
+        return FMIOK;
+    }
+
+    CALL(p->getEventIndicators(p->instance, solver->z, p->nz));
+
+    for (size_t i = 0; i < p->nz; i++) {
+        if ((solver->prez[i] <= 0 && solver->z[i] > 0) || (solver->prez[i] > 0 && solver->z[i] <= 0)) {
+            *stateEvent = true;
+        }
+    }
+
+    // keep the event indicators before the change of sign
+    if (!*stateEvent) {
+        memcpy(solver->prez, solver->z, p->nz * sizeof(double));
+    }
+
+    return status;
+}
+
+/* initial step size estimate h = 0.01 * ||x|| / ||dx|| */
+static double initialStepSize(const FMISolver* solver) {
+
+    const double d0 = norm(solver, solver->x, solver->x, solver->x);
+    const double d1 = norm(solver, solver->k[0], solver->x, solver->x);
+
+    return (d0 < 1e-5 || d1 < 1e-5) ? 1e-6 : 0.01 * d0 / d1;
+}
+
+/* set the FMU to the states at time (interpolated if time is before the end of the last step) */
+static FMIStatus moveTo(FMISolver* solver, double time) {
+
+    const size_t nx = solver->p.nx;
+
+    if (time == solver->time) {
+
+        if (solver->instanceAtTime) {
+            return FMIOK;
+        }
+
+        solver->instanceAtTime = true;
+
+        return setStates(solver, time, solver->x);
+    }
+
+    const double theta = (time - solver->previousTime) / (solver->time - solver->previousTime);
+
+    for (size_t j = 0; j < nx; j++) {
+        solver->xs[j] = solver->r[0][j] + theta * (solver->r[1][j] + (1 - theta) * (solver->r[2][j] + theta * (solver->r[3][j] + (1 - theta) * solver->r[4][j])));
+    }
+
+    solver->instanceAtTime = false;
+
+    return setStates(solver, time, solver->xs);
+}
+
+/* take one accepted step that does not go beyond maxTime */
+static FMIStatus doStep(FMISolver* solver, double maxTime) {
+
+    FMIStatus status = FMIOK;
+
+    const size_t nx = solver->p.nx;
+
+    if (!solver->fsal) {
+
+        CALL(evaluate(solver, solver->time, solver->x, solver->k[0]));
+
+        solver->instanceAtTime = true;
+        solver->fsal = true;
+
+        if (solver->h <= 0) {
+            solver->h = initialStepSize(solver);
+        }
+    }
+
+    for (;;) {
+
+        const bool lastStep = solver->time + solver->h >= maxTime;
+        const double h = lastStep ? maxTime - solver->time : solver->h;
+        const double nextTime = lastStep ? maxTime : solver->time + h;
+
+        for (size_t i = 1; i < N_STAGES; i++) {
+
+            for (size_t j = 0; j < nx; j++) {
+
+                double sum = 0;
+
+                for (size_t l = 0; l < i; l++) {
+                    sum += a[i][l] * solver->k[l][j];
+                }
+
+                solver->xs[j] = solver->x[j] + h * sum;
+            }
+
+            CALL(evaluate(solver, c[i] == 1 ? nextTime : solver->time + c[i] * h, solver->xs, solver->k[i]));
+        }
+
+        // the error estimate (in r[4] which is overwritten by the dense output)
+        double* error = solver->r[4];
+
+        for (size_t j = 0; j < nx; j++) {
+
+            double sum = 0;
+
+            for (size_t l = 0; l < N_STAGES; l++) {
+                sum += e[l] * solver->k[l][j];
+            }
+
+            error[j] = h * sum;
+        }
+
+        const double err = norm(solver, error, solver->x, solver->xs);
+
+        // the error is proportional to h^5
+        const double factor = err > 0 ? fmin(10, fmax(0.2, 0.9 * pow(err, -0.2))) : 10;
+
+        if (err > 1) {
+
+            solver->h = h * factor;
+
+            if (solver->h < 1e-14 * fmax(1, fabs(solver->time))) {
+                FMILogError("The step size became too small at t=%g.", solver->time);
+                return FMIError;
+            }
+
+            continue;
+        }
+
+        // dense output
+        for (size_t j = 0; j < nx; j++) {
+
+            const double dx = solver->xs[j] - solver->x[j];
+            const double bspl = h * solver->k[0][j] - dx;
+
+            double sum = 0;
+
+            for (size_t l = 0; l < N_STAGES; l++) {
+                sum += d[l] * solver->k[l][j];
+            }
+
+            solver->r[0][j] = solver->x[j];
+            solver->r[1][j] = dx;
+            solver->r[2][j] = bspl;
+            solver->r[3][j] = dx - h * solver->k[N_STAGES - 1][j] - bspl;
+            solver->r[4][j] = h * sum;
+        }
+
+        // the last stage is the solution at nextTime (first same as last)
+        memcpy(solver->x, solver->xs, nx * sizeof(double));
+
+        double* k0 = solver->k[0];
+        solver->k[0] = solver->k[N_STAGES - 1];
+        solver->k[N_STAGES - 1] = k0;
+
+        solver->previousTime = solver->time;
+        solver->time = nextTime;
+        solver->instanceAtTime = true;
+
+        // don't reduce the step size after a step that has been shortened to reach maxTime
+        solver->h = lastStep ? fmax(solver->h, h * factor) : h * factor;
+
+        CALL(detectStateEvent(solver, &solver->stateEvent));
+
+        if (solver->stateEvent) {
+            CALL(FMIFindRoot(solver, &solver->p, moveTo, solver->previousTime, solver->prez, solver->time, solver->z, solver->zt, &solver->eventTime));
+        }
+
+        return status;
+    }
+}
+
+FMIStatus FMIRungeKuttaStep(FMISolver* solver, double nextTime, double maxTime, double* timeReached, bool* stateEvent) {
+
+    FMIStatus status = FMIOK;
+
+    const FMISolverParameters* p = &solver->p;
+
+    *stateEvent = false;
+
+    if (p->nx == 0) {
+
+        // nothing to integrate
+        solver->previousTime = solver->time;
+        solver->time = nextTime;
+
+        CALL(setStates(solver, nextTime, NULL));
+        CALL(detectStateEvent(solver, stateEvent));
+
+        if (*stateEvent) {
+            CALL(FMIFindRoot(solver, p, moveTo, solver->previousTime, solver->prez, solver->time, solver->z, solver->zt, &nextTime));
+        }
+
+        *timeReached = nextTime;
+
+        return status;
+    }
+
+    while (solver->time < nextTime && !solver->stateEvent) {
+        CALL(doStep(solver, fmax(maxTime, nextTime)));
+    }
+
+    // report the event if it has been located before nextTime
+    if (solver->stateEvent && solver->eventTime <= nextTime) {
+        *stateEvent = true;
+        solver->stateEvent = false;
+        nextTime = solver->eventTime;
+    }
+
+    CALL(moveTo(solver, nextTime));
+
+    *timeReached = nextTime;
+
+    return status;
+}
+
+FMIStatus FMIRungeKuttaReset(FMISolver* solver, double time) {
+
+    FMIStatus status = FMIOK;
+
+    const FMISolverParameters* p = &solver->p;
+
+    solver->previousTime = time;
+    solver->time = time;
+    solver->fsal = false;
+    solver->instanceAtTime = true;
+    solver->stateEvent = false;
+
+    if (p->nx > 0) {
+
+        CALL(p->getContinuousStates(p->instance, solver->x, p->nx));
+        CALL(p->getNominalsOfContinuousStates(p->instance, solver->nominals, p->nx));
+
+        // the derivatives are calculated with the next step
+    }
+
+    if (p->nz > 0) {
+        CALL(p->getEventIndicators(p->instance, solver->prez, p->nz));
+    }
+
+    return status;
+}
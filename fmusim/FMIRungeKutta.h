@@ -0,0 +1,13 @@
+#pragma once
+
+#include "FMISolver.h"
+
+
+/* explicit Runge-Kutta method of order 5(4) (Dormand-Prince) with step size control and dense output */
+FMISolver* FMIRungeKuttaCreate(const FMISolverParameters* parameters);
+
+void FMIRungeKuttaFree(FMISolver* solver);
+
+FMIStatus FMIRungeKuttaStep(FMISolver* solver, double nextTime, double maxTime, double* timeReached, bool* stateEvent);
+
+FMIStatus FMIRungeKuttaReset(FMISolver* solver, double time);
@@ -0,0 +1,337 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "FMI3.h"
+#include "FMIUtil.h"
+#include "FMIServer.h"
+
+
+#define CALL(f) do { status = f; if (status > FMIWarning) goto TERMINATE; } while (0)
+
+struct FMIServer_ {
+
+    FMISystem* system;
+
+    // the response of the last request
+    uint8_t* response;
+    size_t responseSize;
+    size_t responseCapacity;
+
+    // aligned copies of the arguments
+    FMIValueReference* valueReferences;
+    double* values;
+    size_t nValues;
+
+};
+
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+} Reader;
+
+static bool readBytes(Reader* reader, void* values, size_t size) {
+
+    if (size > reader->size) {
+        return false;
+    }
+
+    memcpy(values, reader->data, size);
+
+    reader->data += size;
+    reader->size -= size;
+
+    return true;
+}
+
+static FMIStatus reserve(FMIServer* server, size_t size) {
+
+    if (server->responseSize + size <= server->responseCapacity) {
+        return FMIOK;
+    }
+
+    size_t capacity = server->responseCapacity > 0 ? server->responseCapacity : 1024;
+
+    while (capacity < server->responseSize + size) {
+        capacity *= 2;
+    }
+
+    FMIStatus status = FMIRealloc((void**)&server->response, capacity);
+
+    if (status == FMIOK) {
+        server->responseCapacity = capacity;
+    }
+
+    return status;
+}
+
+static FMIStatus writeBytes(FMIServer* server, const void* values, size_t size) {
+
+    FMIStatus status = reserve(server, size);
+
+    if (status == FMIOK && size > 0) {
+        memcpy(&server->response[server->responseSize], values, size);
+        server->responseSize += size;
+    }
+
+    return status;
+}
+
+static FMIStatus writeResult(FMIServer* server, FMIStatus callStatus, uint32_t nValues, const double values[]) {
+
+    const int32_t status = callStatus;
+
+    if (writeBytes(server, &status, sizeof(status)) != FMIOK ||
+        writeBytes(server, &nValues, sizeof(nValues)) != FMIOK) {
+        return FMIError;
+    }
+
+    return writeBytes(server, values, nValues * sizeof(double));
+}
+
+static FMIStatus initializeComponent(FMIComponent* component, double startTime) {
+
+    FMIStatus status = FMIOK;
+
+    CALL(FMIApplyStartValues(component->instance, component->nStartValues, component->startVariables, component->startValues));
+    CALL(FMI3EnterInitializationMode(component->instance, fmi3False, 0, startTime, fmi3False, 0));
+    CALL(FMI3ExitInitializationMode(component->instance));
+
+TERMINATE:
+    return status;
+}
+
+FMIServer* FMICreateServer(FMISystem* system, double startTime) {
+
+    FMIServer* server = NULL;
+
+    if (FMICalloc((void**)&server, 1, sizeof(FMIServer)) != FMIOK) {
+        return NULL;
+    }
+
+    server->system = system;
+
+    for (size_t i = 0; i < system->nComponents; i++) {
+
+        FMIComponent* component = &system->components[i];
+
+        const FMIStatus status = FMI3InstantiateCoSimulation(component->instance,
+            component->modelDescription->instantiationToken, // instantiationToken
+            component->resourcePath,                         // resourcePath
+            fmi3False,                                       // visible
+            fmi3False,                                       // loggingOn
+            fmi3False,                                       // eventModeUsed
+            fmi3False,                                       // earlyReturnAllowed
+            NULL,                                            // requiredIntermediateVariables
+            0,                                               // nRequiredIntermediateVariables
+            NULL                                             // intermediateUpdate
+        );
+
+        if (status > FMIWarning || initializeComponent(component, startTime) > FMIWarning) {
+            FMILogError("Failed to initialize %s.", component->name);
+            FMIFreeServer(server);
+            return NULL;
+        }
+    }
+
+    return server;
+}
+
+// copies n value references and (optionally) n values of a call to the aligned buffers
+static bool readArguments(FMIServer* server, Reader* reader, uint32_t n, bool values) {
+
+    if (n > server->nValues) {
+
+        if (FMIRealloc((void**)&server->valueReferences, n * sizeof(FMIValueReference)) != FMIOK ||
+            FMIRealloc((void**)&server->values, n * sizeof(double)) != FMIOK) {
+            return false;
+        }
+
+        server->nValues = n;
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+
+        uint32_t valueReference;
+
+        if (!readBytes(reader, &valueReference, sizeof(valueReference))) {
+            return false;
+        }
+
+        server->valueReferences[i] = valueReference;
+    }
+
+    return !values || readBytes(reader, server->values, n * sizeof(double));
+}
+
+FMIStatus FMIServerProcessRequest(FMIServer* server, const uint8_t* request, size_t size, const uint8_t** response, size_t* responseSize) {
+
+    Reader reader = { request, size };
+
+    uint32_t nCalls;
+
+    if (!readBytes(&reader, &nCalls, sizeof(nCalls))) {
+        FMILogError("The request is incomplete.");
+        return FMIError;
+    }
+
+    // the size is written when the response is complete
+    server->responseSize = 0;
+
+    const uint32_t placeholder = 0;
+
+    if (writeBytes(server, &placeholder, sizeof(placeholder)) != FMIOK ||
+        writeBytes(server, &nCalls, sizeof(nCalls)) != FMIOK) {
+        return FMIError;
+    }
+
+    for (uint32_t i = 0; i < nCalls; i++) {
+
+        uint32_t header[3];
+
+        if (!readBytes(&reader, header, sizeof(header))) {
+            FMILogError("Call %u of the request is incomplete.", i);
+            return FMIError;
+        }
+
+        const uint32_t function  = header[0];
+        const uint32_t index     = header[1];
+        const uint32_t n         = header[2];
+
+        FMIComponent* component = index < server->system->nComponents ? &server->system->components[index] : NULL;
+
+        FMIStatus status = FMIError;
+
+        uint32_t nValues = 0;
+
+        double values[4];
+
+        switch (function) {
+
+        case FMIServerSetFloat64:
+
+            if (!readArguments(server, &reader, n, true)) {
+                FMILogError("Call %u of the request is incomplete.", i);
+                return FMIError;
+            }
+
+            if (component) {
+                status = FMI3SetFloat64(component->instance, server->valueReferences, n, server->values, n);
+            }
+
+            break;
+
+        case FMIServerGetFloat64:
+
+            if (!readArguments(server, &reader, n, false)) {
+                FMILogError("Call %u of the request is incomplete.", i);
+                return FMIError;
+            }
+
+            if (component) {
+                status = FMI3GetFloat64(component->instance, server->valueReferences, n, server->values, n);
+                nValues = n;
+            }
+
+            break;
+
+        case FMIServerDoStep: {
+
+            double arguments[2];
+
+            if (!readBytes(&reader, arguments, sizeof(arguments))) {
+                FMILogError("Call %u of the request is incomplete.", i);
+                return FMIError;
+            }
+
+            if (component) {
+
+                fmi3Boolean eventHandlingNeeded = fmi3False;
+                fmi3Boolean terminateSimulation = fmi3False;
+                fmi3Boolean earlyReturn = fmi3False;
+                fmi3Float64 lastSuccessfulTime = arguments[0];
+
+                status = FMI3DoStep(component->instance, arguments[0], arguments[1], fmi3True,
+                    &eventHandlingNeeded, &terminateSimulation, &earlyReturn, &lastSuccessfulTime);
+
+                values[0] = lastSuccessfulTime;
+                values[1] = eventHandlingNeeded;
+                values[2] = terminateSimulation;
+                values[3] = earlyReturn;
+
+                nValues = 4;
+            }
+
+            break;
+        }
+
+        case FMIServerReset: {
+
+            double startTime;
+
+            if (!readBytes(&reader, &startTime, sizeof(startTime))) {
+                FMILogError("Call %u of the request is incomplete.", i);
+                return FMIError;
+            }
+
+            if (component) {
+
+                status = FMI3Reset(component->instance);
+
+                if (status <= FMIWarning) {
+                    status = initializeComponent(component, startTime);
+                }
+            }
+
+            break;
+        }
+
+        default:
+            FMILogError("Unknown function %u in call %u of the request.", function, i);
+            return FMIError;
+        }
+
+        if (!component) {
+            FMILogError("Component %u of call %u does not exist.", index, i);
+        }
+
+        if (writeResult(server, status, nValues, function == FMIServerGetFloat64 ? server->values : values) != FMIOK) {
+            return FMIError;
+        }
+    }
+
+    if (reader.size > 0) {
+        FMILogError("The request contains %zu bytes after the last call.", reader.size);
+        return FMIError;
+    }
+
+    const uint32_t responseBodySize = (uint32_t)(server->responseSize - sizeof(uint32_t));
+
+    memcpy(server->response, &responseBodySize, sizeof(responseBodySize));
+
+    *response = server->response;
+    *responseSize = server->responseSize;
+
+    return FMIOK;
+}
+
+void FMIFreeServer(FMIServer* server) {
+
+    if (!server) {
+        return;
+    }
+
+    for (size_t i = 0; i < server->system->nComponents; i++) {
+
+        FMIInstance* instance = server->system->components[i].instance;
+
+        if (instance && instance->component) {
+            FMI3Terminate(instance);
+            FMI3FreeInstance(instance);
+        }
+    }
+
+    free(server->response);
+    free(server->valueReferences);
+    free(server->values);
+    free(server);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "FMISystem.h"
+
+/*
+Batched request protocol of fmuserver. The integers and floats are in the byte order of the server and the
+fields are not padded.
+
+    request  = uint32 size, uint32 nCalls, call[nCalls]
+    call     = uint32 function, uint32 component, uint32 n, arguments
+    response = uint32 size, uint32 nResults, result[nResults]
+    result   = int32 status, uint32 nValues, float64 values[nValues]
+
+The size is the number of bytes that follow the size field and the component is the index of the component in
+the system file. The calls of a request are executed in order without the calls of other clients in between.
+*/
+typedef enum {
+
+    // arguments: uint32 valueReferences[n], float64 values[n]
+    FMIServerSetFloat64 = 1,
+
+    // arguments: uint32 valueReferences[n], result: float64 values[n]
+    FMIServerGetFloat64 = 2,
+
+    // arguments: float64 currentCommunicationPoint, float64 communicationStepSize,
+    // result: lastSuccessfulTime, eventHandlingNeeded, terminateSimulation, earlyReturn
+    FMIServerDoStep = 3,
+
+    // arguments: float64 startTime, resets the instance and applies the start values of the system file
+    FMIServerReset = 4
+
+} FMIServerFunction;
+
+#define FMI_SERVER_MAX_REQUEST_SIZE (64 * 1024 * 1024)
+
+typedef struct FMIServer_ FMIServer;
+
+/* instantiate and initialize the components of the system */
+FMIServer* FMICreateServer(FMISystem* system, double startTime);
+
+/* execute the calls of a request (without the size field) and return the response (with the size field) that is
+   valid until the next request */
+FMIStatus FMIServerProcessRequest(FMIServer* server, const uint8_t* request, size_t size, const uint8_t** response, size_t* responseSize);
+
+/* terminate and free the instances of the system */
+void FMIFreeServer(FMIServer* server);
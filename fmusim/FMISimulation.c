@@ -0,0 +1,51 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#define realpath(N,R) _fullpath((R),(N),MAX_PATH)
+#endif
+
+#include "FMISimulation.h"
+
+
+FMIStatus FMISimulate(FMIInstance* S, const FMIModelDescription* modelDescription, const char* unzipdir, const FMISimulationSettings* settings) {
+
+    char resourcePath[4096] = "";
+    char resourceURI[4096] = "";
+    char absolutePath[4096] = "";
+
+    if (!realpath(unzipdir, absolutePath)) {
+        FMILogError("Failed to resolve the path %s.", unzipdir);
+        return FMIError;
+    }
+
+    snprintf(resourcePath, sizeof(resourcePath), "%s" FMI_FILE_SEPARATOR "resources" FMI_FILE_SEPARATOR, absolutePath);
+
+    if (FMIPathToURI(resourcePath, resourceURI, sizeof(resourceURI)) != FMIOK) {
+        FMILogError("Failed to create the resource URI for %s.", resourcePath);
+        return FMIError;
+    }
+
+    if (modelDescription->fmiMajorVersion == FMIMajorVersion2) {
+
+        if (settings->interfaceType == FMICoSimulation) {
+            return FMISimulateFMI2CS(S, modelDescription, resourceURI, settings);
+        } else if (settings->interfaceType == FMIModelExchange) {
+            return FMISimulateFMI2ME(S, modelDescription, resourceURI, settings);
+        }
+
+    } else if (modelDescription->fmiMajorVersion == FMIMajorVersion3) {
+
+        if (settings->interfaceType == FMICoSimulation) {
+            return FMISimulateFMI3CS(S, modelDescription, resourcePath, settings);
+        } else if (settings->interfaceType == FMIModelExchange) {
+            return FMISimulateFMI3ME(S, modelDescription, resourcePath, settings);
+        }
+    }
+
+    FMILogError("The interface type is not supported.");
+
+    return FMIError;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "FMIModelDescription.h"
+#include "FMIInputTable.h"
+#include "FMIRecorder.h"
+#include "FMISolver.h"
+
+
+typedef struct {
+
+    FMIInterfaceType interfaceType;
+
+    double startTime;
+    double stopTime;
+    double stepSize;
+
+    // 0 if undefined
+    double tolerance;
+
+    size_t nStartValues;
+    const FMIModelVariable** startVariables;
+    const char** startValues;
+
+    FMIInputTable* input;
+    FMIRecorder* recorder;
+
+    // Model Exchange
+    FMISolverCreate* solverCreate;
+    FMISolverFree* solverFree;
+    FMISolverStep* solverStep;
+    FMISolverReset* solverReset;
+
+} FMISimulationSettings;
+
+/* simulate the unzipped FMU with the loaded platform binary */
+FMIStatus FMISimulate(FMIInstance* S, const FMIModelDescription* modelDescription, const char* unzipdir, const FMISimulationSettings* settings);
+
+FMIStatus FMISimulateFMI2CS(FMIInstance* S, const FMIModelDescription* modelDescription, const char* resourceURI, const FMISimulationSettings* settings);
+
+FMIStatus FMISimulateFMI2ME(FMIInstance* S, const FMIModelDescription* modelDescription, const char* resourceURI, const FMISimulationSettings* settings);
+
+FMIStatus FMISimulateFMI3CS(FMIInstance* S, const FMIModelDescription* modelDescription, const char* resourcePath, const FMISimulationSettings* settings);
+
+FMIStatus FMISimulateFMI3ME(FMIInstance* S, const FMIModelDescription* modelDescription, const char* resourcePath, const FMISimulationSettings* settings);
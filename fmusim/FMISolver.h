@@ -0,0 +1,59 @@
+#pragma once
+
+#include "FMI.h"
+#include "FMIInputTable.h"
+
+
+typedef struct FMISolverImpl FMISolver;
+
+typedef FMIStatus FMISolverSetTime(FMIInstance* instance, double time);
+
+typedef FMIStatus FMISolverApplyInput(FMIInstance* instance, FMIInputTable* input, double time, bool discrete, bool continuous, bool afterEvent);
+
+typedef FMIStatus FMISolverGetContinuousStates(FMIInstance* instance, double x[], size_t nx);
+
+typedef FMIStatus FMISolverSetContinuousStates(FMIInstance* instance, const double x[], size_t nx);
+
+typedef FMIStatus FMISolverGetNominalsOfContinuousStates(FMIInstance* instance, double x_nominal[], size_t nx);
+
+typedef FMIStatus FMISolverGetContinuousStateDerivatives(FMIInstance* instance, double dx[], size_t nx);
+
+typedef FMIStatus FMISolverGetEventIndicators(FMIInstance* instance, double z[], size_t nz);
+
+typedef FMIStatus FMISolverGetDirectionalDerivative(FMIInstance* instance, const FMIValueReference unknowns[], size_t nUnknowns, const FMIValueReference knowns[], size_t nKnowns, const double seed[], double sensitivity[]);
+
+typedef struct {
+
+    FMIInstance* instance;
+    const FMIModelDescription* modelDescription;
+    FMIInputTable* input;
+
+    double startTime;
+    double tolerance;
+
+    size_t nx;
+    size_t nz;
+
+    FMISolverSetTime* setTime;
+    FMISolverApplyInput* applyInput;
+    FMISolverGetContinuousStates* getContinuousStates;
+    FMISolverSetContinuousStates* setContinuousStates;
+    FMISolverGetNominalsOfContinuousStates* getNominalsOfContinuousStates;
+    FMISolverGetContinuousStateDerivatives* getContinuousStateDerivatives;
+    FMISolverGetEventIndicators* getEventIndicators;
+
+    // NULL if the FMU does not provide directional derivatives
+    FMISolverGetDirectionalDerivative* getDirectionalDerivative;
+
+} FMISolverParameters;
+
+typedef FMISolver* FMISolverCreate(const FMISolverParameters* parameters);
+
+typedef void FMISolverFree(FMISolver* solver);
+
+/* integrate from the current time to nextTime or until a state event is detected (variable step solvers may
+   step beyond nextTime up to maxTime and interpolate the continuous states at nextTime) */
+typedef FMIStatus FMISolverStep(FMISolver* solver, double nextTime, double maxTime, double* timeReached, bool* stateEvent);
+
+/* re-initialize the solver after an event */
+typedef FMIStatus FMISolverReset(FMISolver* solver, double time);
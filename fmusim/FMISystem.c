@@ -0,0 +1,363 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#define realpath(N,R) _fullpath((R),(N),MAX_PATH)
+#define strdup _strdup
+#endif
+
+#include "FMISystem.h"
+
+
+#define MAX_LINE_LENGTH 4096
+
+static char* skipSpace(char* s) {
+
+    while (isspace((unsigned char)*s)) {
+        s++;
+    }
+
+    return s;
+}
+
+/* terminate the token at s and return the start of the next token */
+static char* nextToken(char* s) {
+
+    while (*s && !isspace((unsigned char)*s)) {
+        s++;
+    }
+
+    if (*s) {
+        *s++ = '\0';
+    }
+
+    return skipSpace(s);
+}
+
+static void trimEnd(char* s) {
+
+    size_t length = strlen(s);
+
+    while (length > 0 && isspace((unsigned char)s[length - 1])) {
+        s[--length] = '\0';
+    }
+}
+
+static FMIStatus loadComponent(FMIComponent* component, const char* name, const char* unzipdir, FMILogMessage* logMessage, FMILogFunctionCall* logFunctionCall) {
+
+    component->name = strdup(name);
+    component->unzipdir = strdup(unzipdir);
+
+    if (!component->name || !component->unzipdir) {
+        return FMIError;
+    }
+
+    char path[4096] = "";
+
+    snprintf(path, sizeof(path), "%s" FMI_FILE_SEPARATOR "modelDescription.xml", unzipdir);
+
+    component->modelDescription = FMIReadModelDescription(path);
+
+    if (!component->modelDescription) {
+        FMILogError("Failed to read the model description of %s.", name);
+        return FMIError;
+    }
+
+    const FMIModelDescription* modelDescription = component->modelDescription;
+
+    if (modelDescription->fmiMajorVersion != FMIMajorVersion3 || !modelDescription->coSimulation) {
+        FMILogError("%s is not an FMI 3.0 FMU for Co-Simulation.", name);
+        return FMIError;
+    }
+
+    char absolutePath[4096] = "";
+
+    if (!realpath(unzipdir, absolutePath)) {
+        FMILogError("Failed to resolve the path %s.", unzipdir);
+        return FMIError;
+    }
+
+    snprintf(path, sizeof(path), "%s" FMI_FILE_SEPARATOR "resources" FMI_FILE_SEPARATOR, absolutePath);
+
+    component->resourcePath = strdup(path);
+
+    if (!component->resourcePath) {
+        return FMIError;
+    }
+
+    if (FMIPlatformBinaryPath(unzipdir, modelDescription->coSimulation->modelIdentifier, modelDescription->fmiMajorVersion, path, sizeof(path)) != FMIOK) {
+        return FMIError;
+    }
+
+    component->instance = FMICreateInstance(name, logMessage, logFunctionCall);
+
+    if (!component->instance) {
+        return FMIError;
+    }
+
+    component->instance->fmiMajorVersion = modelDescription->fmiMajorVersion;
+
+    return FMILoadPlatformBinary(component->instance, path);
+}
+
+/* find the component and variable for a name "COMPONENT.VARIABLE" */
+static FMIStatus findVariable(FMISystem* system, char* name, FMIComponent** component, const FMIModelVariable** variable) {
+
+    char* dot = strchr(name, '.');
+
+    if (!dot) {
+        FMILogError("Expected COMPONENT.VARIABLE but found %s.", name);
+        return FMIError;
+    }
+
+    *dot = '\0';
+
+    *component = NULL;
+
+    for (size_t i = 0; i < system->nComponents; i++) {
+        if (!strcmp(system->components[i].name, name)) {
+            *component = &system->components[i];
+            break;
+        }
+    }
+
+    *dot = '.';
+
+    if (!*component) {
+        FMILogError("The component of %s does not exist.", name);
+        return FMIError;
+    }
+
+    *variable = FMIModelVariableForName((*component)->modelDescription, dot + 1);
+
+    if (!*variable) {
+        FMILogError("The variable %s does not exist.", name);
+        return FMIError;
+    }
+
+    return FMIOK;
+}
+
+static FMIStatus addStartValue(FMISystem* system, char* name, const char* value) {
+
+    FMIComponent* component = NULL;
+    const FMIModelVariable* variable = NULL;
+
+    if (findVariable(system, name, &component, &variable) != FMIOK) {
+        return FMIError;
+    }
+
+    const size_t n = component->nStartValues + 1;
+
+    if (FMIRealloc((void**)&component->startVariables, n * sizeof(FMIModelVariable*)) != FMIOK ||
+        FMIRealloc((void**)&component->startValues, n * sizeof(char*)) != FMIOK) {
+        return FMIError;
+    }
+
+    component->startVariables[component->nStartValues] = variable;
+    component->startValues[component->nStartValues] = strdup(value);
+
+    if (!component->startValues[component->nStartValues]) {
+        return FMIError;
+    }
+
+    component->nStartValues = n;
+
+    return FMIOK;
+}
+
+static FMIStatus addConnection(FMISystem* system, char* start, char* end) {
+
+    FMIConnection* connection = &system->connections[system->nConnections];
+
+    if (findVariable(system, start, &connection->startComponent, &connection->startVariable) != FMIOK ||
+        findVariable(system, end, &connection->endComponent, &connection->endVariable) != FMIOK) {
+        return FMIError;
+    }
+
+    if (connection->startVariable->causality != FMIOutput) {
+        FMILogError("The start of the connection %s -> %s is not an output.", start, end);
+        return FMIError;
+    }
+
+    if (connection->endVariable->causality != FMIInput) {
+        FMILogError("The end of the connection %s -> %s is not an input.", start, end);
+        return FMIError;
+    }
+
+    if (connection->startVariable->type != connection->endVariable->type) {
+        FMILogError("The variables of the connection %s -> %s have different types.", start, end);
+        return FMIError;
+    }
+
+    if (connection->startVariable->type == FMIClockType) {
+        FMILogError("The connection %s -> %s connects clocks which is not supported.", start, end);
+        return FMIError;
+    }
+
+    system->nConnections++;
+
+    return FMIOK;
+}
+
+FMISystem* FMIReadSystem(const char* filename, FMILogMessage* logMessage, FMILogFunctionCall* logFunctionCall) {
+
+    FMISystem* system = NULL;
+    FILE* file = NULL;
+    char line[MAX_LINE_LENGTH];
+    size_t lineNumber = 0;
+    size_t nConnections = 0;
+    FMIStatus status = FMIOK;
+
+    if (FMICalloc((void**)&system, 1, sizeof(FMISystem)) != FMIOK) {
+        return NULL;
+    }
+
+    file = fopen(filename, "r");
+
+    if (!file) {
+        FMILogError("Failed to open %s.", filename);
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    // the components are read in the first pass so the other statements can refer to them
+    for (int pass = 0; pass < 2 && status == FMIOK; pass++) {
+
+        rewind(file);
+
+        lineNumber = 0;
+
+        while (status == FMIOK && fgets(line, sizeof(line), file)) {
+
+            lineNumber++;
+
+            if (!strchr(line, '\n') && !feof(file)) {
+                FMILogError("Line %zu of %s is too long.", lineNumber, filename);
+                status = FMIError;
+                break;
+            }
+
+            char* comment = strchr(line, '#');
+
+            if (comment) {
+                *comment = '\0';
+            }
+
+            trimEnd(line);
+
+            char* keyword = skipSpace(line);
+
+            if (!*keyword) {
+                continue;
+            }
+
+            char* first = nextToken(keyword);
+            char* second = nextToken(first);
+
+            if (!*first || !*second) {
+                FMILogError("Missing argument in line %zu of %s.", lineNumber, filename);
+                status = FMIError;
+            } else if (!strcmp(keyword, "component")) {
+
+                if (*nextToken(second)) {
+                    FMILogError("Unexpected argument in line %zu of %s.", lineNumber, filename);
+                    status = FMIError;
+                } else if (pass == 0) {
+                    status = FMIRealloc((void**)&system->components, (system->nComponents + 1) * sizeof(FMIComponent));
+                    if (status == FMIOK) {
+                        FMIComponent* component = &system->components[system->nComponents++];
+                        memset(component, 0, sizeof(FMIComponent));
+                        status = loadComponent(component, first, second, logMessage, logFunctionCall);
+                    }
+                }
+
+            } else if (!strcmp(keyword, "start")) {
+
+                if (pass == 1) {
+                    status = addStartValue(system, first, second);
+                }
+
+            } else if (!strcmp(keyword, "connection")) {
+
+                if (*nextToken(second)) {
+                    FMILogError("Unexpected argument in line %zu of %s.", lineNumber, filename);
+                    status = FMIError;
+                } else if (pass == 0) {
+                    nConnections++;
+                } else {
+                    status = addConnection(system, first, second);
+                }
+
+            } else {
+                FMILogError("Unknown statement \"%s\" in line %zu of %s.", keyword, lineNumber, filename);
+                status = FMIError;
+            }
+        }
+
+        if (pass == 0 && status == FMIOK) {
+            status = FMICalloc((void**)&system->connections, nConnections + 1, sizeof(FMIConnection));
+        }
+    }
+
+    if (status == FMIOK && system->nComponents == 0) {
+        FMILogError("%s does not contain any components.", filename);
+        status = FMIError;
+    }
+
+TERMINATE:
+
+    if (file) {
+        fclose(file);
+    }
+
+    if (status != FMIOK) {
+        FMIFreeSystem(system);
+        return NULL;
+    }
+
+    return system;
+}
+
+void FMIFreeSystem(FMISystem* system) {
+
+    if (!system) {
+        return;
+    }
+
+    for (size_t i = 0; i < system->nConnectionGroups; i++) {
+        free(system->connectionGroups[i].startValueReferences);
+        free(system->connectionGroups[i].endValueReferences);
+    }
+
+    free(system->connectionGroups);
+    free(system->values);
+    free(system->previousValues);
+    free(system->sizes);
+
+    for (size_t i = 0; i < system->nComponents; i++) {
+
+        FMIComponent* component = &system->components[i];
+
+        for (size_t j = 0; j < component->nStartValues; j++) {
+            free((void*)component->startValues[j]);
+        }
+
+        free(component->startVariables);
+        free(component->startValues);
+
+        FMIFreeInstance(component->instance);
+        FMIFreeModelDescription(component->modelDescription);
+
+        free(component->name);
+        free(component->unzipdir);
+        free(component->resourcePath);
+    }
+
+    free(system->components);
+    free(system->connections);
+    free(system);
+}
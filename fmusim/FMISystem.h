@@ -0,0 +1,97 @@
+#pragma once
+
+#include "FMIModelDescription.h"
+
+
+/* an FMU in a system */
+typedef struct {
+
+    char* name;
+    char* unzipdir;
+    char* resourcePath;
+
+    FMIModelDescription* modelDescription;
+    FMIInstance* instance;
+
+    size_t nStartValues;
+    const FMIModelVariable** startVariables;
+    const char** startValues;
+
+    // result of the last step
+    FMIStatus status;
+    bool terminateSimulation;
+
+    // snapshot of the FMU state for the rollback of rejected steps
+    void* state;
+
+} FMIComponent;
+
+/* a connection from an output to an input */
+typedef struct {
+
+    FMIComponent* startComponent;
+    const FMIModelVariable* startVariable;
+
+    FMIComponent* endComponent;
+    const FMIModelVariable* endVariable;
+
+    // the values in the arena of the system
+    size_t nValues;
+    void* values;
+    size_t* sizes;
+
+    // the values at the start of the step
+    void* previousValues;
+
+} FMIConnection;
+
+/* connections of the same type between the same components that are exchanged with a single get and set call */
+typedef struct {
+
+    FMIComponent* startComponent;
+    FMIComponent* endComponent;
+    FMIVariableType type;
+
+    size_t nValueReferences;
+    FMIValueReference* startValueReferences;
+    FMIValueReference* endValueReferences;
+
+    // the values of the connections in the arena of the system
+    size_t nValues;
+    void* values;
+    size_t* sizes;
+
+} FMIConnectionGroup;
+
+typedef struct {
+
+    size_t nComponents;
+    FMIComponent* components;
+
+    size_t nConnections;
+    FMIConnection* connections;
+
+    size_t nConnectionGroups;
+    FMIConnectionGroup* connectionGroups;
+
+    // contiguous memory for the values of all connections and a copy from the start of the step
+    size_t valuesSize;
+    void* values;
+    void* previousValues;
+    size_t* sizes;
+
+} FMISystem;
+
+/*
+Read a system from a text file with one statement per line:
+
+    # comment
+    component NAME UNZIPDIR
+    start COMPONENT.VARIABLE VALUE
+    connection COMPONENT.OUTPUT COMPONENT.INPUT
+
+and load the platform binaries of the components.
+*/
+FMISystem* FMIReadSystem(const char* filename, FMILogMessage* logMessage, FMILogFunctionCall* logFunctionCall);
+
+void FMIFreeSystem(FMISystem* system);
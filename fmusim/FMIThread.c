@@ -0,0 +1,135 @@
+#include <stdlib.h>
+
+#include "FMIThread.h"
+
+
+typedef struct {
+    FMIThreadFunction* function;
+    void* arg;
+} ThreadArgs;
+
+#ifdef _WIN32
+static DWORD WINAPI threadMain(LPVOID p) {
+#else
+static void* threadMain(void* p) {
+#endif
+
+    ThreadArgs args = *(ThreadArgs*)p;
+
+    free(p);
+
+    args.function(args.arg);
+
+#ifdef _WIN32
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+FMIStatus FMICreateThread(FMIThread* thread, FMIThreadFunction* function, void* arg) {
+
+    ThreadArgs* args = NULL;
+
+    if (FMICalloc((void**)&args, 1, sizeof(ThreadArgs)) != FMIOK) {
+        return FMIError;
+    }
+
+    args->function = function;
+    args->arg = arg;
+
+#ifdef _WIN32
+    *thread = CreateThread(NULL, 0, threadMain, args, 0, NULL);
+
+    if (!*thread) {
+#else
+    if (pthread_create(thread, NULL, threadMain, args)) {
+#endif
+        FMILogError("Failed to create thread.");
+        free(args);
+        return FMIError;
+    }
+
+    return FMIOK;
+}
+
+void FMIJoinThread(FMIThread thread) {
+#ifdef _WIN32
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+#else
+    pthread_join(thread, NULL);
+#endif
+}
+
+void FMIInitMutex(FMIMutex* mutex) {
+#ifdef _WIN32
+    InitializeCriticalSection(mutex);
+#else
+    pthread_mutex_init(mutex, NULL);
+#endif
+}
+
+void FMIDestroyMutex(FMIMutex* mutex) {
+#ifdef _WIN32
+    DeleteCriticalSection(mutex);
+#else
+    pthread_mutex_destroy(mutex);
+#endif
+}
+
+void FMILockMutex(FMIMutex* mutex) {
+#ifdef _WIN32
+    EnterCriticalSection(mutex);
+#else
+    pthread_mutex_lock(mutex);
+#endif
+}
+
+void FMIUnlockMutex(FMIMutex* mutex) {
+#ifdef _WIN32
+    LeaveCriticalSection(mutex);
+#else
+    pthread_mutex_unlock(mutex);
+#endif
+}
+
+void FMIInitCondition(FMICondition* condition) {
+#ifdef _WIN32
+    InitializeConditionVariable(condition);
+#else
+    pthread_cond_init(condition, NULL);
+#endif
+}
+
+void FMIDestroyCondition(FMICondition* condition) {
+#ifdef _WIN32
+    (void)condition;
+#else
+    pthread_cond_destroy(condition);
+#endif
+}
+
+void FMIWaitCondition(FMICondition* condition, FMIMutex* mutex) {
+#ifdef _WIN32
+    SleepConditionVariableCS(condition, mutex, INFINITE);
+#else
+    pthread_cond_wait(condition, mutex);
+#endif
+}
+
+void FMISignalCondition(FMICondition* condition) {
+#ifdef _WIN32
+    WakeConditionVariable(condition);
+#else
+    pthread_cond_signal(condition);
+#endif
+}
+
+void FMIBroadcastCondition(FMICondition* condition) {
+#ifdef _WIN32
+    WakeAllConditionVariable(condition);
+#else
+    pthread_cond_broadcast(condition);
+#endif
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include "FMI.h"
+
+
+#ifdef _WIN32
+typedef HANDLE FMIThread;
+typedef CRITICAL_SECTION FMIMutex;
+typedef CONDITION_VARIABLE FMICondition;
+#else
+typedef pthread_t FMIThread;
+typedef pthread_mutex_t FMIMutex;
+typedef pthread_cond_t FMICondition;
+#endif
+
+typedef void FMIThreadFunction(void* arg);
+
+FMIStatus FMICreateThread(FMIThread* thread, FMIThreadFunction* function, void* arg);
+
+void FMIJoinThread(FMIThread thread);
+
+void FMIInitMutex(FMIMutex* mutex);
+
+void FMIDestroyMutex(FMIMutex* mutex);
+
+void FMILockMutex(FMIMutex* mutex);
+
+void FMIUnlockMutex(FMIMutex* mutex);
+
+void FMIInitCondition(FMICondition* condition);
+
+void FMIDestroyCondition(FMICondition* condition);
+
+/* atomically release the mutex and wait until the condition is signaled */
+void FMIWaitCondition(FMICondition* condition, FMIMutex* mutex);
+
+void FMISignalCondition(FMICondition* condition);
+
+void FMIBroadcastCondition(FMICondition* condition);
@@ -0,0 +1,159 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "FMIThread.h"
+#include "FMIThreadPool.h"
+
+
+struct FMIThreadPool {
+
+    size_t nWorkers;
+    FMIThread* workers;
+
+    FMIMutex mutex;
+    FMICondition start;
+    FMICondition done;
+
+    // the current batch of tasks
+    uint64_t batch;
+    FMITaskFunction* function;
+    void* arg;
+    size_t nTasks;
+    size_t nextTask;
+    size_t nCompletedTasks;
+
+    bool terminate;
+};
+
+/* run the tasks of the current batch until all have been started (call with the mutex locked) */
+static void runTasks(FMIThreadPool* pool) {
+
+    while (pool->nextTask < pool->nTasks) {
+
+        const size_t index = pool->nextTask++;
+
+        FMIUnlockMutex(&pool->mutex);
+
+        pool->function(pool->arg, index);
+
+        FMILockMutex(&pool->mutex);
+
+        pool->nCompletedTasks++;
+
+        if (pool->nCompletedTasks == pool->nTasks) {
+            FMISignalCondition(&pool->done);
+        }
+    }
+}
+
+static void work(void* arg) {
+
+    FMIThreadPool* pool = (FMIThreadPool*)arg;
+
+    uint64_t batch = 0;
+
+    FMILockMutex(&pool->mutex);
+
+    for (;;) {
+
+        while (!pool->terminate && pool->batch == batch) {
+            FMIWaitCondition(&pool->start, &pool->mutex);
+        }
+
+        if (pool->terminate) {
+            break;
+        }
+
+        batch = pool->batch;
+
+        runTasks(pool);
+    }
+
+    FMIUnlockMutex(&pool->mutex);
+}
+
+FMIThreadPool* FMICreateThreadPool(size_t nThreads) {
+
+    FMIThreadPool* pool = NULL;
+
+    if (FMICalloc((void**)&pool, 1, sizeof(FMIThreadPool)) != FMIOK) {
+        return NULL;
+    }
+
+    FMIInitMutex(&pool->mutex);
+    FMIInitCondition(&pool->start);
+    FMIInitCondition(&pool->done);
+
+    if (nThreads > 1 && FMICalloc((void**)&pool->workers, nThreads - 1, sizeof(FMIThread)) != FMIOK) {
+        FMIFreeThreadPool(pool);
+        return NULL;
+    }
+
+    for (size_t i = 0; i + 1 < nThreads; i++) {
+
+        if (FMICreateThread(&pool->workers[i], work, pool) != FMIOK) {
+            FMIFreeThreadPool(pool);
+            return NULL;
+        }
+
+        pool->nWorkers++;
+    }
+
+    return pool;
+}
+
+void FMIFreeThreadPool(FMIThreadPool* pool) {
+
+    if (!pool) {
+        return;
+    }
+
+    FMILockMutex(&pool->mutex);
+    pool->terminate = true;
+    FMIBroadcastCondition(&pool->start);
+    FMIUnlockMutex(&pool->mutex);
+
+    for (size_t i = 0; i < pool->nWorkers; i++) {
+        FMIJoinThread(pool->workers[i]);
+    }
+
+    FMIDestroyCondition(&pool->done);
+    FMIDestroyCondition(&pool->start);
+    FMIDestroyMutex(&pool->mutex);
+
+    free(pool->workers);
+    free(pool);
+}
+
+void FMIRunTasks(FMIThreadPool* pool, FMITaskFunction* function, void* arg, size_t nTasks) {
+
+    if (pool->nWorkers == 0 || nTasks < 2) {
+
+        for (size_t i = 0; i < nTasks; i++) {
+            function(arg, i);
+        }
+
+        return;
+    }
+
+    FMILockMutex(&pool->mutex);
+
+    pool->function = function;
+    pool->arg = arg;
+    pool->nTasks = nTasks;
+    pool->nextTask = 0;
+    pool->nCompletedTasks = 0;
+    pool->batch++;
+
+    FMIBroadcastCondition(&pool->start);
+
+    // the calling thread works on the tasks too
+    runTasks(pool);
+
+    while (pool->nCompletedTasks < pool->nTasks) {
+        FMIWaitCondition(&pool->done, &pool->mutex);
+    }
+
+    FMIUnlockMutex(&pool->mutex);
+}
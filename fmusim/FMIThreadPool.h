@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "FMI.h"
+
+
+typedef struct FMIThreadPool FMIThreadPool;
+
+typedef void FMITaskFunction(void* arg, size_t index);
+
+/* create a pool that runs the tasks on nThreads threads (including the calling thread) */
+FMIThreadPool* FMICreateThreadPool(size_t nThreads);
+
+void FMIFreeThreadPool(FMIThreadPool* pool);
+
+/* call function(arg, index) for index = 0, ..., nTasks - 1 on the threads of the pool and wait until all calls have returned */
+void FMIRunTasks(FMIThreadPool* pool, FMITaskFunction* function, void* arg, size_t nTasks);
@@ -0,0 +1,684 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "FMI2.h"
+#include "FMI3.h"
+#include "FMIUtil.h"
+
+
+size_t FMISizeOfVariableType(FMIVariableType type, FMIMajorVersion fmiMajorVersion) {
+
+    switch (type) {
+    case FMIFloat32Type:
+        return sizeof(fmi3Float32);
+    case FMIFloat64Type:
+        return sizeof(fmi3Float64);
+    case FMIInt8Type:
+    case FMIUInt8Type:
+        return sizeof(fmi3Int8);
+    case FMIInt16Type:
+    case FMIUInt16Type:
+        return sizeof(fmi3Int16);
+    case FMIInt32Type:
+    case FMIUInt32Type:
+        return sizeof(fmi3Int32);
+    case FMIInt64Type:
+    case FMIUInt64Type:
+        return sizeof(fmi3Int64);
+    case FMIBooleanType:
+        return fmiMajorVersion == FMIMajorVersion2 ? sizeof(fmi2Boolean) : sizeof(fmi3Boolean);
+    case FMIStringType:
+        return sizeof(fmi3String);
+    case FMIBinaryType:
+        return sizeof(fmi3Binary);
+    case FMIClockType:
+        return sizeof(fmi3Clock);
+    default:
+        return 0;
+    }
+}
+
+static int hexValue(char c) {
+
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+
+    return -1;
+}
+
+static FMIStatus parseBinary(const char* literal, size_t* size, unsigned char** value) {
+
+    if (!strncmp(literal, "0x", 2)) {
+        literal += 2;
+    }
+
+    const size_t length = strlen(literal);
+
+    if (length % 2) {
+        FMILogError("Binary literal \"%s\" must have an even number of hex digits.", literal);
+        return FMIError;
+    }
+
+    *size = length / 2;
+    *value = NULL;
+
+    if (FMICalloc((void**)value, *size + 1, 1) != FMIOK) {
+        return FMIError;
+    }
+
+    for (size_t i = 0; i < *size; i++) {
+
+        const int high = hexValue(literal[2 * i]);
+        const int low = hexValue(literal[2 * i + 1]);
+
+        if (high < 0 || low < 0) {
+            FMILogError("Illegal binary literal \"%s\".", literal);
+            FMIFree((void**)value);
+            return FMIError;
+        }
+
+        (*value)[i] = (unsigned char)(high << 4 | low);
+    }
+
+    return FMIOK;
+}
+
+static bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static bool startsWithIgnoreCase(const char* s, const char* prefix) {
+
+    for (; *prefix; s++, prefix++) {
+        if ((*s | 0x20) != *prefix) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+double FMIParseDouble(const char* literal, char** end) {
+
+    // exact powers of ten in double precision
+    static const double exact[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    const char* s = literal;
+
+    *end = (char*)literal;
+
+    const bool negative = *s == '-';
+
+    if (*s == '-' || *s == '+') {
+        s++;
+    }
+
+    if (startsWithIgnoreCase(s, "inf")) {
+        s += startsWithIgnoreCase(s, "infinity") ? 8 : 3;
+        *end = (char*)s;
+        return negative ? -INFINITY : INFINITY;
+    }
+
+    if (startsWithIgnoreCase(s, "nan")) {
+        *end = (char*)s + 3;
+        return NAN;
+    }
+
+    const char* integerDigits = s;
+
+    while (*s >= '0' && *s <= '9') {
+        s++;
+    }
+
+    const size_t nIntegerDigits = s - integerDigits;
+
+    const char* fractionDigits = s;
+    size_t nFractionDigits = 0;
+
+    if (*s == '.') {
+
+        fractionDigits = ++s;
+
+        while (*s >= '0' && *s <= '9') {
+            s++;
+        }
+
+        nFractionDigits = s - fractionDigits;
+    }
+
+    if (nIntegerDigits == 0 && nFractionDigits == 0) {
+        return 0;
+    }
+
+    int exponent = 0;
+
+    if (*s == 'e' || *s == 'E') {
+
+        const char* e = s + 1;
+        const bool negativeExponent = *e == '-';
+
+        if (*e == '-' || *e == '+') {
+            e++;
+        }
+
+        if (*e >= '0' && *e <= '9') {
+
+            for (; *e >= '0' && *e <= '9'; e++) {
+                if (exponent < 100000) {
+                    exponent = 10 * exponent + (*e - '0');
+                }
+            }
+
+            if (negativeExponent) {
+                exponent = -exponent;
+            }
+
+            s = e;
+        }
+    }
+
+    *end = (char*)s;
+
+    // the digits without the decimal point times 10^exponent
+    exponent -= (int)nFractionDigits;
+
+    uint64_t mantissa = 0;
+    size_t nDigits = 0;
+
+    for (size_t i = 0; i < nIntegerDigits + nFractionDigits; i++) {
+
+        const char c = i < nIntegerDigits ? integerDigits[i] : fractionDigits[i - nIntegerDigits];
+
+        if (nDigits == 0 && c == '0') {
+            continue;  // leading zero
+        }
+
+        if (++nDigits > 19) {
+            break;
+        }
+
+        mantissa = 10 * mantissa + (uint64_t)(c - '0');
+    }
+
+    double value;
+
+    if (mantissa == 0) {
+
+        value = 0;
+
+    } else if (nDigits <= 19 && mantissa <= (UINT64_C(1) << 53) && exponent >= -22 && exponent <= 22) {
+
+        // both operands are exact so the result is correctly rounded
+        value = exponent < 0 ? (double)mantissa / exact[-exponent] : (double)mantissa * exact[exponent];
+
+    } else {
+
+        // pass the digits without a decimal point to strtod() which makes the result independent of the locale
+        char buffer[800];
+        size_t length = 0;
+
+        for (size_t i = 0; i < nIntegerDigits + nFractionDigits && length < sizeof(buffer) - 16; i++) {
+            buffer[length++] = i < nIntegerDigits ? integerDigits[i] : fractionDigits[i - nIntegerDigits];
+        }
+
+        const int truncated = (int)(nIntegerDigits + nFractionDigits - length);
+
+        snprintf(&buffer[length], sizeof(buffer) - length, "e%d", exponent + truncated);
+
+        value = strtod(buffer, NULL);
+    }
+
+    return negative ? -value : value;
+}
+
+FMIStatus FMIParseNumericValues(FMIMajorVersion fmiMajorVersion, FMIVariableType type, const char* literal, void* values, size_t capacity, size_t* nValues) {
+
+    *nValues = 0;
+
+    const char* s = literal;
+
+    while (*s) {
+
+        while (isSpace(*s)) {
+            s++;
+        }
+
+        if (!*s) {
+            break;
+        }
+
+        if (*nValues == capacity) {
+            FMILogError("Too many values in \"%s\".", literal);
+            return FMIError;
+        }
+
+        char* end = NULL;
+
+        const size_t i = *nValues;
+
+        switch (type) {
+        case FMIFloat32Type:
+            ((fmi3Float32*)values)[i] = (fmi3Float32)FMIParseDouble(s, &end);
+            break;
+        case FMIFloat64Type:
+            ((fmi3Float64*)values)[i] = FMIParseDouble(s, &end);
+            break;
+        case FMIInt8Type:
+            ((fmi3Int8*)values)[i] = (fmi3Int8)strtol(s, &end, 10);
+            break;
+        case FMIUInt8Type:
+            ((fmi3UInt8*)values)[i] = (fmi3UInt8)strtoul(s, &end, 10);
+            break;
+        case FMIInt16Type:
+            ((fmi3Int16*)values)[i] = (fmi3Int16)strtol(s, &end, 10);
+            break;
+        case FMIUInt16Type:
+            ((fmi3UInt16*)values)[i] = (fmi3UInt16)strtoul(s, &end, 10);
+            break;
+        case FMIInt32Type:
+            ((fmi3Int32*)values)[i] = (fmi3Int32)strtol(s, &end, 10);
+            break;
+        case FMIUInt32Type:
+            ((fmi3UInt32*)values)[i] = (fmi3UInt32)strtoul(s, &end, 10);
+            break;
+        case FMIInt64Type:
+            ((fmi3Int64*)values)[i] = (fmi3Int64)strtoll(s, &end, 10);
+            break;
+        case FMIUInt64Type:
+            ((fmi3UInt64*)values)[i] = (fmi3UInt64)strtoull(s, &end, 10);
+            break;
+        case FMIBooleanType:
+        case FMIClockType: {
+            bool value;
+            if (!strncmp(s, "true", 4)) {
+                value = true;
+                end = (char*)s + 4;
+            } else if (!strncmp(s, "false", 5)) {
+                value = false;
+                end = (char*)s + 5;
+            } else {
+                value = strtol(s, &end, 10) != 0;
+            }
+            if (fmiMajorVersion == FMIMajorVersion2) {
+                ((fmi2Boolean*)values)[i] = value;
+            } else {
+                ((fmi3Boolean*)values)[i] = value;
+            }
+            break;
+        }
+        default:
+            break;
+        }
+
+        if (!end || end == s || (*end && !isSpace(*end))) {
+            FMILogError("Failed to parse \"%s\" as %s.", literal, FMIVariableTypeToString(type));
+            return FMIError;
+        }
+
+        (*nValues)++;
+
+        s = end;
+    }
+
+    return FMIOK;
+}
+
+FMIStatus FMIParseValues(FMIMajorVersion fmiMajorVersion, FMIVariableType type, const char* literal, size_t* nValues, void** values, size_t** sizes) {
+
+    *nValues = 0;
+    *values = NULL;
+
+    if (sizes) {
+        *sizes = NULL;
+    }
+
+    if (!literal) {
+        return FMIOK;
+    }
+
+    if (type == FMIStringType) {
+
+        if (FMICalloc(values, 1, sizeof(char*)) != FMIOK) {
+            return FMIError;
+        }
+
+        *nValues = 1;
+        ((char**)*values)[0] = strdup(literal);
+
+        return FMIOK;
+    }
+
+    if (type == FMIBinaryType) {
+
+        if (!sizes || FMICalloc(values, 1, sizeof(unsigned char*)) != FMIOK || FMICalloc((void**)sizes, 1, sizeof(size_t)) != FMIOK) {
+            return FMIError;
+        }
+
+        *nValues = 1;
+
+        return parseBinary(literal, *sizes, (unsigned char**)*values);
+    }
+
+    const size_t size = FMISizeOfVariableType(type, fmiMajorVersion);
+
+    // upper bound of the number of values
+    size_t capacity = 1;
+
+    for (const char* c = literal; *c; c++) {
+        if (*c == ' ') {
+            capacity++;
+        }
+    }
+
+    if (FMICalloc(values, capacity, size) != FMIOK) {
+        return FMIError;
+    }
+
+    if (FMIParseNumericValues(fmiMajorVersion, type, literal, *values, capacity, nValues) != FMIOK) {
+        FMIFree(values);
+        *nValues = 0;
+        return FMIError;
+    }
+
+    return FMIOK;
+}
+
+void FMIFreeValues(FMIVariableType type, size_t nValues, void* values, size_t* sizes) {
+
+    if (values && (type == FMIStringType || type == FMIBinaryType)) {
+        for (size_t i = 0; i < nValues; i++) {
+            free(((void**)values)[i]);
+        }
+    }
+
+    free(values);
+    free(sizes);
+}
+
+FMIStatus FMIGetValues(FMIInstance* instance, FMIVariableType type, const FMIValueReference valueReferences[], size_t nValueReferences, void* values, size_t sizes[], size_t nValues) {
+
+    if (instance->fmiMajorVersion == FMIMajorVersion2) {
+
+        switch (type) {
+        case FMIRealType:
+            return FMI2GetReal(instance, valueReferences, nValueReferences, (fmi2Real*)values);
+        case FMIIntegerType:
+            return FMI2GetInteger(instance, valueReferences, nValueReferences, (fmi2Integer*)values);
+        case FMIBooleanType:
+            return FMI2GetBoolean(instance, valueReferences, nValueReferences, (fmi2Boolean*)values);
+        case FMIStringType:
+            return FMI2GetString(instance, valueReferences, nValueReferences, (fmi2String*)values);
+        default:
+            FMILogError("Variable type %s is not supported for FMI 2.0.", FMIVariableTypeToString(type));
+            return FMIError;
+        }
+    }
+
+    switch (type) {
+    case FMIFloat32Type:
+        return FMI3GetFloat32(instance, valueReferences, nValueReferences, (fmi3Float32*)values, nValues);
+    case FMIFloat64Type:
+        return FMI3GetFloat64(instance, valueReferences, nValueReferences, (fmi3Float64*)values, nValues);
+    case FMIInt8Type:
+        return FMI3GetInt8(instance, valueReferences, nValueReferences, (fmi3Int8*)values, nValues);
+    case FMIUInt8Type:
+        return FMI3GetUInt8(instance, valueReferences, nValueReferences, (fmi3UInt8*)values, nValues);
+    case FMIInt16Type:
+        return FMI3GetInt16(instance, valueReferences, nValueReferences, (fmi3Int16*)values, nValues);
+    case FMIUInt16Type:
+        return FMI3GetUInt16(instance, valueReferences, nValueReferences, (fmi3UInt16*)values, nValues);
+    case FMIInt32Type:
+        return FMI3GetInt32(instance, valueReferences, nValueReferences, (fmi3Int32*)values, nValues);
+    case FMIUInt32Type:
+        return FMI3GetUInt32(instance, valueReferences, nValueReferences, (fmi3UInt32*)values, nValues);
+    case FMIInt64Type:
+        return FMI3GetInt64(instance, valueReferences, nValueReferences, (fmi3Int64*)values, nValues);
+    case FMIUInt64Type:
+        return FMI3GetUInt64(instance, valueReferences, nValueReferences, (fmi3UInt64*)values, nValues);
+    case FMIBooleanType:
+        return FMI3GetBoolean(instance, valueReferences, nValueReferences, (fmi3Boolean*)values, nValues);
+    case FMIStringType:
+        return FMI3GetString(instance, valueReferences, nValueReferences, (fmi3String*)values, nValues);
+    case FMIBinaryType:
+        return FMI3GetBinary(instance, valueReferences, nValueReferences, sizes, (fmi3Binary*)values, nValues);
+    case FMIClockType:
+        return FMI3GetClock(instance, valueReferences, nValueReferences, (fmi3Clock*)values);
+    default:
+        return FMIError;
+    }
+}
+
+FMIStatus FMISetValues(FMIInstance* instance, FMIVariableType type, const FMIValueReference valueReferences[], size_t nValueReferences, const void* values, const size_t sizes[], size_t nValues) {
+
+    if (instance->fmiMajorVersion == FMIMajorVersion2) {
+
+        switch (type) {
+        case FMIRealType:
+            return FMI2SetReal(instance, valueReferences, nValueReferences, (const fmi2Real*)values);
+        case FMIIntegerType:
+            return FMI2SetInteger(instance, valueReferences, nValueReferences, (const fmi2Integer*)values);
+        case FMIBooleanType:
+            return FMI2SetBoolean(instance, valueReferences, nValueReferences, (const fmi2Boolean*)values);
+        case FMIStringType:
+            return FMI2SetString(instance, valueReferences, nValueReferences, (const fmi2String*)values);
+        default:
+            FMILogError("Variable type %s is not supported for FMI 2.0.", FMIVariableTypeToString(type));
+            return FMIError;
+        }
+    }
+
+    switch (type) {
+    case FMIFloat32Type:
+        return FMI3SetFloat32(instance, valueReferences, nValueReferences, (const fmi3Float32*)values, nValues);
+    case FMIFloat64Type:
+        return FMI3SetFloat64(instance, valueReferences, nValueReferences, (const fmi3Float64*)values, nValues);
+    case FMIInt8Type:
+        return FMI3SetInt8(instance, valueReferences, nValueReferences, (const fmi3Int8*)values, nValues);
+    case FMIUInt8Type:
+        return FMI3SetUInt8(instance, valueReferences, nValueReferences, (const fmi3UInt8*)values, nValues);
+    case FMIInt16Type:
+        return FMI3SetInt16(instance, valueReferences, nValueReferences, (const fmi3Int16*)values, nValues);
+    case FMIUInt16Type:
+        return FMI3SetUInt16(instance, valueReferences, nValueReferences, (const fmi3UInt16*)values, nValues);
+    case FMIInt32Type:
+        return FMI3SetInt32(instance, valueReferences, nValueReferences, (const fmi3Int32*)values, nValues);
+    case FMIUInt32Type:
+        return FMI3SetUInt32(instance, valueReferences, nValueReferences, (const fmi3UInt32*)values, nValues);
+    case FMIInt64Type:
+        return FMI3SetInt64(instance, valueReferences, nValueReferences, (const fmi3Int64*)values, nValues);
+    case FMIUInt64Type:
+        return FMI3SetUInt64(instance, valueReferences, nValueReferences, (const fmi3UInt64*)values, nValues);
+    case FMIBooleanType:
+        return FMI3SetBoolean(instance, valueReferences, nValueReferences, (const fmi3Boolean*)values, nValues);
+    case FMIStringType:
+        return FMI3SetString(instance, valueReferences, nValueReferences, (const fmi3String*)values, nValues);
+    case FMIBinaryType:
+        return FMI3SetBinary(instance, valueReferences, nValueReferences, sizes, (const fmi3Binary*)values, nValues);
+    case FMIClockType:
+        return FMI3SetClock(instance, valueReferences, nValueReferences, (const fmi3Clock*)values);
+    default:
+        return FMIError;
+    }
+}
+
+static FMIStatus applyStartValue(FMIInstance* instance, const FMIModelVariable* variable, const char* literal) {
+
+    size_t nValues;
+    void* values;
+    size_t* sizes;
+
+    FMIStatus status = FMIParseValues(instance->fmiMajorVersion, variable->type, literal, &nValues, &values, &sizes);
+
+    if (status > FMIWarning) {
+        return status;
+    }
+
+    status = FMISetValues(instance, variable->type, &variable->valueReference, 1, values, sizes, nValues);
+
+    FMIFreeValues(variable->type, nValues, values, sizes);
+
+    return status;
+}
+
+FMIStatus FMIApplyStartValues(FMIInstance* instance, size_t nStartValues, const FMIModelVariable* variables[], const char* values[]) {
+
+    FMIStatus status = FMIOK;
+
+    bool configurationMode = false;
+
+    // structural parameters must be set in Configuration Mode before the other variables
+    for (size_t i = 0; i < nStartValues; i++) {
+
+        if (variables[i]->causality != FMIStructuralParameter) {
+            continue;
+        }
+
+        if (!configurationMode) {
+
+            status = FMI3EnterConfigurationMode(instance);
+
+            if (status > FMIWarning) {
+                return status;
+            }
+
+            configurationMode = true;
+        }
+
+        status = applyStartValue(instance, variables[i], values[i]);
+
+        if (status > FMIWarning) {
+            return status;
+        }
+    }
+
+    if (configurationMode) {
+
+        status = FMI3ExitConfigurationMode(instance);
+
+        if (status > FMIWarning) {
+            return status;
+        }
+    }
+
+    for (size_t i = 0; i < nStartValues; i++) {
+
+        if (variables[i]->causality == FMIStructuralParameter) {
+            continue;
+        }
+
+        status = applyStartValue(instance, variables[i], values[i]);
+
+        if (status > FMIWarning) {
+            break;
+        }
+    }
+
+    return status;
+}
+
+FMIStatus FMIGetVariableSize(FMIInstance* instance, const FMIModelVariable* variable, size_t* size) {
+
+    *size = 1;
+
+    for (size_t i = 0; i < variable->nDimensions; i++) {
+
+        const FMIDimension* dimension = &variable->dimensions[i];
+
+        if (dimension->variable) {
+
+            fmi3UInt64 value;
+
+            const FMIStatus status = FMI3GetUInt64(instance, &dimension->valueReference, 1, &value, 1);
+
+            if (status > FMIWarning) {
+                return status;
+            }
+
+            *size *= (size_t)value;
+
+        } else {
+            *size *= dimension->start;
+        }
+    }
+
+    return FMIOK;
+}
+
+bool FMILUFactorize(size_t n, double A[], size_t pivots[]) {
+
+    for (size_t k = 0; k < n; k++) {
+
+        size_t p = k;
+
+        for (size_t i = k + 1; i < n; i++) {
+            if (fabs(A[i * n + k]) > fabs(A[p * n + k])) {
+                p = i;
+            }
+        }
+
+        if (A[p * n + k] == 0) {
+            return false;
+        }
+
+        pivots[k] = p;
+
+        if (p != k) {
+            for (size_t j = 0; j < n; j++) {
+                const double a = A[k * n + j];
+                A[k * n + j] = A[p * n + j];
+                A[p * n + j] = a;
+            }
+        }
+
+        for (size_t i = k + 1; i < n; i++) {
+
+            A[i * n + k] /= A[k * n + k];
+
+            for (size_t j = k + 1; j < n; j++) {
+                A[i * n + j] -= A[i * n + k] * A[k * n + j];
+            }
+        }
+    }
+
+    return true;
+}
+
+void FMILUSolve(size_t n, const double LU[], const size_t pivots[], double b[]) {
+
+    for (size_t k = 0; k < n; k++) {
+
+        const size_t p = pivots[k];
+
+        if (p != k) {
+            const double a = b[k];
+            b[k] = b[p];
+            b[p] = a;
+        }
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < i; j++) {
+            b[i] -= LU[i * n + j] * b[j];
+        }
+    }
+
+    for (size_t i = n; i-- > 0;) {
+
+        for (size_t j = i + 1; j < n; j++) {
+            b[i] -= LU[i * n + j] * b[j];
+        }
+
+        b[i] /= LU[i * n + i];
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "FMIModelDescription.h"
+
+
+/* size of a value of the given type in the arrays passed to the FMI get and set functions */
+size_t FMISizeOfVariableType(FMIVariableType type, FMIMajorVersion fmiMajorVersion);
+
+/* parse a floating point literal independent of the current locale (like strtod() in the "C" locale) */
+double FMIParseDouble(const char* literal, char** end);
+
+/* parse a space separated list of numeric or boolean values into values[capacity] */
+FMIStatus FMIParseNumericValues(FMIMajorVersion fmiMajorVersion, FMIVariableType type, const char* literal, void* values, size_t capacity, size_t* nValues);
+
+/* parse a space separated list of values (e.g. a start value or an array cell) */
+FMIStatus FMIParseValues(FMIMajorVersion fmiMajorVersion, FMIVariableType type, const char* literal, size_t* nValues, void** values, size_t** sizes);
+
+/* free values returned by FMIParseValues() */
+void FMIFreeValues(FMIVariableType type, size_t nValues, void* values, size_t* sizes);
+
+FMIStatus FMIGetValues(FMIInstance* instance, FMIVariableType type, const FMIValueReference valueReferences[], size_t nValueReferences, void* values, size_t sizes[], size_t nValues);
+
+FMIStatus FMISetValues(FMIInstance* instance, FMIVariableType type, const FMIValueReference valueReferences[], size_t nValueReferences, const void* values, const size_t sizes[], size_t nValues);
+
+/* apply the start value literals to the variables */
+FMIStatus FMIApplyStartValues(FMIInstance* instance, size_t nStartValues, const FMIModelVariable* variables[], const char* values[]);
+
+/* the current size of a variable with the dimensions queried from the FMU */
+FMIStatus FMIGetVariableSize(FMIInstance* instance, const FMIModelVariable* variable, size_t* size);
+
+/* LU decomposition with partial pivoting of the n x n matrix A (row major) in place (returns false if A is singular) */
+bool FMILUFactorize(size_t n, double A[], size_t pivots[]);
+
+/* solve LU * x = b in place with the LU decomposition returned by FMILUFactorize() */
+void FMILUSolve(size_t n, const double LU[], const size_t pivots[], double b[]);
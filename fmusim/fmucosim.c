@@ -0,0 +1,248 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FMIMaster.h"
+
+
+static bool logFMICalls = false;
+
+static void logMessage(FMIInstance* instance, FMIStatus status, const char* category, const char* message) {
+
+    static const char* statusNames[] = { "OK", "Warning", "Discard", "Error", "Fatal", "Pending" };
+
+    fprintf(stderr, "[%s] %s: %s\n", status <= FMIPending ? statusNames[status] : "Unknown status", instance->name, message);
+}
+
+static void logFunctionCall(FMIInstance* instance, FMIStatus status, const char* message) {
+
+    static const char* statusNames[] = { "OK", "Warning", "Discard", "Error", "Fatal", "Pending" };
+
+    fprintf(stderr, "%s: %s -> %s\n", instance->name, message, status <= FMIPending ? statusNames[status] : "Unknown status");
+}
+
+static void printUsage(void) {
+    printf(
+        "Usage: fmucosim [OPTION]... SYSTEMFILE\n"
+        "Co-simulate the connected FMUs in SYSTEMFILE.\n"
+        "\n"
+        "  --help                     display this help and exit\n"
+        "  --start-time TIME          the start time of the simulation\n"
+        "  --stop-time TIME           the stop time of the simulation\n"
+        "  --step-size STEP           the communication step size (default: (stop time - start time) / 500)\n"
+        "  --algorithm [jacobi|gauss-seidel]\n"
+        "                             the master algorithm (default: jacobi)\n"
+        "  --threads N                the number of threads for the Jacobi algorithm (default: one per component)\n"
+        "  --variable-step            adapt the step size to the change of the connected values and reject\n"
+        "                             steps that exceed the tolerance (requires fmi3GetFMUState and fmi3SetFMUState)\n"
+        "  --tolerance TOLERANCE      the relative and absolute tolerance for the variable step size (default: 1e-3)\n"
+        "  --min-step-size STEP       the minimum variable step size (default: 1e-6 * (stop time - start time))\n"
+        "  --max-step-size STEP       the maximum variable step size (default: stop time - start time)\n"
+        "  --solve-loops              solve the algebraic loops of Float64 connections at the communication points\n"
+        "                             with Newton's method (or Broyden's method if directional derivatives are not provided)\n"
+        "  --loop-tolerance TOLERANCE the relative and absolute tolerance of the algebraic loops (default: 1e-10)\n"
+        "  --max-loop-iterations N    the maximum number of iterations per algebraic loop solve (default: 50)\n"
+        "  --output-file FILE         write the values of the connections to a file (default: stdout)\n"
+        "  --timing-file FILE         write the wall-clock time of every macro step to a file\n"
+        "  --log-fmi-calls            log the FMI calls to stderr\n"
+        "\n"
+        "The SYSTEMFILE contains one statement per line:\n"
+        "\n"
+        "  # comment\n"
+        "  component NAME UNZIPDIR\n"
+        "  start COMPONENT.VARIABLE VALUE\n"
+        "  connection COMPONENT.OUTPUT COMPONENT.INPUT\n"
+        "\n"
+        "Example:\n"
+        "\n"
+        "  fmucosim --stop-time 5 --step-size 0.01 --output-file system_out.csv system.txt\n"
+    );
+}
+
+int main(int argc, const char* argv[]) {
+
+    FMIStatus status = FMIError;
+
+    const char* systemFile = NULL;
+    const char* algorithm = "jacobi";
+    const char* threads = NULL;
+    const char* outputFile = NULL;
+    const char* timingFile = NULL;
+
+    const char* startTime = NULL;
+    const char* stopTime = NULL;
+    const char* stepSize = NULL;
+    const char* tolerance = NULL;
+    const char* minStepSize = NULL;
+    const char* maxStepSize = NULL;
+    const char* loopTolerance = NULL;
+    const char* maxLoopIterations = NULL;
+
+    FMISystem* system = NULL;
+    FILE* output = NULL;
+    FILE* timing = NULL;
+
+    FMIMasterSettings settings;
+    FMIMasterStatistics statistics;
+
+    memset(&settings, 0, sizeof(settings));
+    memset(&statistics, 0, sizeof(statistics));
+
+    for (int i = 1; i < argc; i++) {
+
+        const char* v = argv[i];
+
+        if (!strcmp(v, "--help")) {
+            printUsage();
+            status = FMIOK;
+            goto TERMINATE;
+        } else if (!strcmp(v, "--log-fmi-calls")) {
+            logFMICalls = true;
+        } else if (!strcmp(v, "--variable-step")) {
+            settings.variableStepSize = true;
+        } else if (!strcmp(v, "--solve-loops")) {
+            settings.solveLoops = true;
+        } else if (i + 1 < argc && !strcmp(v, "--start-time")) {
+            startTime = argv[++i];
+        } else if (i + 1 < argc && !strcmp(v, "--stop-time")) {
+            stopTime = argv[++i];
+        } else if (i + 1 < argc && !strcmp(v, "--step-size")) {
+            stepSize = argv[++i];
+        } else if (i + 1 < argc && !strcmp(v, "--tolerance")) {
+            tolerance = argv[++i];
+        } else if (i + 1 < argc && !strcmp(v, "--min-step-size")) {
+            minStepSize = argv[++i];
+        } else if (i + 1 < argc && !strcmp(v, "--max-step-size")) {
+            maxStepSize = argv[++i];
+        } else if (i + 1 < argc && !strcmp(v, "--loop-tolerance")) {
+            loopTolerance = argv[++i];
+        } else if (i + 1 < argc && !strcmp(v, "--max-loop-iterations")) {
+            maxLoopIterations = argv[++i];
+        } else if (i + 1 < argc && !strcmp(v, "--algorithm")) {
+            algorithm = argv[++i];
+        } else if (i + 1 < argc && !strcmp(v, "--threads")) {
+            threads = argv[++i];
+        } else if (i + 1 < argc && !strcmp(v, "--output-file")) {
+            outputFile = argv[++i];
+        } else if (i + 1 < argc && !strcmp(v, "--timing-file")) {
+            timingFile = argv[++i];
+        } else if (i == argc - 1 && strncmp(v, "--", 2)) {
+            systemFile = v;
+        } else {
+            printf("Unknown or incomplete option %s.\n\n", v);
+            printUsage();
+            goto TERMINATE;
+        }
+    }
+
+    if (!systemFile) {
+        printUsage();
+        goto TERMINATE;
+    }
+
+    if (!strcmp(algorithm, "jacobi")) {
+        settings.algorithm = FMIJacobi;
+    } else if (!strcmp(algorithm, "gauss-seidel")) {
+        settings.algorithm = FMIGaussSeidel;
+    } else {
+        printf("Unknown algorithm %s.\n", algorithm);
+        goto TERMINATE;
+    }
+
+    settings.startTime = startTime ? strtod(startTime, NULL) : 0;
+    settings.stopTime  = stopTime ? strtod(stopTime, NULL) : settings.startTime + 1;
+    settings.stepSize  = stepSize ? strtod(stepSize, NULL) : (settings.stopTime - settings.startTime) / 500;
+    settings.nThreads  = threads ? (size_t)strtoul(threads, NULL, 10) : 0;
+
+    settings.tolerance   = tolerance ? strtod(tolerance, NULL) : 1e-3;
+    settings.minStepSize = minStepSize ? strtod(minStepSize, NULL) : 1e-6 * (settings.stopTime - settings.startTime);
+    settings.maxStepSize = maxStepSize ? strtod(maxStepSize, NULL) : settings.stopTime - settings.startTime;
+
+    settings.loopTolerance     = loopTolerance ? strtod(loopTolerance, NULL) : 1e-10;
+    settings.maxLoopIterations = maxLoopIterations ? (size_t)strtoul(maxLoopIterations, NULL, 10) : 50;
+
+    if (settings.stepSize <= 0 || settings.stopTime < settings.startTime) {
+        printf("The step size must be positive and the stop time must not be before the start time.\n");
+        goto TERMINATE;
+    }
+
+    if (settings.solveLoops && settings.loopTolerance <= 0) {
+        printf("The loop tolerance must be positive.\n");
+        goto TERMINATE;
+    }
+
+    if (settings.variableStepSize && (settings.tolerance <= 0 || settings.minStepSize <= 0 || settings.maxStepSize < settings.minStepSize)) {
+        printf("The tolerance and the minimum step size must be positive and the maximum step size must not be less than the minimum step size.\n");
+        goto TERMINATE;
+    }
+
+    // the arguments are only formatted if a callback is set
+    system = FMIReadSystem(systemFile, logMessage, logFMICalls ? logFunctionCall : NULL);
+
+    if (!system) {
+        goto TERMINATE;
+    }
+
+    if (outputFile) {
+
+        output = fopen(outputFile, "w");
+
+        if (!output) {
+            printf("Failed to open %s.\n", outputFile);
+            goto TERMINATE;
+        }
+
+        settings.outputFile = output;
+
+    } else {
+        settings.outputFile = stdout;
+    }
+
+    if (timingFile) {
+
+        timing = fopen(timingFile, "w");
+
+        if (!timing) {
+            printf("Failed to open %s.\n", timingFile);
+            goto TERMINATE;
+        }
+
+        settings.timingFile = timing;
+    }
+
+    status = FMISimulateSystem(system, &settings, &statistics);
+
+    if (statistics.nSteps > 0) {
+        fprintf(stderr, "Macro steps: %llu, wall-clock time per macro step: %.3g us (min: %.3g us, max: %.3g us)\n",
+            (unsigned long long)statistics.nSteps,
+            1e6 * statistics.totalStepTime / (double)statistics.nSteps,
+            1e6 * statistics.minStepTime,
+            1e6 * statistics.maxStepTime);
+    }
+
+    if (settings.variableStepSize) {
+        fprintf(stderr, "Accepted steps: %llu, rejected steps: %llu, time to save the states: %.3g s, time to restore the states: %.3g s\n",
+            (unsigned long long)statistics.nSteps,
+            (unsigned long long)statistics.nRejectedSteps,
+            statistics.saveStateTime,
+            statistics.restoreStateTime);
+    }
+
+    if (settings.solveLoops) {
+        fprintf(stderr, "Algebraic loop iterations: %llu\n", (unsigned long long)statistics.nLoopIterations);
+    }
+
+TERMINATE:
+
+    if (output) {
+        fclose(output);
+    }
+
+    if (timing) {
+        fclose(timing);
+    }
+
+    FMIFreeSystem(system);
+
+    return status > FMIWarning ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,405 @@
+/* Loads the platform binary of an FMU and serves the FMI calls of the importer that started the process with
+   FMILoadRemotePlatformBinary() (see FMIRemote.h). */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "FMI3.h"
+#include "FMIRemote.h"
+
+
+static FMIRemoteChannel *channel = NULL;
+
+static pid_t importer = 0;
+
+static bool importerAlive(void *context) {
+    return getppid() == importer;
+}
+
+#define ARGUMENT(i) (request->arguments[i])
+
+#define POINTER(i) (request->arguments[i] == FMI_REMOTE_NULL ? NULL : (void*)&channel->data[request->arguments[i]])
+
+static fmi3Float64 toFloat64(uint64_t bits) {
+    fmi3Float64 value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static uint64_t fromFloat64(fmi3Float64 value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// replaces the offsets of the strings or binaries in the data area with pointers
+static void *toPointers(void *values, size_t nValues) {
+
+    if (values) {
+        for (size_t i = 0; i < nValues; i++) {
+            const uint64_t offset = ((uint64_t*)values)[i];
+            ((const void**)values)[i] = offset == FMI_REMOTE_NULL ? NULL : &channel->data[offset];
+        }
+    }
+
+    return values;
+}
+
+// copies the strings (sizes == NULL) or binaries to the free data area and replaces the pointers with offsets
+static FMIStatus toOffsets(void *values, const size_t sizes[], size_t nValues, uint64_t top) {
+
+    if (!values) {
+        return FMIOK;
+    }
+
+    // in reverse order because the offsets may be larger than the pointers
+    for (size_t i = nValues; i-- > 0;) {
+
+        const void *value = ((const void**)values)[i];
+
+        uint64_t offset = FMI_REMOTE_NULL;
+
+        if (value) {
+
+            const size_t size = sizes ? sizes[i] : strlen(value) + 1;
+
+            if (size > FMI_REMOTE_DATA_SIZE - top) {
+                FMILogError("The values exceed the data area of %d bytes.", FMI_REMOTE_DATA_SIZE);
+                return FMIError;
+            }
+
+            memcpy(&channel->data[top], value, size);
+
+            offset = top;
+
+            top += (size + 7) & ~(size_t)7;
+        }
+
+        ((uint64_t*)values)[i] = offset;
+    }
+
+    return FMIOK;
+}
+
+static bool serve(FMIInstance *S, FMIRemoteMessage *result);
+
+static void logMessage(FMIInstance *instance, FMIStatus status, const char *category, const char *message) {
+
+    FMIRemoteMessage *response = FMIRemoteReserveMessage(&channel->responses, importerAlive, NULL);
+
+    if (!response) {
+        exit(EXIT_FAILURE);
+    }
+
+    response->type = FMIRemoteLogMessage;
+    response->status = status;
+
+    snprintf(response->text, sizeof(response->text), "%s%c%s", category ? category : "", '\0', message ? message : "");
+
+    // terminate a truncated message
+    response->text[sizeof(response->text) - 1] = '\0';
+
+    FMIRemoteSendMessage(&channel->responses);
+}
+
+static void intermediateUpdate(
+    fmi3InstanceEnvironment instanceEnvironment,
+    fmi3Float64  intermediateUpdateTime,
+    fmi3Boolean  intermediateVariableSetRequested,
+    fmi3Boolean  intermediateVariableGetAllowed,
+    fmi3Boolean  intermediateStepFinished,
+    fmi3Boolean  canReturnEarly,
+    fmi3Boolean* earlyReturnRequested,
+    fmi3Float64* earlyReturnTime) {
+
+    FMIRemoteMessage *callback = FMIRemoteReserveMessage(&channel->responses, importerAlive, NULL);
+
+    if (!callback) {
+        exit(EXIT_FAILURE);
+    }
+
+    callback->type = FMIRemoteIntermediateUpdate;
+    callback->arguments[0] = fromFloat64(intermediateUpdateTime);
+    callback->arguments[1] = intermediateVariableSetRequested;
+    callback->arguments[2] = intermediateVariableGetAllowed;
+    callback->arguments[3] = intermediateStepFinished;
+    callback->arguments[4] = canReturnEarly;
+
+    FMIRemoteSendMessage(&channel->responses);
+
+    // serve the calls of the callback until it returns
+    FMIRemoteMessage result;
+
+    if (!serve(instanceEnvironment, &result)) {
+        exit(EXIT_FAILURE);
+    }
+
+    *earlyReturnRequested = (fmi3Boolean)result.arguments[0];
+    *earlyReturnTime = toFloat64(result.arguments[1]);
+}
+
+static FMIStatus setInstanceName(FMIInstance *S, const char *name) {
+
+    FMIFree((void**)&S->name);
+
+    S->name = strdup(name ? name : "");
+
+    return S->name ? FMIOK : FMIError;
+}
+
+static FMIStatus dispatch(FMIInstance *S, const FMIRemoteMessage *request) {
+
+    FMIStatus status;
+
+    switch (request->function) {
+
+    /* Inquire version numbers and set debug logging */
+    case FMIRemoteSetDebugLogging:
+        return FMI3SetDebugLogging(S, (fmi3Boolean)ARGUMENT(0), ARGUMENT(1), toPointers(POINTER(2), ARGUMENT(1)));
+
+    /* Creation and destruction of FMU instances */
+    case FMIRemoteInstantiateModelExchange:
+        if (setInstanceName(S, POINTER(0)) != FMIOK) {
+            return FMIError;
+        }
+        return FMI3InstantiateModelExchange(S, POINTER(1), POINTER(2), (fmi3Boolean)ARGUMENT(3), (fmi3Boolean)ARGUMENT(4));
+    case FMIRemoteInstantiateCoSimulation:
+        if (setInstanceName(S, POINTER(0)) != FMIOK) {
+            return FMIError;
+        }
+        return FMI3InstantiateCoSimulation(S, POINTER(1), POINTER(2), (fmi3Boolean)ARGUMENT(3), (fmi3Boolean)ARGUMENT(4),
+            (fmi3Boolean)ARGUMENT(5), (fmi3Boolean)ARGUMENT(6), POINTER(7), ARGUMENT(8), ARGUMENT(9) ? intermediateUpdate : NULL);
+    case FMIRemoteFreeInstance:
+        return FMI3FreeInstance(S);
+
+    /* Enter and exit initialization mode, terminate and reset */
+    case FMIRemoteEnterInitializationMode:
+        return FMI3EnterInitializationMode(S, (fmi3Boolean)ARGUMENT(0), toFloat64(ARGUMENT(1)), toFloat64(ARGUMENT(2)), (fmi3Boolean)ARGUMENT(3), toFloat64(ARGUMENT(4)));
+    case FMIRemoteExitInitializationMode:
+        return FMI3ExitInitializationMode(S);
+    case FMIRemoteEnterEventMode:
+        return FMI3EnterEventMode(S);
+    case FMIRemoteTerminate:
+        return FMI3Terminate(S);
+    case FMIRemoteReset:
+        return FMI3Reset(S);
+
+    /* Getting and setting variable values */
+#define GET_SET(t) \
+    case FMIRemoteGet ## t: \
+        return FMI3Get ## t(S, POINTER(0), ARGUMENT(1), POINTER(2), ARGUMENT(3)); \
+    case FMIRemoteSet ## t: \
+        return FMI3Set ## t(S, POINTER(0), ARGUMENT(1), POINTER(2), ARGUMENT(3));
+    GET_SET(Float32)
+    GET_SET(Float64)
+    GET_SET(Int8)
+    GET_SET(UInt8)
+    GET_SET(Int16)
+    GET_SET(UInt16)
+    GET_SET(Int32)
+    GET_SET(UInt32)
+    GET_SET(Int64)
+    GET_SET(UInt64)
+    GET_SET(Boolean)
+#undef GET_SET
+    case FMIRemoteGetString:
+        status = FMI3GetString(S, POINTER(0), ARGUMENT(1), POINTER(2), ARGUMENT(3));
+        if (status <= FMIWarning && toOffsets(POINTER(2), NULL, ARGUMENT(3), request->top) != FMIOK) {
+            return FMIError;
+        }
+        return status;
+    case FMIRemoteGetBinary:
+        status = FMI3GetBinary(S, POINTER(0), ARGUMENT(1), POINTER(2), POINTER(3), ARGUMENT(4));
+        if (status <= FMIWarning && toOffsets(POINTER(3), POINTER(2), ARGUMENT(4), request->top) != FMIOK) {
+            return FMIError;
+        }
+        return status;
+    case FMIRemoteGetClock:
+        return FMI3GetClock(S, POINTER(0), ARGUMENT(1), POINTER(2));
+    case FMIRemoteSetString:
+        return FMI3SetString(S, POINTER(0), ARGUMENT(1), toPointers(POINTER(2), ARGUMENT(3)), ARGUMENT(3));
+    case FMIRemoteSetBinary:
+        return FMI3SetBinary(S, POINTER(0), ARGUMENT(1), POINTER(2), toPointers(POINTER(3), ARGUMENT(4)), ARGUMENT(4));
+    case FMIRemoteSetClock:
+        return FMI3SetClock(S, POINTER(0), ARGUMENT(1), POINTER(2));
+
+    /* Getting Variable Dependency Information */
+    case FMIRemoteGetNumberOfVariableDependencies:
+        return FMI3GetNumberOfVariableDependencies(S, (fmi3ValueReference)ARGUMENT(0), POINTER(1));
+    case FMIRemoteGetVariableDependencies:
+        return FMI3GetVariableDependencies(S, (fmi3ValueReference)ARGUMENT(0), POINTER(1), POINTER(2), POINTER(3), POINTER(4), ARGUMENT(5));
+
+    /* Getting and setting the internal FMU state */
+    case FMIRemoteGetFMUState:
+        return FMI3GetFMUState(S, POINTER(0));
+    case FMIRemoteSetFMUState:
+        return FMI3SetFMUState(S, (fmi3FMUState)(uintptr_t)ARGUMENT(0));
+    case FMIRemoteFreeFMUState:
+        return FMI3FreeFMUState(S, POINTER(0));
+    case FMIRemoteSerializedFMUStateSize:
+        return FMI3SerializedFMUStateSize(S, (fmi3FMUState)(uintptr_t)ARGUMENT(0), POINTER(1));
+    case FMIRemoteSerializeFMUState:
+        return FMI3SerializeFMUState(S, (fmi3FMUState)(uintptr_t)ARGUMENT(0), POINTER(1), ARGUMENT(2));
+    case FMIRemoteDeserializeFMUState:
+        return FMI3DeserializeFMUState(S, POINTER(0), ARGUMENT(1), POINTER(2));
+
+    /* Getting partial derivatives */
+    case FMIRemoteGetDirectionalDerivative:
+        return FMI3GetDirectionalDerivative(S, POINTER(0), ARGUMENT(1), POINTER(2), ARGUMENT(3), POINTER(4), ARGUMENT(5), POINTER(6), ARGUMENT(7));
+    case FMIRemoteGetAdjointDerivative:
+        return FMI3GetAdjointDerivative(S, POINTER(0), ARGUMENT(1), POINTER(2), ARGUMENT(3), POINTER(4), ARGUMENT(5), POINTER(6), ARGUMENT(7));
+
+    /* Entering and exiting the Configuration or Reconfiguration Mode */
+    case FMIRemoteEnterConfigurationMode:
+        return FMI3EnterConfigurationMode(S);
+    case FMIRemoteExitConfigurationMode:
+        return FMI3ExitConfigurationMode(S);
+
+    /* Clock related functions */
+    case FMIRemoteGetIntervalDecimal:
+        return FMI3GetIntervalDecimal(S, POINTER(0), ARGUMENT(1), POINTER(2), POINTER(3));
+    case FMIRemoteGetIntervalFraction:
+        return FMI3GetIntervalFraction(S, POINTER(0), ARGUMENT(1), POINTER(2), POINTER(3), POINTER(4));
+    case FMIRemoteGetShiftDecimal:
+        return FMI3GetShiftDecimal(S, POINTER(0), ARGUMENT(1), POINTER(2));
+    case FMIRemoteGetShiftFraction:
+        return FMI3GetShiftFraction(S, POINTER(0), ARGUMENT(1), POINTER(2), POINTER(3));
+    case FMIRemoteSetIntervalDecimal:
+        return FMI3SetIntervalDecimal(S, POINTER(0), ARGUMENT(1), POINTER(2));
+    case FMIRemoteSetIntervalFraction:
+        return FMI3SetIntervalFraction(S, POINTER(0), ARGUMENT(1), POINTER(2), POINTER(3));
+    case FMIRemoteEvaluateDiscreteStates:
+        return FMI3EvaluateDiscreteStates(S);
+    case FMIRemoteUpdateDiscreteStates:
+        return FMI3UpdateDiscreteStates(S, POINTER(0), POINTER(1), POINTER(2), POINTER(3), POINTER(4), POINTER(5));
+
+    /* Functions for Model Exchange */
+    case FMIRemoteEnterContinuousTimeMode:
+        return FMI3EnterContinuousTimeMode(S);
+    case FMIRemoteCompletedIntegratorStep:
+        return FMI3CompletedIntegratorStep(S, (fmi3Boolean)ARGUMENT(0), POINTER(1), POINTER(2));
+    case FMIRemoteSetTime:
+        return FMI3SetTime(S, toFloat64(ARGUMENT(0)));
+    case FMIRemoteSetContinuousStates:
+        return FMI3SetContinuousStates(S, POINTER(0), ARGUMENT(1));
+    case FMIRemoteGetContinuousStateDerivatives:
+        return FMI3GetContinuousStateDerivatives(S, POINTER(0), ARGUMENT(1));
+    case FMIRemoteGetEventIndicators:
+        return FMI3GetEventIndicators(S, POINTER(0), ARGUMENT(1));
+    case FMIRemoteGetContinuousStates:
+        return FMI3GetContinuousStates(S, POINTER(0), ARGUMENT(1));
+    case FMIRemoteGetNominalsOfContinuousStates:
+        return FMI3GetNominalsOfContinuousStates(S, POINTER(0), ARGUMENT(1));
+    case FMIRemoteGetNumberOfEventIndicators:
+        return FMI3GetNumberOfEventIndicators(S, POINTER(0));
+    case FMIRemoteGetNumberOfContinuousStates:
+        return FMI3GetNumberOfContinuousStates(S, POINTER(0));
+
+    /* Functions for Co-Simulation */
+    case FMIRemoteEnterStepMode:
+        return FMI3EnterStepMode(S);
+    case FMIRemoteGetOutputDerivatives:
+        return FMI3GetOutputDerivatives(S, POINTER(0), ARGUMENT(1), POINTER(2), POINTER(3), ARGUMENT(4));
+    case FMIRemoteDoStep:
+        return FMI3DoStep(S, toFloat64(ARGUMENT(0)), toFloat64(ARGUMENT(1)), (fmi3Boolean)ARGUMENT(2), POINTER(3), POINTER(4), POINTER(5), POINTER(6));
+
+    default:
+        FMILogError("Unsupported function %u.", request->function);
+        return FMIError;
+    }
+}
+
+// serves the calls of the importer until it exits (returns false) or returns from a callback (returns true)
+static bool serve(FMIInstance *S, FMIRemoteMessage *result) {
+
+    for (;;) {
+
+        FMIRemoteMessage *message = FMIRemoteReceiveMessage(&channel->requests, importerAlive, NULL);
+
+        if (!message) {
+            return false;
+        }
+
+        // release the message before the call, so the callbacks can receive nested calls
+        FMIRemoteMessage request;
+
+        memcpy(&request, message, offsetof(FMIRemoteMessage, text));
+
+        FMIRemoteReleaseMessage(&channel->requests);
+
+        if (request.type == FMIRemoteReturn) {
+
+            if (result) {
+                memcpy(result, &request, offsetof(FMIRemoteMessage, text));
+                return true;
+            }
+
+            continue;
+        }
+
+        if (request.function == FMIRemoteExit) {
+            return false;
+        }
+
+        const FMIStatus status = dispatch(S, &request);
+
+        FMIRemoteMessage *response = FMIRemoteReserveMessage(&channel->responses, importerAlive, NULL);
+
+        if (!response) {
+            return false;
+        }
+
+        response->type = FMIRemoteReturn;
+        response->status = status;
+
+        FMIRemoteSendMessage(&channel->responses);
+    }
+}
+
+int main(int argc, char *argv[]) {
+
+    if (argc != 3) {
+        printf("Usage: fmuhost FD PLATFORM_BINARY\n"
+               "Serve the FMI calls of the process that started this host through the shared memory FD.\n");
+        return EXIT_FAILURE;
+    }
+
+    importer = getppid();
+
+    const int fd = atoi(argv[1]);
+
+    channel = mmap(NULL, sizeof(FMIRemoteChannel), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    close(fd);
+
+    if (channel == MAP_FAILED) {
+        FMILogError("Failed to map the shared memory.");
+        return EXIT_FAILURE;
+    }
+
+    FMIInstance *S = FMICreateInstance("", logMessage, NULL);
+
+    FMIStatus status = S ? FMILoadPlatformBinary(S, argv[2]) : FMIError;
+
+    FMIRemoteMessage *response = FMIRemoteReserveMessage(&channel->responses, importerAlive, NULL);
+
+    if (response) {
+        response->type = FMIRemoteReturn;
+        response->status = status;
+        FMIRemoteSendMessage(&channel->responses);
+    }
+
+    if (response && status == FMIOK) {
+        serve(S, NULL);
+    }
+
+    FMIFreeInstance(S);
+
+    munmap(channel, sizeof(FMIRemoteChannel));
+
+    return status == FMIOK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,328 @@
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "FMIServer.h"
+
+
+#define MAX_CLIENTS 64
+
+static bool logFMICalls = false;
+
+static volatile sig_atomic_t stop = 0;
+
+static void logMessage(FMIInstance* instance, FMIStatus status, const char* category, const char* message) {
+
+    static const char* statusNames[] = { "OK", "Warning", "Discard", "Error", "Fatal", "Pending" };
+
+    fprintf(stderr, "[%s] %s: %s\n", status <= FMIPending ? statusNames[status] : "Unknown status", instance->name, message);
+}
+
+static void logFunctionCall(FMIInstance* instance, FMIStatus status, const char* message) {
+
+    static const char* statusNames[] = { "OK", "Warning", "Discard", "Error", "Fatal", "Pending" };
+
+    fprintf(stderr, "%s: %s -> %s\n", instance->name, message, status <= FMIPending ? statusNames[status] : "Unknown status");
+}
+
+static void handleSignal(int signal) {
+    stop = 1;
+}
+
+static void printUsage(void) {
+    printf(
+        "Usage: fmuserver [OPTION]... SYSTEMFILE\n"
+        "Serve the FMUs in SYSTEMFILE to clients on a UNIX domain socket.\n"
+        "\n"
+        "  --help                     display this help and exit\n"
+        "  --socket PATH              the path of the socket (default: fmuserver.sock)\n"
+        "  --start-time TIME          the start time of the instances\n"
+        "  --log-fmi-calls            log the FMI calls to stderr\n"
+        "\n"
+        "The FMUs are instantiated as Co-Simulation and initialized with the start values of\n"
+        "SYSTEMFILE (see fmucosim --help). The connections are ignored. A client sends requests\n"
+        "with a batch of calls to the server and receives the results of the calls in a\n"
+        "single response (see fmusim/FMIServer.h for the protocol).\n"
+        "\n"
+        "Example:\n"
+        "\n"
+        "  fmuserver --socket /tmp/plant.sock system.txt\n"
+    );
+}
+
+// reads exactly size bytes and returns false if the client has closed the connection or an error occurred
+static bool receiveAll(int fd, void* data, size_t size) {
+
+    uint8_t* p = data;
+
+    while (size > 0) {
+
+        const ssize_t n = recv(fd, p, size, 0);
+
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (n <= 0) {
+            return false;
+        }
+
+        p += n;
+        size -= (size_t)n;
+    }
+
+    return true;
+}
+
+static bool sendAll(int fd, const void* data, size_t size) {
+
+    const uint8_t* p = data;
+
+    while (size > 0) {
+
+        const ssize_t n = send(fd, p, size, MSG_NOSIGNAL);
+
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (n <= 0) {
+            return false;
+        }
+
+        p += n;
+        size -= (size_t)n;
+    }
+
+    return true;
+}
+
+// receives a request, processes it and sends the response
+static bool serveRequest(FMIServer* server, int fd, uint8_t** request, size_t* capacity) {
+
+    uint32_t size;
+
+    if (!receiveAll(fd, &size, sizeof(size))) {
+        return false;
+    }
+
+    if (size > FMI_SERVER_MAX_REQUEST_SIZE) {
+        fprintf(stderr, "The request size %u exceeds the maximum request size.\n", size);
+        return false;
+    }
+
+    if (size > *capacity) {
+
+        if (FMIRealloc((void**)request, size) != FMIOK) {
+            return false;
+        }
+
+        *capacity = size;
+    }
+
+    if (!receiveAll(fd, *request, size)) {
+        return false;
+    }
+
+    const uint8_t* response = NULL;
+    size_t responseSize = 0;
+
+    if (FMIServerProcessRequest(server, *request, size, &response, &responseSize) != FMIOK) {
+        return false;
+    }
+
+    return sendAll(fd, response, responseSize);
+}
+
+int main(int argc, const char* argv[]) {
+
+    FMIStatus status = FMIError;
+
+    const char* systemFile = NULL;
+    const char* socketPath = "fmuserver.sock";
+    const char* startTime = NULL;
+
+    FMISystem* system = NULL;
+    FMIServer* server = NULL;
+
+    int listener = -1;
+    bool bound = false;
+
+    struct pollfd fds[MAX_CLIENTS + 1];
+    nfds_t nfds = 0;
+
+    uint8_t* request = NULL;
+    size_t requestCapacity = 0;
+
+    for (int i = 1; i < argc; i++) {
+
+        const char* v = argv[i];
+
+        if (!strcmp(v, "--help")) {
+            printUsage();
+            status = FMIOK;
+            goto TERMINATE;
+        } else if (!strcmp(v, "--log-fmi-calls")) {
+            logFMICalls = true;
+        } else if (i + 1 < argc && !strcmp(v, "--socket")) {
+            socketPath = argv[++i];
+        } else if (i + 1 < argc && !strcmp(v, "--start-time")) {
+            startTime = argv[++i];
+        } else if (i == argc - 1 && strncmp(v, "--", 2)) {
+            systemFile = v;
+        } else {
+            printf("Unknown or incomplete option %s.\n\n", v);
+            printUsage();
+            goto TERMINATE;
+        }
+    }
+
+    if (!systemFile) {
+        printUsage();
+        goto TERMINATE;
+    }
+
+    struct sockaddr_un address;
+
+    memset(&address, 0, sizeof(address));
+
+    address.sun_family = AF_UNIX;
+
+    if (strlen(socketPath) >= sizeof(address.sun_path)) {
+        printf("The socket path %s is too long.\n", socketPath);
+        goto TERMINATE;
+    }
+
+    strcpy(address.sun_path, socketPath);
+
+    // the arguments are only formatted if a callback is set
+    system = FMIReadSystem(systemFile, logMessage, logFMICalls ? logFunctionCall : NULL);
+
+    if (!system) {
+        goto TERMINATE;
+    }
+
+    server = FMICreateServer(system, startTime ? strtod(startTime, NULL) : 0);
+
+    if (!server) {
+        goto TERMINATE;
+    }
+
+    listener = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (listener < 0) {
+        printf("Failed to create the socket. %s.\n", strerror(errno));
+        goto TERMINATE;
+    }
+
+    unlink(socketPath);
+
+    if (bind(listener, (struct sockaddr*)&address, sizeof(address)) < 0) {
+        printf("Failed to bind the socket to %s. %s.\n", socketPath, strerror(errno));
+        goto TERMINATE;
+    }
+
+    bound = true;
+
+    if (listen(listener, MAX_CLIENTS) < 0) {
+        printf("Failed to listen on %s. %s.\n", socketPath, strerror(errno));
+        goto TERMINATE;
+    }
+
+    struct sigaction action;
+
+    memset(&action, 0, sizeof(action));
+
+    action.sa_handler = handleSignal;
+
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    printf("Listening on %s\n", socketPath);
+    fflush(stdout);
+
+    fds[0].fd = listener;
+    fds[0].events = POLLIN;
+    nfds = 1;
+
+    // the requests are processed one after another so the calls of a request are never interleaved with other calls
+    while (!stop) {
+
+        if (poll(fds, nfds, -1) < 0) {
+
+            if (errno == EINTR) {
+                continue;
+            }
+
+            printf("Failed to poll the sockets. %s.\n", strerror(errno));
+            goto TERMINATE;
+        }
+
+        for (nfds_t i = nfds; i-- > 1;) {
+
+            if (!fds[i].revents) {
+                continue;
+            }
+
+            if (!(fds[i].revents & POLLIN) || !serveRequest(server, fds[i].fd, &request, &requestCapacity)) {
+                close(fds[i].fd);
+                fds[i] = fds[--nfds];
+            }
+        }
+
+        if (fds[0].revents & POLLIN) {
+
+            const int client = accept(listener, NULL, NULL);
+
+            if (client < 0) {
+                continue;
+            }
+
+            if (nfds > MAX_CLIENTS) {
+                fprintf(stderr, "Too many clients.\n");
+                close(client);
+                continue;
+            }
+
+            // don't let a client that sends an incomplete request block the others
+            const struct timeval timeout = { 5, 0 };
+
+            setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+            fds[nfds].fd = client;
+            fds[nfds].events = POLLIN;
+            fds[nfds].revents = 0;
+            nfds++;
+        }
+    }
+
+    status = FMIOK;
+
+TERMINATE:
+
+    for (nfds_t i = 1; i < nfds; i++) {
+        close(fds[i].fd);
+    }
+
+    if (listener >= 0) {
+        close(listener);
+    }
+
+    if (bound) {
+        unlink(socketPath);
+    }
+
+    free(request);
+
+    FMIFreeServer(server);
+    FMIFreeSystem(system);
+
+    return status > FMIWarning ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,443 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FMIModelDescription.h"
+#include "FMIRemote.h"
+#include "FMIBDF.h"
+#include "FMIEuler.h"
+#include "FMIRungeKutta.h"
+#include "FMISimulation.h"
+
+
+static bool logFMICalls = false;
+
+static bool outOfProcess = false;
+
+static void logMessage(FMIInstance* instance, FMIStatus status, const char* category, const char* message) {
+
+    switch (status) {
+    case FMIOK:
+        fprintf(stderr, "[OK] ");
+        break;
+    case FMIWarning:
+        fprintf(stderr, "[Warning] ");
+        break;
+    case FMIDiscard:
+        fprintf(stderr, "[Discard] ");
+        break;
+    case FMIError:
+        fprintf(stderr, "[Error] ");
+        break;
+    case FMIFatal:
+        fprintf(stderr, "[Fatal] ");
+        break;
+    case FMIPending:
+        fprintf(stderr, "[Pending] ");
+        break;
+    }
+
+    fprintf(stderr, "%s\n", message);
+}
+
+static void logFunctionCall(FMIInstance* instance, FMIStatus status, const char* message) {
+
+    static const char* statusNames[] = { "OK", "Warning", "Discard", "Error", "Fatal", "Pending" };
+
+    fprintf(stderr, "%s -> %s\n", message, status <= FMIPending ? statusNames[status] : "Unknown status");
+}
+
+static void printUsage(void) {
+    printf(
+        "Usage: fmusim [OPTION]... UNZIPDIR\n"
+        "Simulate the unzipped Functional Mock-up Unit in UNZIPDIR.\n"
+        "\n"
+        "FMU archives (.fmu) are not extracted by fmusim and have to be unzipped beforehand,\n"
+        "e.g. with \"unzip BouncingBall.fmu -d BouncingBall\".\n"
+        "\n"
+        "  --help                     display this help and exit\n"
+        "  --interface-type [me|cs]   the interface type to use\n"
+        "  --start-time TIME          the start time of the simulation\n"
+        "  --stop-time TIME           the stop time of the simulation\n"
+        "  --output-interval INTERVAL the interval between two output samples\n"
+        "  --step-size STEP           the communication step size or fixed solver step size (default: output interval)\n"
+        "  --tolerance TOLERANCE      the relative tolerance\n"
+        "  --solver [euler|rk45|bdf]  the solver to use for Model Exchange: fixed step forward Euler (default),\n"
+        "                             variable step Dormand-Prince or BDF (for stiff systems)\n"
+        "  --start-value NAME VALUE   set a start value\n"
+        "  --input-file FILE          read inputs from a CSV file\n"
+        "  --input-interpolation [linear|step]\n"
+        "                             the interpolation of continuous inputs (default: linear)\n"
+        "  --output-variable NAME     record the variable (default: all outputs)\n"
+        "  --output-file FILE         write the output to a file (default: stdout)\n"
+        "  --output-format [csv|binary]\n"
+        "                             the format of the output file (default: csv)\n"
+        "  --log-fmi-calls            log the FMI calls to stderr\n"
+        "  --out-of-process           run the FMU in a host process (FMI 3.0 on Linux)\n"
+        "\n"
+        "Example:\n"
+        "\n"
+        "  fmusim --stop-time 5 --output-interval 0.1 --output-file BouncingBall_out.csv BouncingBall\n"
+    );
+}
+
+typedef struct {
+    const char* name;
+    FMISolverCreate* create;
+    FMISolverFree* free;
+    FMISolverStep* step;
+    FMISolverReset* reset;
+} SolverEntry;
+
+static const SolverEntry solvers[] = {
+    { "euler", FMIEulerCreate,      FMIEulerFree,      FMIEulerStep,      FMIEulerReset      },
+    { "rk45",  FMIRungeKuttaCreate, FMIRungeKuttaFree, FMIRungeKuttaStep, FMIRungeKuttaReset },
+    { "bdf",   FMIBDFCreate,        FMIBDFFree,        FMIBDFStep,        FMIBDFReset        }
+};
+
+int main(int argc, const char* argv[]) {
+
+    FMIStatus status = FMIError;
+
+    const char* unzipdir = NULL;
+    const char* interfaceType = NULL;
+    const char* solverName = "euler";
+    const char* inputFile = NULL;
+    const char* inputInterpolation = "linear";
+    const char* outputFile = NULL;
+    const char* outputFormat = "csv";
+
+    const char* startTime = NULL;
+    const char* stopTime = NULL;
+    const char* outputInterval = NULL;
+    const char* stepSize = NULL;
+    const char* tolerance = NULL;
+
+    size_t nStartValues = 0;
+    const char** startNames = NULL;
+    const char** startValues = NULL;
+    const FMIModelVariable** startVariables = NULL;
+
+    size_t nOutputVariables = 0;
+    const char** outputNames = NULL;
+    const FMIModelVariable** outputVariables = NULL;
+
+    FMIModelDescription* modelDescription = NULL;
+    FMIInstance* S = NULL;
+    FMIInputTable* input = NULL;
+    FMIRecorder* recorder = NULL;
+
+    if (FMICalloc((void**)&startNames, argc, sizeof(char*)) != FMIOK ||
+        FMICalloc((void**)&startValues, argc, sizeof(char*)) != FMIOK ||
+        FMICalloc((void**)&startVariables, argc, sizeof(FMIModelVariable*)) != FMIOK ||
+        FMICalloc((void**)&outputNames, argc, sizeof(char*)) != FMIOK) {
+        goto TERMINATE;
+    }
+
+    for (int i = 1; i < argc; i++) {
+
+        const char* v = argv[i];
+
+        if (!strcmp(v, "--help")) {
+            printUsage();
+            status = FMIOK;
+            goto TERMINATE;
+        } else if (!strcmp(v, "--log-fmi-calls")) {
+            logFMICalls = true;
+        } else if (!strcmp(v, "--out-of-process")) {
+            outOfProcess = true;
+        } else if (!strcmp(v, "--start-value") && i + 2 < argc) {
+            startNames[nStartValues] = argv[++i];
+            startValues[nStartValues] = argv[++i];
+            nStartValues++;
+        } else if (!strcmp(v, "--output-variable") && i + 1 < argc) {
+            outputNames[nOutputVariables++] = argv[++i];
+        } else if (i + 1 < argc && !strcmp(v, "--interface-type")) {
+            interfaceType = argv[++i];
+        } else if (i + 1 < argc && !strcmp(v, "--start-time")) {
+            startTime = argv[++i];
+        } else if (i + 1 < argc && !strcmp(v, "--stop-time")) {
+            stopTime = argv[++i];
+        } else if (i + 1 < argc && !strcmp(v, "--output-interval")) {
+            outputInterval = argv[++i];
+        } else if (i + 1 < argc && !strcmp(v, "--tolerance")) {
+            tolerance = argv[++i];
+        } else if (i + 1 < argc && !strcmp(v, "--solver")) {
+            solverName = argv[++i];
+        } else if (i + 1 < argc && !strcmp(v, "--input-file")) {
+            inputFile = argv[++i];
+        } else if (i + 1 < argc && !strcmp(v, "--input-interpolation")) {
+            inputInterpolation = argv[++i];
+        } else if (i + 1 < argc && !strcmp(v, "--output-file")) {
+            outputFile = argv[++i];
+        } else if (i + 1 < argc && !strcmp(v, "--output-format")) {
+            outputFormat = argv[++i];
+        } else if (i + 1 < argc && !strcmp(v, "--step-size")) {
+            stepSize = argv[++i];
+        } else if (i == argc - 1 && strncmp(v, "--", 2)) {
+            unzipdir = v;
+        } else {
+            printf("Unknown or incomplete option %s.\n\n", v);
+            printUsage();
+            goto TERMINATE;
+        }
+    }
+
+    if (!unzipdir) {
+        printUsage();
+        goto TERMINATE;
+    }
+
+    const size_t length = strlen(unzipdir);
+
+    if (length > 4 && !strcmp(&unzipdir[length - 4], ".fmu")) {
+        printf("%s is an FMU archive. Unzip the FMU and pass the directory instead.\n", unzipdir);
+        goto TERMINATE;
+    }
+
+    char modelDescriptionPath[4096] = "";
+
+    snprintf(modelDescriptionPath, sizeof(modelDescriptionPath), "%s" FMI_FILE_SEPARATOR "modelDescription.xml", unzipdir);
+
+    modelDescription = FMIReadModelDescription(modelDescriptionPath);
+
+    if (!modelDescription) {
+        goto TERMINATE;
+    }
+
+    FMISimulationSettings settings;
+
+    memset(&settings, 0, sizeof(settings));
+
+    // interface type
+    const char* modelIdentifier = NULL;
+
+    if (interfaceType && !strcmp(interfaceType, "me")) {
+        settings.interfaceType = FMIModelExchange;
+    } else if (interfaceType && !strcmp(interfaceType, "cs")) {
+        settings.interfaceType = FMICoSimulation;
+    } else if (interfaceType) {
+        printf("Unknown interface type %s.\n", interfaceType);
+        goto TERMINATE;
+    } else {
+        settings.interfaceType = modelDescription->coSimulation ? FMICoSimulation : FMIModelExchange;
+    }
+
+    if (settings.interfaceType == FMICoSimulation && modelDescription->coSimulation) {
+        modelIdentifier = modelDescription->coSimulation->modelIdentifier;
+    } else if (settings.interfaceType == FMIModelExchange && modelDescription->modelExchange) {
+        modelIdentifier = modelDescription->modelExchange->modelIdentifier;
+    } else {
+        printf("The FMU does not support the selected interface type.\n");
+        goto TERMINATE;
+    }
+
+    // experiment
+    const FMIDefaultExperiment* defaultExperiment = modelDescription->defaultExperiment;
+
+    if (!startTime && defaultExperiment && defaultExperiment->startTime) {
+        startTime = defaultExperiment->startTime;
+    }
+
+    if (!stopTime && defaultExperiment && defaultExperiment->stopTime) {
+        stopTime = defaultExperiment->stopTime;
+    }
+
+    if (!tolerance && defaultExperiment && defaultExperiment->tolerance) {
+        tolerance = defaultExperiment->tolerance;
+    }
+
+    settings.startTime = startTime ? strtod(startTime, NULL) : 0;
+    settings.stopTime  = stopTime ? strtod(stopTime, NULL) : settings.startTime + 1;
+    settings.tolerance = tolerance ? strtod(tolerance, NULL) : 0;
+
+    double interval;
+
+    if (outputInterval) {
+        interval = strtod(outputInterval, NULL);
+    } else if (defaultExperiment && defaultExperiment->stepSize) {
+        interval = strtod(defaultExperiment->stepSize, NULL);
+    } else {
+        interval = (settings.stopTime - settings.startTime) / 500;
+    }
+
+    settings.stepSize = stepSize ? strtod(stepSize, NULL) : interval;
+
+    if (interval <= 0 || settings.stepSize <= 0 || settings.stopTime < settings.startTime) {
+        printf("The output interval and step size must be positive and the stop time must not be before the start time.\n");
+        goto TERMINATE;
+    }
+
+    FMIResultFormat format;
+
+    if (!strcmp(outputFormat, "csv")) {
+        format = FMICSVFormat;
+    } else if (!strcmp(outputFormat, "binary")) {
+        format = FMIBinaryFormat;
+    } else {
+        printf("Unknown output format %s.\n", outputFormat);
+        goto TERMINATE;
+    }
+
+    // solver
+    const SolverEntry* solver = NULL;
+
+    for (size_t i = 0; i < sizeof(solvers) / sizeof(solvers[0]); i++) {
+        if (!strcmp(solvers[i].name, solverName)) {
+            solver = &solvers[i];
+        }
+    }
+
+    if (!solver) {
+        printf("Unknown solver %s.\n", solverName);
+        goto TERMINATE;
+    }
+
+    settings.solverCreate = solver->create;
+    settings.solverFree   = solver->free;
+    settings.solverStep   = solver->step;
+    settings.solverReset  = solver->reset;
+
+    // start values
+    for (size_t i = 0; i < nStartValues; i++) {
+
+        startVariables[i] = FMIModelVariableForName(modelDescription, startNames[i]);
+
+        if (!startVariables[i]) {
+            printf("Variable %s does not exist.\n", startNames[i]);
+            goto TERMINATE;
+        }
+    }
+
+    settings.nStartValues   = nStartValues;
+    settings.startVariables = startVariables;
+    settings.startValues    = startValues;
+
+    // inputs
+    if (inputFile) {
+
+        FMIInterpolation interpolation;
+
+        if (!strcmp(inputInterpolation, "linear")) {
+            interpolation = FMILinearInterpolation;
+        } else if (!strcmp(inputInterpolation, "step")) {
+            interpolation = FMIStepInterpolation;
+        } else {
+            printf("Unknown input interpolation %s.\n", inputInterpolation);
+            goto TERMINATE;
+        }
+
+        input = FMIReadInput(modelDescription, inputFile, interpolation);
+
+        if (!input) {
+            goto TERMINATE;
+        }
+
+        settings.input = input;
+    }
+
+    // outputs
+    if (nOutputVariables > 0) {
+
+        if (FMICalloc((void**)&outputVariables, nOutputVariables, sizeof(FMIModelVariable*)) != FMIOK) {
+            goto TERMINATE;
+        }
+
+        for (size_t i = 0; i < nOutputVariables; i++) {
+
+            outputVariables[i] = FMIModelVariableForName(modelDescription, outputNames[i]);
+
+            if (!outputVariables[i]) {
+                printf("Variable %s does not exist.\n", outputNames[i]);
+                goto TERMINATE;
+            }
+        }
+
+    } else {
+
+        if (FMICalloc((void**)&outputVariables, modelDescription->nModelVariables, sizeof(FMIModelVariable*)) != FMIOK) {
+            goto TERMINATE;
+        }
+
+        for (size_t i = 0; i < modelDescription->nModelVariables; i++) {
+
+            const FMIModelVariable* variable = &modelDescription->modelVariables[i];
+
+            if (variable->causality == FMIOutput && variable->type != FMIClockType) {
+                outputVariables[nOutputVariables++] = variable;
+            }
+        }
+    }
+
+#if defined(STATIC_MODEL_IDENTIFIER)
+    // the model is linked statically and the FMI functions are called directly
+    if (strcmp(modelIdentifier, STATIC_MODEL_IDENTIFIER) || modelDescription->fmiMajorVersion != FMI_VERSION) {
+        printf("This executable can only simulate " STATIC_MODEL_IDENTIFIER " (FMI %d).\n", FMI_VERSION);
+        goto TERMINATE;
+    }
+#else
+    char platformBinaryPath[4096] = "";
+
+    if (FMIPlatformBinaryPath(unzipdir, modelIdentifier, modelDescription->fmiMajorVersion, platformBinaryPath, sizeof(platformBinaryPath)) != FMIOK) {
+        goto TERMINATE;
+    }
+#endif
+
+    // the arguments are only formatted if a callback is set
+    S = FMICreateInstance("instance1", logMessage, logFMICalls ? logFunctionCall : NULL);
+
+    if (!S) {
+        goto TERMINATE;
+    }
+
+#if !defined(STATIC_MODEL_IDENTIFIER)
+    if (outOfProcess) {
+
+        if (modelDescription->fmiMajorVersion != FMIMajorVersion3) {
+            printf("Only FMI 3.0 FMUs can be run in a host process.\n");
+            goto TERMINATE;
+        }
+
+        if (FMILoadRemotePlatformBinary(S, NULL, platformBinaryPath) != FMIOK) {
+            goto TERMINATE;
+        }
+
+    } else if (FMILoadPlatformBinary(S, platformBinaryPath) != FMIOK) {
+        goto TERMINATE;
+    }
+#endif
+
+    S->fmiMajorVersion = modelDescription->fmiMajorVersion;
+
+    // record every sample if the output interval is the step size
+    recorder = FMICreateRecorder(S, nOutputVariables, outputVariables, format, settings.stepSize == interval ? 0 : interval, outputFile);
+
+    if (!recorder) {
+        goto TERMINATE;
+    }
+
+    settings.recorder = recorder;
+
+    status = FMISimulate(S, modelDescription, unzipdir, &settings);
+
+    const FMIStatus flushStatus = FMIFlushRecorder(recorder);
+
+    if (flushStatus > status) {
+        status = flushStatus;
+    }
+
+TERMINATE:
+
+    FMIFreeRecorder(recorder);
+    FMIFreeInput(input);
+    FMIFreeInstance(S);
+    FMIFreeModelDescription(modelDescription);
+
+    free(startNames);
+    free(startValues);
+    free(startVariables);
+    free(outputNames);
+    free(outputVariables);
+
+    return status > FMIWarning ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,119 @@
+# fmusim
+set(FMUSIM_SOURCES
+    include/FMI.h
+    include/FMI2.h
+    include/FMI3.h
+    include/FMIModelDescription.h
+    include/FMIRemote.h
+    src/FMI.c
+    src/FMI2.c
+    src/FMI3.c
+    src/FMIModelDescription.c
+    src/FMIRemote.c
+    fmusim/FMIBDF.h
+    fmusim/FMIBDF.c
+    fmusim/FMIEuler.h
+    fmusim/FMIEuler.c
+    fmusim/FMIInputTable.h
+    fmusim/FMIInputTable.c
+    fmusim/FMILoopSolver.h
+    fmusim/FMILoopSolver.c
+    fmusim/FMIMaster.h
+    fmusim/FMIMaster.c
+    fmusim/FMIRecorder.h
+    fmusim/FMIRecorder.c
+    fmusim/FMIResult.h
+    fmusim/FMIResult.c
+    fmusim/FMIRootFinder.h
+    fmusim/FMIRootFinder.c
+    fmusim/FMIRungeKutta.h
+    fmusim/FMIRungeKutta.c
+    fmusim/FMISimulation.h
+    fmusim/FMISimulation.c
+    fmusim/FMISolver.h
+    fmusim/FMISystem.h
+    fmusim/FMISystem.c
+    fmusim/FMIThread.h
+    fmusim/FMIThread.c
+    fmusim/FMIThreadPool.h
+    fmusim/FMIThreadPool.c
+    fmusim/FMIUtil.h
+    fmusim/FMIUtil.c
+    fmusim/fmusim_fmi2_cs.c
+    fmusim/fmusim_fmi2_me.c
+    fmusim/fmusim_fmi3_cs.c
+    fmusim/fmusim_fmi3_me.c
+)
+
+find_package(Threads REQUIRED)
+
+add_executable(fmusim ${FMUSIM_SOURCES} fmusim/fmusim.c)
+
+# converts binary results to CSV
+add_executable(result2csv ${FMUSIM_SOURCES} fmusim/result2csv.c)
+
+# co-simulates connected FMUs
+add_executable(fmucosim ${FMUSIM_SOURCES} fmusim/fmucosim.c)
+
+set(FMUSIM_TARGETS fmusim result2csv fmucosim)
+
+if (CMAKE_SYSTEM_NAME STREQUAL "Linux")
+    # runs the platform binary of an FMU for fmusim --out-of-process
+    add_executable(fmuhost include/FMI.h include/FMI3.h include/FMIRemote.h src/FMI.c src/FMI3.c src/FMIRemote.c fmusim/fmuhost.c)
+    list(APPEND FMUSIM_TARGETS fmuhost)
+endif ()
+
+if (UNIX)
+    # serves the FMUs of a system to clients on a UNIX domain socket
+    add_executable(fmuserver ${FMUSIM_SOURCES} fmusim/FMIServer.h fmusim/FMIServer.c fmusim/fmuserver.c)
+    list(APPEND FMUSIM_TARGETS fmuserver)
+endif ()
+
+if (BUILD_STATIC_MODELS)
+
+    # fmusim_<model> calls the FMI functions of the statically linked model directly
+    foreach (MODEL_NAME ${ALL_MODEL_NAMES})
+
+        set(TARGET fmusim_${MODEL_NAME})
+
+        add_executable(${TARGET} ${FMUSIM_SOURCES} fmusim/fmusim.c)
+
+        target_compile_definitions(${TARGET} PRIVATE
+            FMI_VERSION=${FMI_VERSION}
+            FMI${FMI_VERSION}_FUNCTION_PREFIX=${MODEL_NAME}_
+            STATIC_MODEL_IDENTIFIER="${MODEL_NAME}"
+        )
+
+        target_link_libraries(${TARGET} ${MODEL_NAME}_static)
+
+        set_target_properties(${TARGET} PROPERTIES INTERPROCEDURAL_OPTIMIZATION ${IPO_SUPPORTED})
+
+        list(APPEND FMUSIM_TARGETS ${TARGET})
+
+    endforeach ()
+
+endif ()
+
+foreach (TARGET ${FMUSIM_TARGETS})
+
+    set_target_properties(${TARGET} PROPERTIES FOLDER fmusim)
+    target_include_directories(${TARGET} PRIVATE include fmusim)
+    target_link_libraries(${TARGET} Threads::Threads)
+
+    if (MSVC)
+        target_link_libraries(${TARGET} shlwapi.lib)
+    elseif(UNIX AND NOT APPLE)
+        target_link_libraries(${TARGET} ${CMAKE_DL_LIBS} m)
+    else ()
+        target_link_libraries(${TARGET} ${CMAKE_DL_LIBS})
+    endif()
+
+    set_target_properties(${TARGET} PROPERTIES
+        RUNTIME_OUTPUT_DIRECTORY         temp
+        RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+        RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+    )
+
+endforeach ()
+
+install(TARGETS ${FMUSIM_TARGETS} DESTINATION ${CMAKE_INSTALL_PREFIX})
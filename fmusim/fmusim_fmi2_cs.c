@@ -0,0 +1,66 @@
+#include <math.h>
+#include <stdint.h>
+
+#include "FMI2.h"
+#include "FMIUtil.h"
+#include "FMISimulation.h"
+
+
+#define CALL(f) do { status = f; if (status > FMIWarning) goto TERMINATE; } while (0)
+
+FMIStatus FMISimulateFMI2CS(FMIInstance* S, const FMIModelDescription* modelDescription, const char* resourceURI, const FMISimulationSettings* settings) {
+
+    FMIStatus status = FMIOK;
+
+    fmi2Real time = settings->startTime;
+
+    CALL(FMI2Instantiate(S, resourceURI, fmi2CoSimulation, modelDescription->instantiationToken, fmi2False, fmi2False));
+
+    CALL(FMIApplyStartValues(S, settings->nStartValues, settings->startVariables, settings->startValues));
+
+    CALL(FMIApplyInput(S, settings->input, time, true, true, false));
+
+    CALL(FMI2SetupExperiment(S, settings->tolerance > 0, settings->tolerance, time, fmi2True, settings->stopTime));
+
+    CALL(FMI2EnterInitializationMode(S));
+
+    CALL(FMI2ExitInitializationMode(S));
+
+    CALL(FMISample(S, time, settings->recorder, false));
+
+    for (uint64_t step = 1; time < settings->stopTime; step++) {
+
+        const fmi2Real nextCommunicationPoint = fmin(settings->startTime + step * settings->stepSize, settings->stopTime);
+
+        CALL(FMIDiscardInput(settings->input, time));
+
+        CALL(FMIApplyInput(S, settings->input, time, true, true, true));
+
+        if (modelDescription->coSimulation->canInterpolateInputs) {
+            CALL(FMIApplyInputDerivatives(S, settings->input, time));
+        }
+
+        CALL(FMI2DoStep(S, time, nextCommunicationPoint - time, fmi2True));
+
+        time = nextCommunicationPoint;
+
+        CALL(FMISample(S, time, settings->recorder, time >= settings->stopTime));
+    }
+
+TERMINATE:
+
+    if (status < FMIError) {
+
+        const FMIStatus terminateStatus = FMI2Terminate(S);
+
+        if (terminateStatus > status) {
+            status = terminateStatus;
+        }
+    }
+
+    if (status != FMIFatal) {
+        FMI2FreeInstance(S);
+    }
+
+    return status;
+}
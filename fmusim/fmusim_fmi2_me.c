@@ -0,0 +1,188 @@
+#include <math.h>
+#include <stdint.h>
+
+#include "FMI2.h"
+#include "FMIUtil.h"
+#include "FMISimulation.h"
+
+
+#define CALL(f) do { status = f; if (status > FMIWarning) goto TERMINATE; } while (0)
+
+static FMIStatus getDirectionalDerivative(FMIInstance* instance, const FMIValueReference unknowns[], size_t nUnknowns, const FMIValueReference knowns[], size_t nKnowns, const double seed[], double sensitivity[]) {
+    return FMI2GetDirectionalDerivative(instance, unknowns, nUnknowns, knowns, nKnowns, seed, sensitivity);
+}
+
+FMIStatus FMISimulateFMI2ME(FMIInstance* S, const FMIModelDescription* modelDescription, const char* resourceURI, const FMISimulationSettings* settings) {
+
+    FMIStatus status = FMIOK;
+
+    FMISolver* solver = NULL;
+
+    fmi2Boolean inputEvent = fmi2False;
+    fmi2Boolean timeEvent  = fmi2False;
+    fmi2Boolean stepEvent  = fmi2False;
+
+    bool stateEvent = false;
+
+    fmi2EventInfo eventInfo = {
+        .newDiscreteStatesNeeded           = fmi2True,
+        .terminateSimulation               = fmi2False,
+        .nominalsOfContinuousStatesChanged = fmi2False,
+        .valuesOfContinuousStatesChanged   = fmi2False,
+        .nextEventTimeDefined              = fmi2False,
+        .nextEventTime                     = INFINITY
+    };
+
+    fmi2Boolean terminateSimulation = fmi2False;
+
+    fmi2Real time = settings->startTime;
+
+    CALL(FMI2Instantiate(S, resourceURI, fmi2ModelExchange, modelDescription->instantiationToken, fmi2False, fmi2False));
+
+    CALL(FMIApplyStartValues(S, settings->nStartValues, settings->startVariables, settings->startValues));
+
+    CALL(FMIApplyInput(S, settings->input, time, true, true, false));
+
+    CALL(FMI2SetupExperiment(S, settings->tolerance > 0, settings->tolerance, time, fmi2True, settings->stopTime));
+
+    CALL(FMI2EnterInitializationMode(S));
+
+    CALL(FMI2ExitInitializationMode(S));
+
+    // initial event iteration
+    while (eventInfo.newDiscreteStatesNeeded) {
+
+        CALL(FMI2NewDiscreteStates(S, &eventInfo));
+
+        if (eventInfo.terminateSimulation) {
+            goto TERMINATE;
+        }
+    }
+
+    CALL(FMI2EnterContinuousTimeMode(S));
+
+    const FMISolverParameters solverParameters = {
+        .instance                      = S,
+        .modelDescription              = modelDescription,
+        .input                         = settings->input,
+        .startTime                     = time,
+        .tolerance                     = settings->tolerance,
+        .nx                            = modelDescription->nDerivatives,
+        .nz                            = modelDescription->nEventIndicators,
+        .setTime                       = FMI2SetTime,
+        .applyInput                    = FMIApplyInput,
+        .getContinuousStates           = FMI2GetContinuousStates,
+        .setContinuousStates           = FMI2SetContinuousStates,
+        .getNominalsOfContinuousStates = FMI2GetNominalsOfContinuousStates,
+        .getContinuousStateDerivatives = FMI2GetDerivatives,
+        .getEventIndicators            = FMI2GetEventIndicators,
+        .getDirectionalDerivative      = getDirectionalDerivative
+    };
+
+    solver = settings->solverCreate(&solverParameters);
+
+    if (!solver) {
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    CALL(FMISample(S, time, settings->recorder, false));
+
+    uint64_t step = 0;
+
+    while (!terminateSimulation && time < settings->stopTime) {
+
+        const fmi2Real nextCommunicationPoint = fmin(settings->startTime + (step + 1) * settings->stepSize, settings->stopTime);
+
+        fmi2Real nextInputEventTime;
+        bool isInputEvent;
+
+        CALL(FMIDiscardInput(settings->input, time));
+
+        CALL(FMINextInputEventTime(settings->input, time, &nextInputEventTime, &isInputEvent));
+
+        // variable step solvers can step beyond the communication point but not beyond an event
+        fmi2Real maxTime = settings->stopTime;
+
+        if (nextInputEventTime < maxTime) {
+            maxTime = nextInputEventTime;
+        }
+
+        if (eventInfo.nextEventTimeDefined && eventInfo.nextEventTime < maxTime) {
+            maxTime = eventInfo.nextEventTime;
+        }
+
+        const fmi2Real nextTime = fmin(nextCommunicationPoint, maxTime);
+
+        // integrate and set the continuous inputs
+        CALL(settings->solverStep(solver, nextTime, maxTime, &time, &stateEvent));
+
+        if (time == nextCommunicationPoint) {
+            step++;
+        }
+
+        CALL(FMI2CompletedIntegratorStep(S, fmi2True, &stepEvent, &terminateSimulation));
+
+        if (terminateSimulation) {
+            break;
+        }
+
+        inputEvent = isInputEvent && time >= nextInputEventTime;
+        timeEvent  = eventInfo.nextEventTimeDefined && time >= eventInfo.nextEventTime;
+
+        const bool event = inputEvent || timeEvent || stateEvent || stepEvent;
+
+        if (event) {
+
+            // record the left limit
+            CALL(FMISample(S, time, settings->recorder, true));
+
+            CALL(FMI2EnterEventMode(S));
+
+            if (inputEvent) {
+                CALL(FMIApplyInput(S, settings->input, time, true, true, true));
+            }
+
+            eventInfo.newDiscreteStatesNeeded = fmi2True;
+
+            while (eventInfo.newDiscreteStatesNeeded) {
+
+                CALL(FMI2NewDiscreteStates(S, &eventInfo));
+
+                if (eventInfo.terminateSimulation) {
+                    goto TERMINATE;
+                }
+            }
+
+            CALL(FMI2EnterContinuousTimeMode(S));
+
+            CALL(settings->solverReset(solver, time));
+        }
+
+        // skip the intermediate stops at the end of the buffered input
+        if (time == nextCommunicationPoint || event) {
+            CALL(FMISample(S, time, settings->recorder, event || time >= settings->stopTime));
+        }
+    }
+
+TERMINATE:
+
+    if (solver) {
+        settings->solverFree(solver);
+    }
+
+    if (status < FMIError) {
+
+        const FMIStatus terminateStatus = FMI2Terminate(S);
+
+        if (terminateStatus > status) {
+            status = terminateStatus;
+        }
+    }
+
+    if (status != FMIFatal) {
+        FMI2FreeInstance(S);
+    }
+
+    return status;
+}
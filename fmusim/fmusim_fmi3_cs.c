@@ -0,0 +1,78 @@
+#include <math.h>
+
+#include "FMI3.h"
+#include "FMIUtil.h"
+#include "FMISimulation.h"
+
+
+#define CALL(f) do { status = f; if (status > FMIWarning) goto TERMINATE; } while (0)
+
+FMIStatus FMISimulateFMI3CS(FMIInstance* S, const FMIModelDescription* modelDescription, const char* resourcePath, const FMISimulationSettings* settings) {
+
+    FMIStatus status = FMIOK;
+
+    fmi3Boolean eventHandlingNeeded = fmi3False;
+    fmi3Boolean terminateSimulation = fmi3False;
+    fmi3Boolean earlyReturn = fmi3False;
+    fmi3Float64 lastSuccessfulTime = settings->startTime;
+
+    fmi3Float64 time = settings->startTime;
+
+    CALL(FMI3InstantiateCoSimulation(S,
+        modelDescription->instantiationToken, // instantiationToken
+        resourcePath,                         // resourcePath
+        fmi3False,                            // visible
+        fmi3False,                            // loggingOn
+        fmi3False,                            // eventModeUsed
+        fmi3False,                            // earlyReturnAllowed
+        NULL,                                 // requiredIntermediateVariables
+        0,                                    // nRequiredIntermediateVariables
+        NULL                                  // intermediateUpdate
+    ));
+
+    CALL(FMIApplyStartValues(S, settings->nStartValues, settings->startVariables, settings->startValues));
+
+    CALL(FMIApplyInput(S, settings->input, time, true, true, false));
+
+    CALL(FMI3EnterInitializationMode(S, settings->tolerance > 0, settings->tolerance, time, fmi3True, settings->stopTime));
+
+    CALL(FMI3ExitInitializationMode(S));
+
+    CALL(FMISample(S, time, settings->recorder, false));
+
+    for (uint64_t step = 1;; step++) {
+
+        if (terminateSimulation || time >= settings->stopTime) {
+            break;
+        }
+
+        const fmi3Float64 nextCommunicationPoint = fmin(settings->startTime + step * settings->stepSize, settings->stopTime);
+
+        CALL(FMIDiscardInput(settings->input, time));
+
+        CALL(FMIApplyInput(S, settings->input, time, true, true, true));
+
+        CALL(FMI3DoStep(S, time, nextCommunicationPoint - time, fmi3True, &eventHandlingNeeded, &terminateSimulation, &earlyReturn, &lastSuccessfulTime));
+
+        time = earlyReturn ? lastSuccessfulTime : nextCommunicationPoint;
+
+        CALL(FMISample(S, time, settings->recorder, time >= settings->stopTime));
+    }
+
+TERMINATE:
+
+    if (status < FMIError) {
+
+        const FMIStatus terminateStatus = FMI3Terminate(S);
+
+        if (terminateStatus > status) {
+            status = terminateStatus;
+        }
+    }
+
+    if (status != FMIFatal) {
+        FMI3FreeInstance(S);
+    }
+
+    return status;
+}
@@ -0,0 +1,211 @@
+#include <math.h>
+
+#include "FMI3.h"
+#include "FMIUtil.h"
+#include "FMISimulation.h"
+
+
+#define CALL(f) do { status = f; if (status > FMIWarning) goto TERMINATE; } while (0)
+
+static FMIStatus getDirectionalDerivative(FMIInstance* instance, const FMIValueReference unknowns[], size_t nUnknowns, const FMIValueReference knowns[], size_t nKnowns, const double seed[], double sensitivity[]) {
+    return FMI3GetDirectionalDerivative(instance, unknowns, nUnknowns, knowns, nKnowns, seed, nKnowns, sensitivity, nUnknowns);
+}
+
+FMIStatus FMISimulateFMI3ME(FMIInstance* S, const FMIModelDescription* modelDescription, const char* resourcePath, const FMISimulationSettings* settings) {
+
+    FMIStatus status = FMIOK;
+
+    FMISolver* solver = NULL;
+
+    fmi3Boolean inputEvent = fmi3False;
+    fmi3Boolean timeEvent  = fmi3False;
+    fmi3Boolean stateEvent = fmi3False;
+    fmi3Boolean stepEvent  = fmi3False;
+
+    fmi3Boolean discreteStatesNeedUpdate          = fmi3True;
+    fmi3Boolean terminateSimulation               = fmi3False;
+    fmi3Boolean nominalsOfContinuousStatesChanged = fmi3False;
+    fmi3Boolean valuesOfContinuousStatesChanged   = fmi3False;
+    fmi3Boolean nextEventTimeDefined              = fmi3False;
+    fmi3Float64 nextEventTime                     = INFINITY;
+
+    fmi3Float64 time = settings->startTime;
+
+    size_t nx = 0;
+    size_t nz = 0;
+
+    CALL(FMI3InstantiateModelExchange(S,
+        modelDescription->instantiationToken, // instantiationToken
+        resourcePath,                         // resourcePath
+        fmi3False,                            // visible
+        fmi3False                             // loggingOn
+    ));
+
+    CALL(FMIApplyStartValues(S, settings->nStartValues, settings->startVariables, settings->startValues));
+
+    CALL(FMIApplyInput(S, settings->input, time, true, true, false));
+
+    CALL(FMI3EnterInitializationMode(S, settings->tolerance > 0, settings->tolerance, time, fmi3True, settings->stopTime));
+
+    CALL(FMI3ExitInitializationMode(S));
+
+    // initial event iteration
+    while (discreteStatesNeedUpdate) {
+
+        CALL(FMI3UpdateDiscreteStates(S,
+            &discreteStatesNeedUpdate,
+            &terminateSimulation,
+            &nominalsOfContinuousStatesChanged,
+            &valuesOfContinuousStatesChanged,
+            &nextEventTimeDefined,
+            &nextEventTime));
+
+        if (terminateSimulation) {
+            goto TERMINATE;
+        }
+    }
+
+    CALL(FMI3EnterContinuousTimeMode(S));
+
+    CALL(FMI3GetNumberOfContinuousStates(S, &nx));
+    CALL(FMI3GetNumberOfEventIndicators(S, &nz));
+
+    const FMISolverParameters solverParameters = {
+        .instance                      = S,
+        .modelDescription              = modelDescription,
+        .input                         = settings->input,
+        .startTime                     = time,
+        .tolerance                     = settings->tolerance,
+        .nx                            = nx,
+        .nz                            = nz,
+        .setTime                       = FMI3SetTime,
+        .applyInput                    = FMIApplyInput,
+        .getContinuousStates           = FMI3GetContinuousStates,
+        .setContinuousStates           = FMI3SetContinuousStates,
+        .getNominalsOfContinuousStates = FMI3GetNominalsOfContinuousStates,
+        .getContinuousStateDerivatives = FMI3GetContinuousStateDerivatives,
+        .getEventIndicators            = FMI3GetEventIndicators,
+        .getDirectionalDerivative      = getDirectionalDerivative
+    };
+
+    solver = settings->solverCreate(&solverParameters);
+
+    if (!solver) {
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    CALL(FMISample(S, time, settings->recorder, false));
+
+    uint64_t step = 0;
+
+    while (!terminateSimulation && time < settings->stopTime) {
+
+        const fmi3Float64 nextCommunicationPoint = fmin(settings->startTime + (step + 1) * settings->stepSize, settings->stopTime);
+
+        fmi3Float64 nextInputEventTime;
+        bool isInputEvent;
+
+        CALL(FMIDiscardInput(settings->input, time));
+
+        CALL(FMINextInputEventTime(settings->input, time, &nextInputEventTime, &isInputEvent));
+
+        // variable step solvers can step beyond the communication point but not beyond an event
+        fmi3Float64 maxTime = settings->stopTime;
+
+        if (nextInputEventTime < maxTime) {
+            maxTime = nextInputEventTime;
+        }
+
+        if (nextEventTimeDefined && nextEventTime < maxTime) {
+            maxTime = nextEventTime;
+        }
+
+        const fmi3Float64 nextTime = fmin(nextCommunicationPoint, maxTime);
+
+        // integrate and set the continuous inputs
+        CALL(settings->solverStep(solver, nextTime, maxTime, &time, &stateEvent));
+
+        if (time == nextCommunicationPoint) {
+            step++;
+        }
+
+        CALL(FMI3CompletedIntegratorStep(S, fmi3True, &stepEvent, &terminateSimulation));
+
+        if (terminateSimulation) {
+            break;
+        }
+
+        inputEvent = isInputEvent && time >= nextInputEventTime;
+        timeEvent  = nextEventTimeDefined && time >= nextEventTime;
+
+        const bool event = inputEvent || timeEvent || stateEvent || stepEvent;
+
+        if (event) {
+
+            // record the left limit
+            CALL(FMISample(S, time, settings->recorder, true));
+
+            CALL(FMI3EnterEventMode(S));
+
+            if (inputEvent) {
+                CALL(FMIApplyInput(S, settings->input, time, true, true, true));
+            }
+
+            nominalsOfContinuousStatesChanged = fmi3False;
+            valuesOfContinuousStatesChanged   = fmi3False;
+
+            do {
+
+                fmi3Boolean nominalsChanged = fmi3False;
+                fmi3Boolean statesChanged   = fmi3False;
+
+                CALL(FMI3UpdateDiscreteStates(S,
+                    &discreteStatesNeedUpdate,
+                    &terminateSimulation,
+                    &nominalsChanged,
+                    &statesChanged,
+                    &nextEventTimeDefined,
+                    &nextEventTime));
+
+                nominalsOfContinuousStatesChanged |= nominalsChanged;
+                valuesOfContinuousStatesChanged   |= statesChanged;
+
+                if (terminateSimulation) {
+                    goto TERMINATE;
+                }
+
+            } while (discreteStatesNeedUpdate);
+
+            CALL(FMI3EnterContinuousTimeMode(S));
+
+            CALL(settings->solverReset(solver, time));
+        }
+
+        // skip the intermediate stops at the end of the buffered input
+        if (time == nextCommunicationPoint || event) {
+            CALL(FMISample(S, time, settings->recorder, event || time >= settings->stopTime));
+        }
+    }
+
+TERMINATE:
+
+    if (solver) {
+        settings->solverFree(solver);
+    }
+
+    if (status < FMIError) {
+
+        const FMIStatus terminateStatus = FMI3Terminate(S);
+
+        if (terminateStatus > status) {
+            status = terminateStatus;
+        }
+    }
+
+    if (status != FMIFatal) {
+        FMI3FreeInstance(S);
+    }
+
+    return status;
+}
@@ -0,0 +1,75 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FMIResult.h"
+
+
+int main(int argc, const char* argv[]) {
+
+    FMIStatus status = FMIError;
+
+    FILE* input = NULL;
+    FILE* output = NULL;
+    FMIResultHeader* header = NULL;
+    FMIResultBlock* block = NULL;
+
+    if (argc < 2 || argc > 3) {
+        printf(
+            "Usage: result2csv RESULT_FILE [CSV_FILE]\n"
+            "Convert a binary result file written by fmusim to CSV (default: stdout).\n"
+        );
+        return EXIT_FAILURE;
+    }
+
+    input = fopen(argv[1], "rb");
+
+    if (!input) {
+        printf("Failed to open %s.\n", argv[1]);
+        goto TERMINATE;
+    }
+
+    output = argc > 2 ? fopen(argv[2], "w") : stdout;
+
+    if (!output) {
+        printf("Failed to open %s.\n", argv[2]);
+        goto TERMINATE;
+    }
+
+    header = FMIReadResultHeader(input);
+
+    if (!header) {
+        goto TERMINATE;
+    }
+
+    block = FMICreateResultBlock(header, 0);
+
+    if (!block || FMIWriteResultHeader(output, FMICSVFormat, header) != FMIOK) {
+        goto TERMINATE;
+    }
+
+    do {
+
+        if (FMIReadResultBlock(input, header, block) != FMIOK ||
+            FMIWriteResultBlock(output, FMICSVFormat, header, block) != FMIOK) {
+            goto TERMINATE;
+        }
+
+    } while (block->nRows > 0);
+
+    status = FMIOK;
+
+TERMINATE:
+
+    FMIFreeResultBlock(block);
+    FMIFreeResultHeader(header);
+
+    if (input) {
+        fclose(input);
+    }
+
+    if (output && output != stdout) {
+        fclose(output);
+    }
+
+    return status == FMIOK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
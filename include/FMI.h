@@ -139,6 +139,12 @@ typedef void FMILogMessage(FMIInstance *instance, FMIStatus status, const char *
 
 typedef void FMILogErrorMessage(const char* message, va_list args);
 
+typedef void (*FMIFunction)(void);
+
+typedef FMIFunction FMIGetFunction(FMIInstance *instance, const char *name);
+
+typedef void FMIFreeBackend(FMIInstance *instance);
+
 extern FMILogErrorMessage* logErrorMessage;
 
 struct FMIInstance_ {
@@ -153,6 +159,11 @@ struct FMIInstance_ {
     void *libraryHandle;
 #endif
 
+    // resolve the FMI functions if the platform binary is not loaded into this process (see FMIRemote.h)
+    FMIGetFunction *getFunction;
+    FMIFreeBackend *freeBackend;
+    void *backend;
+
     void *userData;
 
     FMILogMessage      *logMessage;
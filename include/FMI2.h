@@ -90,6 +90,11 @@ FMI_STATIC FMIStatus FMI2SetDebugLogging(FMIInstance *instance, fmi2Boolean logg
 FMI_STATIC FMIStatus FMI2Instantiate(FMIInstance *instance, const char *fmuResourceLocation, fmi2Type fmuType, fmi2String fmuGUID,
     fmi2Boolean visible, fmi2Boolean loggingOn);
 
+/* Instantiate a Co-Simulation FMU with the stepFinished callback, so fmi2DoStep() can return fmi2Pending.
+   The componentEnvironment passed to stepFinished is the instance. */
+FMI_STATIC FMIStatus FMI2InstantiateAsynchronous(FMIInstance *instance, const char *fmuResourceLocation, fmi2String fmuGUID,
+    fmi2Boolean visible, fmi2Boolean loggingOn, fmi2StepFinished stepFinished);
+
 FMI_STATIC void FMI2FreeInstance(FMIInstance *instance);
 
 /* Enter and exit initialization mode, terminate and reset */
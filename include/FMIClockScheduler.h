@@ -0,0 +1,48 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "FMI3.h"
+
+
+typedef enum {
+    FMIPeriodicClock,   // input clock with a constant, fixed or tunable interval
+    FMITriggeredClock,  // input clock that is triggered by the importer
+    FMICountdownClock,  // input clock whose interval is set by the FMU
+    FMIOutputClock      // output clock
+} FMIClockKind;
+
+typedef struct FMIClockScheduler FMIClockScheduler;
+
+typedef void FMIOutputClockTicked(FMIClockScheduler* scheduler, FMIValueReference valueReference, double time, void* userData);
+
+/* create a scheduler for the clocks of a Scheduled Execution instance with a time base of resolution seconds */
+FMIClockScheduler* FMICreateClockScheduler(FMIInstance* instance, double resolution, FMIOutputClockTicked* outputClockTicked, void* userData);
+
+void FMIFreeClockScheduler(FMIClockScheduler* scheduler);
+
+/* add a clock. Input clocks are activated in the order of their priority (lower value means higher priority,
+   0 to 62). An interval <= 0 of a periodic clock is read from the FMU. If supportsFraction is true the
+   intervals are read with fmi3GetIntervalFraction(). */
+FMIStatus FMIAddClock(FMIClockScheduler* scheduler, FMIValueReference valueReference, FMIClockKind kind, int priority, double interval, double shift, bool supportsFraction);
+
+/* read the unknown intervals and schedule the first activations of the periodic clocks */
+FMIStatus FMIStartClockScheduler(FMIClockScheduler* scheduler, double startTime);
+
+/* schedule the activation of a triggered clock */
+FMIStatus FMITriggerClock(FMIClockScheduler* scheduler, FMIValueReference valueReference, double time);
+
+/* activate the model partitions of all clocks that tick until time (inclusive) */
+FMIStatus FMIAdvanceClockScheduler(FMIClockScheduler* scheduler, double time);
+
+/* to be called from the clockUpdate callback: schedules the countdown clocks and reports the output clocks */
+FMIStatus FMIClockSchedulerClockUpdate(FMIClockScheduler* scheduler);
+
+#ifdef __cplusplus
+}  /* end of extern "C" { */
+#endif
@@ -0,0 +1,187 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "FMI.h"
+
+
+typedef enum {
+    FMIParameter,
+    FMICalculatedParameter,
+    FMIStructuralParameter,
+    FMIInput,
+    FMIOutput,
+    FMILocal,
+    FMIIndependent
+} FMICausality;
+
+typedef enum {
+    FMIConstant,
+    FMIFixed,
+    FMITunable,
+    FMIDiscrete,
+    FMIContinuous
+} FMIVariability;
+
+typedef enum {
+    FMIInitialUndefined,
+    FMIExact,
+    FMIApprox,
+    FMICalculated
+} FMIInitial;
+
+typedef struct FMIModelVariable_ FMIModelVariable;
+
+typedef struct {
+
+    // fixed size (used if variable is NULL)
+    size_t start;
+
+    // structural parameter that holds the size
+    FMIValueReference valueReference;
+    FMIModelVariable* variable;
+
+} FMIDimension;
+
+struct FMIModelVariable_ {
+
+    FMIVariableType type;
+
+    // strings point into the buffer of the model description
+    const char* name;
+    const char* description;
+    const char* start;
+    const char* declaredType;
+
+    FMIValueReference valueReference;
+
+    FMICausality causality;
+    FMIVariability variability;
+    FMIInitial initial;
+
+    // state variable if this variable is a state derivative
+    FMIModelVariable* derivative;
+
+    size_t nDimensions;
+    FMIDimension* dimensions;
+
+};
+
+typedef struct {
+
+    FMIModelVariable* modelVariable;
+
+    size_t nDependencies;
+    FMIModelVariable** dependencies;
+
+} FMIUnknown;
+
+typedef struct {
+
+    const char* modelIdentifier;
+
+    bool canGetAndSetFMUState;
+    bool providesDirectionalDerivatives;
+    bool needsCompletedIntegratorStep;
+
+} FMIModelExchangeInterface;
+
+typedef struct {
+
+    const char* modelIdentifier;
+
+    bool canGetAndSetFMUState;
+    bool providesDirectionalDerivatives;
+    bool canHandleVariableCommunicationStepSize;
+    bool canInterpolateInputs;
+    bool hasEventMode;
+    bool providesIntermediateUpdate;
+    bool canReturnEarlyAfterIntermediateUpdate;
+
+    double fixedInternalStepSize;
+
+    int maxOutputDerivativeOrder;
+
+} FMICoSimulationInterface;
+
+typedef struct {
+
+    const char* modelIdentifier;
+
+} FMIScheduledExecutionInterface;
+
+typedef struct {
+
+    const char* startTime;
+    const char* stopTime;
+    const char* tolerance;
+    const char* stepSize;
+
+} FMIDefaultExperiment;
+
+typedef struct {
+
+    FMIMajorVersion fmiMajorVersion;
+
+    const char* fmiVersion;
+    const char* modelName;
+    const char* description;
+    const char* generationTool;
+    const char* instantiationToken;
+
+    FMIModelExchangeInterface* modelExchange;
+    FMICoSimulationInterface* coSimulation;
+    FMIScheduledExecutionInterface* scheduledExecution;
+
+    FMIDefaultExperiment* defaultExperiment;
+
+    size_t nModelVariables;
+    FMIModelVariable* modelVariables;
+
+    size_t nOutputs;
+    FMIUnknown* outputs;
+
+    size_t nDerivatives;
+    FMIUnknown* derivatives;
+
+    size_t nInitialUnknowns;
+    FMIUnknown* initialUnknowns;
+
+    size_t nEventIndicators;
+    FMIUnknown* eventIndicators;
+
+    // private
+    char* buffer;
+    void* memory;
+    size_t nBuckets;
+    size_t* nameBuckets;
+    size_t* valueReferenceBuckets;
+
+} FMIModelDescription;
+
+FMI_STATIC FMIModelDescription* FMIReadModelDescription(const char* filename);
+
+FMI_STATIC FMIModelDescription* FMIParseModelDescription(const char* xml, size_t length);
+
+FMI_STATIC void FMIFreeModelDescription(FMIModelDescription* modelDescription);
+
+FMI_STATIC FMIModelVariable* FMIModelVariableForName(const FMIModelDescription* modelDescription, const char* name);
+
+FMI_STATIC FMIModelVariable* FMIModelVariableForValueReference(const FMIModelDescription* modelDescription, FMIVariableType type, FMIValueReference valueReference);
+
+FMI_STATIC size_t FMIModelVariableSize(const FMIModelVariable* variable);
+
+FMI_STATIC const char* FMIVariableTypeToString(FMIVariableType type);
+
+FMI_STATIC const char* FMICausalityToString(FMICausality causality);
+
+FMI_STATIC const char* FMIVariabilityToString(FMIVariability variability);
+
+#ifdef __cplusplus
+}  /* end of extern "C" { */
+#endif
@@ -0,0 +1,187 @@
+#pragma once
+
+/* Runs the platform binary of an FMU in a host process (fmuhost) so that a crash of the FMU does not terminate the
+   importer. The FMI calls are passed through two single producer / single consumer rings in shared memory (requests
+   to the host, responses and callbacks to the importer) and the waiting side spins briefly before it sleeps on a
+   futex. The arguments are passed as scalars or as offsets into the data area of the shared memory that is used as
+   a stack, so value arrays are only copied once and nested calls from callbacks are possible.
+
+   Only FMI 3.0 Model Exchange and Co-Simulation are supported on Linux. */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "FMI.h"
+
+#ifndef FMI_REMOTE_RING_SIZE
+#define FMI_REMOTE_RING_SIZE 16
+#endif
+
+#ifndef FMI_REMOTE_DATA_SIZE
+#define FMI_REMOTE_DATA_SIZE (16 * 1024 * 1024)
+#endif
+
+#define FMI_REMOTE_MAX_ARGUMENTS 12
+
+// the offset of a NULL pointer
+#define FMI_REMOTE_NULL UINT64_MAX
+
+#define FMI_REMOTE_FUNCTIONS(X) \
+    X(GetVersion) \
+    X(SetDebugLogging) \
+    X(InstantiateModelExchange) \
+    X(InstantiateCoSimulation) \
+    X(InstantiateScheduledExecution) \
+    X(FreeInstance) \
+    X(EnterInitializationMode) \
+    X(ExitInitializationMode) \
+    X(EnterEventMode) \
+    X(Terminate) \
+    X(Reset) \
+    X(GetFloat32) \
+    X(GetFloat64) \
+    X(GetInt8) \
+    X(GetUInt8) \
+    X(GetInt16) \
+    X(GetUInt16) \
+    X(GetInt32) \
+    X(GetUInt32) \
+    X(GetInt64) \
+    X(GetUInt64) \
+    X(GetBoolean) \
+    X(GetString) \
+    X(GetBinary) \
+    X(GetClock) \
+    X(SetFloat32) \
+    X(SetFloat64) \
+    X(SetInt8) \
+    X(SetUInt8) \
+    X(SetInt16) \
+    X(SetUInt16) \
+    X(SetInt32) \
+    X(SetUInt32) \
+    X(SetInt64) \
+    X(SetUInt64) \
+    X(SetBoolean) \
+    X(SetString) \
+    X(SetBinary) \
+    X(SetClock) \
+    X(GetNumberOfVariableDependencies) \
+    X(GetVariableDependencies) \
+    X(GetFMUState) \
+    X(SetFMUState) \
+    X(FreeFMUState) \
+    X(SerializedFMUStateSize) \
+    X(SerializeFMUState) \
+    X(DeserializeFMUState) \
+    X(GetDirectionalDerivative) \
+    X(GetAdjointDerivative) \
+    X(EnterConfigurationMode) \
+    X(ExitConfigurationMode) \
+    X(GetIntervalDecimal) \
+    X(GetIntervalFraction) \
+    X(GetShiftDecimal) \
+    X(GetShiftFraction) \
+    X(SetIntervalDecimal) \
+    X(SetIntervalFraction) \
+    X(EvaluateDiscreteStates) \
+    X(UpdateDiscreteStates) \
+    X(EnterContinuousTimeMode) \
+    X(CompletedIntegratorStep) \
+    X(SetTime) \
+    X(SetContinuousStates) \
+    X(GetContinuousStateDerivatives) \
+    X(GetEventIndicators) \
+    X(GetContinuousStates) \
+    X(GetNominalsOfContinuousStates) \
+    X(GetNumberOfEventIndicators) \
+    X(GetNumberOfContinuousStates) \
+    X(EnterStepMode) \
+    X(GetOutputDerivatives) \
+    X(DoStep) \
+    X(ActivateModelPartition)
+
+#define FMI_REMOTE_FUNCTION_ID(f) FMIRemote ## f,
+
+typedef enum {
+    FMI_REMOTE_FUNCTIONS(FMI_REMOTE_FUNCTION_ID)
+    FMIRemoteExit
+} FMIRemoteFunction;
+
+#undef FMI_REMOTE_FUNCTION_ID
+
+typedef enum {
+    FMIRemoteCall,               // importer -> host
+    FMIRemoteReturn,             // the result of a call or callback
+    FMIRemoteLogMessage,         // host -> importer
+    FMIRemoteIntermediateUpdate  // host -> importer
+} FMIRemoteMessageType;
+
+typedef struct {
+
+    uint32_t type;
+    uint32_t function;
+    int32_t  status;
+    uint32_t reserved;
+
+    // the first free byte of the data area
+    uint64_t top;
+
+    // scalars (floats are stored bitwise) or offsets into the data area
+    uint64_t arguments[FMI_REMOTE_MAX_ARGUMENTS];
+
+    // "category\0message" of a log message
+    char text[FMI_MAX_MESSAGE_LENGTH];
+
+} FMIRemoteMessage;
+
+typedef struct {
+
+    // written by the producer
+    uint32_t tail;
+    uint32_t producerWaiting;
+    char padding1[56];
+
+    // written by the consumer
+    uint32_t head;
+    uint32_t consumerWaiting;
+    char padding2[56];
+
+    FMIRemoteMessage messages[FMI_REMOTE_RING_SIZE];
+
+} FMIRemoteRing;
+
+typedef struct {
+
+    FMIRemoteRing requests;
+    FMIRemoteRing responses;
+
+    char data[FMI_REMOTE_DATA_SIZE];
+
+} FMIRemoteChannel;
+
+typedef bool FMIRemotePeerAlive(void *context);
+
+/* Waits for a free message in the ring. Returns NULL if the peer has terminated. */
+FMI_STATIC FMIRemoteMessage *FMIRemoteReserveMessage(FMIRemoteRing *ring, FMIRemotePeerAlive *peerAlive, void *context);
+
+/* Passes the reserved message to the consumer. */
+FMI_STATIC void FMIRemoteSendMessage(FMIRemoteRing *ring);
+
+/* Waits for the next message in the ring. Returns NULL if the peer has terminated. */
+FMI_STATIC FMIRemoteMessage *FMIRemoteReceiveMessage(FMIRemoteRing *ring, FMIRemotePeerAlive *peerAlive, void *context);
+
+/* Returns the received message to the producer. */
+FMI_STATIC void FMIRemoteReleaseMessage(FMIRemoteRing *ring);
+
+/* Starts the host process hostPath (or fmuhost in the directory of the current executable if hostPath is NULL)
+   that loads the platform binary at libraryPath and resolves the FMI functions of the instance to functions that
+   call the host. */
+FMI_STATIC FMIStatus FMILoadRemotePlatformBinary(FMIInstance *instance, const char *hostPath, const char *libraryPath);
+
+#ifdef __cplusplus
+}  /* end of extern "C" { */
+#endif
@@ -2,4 +2,10 @@
 
 #include "model.h"
 
+Ticks getNextSolverStepTicks(ModelInstance *comp);
+
 Status doFixedStep(ModelInstance *comp, bool* stateEvent, bool* timeEvent);
+
+Status setInputDerivative(ModelInstance *comp, ValueReference vr, int order, double value);
+
+void clearInputDerivatives(ModelInstance *comp);
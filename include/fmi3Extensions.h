@@ -0,0 +1,69 @@
+#ifndef fmi3Extensions_h
+#define fmi3Extensions_h
+
+/*
+Non-standard extensions of the FMI 3.0 API that are implemented by the Reference FMUs.
+The functions are named and exported like the functions in fmi3Functions.h.
+*/
+
+#include "fmi3Functions.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Advance nSteps communication steps of size communicationStepSize in one call. Before step k the Float64 inputs
+   are set to inputValues[k * nInputValueReferences ... (k + 1) * nInputValueReferences - 1] and after the step the
+   Float64 outputs are written to outputValues[k * nOutputValueReferences ...] (one value per value reference).
+   The function returns after the first step that requires event handling, returns early or terminates the
+   simulation and sets nStepsCompleted to the number of steps whose outputs have been written. The results are
+   identical to calling fmi3SetFloat64(), fmi3DoStep() and fmi3GetFloat64() for every step. */
+typedef fmi3Status fmi3DoStepsTYPE(fmi3Instance instance,
+                                   fmi3Float64 currentCommunicationPoint,
+                                   fmi3Float64 communicationStepSize,
+                                   size_t nSteps,
+                                   const fmi3ValueReference inputValueReferences[],
+                                   size_t nInputValueReferences,
+                                   const fmi3Float64 inputValues[],
+                                   const fmi3ValueReference outputValueReferences[],
+                                   size_t nOutputValueReferences,
+                                   fmi3Float64 outputValues[],
+                                   size_t* nStepsCompleted,
+                                   fmi3Boolean* eventHandlingNeeded,
+                                   fmi3Boolean* terminateSimulation,
+                                   fmi3Boolean* earlyReturn,
+                                   fmi3Float64* lastSuccessfulTime);
+
+/* Number of bins of the execution time histogram. Bin 0 counts the activations that took less than 1 us,
+   bin k the activations that took [2^(k-1), 2^k) us and the last bin all longer activations. */
+#define fmi3ExecutionTimeHistogramBins 16
+
+/* Activation statistics of an input clock measured by the FMU. The latency is the delay of the call to
+   fmi3ActivateModelPartition() relative to the activationTime, measured from the first activation of any
+   clock, and is only meaningful if the importer runs in real time. Times are in seconds. */
+typedef struct {
+    fmi3UInt64  nActivations;
+    fmi3Float64 totalExecutionTime;
+    fmi3Float64 maxExecutionTime;
+    fmi3Float64 maxLatency;
+    fmi3UInt64  executionTimeHistogram[fmi3ExecutionTimeHistogramBins];
+} fmi3ClockStatistics;
+
+/* Get the activation statistics of the input clock clockReference since the instantiation or the last
+   fmi3Reset(). Returns fmi3Error if clockReference is not an input clock. The statistics are also reported
+   with the category "logEvents" in fmi3Terminate(). */
+typedef fmi3Status fmi3GetClockStatisticsTYPE(fmi3Instance instance,
+                                              fmi3ValueReference clockReference,
+                                              fmi3ClockStatistics* statistics);
+
+#define fmi3DoSteps            fmi3FullName(fmi3DoSteps)
+#define fmi3GetClockStatistics fmi3FullName(fmi3GetClockStatistics)
+
+FMI3_Export fmi3DoStepsTYPE            fmi3DoSteps;
+FMI3_Export fmi3GetClockStatisticsTYPE fmi3GetClockStatistics;
+
+#ifdef __cplusplus
+}  /* end of extern "C" { */
+#endif
+
+#endif /* fmi3Extensions_h */
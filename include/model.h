@@ -12,6 +12,27 @@
 
 #include "config.h"
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/* atomic operations on int variables that are accessed by model partitions that run in parallel */
+#ifdef _MSC_VER
+#define ATOMIC_LOAD(p)       _InterlockedOr((volatile long*)(p), 0)
+#define ATOMIC_STORE(p, v)   _InterlockedExchange((volatile long*)(p), (v))
+#define ATOMIC_EXCHANGE(p, v) _InterlockedExchange((volatile long*)(p), (v))
+#define ATOMIC_INCREMENT(p)  _InterlockedIncrement((volatile long*)(p))
+#define ATOMIC_COMPARE_EXCHANGE(p, expected, desired) \
+    (_InterlockedCompareExchange((volatile long*)(p), (desired), (expected)) == (expected))
+#else
+#define ATOMIC_LOAD(p)       __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#define ATOMIC_STORE(p, v)   __atomic_store_n((p), (v), __ATOMIC_SEQ_CST)
+#define ATOMIC_EXCHANGE(p, v) __atomic_exchange_n((p), (v), __ATOMIC_SEQ_CST)
+#define ATOMIC_INCREMENT(p)  __atomic_add_fetch((p), 1, __ATOMIC_SEQ_CST)
+#define ATOMIC_COMPARE_EXCHANGE(p, expected, desired) \
+    __extension__ ({ int e_ = (expected); __atomic_compare_exchange_n((p), &e_, (desired), false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST); })
+#endif
+
 #if FMI_VERSION == 1
 
 #define not_modelError (Instantiated| Initialized | Terminated)
@@ -98,11 +119,66 @@ typedef void (*intermediateUpdateType) (void *instanceEnvironment,
 
 typedef void(*clockUpdateType) (void *instanceEnvironment);
 
+#if FMI_VERSION == 2
+typedef void (*stepFinishedType) (void *componentEnvironment, int status);
+#endif
+
+// memory callbacks of the environment (same signature as calloc() and free())
+typedef void* (*allocateMemoryType) (size_t nobj, size_t size);
+typedef void  (*freeMemoryType)     (void *obj);
+
+/* Freed memory blocks of up to MIN_MEMORY_BLOCK_SIZE * 2^(N_MEMORY_SIZE_CLASSES - 1) bytes are kept in a pool of
+   the instance and reused for allocations of the same size class, so an instance that has reached its working set
+   does not allocate memory from the environment anymore. */
+#define MIN_MEMORY_BLOCK_SIZE 16
+
+#ifndef N_MEMORY_SIZE_CLASSES
+#define N_MEMORY_SIZE_CLASSES 16
+#endif
+
+/* The fixed step solver, the time events and the communication points of Co-Simulation use an integer time base
+   of ticks of 1 / TIME_RESOLUTION s (like the interval counter / resolution of fmi3GetIntervalFraction()), so
+   steps and events are scheduled exactly. */
+#ifndef TIME_RESOLUTION
+#define TIME_RESOLUTION 1000000000
+#endif
+
+typedef int64_t Ticks;
+
+#if MAX_TIME_EVENTS > 0
+// a (periodic) time event at ticks (interval = 0 for single events)
+typedef struct {
+    int id;
+    Ticks ticks;
+    Ticks interval;
+} TimeEvent;
+#endif
+
+#if N_INPUT_CLOCKS > 0
+// number of bins of the execution time histogram: bin 0 counts activations < 1 us,
+// bin k activations in [2^(k-1), 2^k) us and the last bin all longer activations
+// (must be equal to fmi3ExecutionTimeHistogramBins in fmi3Extensions.h)
+#define N_EXECUTION_TIME_BINS 16
+
+// activation statistics of an input clock (updated under the lock because the partitions may run in parallel)
+typedef struct {
+    int lock;
+    ValueReference clockReference;
+    uint64_t nActivations;
+    double totalExecutionTime;
+    double maxExecutionTime;
+    double maxLatency;
+    uint64_t executionTimeHistogram[N_EXECUTION_TIME_BINS];
+} ClockStatistics;
+#endif
+
 typedef struct {
 
     double startTime;
     double stopTime;
     double time;
+    Ticks startTicks;
+    Ticks ticks;
     const char *instanceName;
     InterfaceType type;
     const char *resourceLocation;
@@ -117,6 +193,15 @@ typedef struct {
     lockPreemptionType lockPreemption;
     unlockPreemptionType unlockPreemption;
 
+    allocateMemoryType cbAllocateMemory;
+    freeMemoryType cbFreeMemory;
+
+#if FMI_VERSION == 2
+    // asynchronous fmi2DoStep() (see fmi2Functions.c)
+    stepFinishedType stepFinished;
+    void *asynchronousStep;
+#endif
+
     bool logEvents;
     bool logErrors;
 
@@ -143,6 +228,7 @@ typedef struct {
     bool earlyReturnAllowed;
     bool eventModeUsed;
     double nextCommunicationPoint;
+    Ticks nextCommunicationTicks;
 
     // solver
 #if MAX_EVENT_INDICATORS > 0
@@ -153,14 +239,49 @@ typedef struct {
 
 #if MAX_CONTINUOUS_STATES > 0
     size_t nx;
-    double x[MAX_CONTINUOUS_STATES];
-    double dx[MAX_CONTINUOUS_STATES];
+    size_t nxCapacity;
+    double *x;
+    double *dx;
+#endif
+
+    // memory of the model whose size depends on the structural parameters (part of the FMU state)
+    void *arena;
+    size_t arenaSize;
+    size_t arenaCapacity;
+
+    // derivatives of the inputs to extrapolate them within a communication step
+#if MAX_INPUT_DERIVATIVES > 0
+    size_t nInputDerivatives;
+    ValueReference inputDerivativeReferences[MAX_INPUT_DERIVATIVES];
+    double inputDerivatives[MAX_INPUT_DERIVATIVES][2];
+#endif
+
+    // scheduled time events (min-heap ordered by time)
+#if MAX_TIME_EVENTS > 0
+    size_t nTimeEvents;
+    TimeEvent timeEvents[MAX_TIME_EVENTS];
+#endif
+
+    // activation statistics of the input clocks INPUT_CLOCKS
+#if N_INPUT_CLOCKS > 0
+    ClockStatistics clockStatistics[N_INPUT_CLOCKS];
+    int firstActivationLock;
+    bool firstActivationRecorded;
+    double firstActivationTime;
+    double firstActivationWallClockTime;
 #endif
 
+    // free memory blocks of the pool (linked lists per size class) and the lock that protects them, because
+    // the pool is also used by partitions that run in parallel and asynchronous steps
+    void *freeMemoryBlocks[N_MEMORY_SIZE_CLASSES];
+    int memoryLock;
+
 } ModelInstance;
 
 ModelInstance *createModelInstance(
     loggerType logger,
+    allocateMemoryType allocateMemory,
+    freeMemoryType freeMemory,
     intermediateUpdateType intermediateUpdate,
     void *componentEnvironment,
     const char *instanceName,
@@ -171,8 +292,18 @@ ModelInstance *createModelInstance(
 
 void freeModelInstance(ModelInstance *comp);
 
+void *allocateMemory(ModelInstance *comp, size_t size);
+Status reallocateMemory(ModelInstance *comp, void **memory, size_t size);
+void freeMemory(ModelInstance *comp, void *memory);
+
+/* lock (an int that is 0 if unlocked) for short critical sections of model partitions that run in parallel */
+void acquireLock(ModelInstance *comp, int *lock);
+void releaseLock(ModelInstance *comp, int *lock);
+
 Status configurate(ModelInstance* comp);
 
+Status resizeArena(ModelInstance* comp, size_t size);
+
 Status reset(ModelInstance* comp);
 
 Status setStartValues(ModelInstance* comp);
@@ -222,10 +353,29 @@ Status getNominalsOfContinuousStates(ModelInstance* comp, double nominals[], siz
 Status setContinuousStates(ModelInstance *comp, const double x[], size_t nx);
 Status getDerivatives(ModelInstance *comp, double dx[], size_t nx);
 Status getOutputDerivative(ModelInstance *comp, ValueReference valueReference, int order, double *value);
+double getInputDerivative(ModelInstance *comp, ValueReference vr, int order);
 Status getPartialDerivative(ModelInstance *comp, ValueReference unknown, ValueReference known, double *partialDerivative);
 Status getEventIndicators(ModelInstance *comp, double z[], size_t nz);
 Status eventUpdate(ModelInstance *comp);
 
+Status scheduleTimeEvent(ModelInstance *comp, int id, double time, double interval);
+Status cancelTimeEvent(ModelInstance *comp, int id);
+bool popTimeEvent(ModelInstance *comp, int *id);
+
+#if N_INPUT_CLOCKS > 0
+double wallClockTime(void);
+void resetClockStatistics(ModelInstance *comp);
+void recordClockActivation(ModelInstance *comp, ValueReference vr, double activationTime, double startTime, double endTime);
+bool getClockStatistics(ModelInstance *comp, ValueReference vr, ClockStatistics *statistics);
+void logClockStatistics(ModelInstance *comp);
+#endif
+
+Ticks timeToTicks(double time);
+double ticksToTime(Ticks ticks);
+
+/* true if time is the next communication point (within one tick to allow for the rounding of the importer) */
+bool isNextCommunicationPoint(ModelInstance *comp, double time);
+
 bool isClose(double a, double b);
 bool invalidNumber(ModelInstance *comp, const char *f, const char *arg, size_t actual, size_t expected);
 bool invalidState(ModelInstance *comp, const char *f, int statesExpected);
@@ -237,6 +387,8 @@ void logError(ModelInstance *comp, const char *message, ...);
 
 Status getFMUState(ModelInstance* comp, void** FMUState);
 Status setFMUState(ModelInstance* comp, void* FMUState);
+size_t getSerializedFMUStateSize(const void* FMUState);
+Status deserializeFMUState(ModelInstance* comp, const void* serializedState, size_t size, void** FMUState);
 
 // shorthand to access the variables
 #define M(v) (comp->modelData.v)
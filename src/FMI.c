@@ -162,6 +162,11 @@ void FMIFreeInstance(FMIInstance *instance) {
         return;
     }
 
+    if (instance->freeBackend) {
+        instance->freeBackend(instance);
+        instance->freeBackend = NULL;
+    }
+
     // unload the shared library
     if (instance->libraryHandle) {
 # ifdef _WIN32
@@ -59,9 +59,16 @@ do { \
 } while (0)
 #endif
 
+// call the FMI functions directly if the FMU is linked statically
+#if defined(FMI2_FUNCTION_PREFIX)
+#define FMI2_FUNCTION(f) fmi2 ## f
+#else
+#define FMI2_FUNCTION(f) instance->fmi2Functions->fmi2 ## f
+#endif
+
 #define CALL(f) \
 do { \
-    const FMIStatus status = (FMIStatus)instance->fmi2Functions->fmi2 ## f (instance->component); \
+    const FMIStatus status = (FMIStatus)FMI2_FUNCTION(f)(instance->component); \
     if (instance->logFunctionCall) { \
         instance->logFunctionCall(instance, status, "fmi2" #f "()"); \
     } \
@@ -70,7 +77,7 @@ do { \
 
 #define CALL_ARGS(f, m, ...) \
 do { \
-    const FMIStatus status = (FMIStatus)instance->fmi2Functions-> fmi2 ## f (instance->component, __VA_ARGS__); \
+    const FMIStatus status = (FMIStatus)FMI2_FUNCTION(f)(instance->component, __VA_ARGS__); \
     if (instance->logFunctionCall) { \
         FMIClearLogMessageBuffer(instance); \
         FMIAppendToLogMessageBuffer(instance, "fmi2" #f "(" m ")", __VA_ARGS__); \
@@ -81,7 +88,7 @@ do { \
 
 #define CALL_ARRAY(s, t) \
 do { \
-    const FMIStatus status = (FMIStatus)instance->fmi2Functions->fmi2 ## s ## t(instance->component, vr, nvr, value); \
+    const FMIStatus status = (FMIStatus)FMI2_FUNCTION(s ## t)(instance->component, vr, nvr, value); \
     if (instance->logFunctionCall) { \
         FMIClearLogMessageBuffer(instance); \
         FMIAppendToLogMessageBuffer(instance, "fmi2" #s #t "(vr={"); \
@@ -105,7 +112,7 @@ const char* FMI2GetTypesPlatform(FMIInstance *instance) {
         instance->logFunctionCall(instance, FMIOK, "fmi2GetTypesPlatform()");
     }
 
-    return instance->fmi2Functions->fmi2GetTypesPlatform();
+    return FMI2_FUNCTION(GetTypesPlatform)();
 }
 
 const char* FMI2GetVersion(FMIInstance *instance) {
@@ -114,12 +121,12 @@ const char* FMI2GetVersion(FMIInstance *instance) {
         instance->logFunctionCall(instance, FMIOK, "fmi2GetVersion()");
     }
 
-    return instance->fmi2Functions->fmi2GetVersion();
+    return FMI2_FUNCTION(GetVersion)();
 }
 
 FMIStatus FMI2SetDebugLogging(FMIInstance *instance, fmi2Boolean loggingOn, size_t nCategories, const fmi2String categories[]) {
 
-    const FMIStatus status = (FMIStatus)instance->fmi2Functions->fmi2SetDebugLogging(instance->component, loggingOn, nCategories, categories);
+    const FMIStatus status = (FMIStatus)FMI2_FUNCTION(SetDebugLogging)(instance->component, loggingOn, nCategories, categories);
 
     if (instance->logFunctionCall) {
         FMIClearLogMessageBuffer(instance);
@@ -133,8 +140,8 @@ FMIStatus FMI2SetDebugLogging(FMIInstance *instance, fmi2Boolean loggingOn, size
 }
 
 /* Creation and destruction of FMU instances and setting debug status */
-FMIStatus FMI2Instantiate(FMIInstance *instance, const char *fmuResourceLocation, fmi2Type fmuType, fmi2String fmuGUID,
-    fmi2Boolean visible, fmi2Boolean loggingOn) {
+static FMIStatus instantiate(FMIInstance *instance, const char *fmuResourceLocation, fmi2Type fmuType, fmi2String fmuGUID,
+    fmi2Boolean visible, fmi2Boolean loggingOn, fmi2StepFinished stepFinished) {
 
     instance->fmiMajorVersion = FMIMajorVersion2;
 
@@ -221,10 +228,10 @@ FMIStatus FMI2Instantiate(FMIInstance *instance, const char *fmuResourceLocation
     instance->fmi2Functions->callbacks.logger               = cb_logMessage2;
     instance->fmi2Functions->callbacks.allocateMemory       = calloc;
     instance->fmi2Functions->callbacks.freeMemory           = free;
-    instance->fmi2Functions->callbacks.stepFinished         = NULL;
+    instance->fmi2Functions->callbacks.stepFinished         = stepFinished;
     instance->fmi2Functions->callbacks.componentEnvironment = instance;
 
-    instance->component = instance->fmi2Functions->fmi2Instantiate(instance->name, fmuType, fmuGUID, fmuResourceLocation, &instance->fmi2Functions->callbacks, visible, loggingOn);
+    instance->component = FMI2_FUNCTION(Instantiate)(instance->name, fmuType, fmuGUID, fmuResourceLocation, &instance->fmi2Functions->callbacks, visible, loggingOn);
 
     if (instance->logFunctionCall) {
         fmi2CallbackFunctions* f = &instance->fmi2Functions->callbacks;
@@ -244,13 +251,23 @@ FMIStatus FMI2Instantiate(FMIInstance *instance, const char *fmuResourceLocation
     return FMIOK;
 }
 
+FMIStatus FMI2Instantiate(FMIInstance *instance, const char *fmuResourceLocation, fmi2Type fmuType, fmi2String fmuGUID,
+    fmi2Boolean visible, fmi2Boolean loggingOn) {
+    return instantiate(instance, fmuResourceLocation, fmuType, fmuGUID, visible, loggingOn, NULL);
+}
+
+FMIStatus FMI2InstantiateAsynchronous(FMIInstance *instance, const char *fmuResourceLocation, fmi2String fmuGUID,
+    fmi2Boolean visible, fmi2Boolean loggingOn, fmi2StepFinished stepFinished) {
+    return instantiate(instance, fmuResourceLocation, fmi2CoSimulation, fmuGUID, visible, loggingOn, stepFinished);
+}
+
 void FMI2FreeInstance(FMIInstance *instance) {
 
     if (!instance) {
         return;
     }
 
-    instance->fmi2Functions->fmi2FreeInstance(instance->component);
+    FMI2_FUNCTION(FreeInstance)(instance->component);
 
     if (instance->logFunctionCall) {
         instance->logFunctionCall(instance, FMIOK, "fmi2FreeInstance()");
@@ -335,7 +352,7 @@ FMIStatus FMI2FreeFMUstate(FMIInstance *instance, fmi2FMUstate* FMUstate) {
 
 FMIStatus FMI2SerializedFMUstateSize(FMIInstance *instance, fmi2FMUstate  FMUstate, size_t* size) {
 
-    const FMIStatus status = (FMIStatus)instance->fmi2Functions->fmi2SerializedFMUstateSize(instance->component, FMUstate, size);
+    const FMIStatus status = (FMIStatus)FMI2_FUNCTION(SerializedFMUstateSize)(instance->component, FMUstate, size);
 
     if (instance->logFunctionCall) {
         FMIClearLogMessageBuffer(instance);
@@ -361,7 +378,7 @@ FMIStatus FMI2GetDirectionalDerivative(FMIInstance *instance,
     const fmi2Real dvKnown[],
     fmi2Real dvUnknown[]) {
 
-    const FMIStatus status = (FMIStatus)instance->fmi2Functions->fmi2GetDirectionalDerivative(instance->component, vUnknown_ref, nUnknown, vKnown_ref, nKnown, dvKnown, dvUnknown);
+    const FMIStatus status = (FMIStatus)FMI2_FUNCTION(GetDirectionalDerivative)(instance->component, vUnknown_ref, nUnknown, vKnown_ref, nKnown, dvKnown, dvUnknown);
 
     if (instance->logFunctionCall) {
         FMIClearLogMessageBuffer(instance);
@@ -392,7 +409,7 @@ FMIStatus FMI2EnterEventMode(FMIInstance *instance) {
 
 FMIStatus FMI2NewDiscreteStates(FMIInstance *instance, fmi2EventInfo *eventInfo) {
 
-    const FMIStatus status = (FMIStatus)instance->fmi2Functions->fmi2NewDiscreteStates(instance->component, eventInfo);
+    const FMIStatus status = (FMIStatus)FMI2_FUNCTION(NewDiscreteStates)(instance->component, eventInfo);
 
     if (instance->logFunctionCall) {
         FMIClearLogMessageBuffer(instance);
@@ -415,7 +432,7 @@ FMIStatus FMI2CompletedIntegratorStep(FMIInstance *instance,
     fmi2Boolean*  enterEventMode,
     fmi2Boolean*  terminateSimulation) {
 
-    const FMIStatus status = (FMIStatus)instance->fmi2Functions->fmi2CompletedIntegratorStep(instance->component, noSetFMUStatePriorToCurrentPoint, enterEventMode, terminateSimulation);
+    const FMIStatus status = (FMIStatus)FMI2_FUNCTION(CompletedIntegratorStep)(instance->component, noSetFMUStatePriorToCurrentPoint, enterEventMode, terminateSimulation);
 
     if (instance->logFunctionCall) {
         FMIClearLogMessageBuffer(instance);
@@ -435,7 +452,7 @@ FMIStatus FMI2SetTime(FMIInstance* instance, fmi2Real time) {
 
 FMIStatus FMI2SetContinuousStates(FMIInstance *instance, const fmi2Real x[], size_t nx) {
 
-    const FMIStatus status = (FMIStatus)instance->fmi2Functions->fmi2SetContinuousStates(instance->component, x, nx);
+    const FMIStatus status = (FMIStatus)FMI2_FUNCTION(SetContinuousStates)(instance->component, x, nx);
 
     if (instance->logFunctionCall) {
         FMIClearLogMessageBuffer(instance);
@@ -451,7 +468,7 @@ FMIStatus FMI2SetContinuousStates(FMIInstance *instance, const fmi2Real x[], siz
 /* Evaluation of the model equations */
 FMIStatus FMI2GetDerivatives(FMIInstance *instance, fmi2Real derivatives[], size_t nx) {
 
-    const FMIStatus status = (FMIStatus)instance->fmi2Functions->fmi2GetDerivatives(instance->component, derivatives, nx);
+    const FMIStatus status = (FMIStatus)FMI2_FUNCTION(GetDerivatives)(instance->component, derivatives, nx);
 
     if (instance->logFunctionCall) {
         FMIClearLogMessageBuffer(instance);
@@ -466,7 +483,7 @@ FMIStatus FMI2GetDerivatives(FMIInstance *instance, fmi2Real derivatives[], size
 
 FMIStatus FMI2GetEventIndicators(FMIInstance *instance, fmi2Real eventIndicators[], size_t ni) {
 
-    const FMIStatus status = (FMIStatus)instance->fmi2Functions->fmi2GetEventIndicators(instance->component, eventIndicators, ni);
+    const FMIStatus status = (FMIStatus)FMI2_FUNCTION(GetEventIndicators)(instance->component, eventIndicators, ni);
 
     if (instance->logFunctionCall) {
         FMIClearLogMessageBuffer(instance);
@@ -481,7 +498,7 @@ FMIStatus FMI2GetEventIndicators(FMIInstance *instance, fmi2Real eventIndicators
 
 FMIStatus FMI2GetContinuousStates(FMIInstance *instance, fmi2Real x[], size_t nx) {
 
-    const FMIStatus status = (FMIStatus)instance->fmi2Functions->fmi2GetContinuousStates(instance->component, x, nx);
+    const FMIStatus status = (FMIStatus)FMI2_FUNCTION(GetContinuousStates)(instance->component, x, nx);
 
     if (instance->logFunctionCall) {
         FMIClearLogMessageBuffer(instance);
@@ -496,7 +513,7 @@ FMIStatus FMI2GetContinuousStates(FMIInstance *instance, fmi2Real x[], size_t nx
 
 FMIStatus FMI2GetNominalsOfContinuousStates(FMIInstance *instance, fmi2Real x_nominal[], size_t nx) {
 
-    const FMIStatus status = (FMIStatus)instance->fmi2Functions->fmi2GetNominalsOfContinuousStates(instance->component, x_nominal, nx);
+    const FMIStatus status = (FMIStatus)FMI2_FUNCTION(GetNominalsOfContinuousStates)(instance->component, x_nominal, nx);
 
     if (instance->logFunctionCall) {
         FMIClearLogMessageBuffer(instance);
@@ -543,7 +560,7 @@ FMIStatus FMI2CancelStep(FMIInstance *instance) {
 /* Inquire slave status */
 FMIStatus FMI2GetStatus(FMIInstance *instance, const fmi2StatusKind s, fmi2Status* value) {
 
-    const FMIStatus status = (FMIStatus)instance->fmi2Functions->fmi2GetStatus(instance->component, s, value);
+    const FMIStatus status = (FMIStatus)FMI2_FUNCTION(GetStatus)(instance->component, s, value);
 
     if (instance->logFunctionCall) {
         FMIClearLogMessageBuffer(instance);
@@ -556,7 +573,7 @@ FMIStatus FMI2GetStatus(FMIInstance *instance, const fmi2StatusKind s, fmi2Statu
 
 FMIStatus FMI2GetRealStatus(FMIInstance *instance, const fmi2StatusKind s, fmi2Real* value) {
 
-    const FMIStatus status = (FMIStatus)instance->fmi2Functions->fmi2GetRealStatus(instance->component, s, value);
+    const FMIStatus status = (FMIStatus)FMI2_FUNCTION(GetRealStatus)(instance->component, s, value);
 
     if (instance->logFunctionCall) {
         FMIClearLogMessageBuffer(instance);
@@ -569,7 +586,7 @@ FMIStatus FMI2GetRealStatus(FMIInstance *instance, const fmi2StatusKind s, fmi2R
 
 FMIStatus FMI2GetIntegerStatus(FMIInstance *instance, const fmi2StatusKind s, fmi2Integer* value) {
 
-    const FMIStatus status = (FMIStatus)instance->fmi2Functions->fmi2GetIntegerStatus(instance->component, s, value);
+    const FMIStatus status = (FMIStatus)FMI2_FUNCTION(GetIntegerStatus)(instance->component, s, value);
 
     if (instance->logFunctionCall) {
         FMIClearLogMessageBuffer(instance);
@@ -582,7 +599,7 @@ FMIStatus FMI2GetIntegerStatus(FMIInstance *instance, const fmi2StatusKind s, fm
 
 FMIStatus FMI2GetBooleanStatus(FMIInstance *instance, const fmi2StatusKind s, fmi2Boolean* value) {
 
-    const FMIStatus status = (FMIStatus)instance->fmi2Functions->fmi2GetBooleanStatus(instance->component, s, value);
+    const FMIStatus status = (FMIStatus)FMI2_FUNCTION(GetBooleanStatus)(instance->component, s, value);
 
     if (instance->logFunctionCall) {
         FMIClearLogMessageBuffer(instance);
@@ -595,7 +612,7 @@ FMIStatus FMI2GetBooleanStatus(FMIInstance *instance, const fmi2StatusKind s, fm
 
 FMIStatus FMI2GetStringStatus(FMIInstance *instance, const fmi2StatusKind s, fmi2String* value) {
 
-    const FMIStatus status = (FMIStatus)instance->fmi2Functions->fmi2GetStringStatus(instance->component, s, value);
+    const FMIStatus status = (FMIStatus)FMI2_FUNCTION(GetStringStatus)(instance->component, s, value);
 
     if (instance->logFunctionCall) {
         FMIClearLogMessageBuffer(instance);
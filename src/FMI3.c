@@ -9,6 +9,10 @@
 #include <stdio.h>
 #include <string.h>
 
+#if defined(FMI3_FUNCTION_PREFIX)
+#include "fmi3Functions.h"
+#endif
+
 #include "FMI3.h"
 
 
@@ -43,7 +47,11 @@ do { \
 #else
 #define LOAD_SYMBOL(f) \
 do { \
-    instance->fmi3Functions->fmi3 ## f = (fmi3 ## f ## TYPE*)dlsym(instance->libraryHandle, "fmi3" #f); \
+    if (instance->getFunction) { \
+        instance->fmi3Functions->fmi3 ## f = (fmi3 ## f ## TYPE*)instance->getFunction(instance, "fmi3" #f); \
+    } else { \
+        instance->fmi3Functions->fmi3 ## f = (fmi3 ## f ## TYPE*)dlsym(instance->libraryHandle, "fmi3" #f); \
+    } \
     if (!instance->fmi3Functions->fmi3 ## f) { \
         instance->logMessage(instance, FMIFatal, "fatal", "Symbol fmi3" #f " is missing in shared library."); \
         return FMIFatal; \
@@ -51,9 +59,16 @@ do { \
 } while (0)
 #endif
 
+// call the FMI functions directly if the FMU is linked statically
+#if defined(FMI3_FUNCTION_PREFIX)
+#define FMI3_FUNCTION(f) fmi3 ## f
+#else
+#define FMI3_FUNCTION(f) instance->fmi3Functions->fmi3 ## f
+#endif
+
 #define CALL(f) \
 do { \
-    const FMIStatus status = (FMIStatus)instance->fmi3Functions->fmi3 ## f (instance->component); \
+    const FMIStatus status = (FMIStatus)FMI3_FUNCTION(f)(instance->component); \
     if (instance->logFunctionCall) { \
         instance->logFunctionCall(instance, status, "fmi3" #f "()"); \
     } \
@@ -63,7 +78,7 @@ do { \
 
 #define CALL_ARGS(f, m, ...) \
 do { \
-    const FMIStatus status = (FMIStatus)instance->fmi3Functions-> fmi3 ## f (instance->component, __VA_ARGS__); \
+    const FMIStatus status = (FMIStatus)FMI3_FUNCTION(f)(instance->component, __VA_ARGS__); \
     if (instance->logFunctionCall) { \
         FMIClearLogMessageBuffer(instance); \
         FMIAppendToLogMessageBuffer(instance, "fmi3" #f "(" m ")", __VA_ARGS__); \
@@ -75,7 +90,7 @@ do { \
 
 #define CALL_ARRAY(s, t) \
 do { \
-    const FMIStatus status = (FMIStatus)instance->fmi3Functions->fmi3 ## s ## t(instance->component, valueReferences, nValueReferences, values, nValues); \
+    const FMIStatus status = (FMIStatus)FMI3_FUNCTION(s ## t)(instance->component, valueReferences, nValueReferences, values, nValues); \
     if (instance->logFunctionCall) { \
         FMIClearLogMessageBuffer(instance); \
         FMIAppendToLogMessageBuffer(instance, "fmi3" #s #t "(valueReferences={"); \
@@ -98,7 +113,7 @@ const char* FMI3GetVersion(FMIInstance *instance) {
     if (instance->logFunctionCall) {
         instance->logFunctionCall(instance, FMIOK, "fmi3GetVersion()");
     }
-    return instance->fmi3Functions->fmi3GetVersion();
+    return FMI3_FUNCTION(GetVersion)();
 }
 
 FMIStatus FMI3SetDebugLogging(FMIInstance *instance,
@@ -106,7 +121,7 @@ FMIStatus FMI3SetDebugLogging(FMIInstance *instance,
     size_t nCategories,
     const fmi3String categories[]) {
 
-    const FMIStatus status = (FMIStatus)instance->fmi3Functions->fmi3SetDebugLogging(instance->component, loggingOn, nCategories, categories);
+    const FMIStatus status = (FMIStatus)FMI3_FUNCTION(SetDebugLogging)(instance->component, loggingOn, nCategories, categories);
 
     if (instance->logFunctionCall) {
         FMIClearLogMessageBuffer(instance);
@@ -264,7 +279,7 @@ FMIStatus FMI3InstantiateModelExchange(
 
     fmi3LogMessageCallback logMessage = instance->logMessage ? cb_logMessage3 : NULL;
 
-    instance->component = instance->fmi3Functions->fmi3InstantiateModelExchange(instance->name, instantiationToken, resourcePath, visible, loggingOn, instance, logMessage);
+    instance->component = FMI3_FUNCTION(InstantiateModelExchange)(instance->name, instantiationToken, resourcePath, visible, loggingOn, instance, logMessage);
 
     if (instance->logFunctionCall) {
         FMIClearLogMessageBuffer(instance);
@@ -315,7 +330,7 @@ FMIStatus FMI3InstantiateCoSimulation(
 
     fmi3LogMessageCallback logMessage = instance->logMessage ? cb_logMessage3 : NULL;
 
-    instance->component = instance->fmi3Functions->fmi3InstantiateCoSimulation(
+    instance->component = FMI3_FUNCTION(InstantiateCoSimulation)(
         instance->name,
         instantiationToken,
         resourcePath,
@@ -390,7 +405,7 @@ FMIStatus FMI3InstantiateScheduledExecution(
 
     fmi3LogMessageCallback _logMessage = instance->logMessage ? cb_logMessage3 : NULL;
 
-    instance->component = instance->fmi3Functions->fmi3InstantiateScheduledExecution(
+    instance->component = FMI3_FUNCTION(InstantiateScheduledExecution)(
         instance->name,
         instantiationToken,
         resourcePath,
@@ -445,7 +460,7 @@ FMIStatus FMI3FreeInstance(FMIInstance *instance) {
         return FMIError;
     }
 
-    instance->fmi3Functions->fmi3FreeInstance(instance->component);
+    FMI3_FUNCTION(FreeInstance)(instance->component);
 
     instance->component = NULL;
 
@@ -603,7 +618,7 @@ FMIStatus FMI3GetBinary(FMIInstance *instance,
     fmi3Binary values[],
     size_t nValues) {
 
-    const FMIStatus status = (FMIStatus)instance->fmi3Functions->fmi3GetBinary(instance->component, valueReferences, nValueReferences, sizes, values, nValues);
+    const FMIStatus status = (FMIStatus)FMI3_FUNCTION(GetBinary)(instance->component, valueReferences, nValueReferences, sizes, values, nValues);
 
     if (instance->logFunctionCall) {
         FMIClearLogMessageBuffer(instance);
@@ -625,7 +640,7 @@ FMIStatus FMI3GetClock(FMIInstance *instance,
     size_t nValueReferences,
     fmi3Clock values[]) {
 
-    const FMIStatus status = (FMIStatus)instance->fmi3Functions->fmi3GetClock(instance->component, valueReferences, nValueReferences, values);
+    const FMIStatus status = (FMIStatus)FMI3_FUNCTION(GetClock)(instance->component, valueReferences, nValueReferences, values);
 
     if (instance->logFunctionCall) {
         FMIClearLogMessageBuffer(instance);
@@ -743,7 +758,7 @@ FMIStatus FMI3SetBinary(FMIInstance *instance,
     const fmi3Binary values[],
     size_t nValues) {
 
-    const FMIStatus status = (FMIStatus)instance->fmi3Functions->fmi3SetBinary(instance->component, valueReferences, nValueReferences, sizes, values, nValues);
+    const FMIStatus status = (FMIStatus)FMI3_FUNCTION(SetBinary)(instance->component, valueReferences, nValueReferences, sizes, values, nValues);
 
     if (instance->logFunctionCall) {
         FMIClearLogMessageBuffer(instance);
@@ -765,7 +780,7 @@ FMIStatus FMI3SetClock(FMIInstance *instance,
     size_t nValueReferences,
     const fmi3Clock values[]) {
 
-    const FMIStatus status = (FMIStatus)instance->fmi3Functions->fmi3SetClock(instance->component, valueReferences, nValueReferences, values);
+    const FMIStatus status = (FMIStatus)FMI3_FUNCTION(SetClock)(instance->component, valueReferences, nValueReferences, values);
 
     if (instance->logFunctionCall) {
         FMIClearLogMessageBuffer(instance);
@@ -816,7 +831,7 @@ FMIStatus FMI3SerializedFMUStateSize(FMIInstance *instance,
     fmi3FMUState  FMUState,
     size_t* size) {
 
-    const FMIStatus status = (FMIStatus)instance->fmi3Functions->fmi3SerializedFMUStateSize(instance->component, FMUState, size);
+    const FMIStatus status = (FMIStatus)FMI3_FUNCTION(SerializedFMUStateSize)(instance->component, FMUState, size);
 
     if (instance->logFunctionCall) {
         FMIClearLogMessageBuffer(instance);
@@ -993,7 +1008,7 @@ FMIStatus FMI3UpdateDiscreteStates(FMIInstance *instance,
     fmi3Boolean* nextEventTimeDefined,
     fmi3Float64* nextEventTime) {
 
-    const FMIStatus status = (FMIStatus)instance->fmi3Functions->fmi3UpdateDiscreteStates(instance->component, discreteStatesNeedUpdate, terminateSimulation, nominalsOfContinuousStatesChanged, valuesOfContinuousStatesChanged, nextEventTimeDefined, nextEventTime);
+    const FMIStatus status = (FMIStatus)FMI3_FUNCTION(UpdateDiscreteStates)(instance->component, discreteStatesNeedUpdate, terminateSimulation, nominalsOfContinuousStatesChanged, valuesOfContinuousStatesChanged, nextEventTimeDefined, nextEventTime);
 
     if (instance->logFunctionCall) {
         FMIClearLogMessageBuffer(instance);
@@ -1020,7 +1035,7 @@ FMIStatus FMI3CompletedIntegratorStep(FMIInstance *instance,
     fmi3Boolean* enterEventMode,
     fmi3Boolean* terminateSimulation) {
 
-    const FMIStatus status = (FMIStatus)instance->fmi3Functions->fmi3CompletedIntegratorStep(instance->component, noSetFMUStatePriorToCurrentPoint, enterEventMode, terminateSimulation);
+    const FMIStatus status = (FMIStatus)FMI3_FUNCTION(CompletedIntegratorStep)(instance->component, noSetFMUStatePriorToCurrentPoint, enterEventMode, terminateSimulation);
 
     if (instance->logFunctionCall) {
         FMIClearLogMessageBuffer(instance);
@@ -1042,7 +1057,7 @@ FMIStatus FMI3SetContinuousStates(FMIInstance *instance,
     const fmi3Float64 continuousStates[],
     size_t nContinuousStates) {
 
-    const FMIStatus status = (FMIStatus)instance->fmi3Functions->fmi3SetContinuousStates(instance->component, continuousStates, nContinuousStates);
+    const FMIStatus status = (FMIStatus)FMI3_FUNCTION(SetContinuousStates)(instance->component, continuousStates, nContinuousStates);
 
     if (instance->logFunctionCall) {
         FMIClearLogMessageBuffer(instance);
@@ -1060,7 +1075,7 @@ FMIStatus FMI3GetContinuousStateDerivatives(FMIInstance *instance,
     fmi3Float64 derivatives[],
     size_t nContinuousStates) {
 
-    const FMIStatus status = (FMIStatus)instance->fmi3Functions->fmi3GetContinuousStateDerivatives(instance->component, derivatives, nContinuousStates);
+    const FMIStatus status = (FMIStatus)FMI3_FUNCTION(GetContinuousStateDerivatives)(instance->component, derivatives, nContinuousStates);
 
     if (instance->logFunctionCall) {
         FMIClearLogMessageBuffer(instance);
@@ -1077,7 +1092,7 @@ FMIStatus FMI3GetEventIndicators(FMIInstance *instance,
     fmi3Float64 eventIndicators[],
     size_t nEventIndicators) {
 
-    const FMIStatus status = (FMIStatus)instance->fmi3Functions->fmi3GetEventIndicators(instance->component, eventIndicators, nEventIndicators);
+    const FMIStatus status = (FMIStatus)FMI3_FUNCTION(GetEventIndicators)(instance->component, eventIndicators, nEventIndicators);
 
     if (instance->logFunctionCall) {
         FMIClearLogMessageBuffer(instance);
@@ -1094,7 +1109,7 @@ FMIStatus FMI3GetContinuousStates(FMIInstance *instance,
     fmi3Float64 continuousStates[],
     size_t nContinuousStates) {
 
-    const FMIStatus status = (FMIStatus)instance->fmi3Functions->fmi3GetContinuousStates(instance->component, continuousStates, nContinuousStates);
+    const FMIStatus status = (FMIStatus)FMI3_FUNCTION(GetContinuousStates)(instance->component, continuousStates, nContinuousStates);
 
     if (instance->logFunctionCall) {
         FMIClearLogMessageBuffer(instance);
@@ -1111,7 +1126,7 @@ FMIStatus FMI3GetNominalsOfContinuousStates(FMIInstance *instance,
     fmi3Float64 nominals[],
     size_t nContinuousStates) {
 
-    const FMIStatus status = (FMIStatus)instance->fmi3Functions->fmi3GetNominalsOfContinuousStates(instance->component, nominals, nContinuousStates);
+    const FMIStatus status = (FMIStatus)FMI3_FUNCTION(GetNominalsOfContinuousStates)(instance->component, nominals, nContinuousStates);
 
     if (instance->logFunctionCall) {
         FMIClearLogMessageBuffer(instance);
@@ -1165,7 +1180,7 @@ FMIStatus FMI3DoStep(FMIInstance *instance,
     fmi3Boolean* earlyReturn,
     fmi3Float64* lastSuccessfulTime) {
 
-    const FMIStatus status = (FMIStatus)instance->fmi3Functions->fmi3DoStep(instance->component, currentCommunicationPoint, communicationStepSize, noSetFMUStatePriorToCurrentPoint, eventHandlingNeeded, terminateSimulation, earlyReturn, lastSuccessfulTime);
+    const FMIStatus status = (FMIStatus)FMI3_FUNCTION(DoStep)(instance->component, currentCommunicationPoint, communicationStepSize, noSetFMUStatePriorToCurrentPoint, eventHandlingNeeded, terminateSimulation, earlyReturn, lastSuccessfulTime);
 
     if (instance->logFunctionCall) {
         FMIClearLogMessageBuffer(instance);
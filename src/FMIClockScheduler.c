@@ -0,0 +1,457 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "FMIClockScheduler.h"
+
+
+#define CALL(f) do { status = f; if (status > FMIWarning) goto TERMINATE; } while (0)
+
+// number of slots of the timer wheel (power of 2)
+#define WHEEL_SIZE 256
+
+// number of priority levels (bits of the ready mask)
+#define MAX_PRIORITIES 63
+
+typedef struct FMIActivation FMIActivation;
+
+/* a pending activation of a clock */
+struct FMIActivation {
+    size_t clockIndex;
+    uint64_t tick;
+    FMIActivation* next;
+};
+
+typedef struct {
+    FMIValueReference valueReference;
+    FMIClockKind kind;
+    int priority;
+    uint64_t interval;
+    uint64_t shift;
+    bool supportsFraction;
+} FMIClock;
+
+typedef struct {
+    FMIActivation* first;
+    FMIActivation* last;
+} FMIActivationList;
+
+struct FMIClockScheduler {
+
+    FMIInstance* instance;
+
+    double resolution;
+
+    // the next tick to process
+    uint64_t nextTick;
+
+    size_t nClocks;
+    FMIClock* clocks;
+
+    // indices of the countdown clocks
+    size_t nCountdownClocks;
+    size_t* countdownClocks;
+
+    // output clocks (read with a single call)
+    size_t nOutputClocks;
+    fmi3ValueReference* outputValueReferences;
+    fmi3Clock* outputClockValues;
+
+    // pending activations in the slot (tick % WHEEL_SIZE)
+    FMIActivation* wheel[WHEEL_SIZE];
+
+    // activations that are due, one FIFO per priority and a bit mask of the non-empty FIFOs
+    FMIActivationList ready[MAX_PRIORITIES];
+    uint64_t readyMask;
+
+    // recycled activations
+    FMIActivation* available;
+
+    FMIOutputClockTicked* outputClockTicked;
+    void* userData;
+};
+
+static unsigned int firstSetBit(uint64_t mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return (unsigned int)index;
+#else
+    return (unsigned int)__builtin_ctzll(mask);
+#endif
+}
+
+static uint64_t toTicks(FMIClockScheduler* scheduler, double time) {
+    return (uint64_t)llround(time / scheduler->resolution);
+}
+
+static FMIActivation* createActivation(FMIClockScheduler* scheduler, size_t clockIndex, uint64_t tick) {
+
+    FMIActivation* activation = scheduler->available;
+
+    if (activation) {
+        scheduler->available = activation->next;
+    } else {
+        activation = (FMIActivation*)malloc(sizeof(FMIActivation));
+    }
+
+    if (activation) {
+        activation->clockIndex = clockIndex;
+        activation->tick = tick;
+        activation->next = NULL;
+    }
+
+    return activation;
+}
+
+static void appendReady(FMIClockScheduler* scheduler, FMIActivation* activation) {
+
+    const int priority = scheduler->clocks[activation->clockIndex].priority;
+
+    FMIActivationList* list = &scheduler->ready[priority];
+
+    activation->next = NULL;
+
+    if (list->last) {
+        list->last->next = activation;
+    } else {
+        list->first = activation;
+    }
+
+    list->last = activation;
+
+    scheduler->readyMask |= (uint64_t)1 << priority;
+}
+
+/* add an activation to the wheel or to the ready FIFOs if it is due */
+static void schedule(FMIClockScheduler* scheduler, FMIActivation* activation) {
+
+    if (activation->tick < scheduler->nextTick) {
+        appendReady(scheduler, activation);
+    } else {
+        FMIActivation** slot = &scheduler->wheel[activation->tick % WHEEL_SIZE];
+        activation->next = *slot;
+        *slot = activation;
+    }
+}
+
+static FMIStatus scheduleClock(FMIClockScheduler* scheduler, size_t clockIndex, uint64_t tick) {
+
+    FMIActivation* activation = createActivation(scheduler, clockIndex, tick);
+
+    if (!activation) {
+        FMILogError("Failed to allocate clock activation.");
+        return FMIError;
+    }
+
+    schedule(scheduler, activation);
+
+    return FMIOK;
+}
+
+static FMIStatus findClock(FMIClockScheduler* scheduler, FMIValueReference valueReference, size_t* clockIndex) {
+
+    for (size_t i = 0; i < scheduler->nClocks; i++) {
+        if (scheduler->clocks[i].valueReference == valueReference) {
+            *clockIndex = i;
+            return FMIOK;
+        }
+    }
+
+    FMILogError("Unknown clock (value reference %u).", valueReference);
+
+    return FMIError;
+}
+
+/* read the interval of a clock and whether it has changed */
+static FMIStatus getInterval(FMIClockScheduler* scheduler, const FMIClock* clock, double* interval, fmi3IntervalQualifier* qualifier) {
+
+    if (clock->supportsFraction) {
+
+        fmi3UInt64 counter, resolution;
+
+        const FMIStatus status = FMI3GetIntervalFraction(scheduler->instance, &clock->valueReference, 1, &counter, &resolution, qualifier);
+
+        *interval = resolution > 0 ? (double)counter / (double)resolution : 0;
+
+        return status;
+    }
+
+    return FMI3GetIntervalDecimal(scheduler->instance, &clock->valueReference, 1, interval, qualifier);
+}
+
+static FMIStatus reallocate(void** memory, size_t size) {
+
+    void* p = realloc(*memory, size);
+
+    if (!p) {
+        FMILogError("Failed to allocate memory.");
+        return FMIError;
+    }
+
+    *memory = p;
+
+    return FMIOK;
+}
+
+FMIClockScheduler* FMICreateClockScheduler(FMIInstance* instance, double resolution, FMIOutputClockTicked* outputClockTicked, void* userData) {
+
+    if (resolution <= 0) {
+        FMILogError("The resolution of the clock scheduler must be > 0.");
+        return NULL;
+    }
+
+    FMIClockScheduler* scheduler = (FMIClockScheduler*)calloc(1, sizeof(FMIClockScheduler));
+
+    if (!scheduler) {
+        FMILogError("Failed to allocate clock scheduler.");
+        return NULL;
+    }
+
+    scheduler->instance          = instance;
+    scheduler->resolution        = resolution;
+    scheduler->outputClockTicked = outputClockTicked;
+    scheduler->userData          = userData;
+
+    return scheduler;
+}
+
+static void freeActivations(FMIActivation* activation) {
+
+    while (activation) {
+        FMIActivation* next = activation->next;
+        free(activation);
+        activation = next;
+    }
+}
+
+void FMIFreeClockScheduler(FMIClockScheduler* scheduler) {
+
+    if (!scheduler) {
+        return;
+    }
+
+    for (size_t i = 0; i < WHEEL_SIZE; i++) {
+        freeActivations(scheduler->wheel[i]);
+    }
+
+    for (size_t i = 0; i < MAX_PRIORITIES; i++) {
+        freeActivations(scheduler->ready[i].first);
+    }
+
+    freeActivations(scheduler->available);
+
+    free(scheduler->clocks);
+    free(scheduler->countdownClocks);
+    free(scheduler->outputValueReferences);
+    free(scheduler->outputClockValues);
+    free(scheduler);
+}
+
+FMIStatus FMIAddClock(FMIClockScheduler* scheduler, FMIValueReference valueReference, FMIClockKind kind, int priority, double interval, double shift, bool supportsFraction) {
+
+    FMIStatus status = FMIOK;
+
+    if (kind != FMIOutputClock && (priority < 0 || priority >= MAX_PRIORITIES)) {
+        FMILogError("The priority of clock %u must be in [0, %d] but was %d.", valueReference, MAX_PRIORITIES - 1, priority);
+        return FMIError;
+    }
+
+    CALL(reallocate((void**)&scheduler->clocks, (scheduler->nClocks + 1) * sizeof(FMIClock)));
+
+    FMIClock* clock = &scheduler->clocks[scheduler->nClocks];
+
+    clock->valueReference   = valueReference;
+    clock->kind             = kind;
+    clock->priority         = kind == FMIOutputClock ? 0 : priority;
+    clock->interval         = interval > 0 ? toTicks(scheduler, interval) : 0;
+    clock->shift            = toTicks(scheduler, shift);
+    clock->supportsFraction = supportsFraction;
+
+    if (kind == FMICountdownClock) {
+
+        const size_t m = scheduler->nCountdownClocks + 1;
+
+        CALL(reallocate((void**)&scheduler->countdownClocks, m * sizeof(size_t)));
+
+        scheduler->countdownClocks[scheduler->nCountdownClocks++] = scheduler->nClocks;
+
+    } else if (kind == FMIOutputClock) {
+
+        const size_t m = scheduler->nOutputClocks + 1;
+
+        CALL(reallocate((void**)&scheduler->outputValueReferences, m * sizeof(fmi3ValueReference)));
+        CALL(reallocate((void**)&scheduler->outputClockValues, m * sizeof(fmi3Clock)));
+
+        scheduler->outputValueReferences[scheduler->nOutputClocks] = valueReference;
+        scheduler->nOutputClocks++;
+    }
+
+    scheduler->nClocks++;
+
+TERMINATE:
+    return status;
+}
+
+FMIStatus FMIStartClockScheduler(FMIClockScheduler* scheduler, double startTime) {
+
+    FMIStatus status = FMIOK;
+
+    const uint64_t startTick = toTicks(scheduler, startTime);
+
+    scheduler->nextTick = startTick;
+
+    for (size_t i = 0; i < scheduler->nClocks; i++) {
+
+        FMIClock* clock = &scheduler->clocks[i];
+
+        if (clock->kind != FMIPeriodicClock) {
+            continue;
+        }
+
+        if (clock->interval == 0) {
+
+            double interval;
+            fmi3IntervalQualifier qualifier;
+
+            CALL(getInterval(scheduler, clock, &interval, &qualifier));
+
+            clock->interval = toTicks(scheduler, interval);
+
+            if (clock->interval == 0) {
+                FMILogError("The interval of clock %u must be at least one tick.", clock->valueReference);
+                status = FMIError;
+                goto TERMINATE;
+            }
+        }
+
+        CALL(scheduleClock(scheduler, i, startTick + clock->shift));
+    }
+
+TERMINATE:
+    return status;
+}
+
+FMIStatus FMITriggerClock(FMIClockScheduler* scheduler, FMIValueReference valueReference, double time) {
+
+    size_t clockIndex;
+
+    if (findClock(scheduler, valueReference, &clockIndex) > FMIWarning) {
+        return FMIError;
+    }
+
+    return scheduleClock(scheduler, clockIndex, toTicks(scheduler, time));
+}
+
+/* activate the due clocks in the order of their priority */
+static FMIStatus dispatch(FMIClockScheduler* scheduler) {
+
+    FMIStatus status = FMIOK;
+
+    while (scheduler->readyMask) {
+
+        const unsigned int priority = firstSetBit(scheduler->readyMask);
+
+        FMIActivationList* list = &scheduler->ready[priority];
+
+        FMIActivation* activation = list->first;
+
+        list->first = activation->next;
+
+        if (!list->first) {
+            list->last = NULL;
+            scheduler->readyMask &= ~((uint64_t)1 << priority);
+        }
+
+        const FMIClock* clock = &scheduler->clocks[activation->clockIndex];
+
+        const uint64_t tick = activation->tick;
+
+        if (clock->kind == FMIPeriodicClock) {
+            // re-use the activation for the next tick of the clock
+            activation->tick += clock->interval;
+            schedule(scheduler, activation);
+        } else {
+            activation->next = scheduler->available;
+            scheduler->available = activation;
+        }
+
+        // the partition may schedule further activations through the clockUpdate callback
+        CALL(FMI3ActivateModelPartition(scheduler->instance, clock->valueReference, tick * scheduler->resolution));
+    }
+
+TERMINATE:
+    return status;
+}
+
+FMIStatus FMIAdvanceClockScheduler(FMIClockScheduler* scheduler, double time) {
+
+    FMIStatus status = FMIOK;
+
+    const uint64_t lastTick = toTicks(scheduler, time);
+
+    while (scheduler->nextTick <= lastTick) {
+
+        const uint64_t tick = scheduler->nextTick++;
+
+        // move the activations of this tick from the slot to the ready FIFOs
+        FMIActivation** previous = &scheduler->wheel[tick % WHEEL_SIZE];
+
+        while (*previous) {
+
+            FMIActivation* activation = *previous;
+
+            if (activation->tick == tick) {
+                *previous = activation->next;
+                appendReady(scheduler, activation);
+            } else {
+                previous = &activation->next;
+            }
+        }
+
+        CALL(dispatch(scheduler));
+    }
+
+TERMINATE:
+    return status;
+}
+
+FMIStatus FMIClockSchedulerClockUpdate(FMIClockScheduler* scheduler) {
+
+    FMIStatus status = FMIOK;
+
+    // the tick that is currently processed
+    const uint64_t currentTick = scheduler->nextTick > 0 ? scheduler->nextTick - 1 : 0;
+
+    for (size_t i = 0; i < scheduler->nCountdownClocks; i++) {
+
+        const size_t clockIndex = scheduler->countdownClocks[i];
+
+        double interval;
+        fmi3IntervalQualifier qualifier;
+
+        CALL(getInterval(scheduler, &scheduler->clocks[clockIndex], &interval, &qualifier));
+
+        if (qualifier == fmi3IntervalChanged) {
+            CALL(scheduleClock(scheduler, clockIndex, currentTick + toTicks(scheduler, interval)));
+        }
+    }
+
+    if (scheduler->nOutputClocks > 0) {
+
+        CALL(FMI3GetClock(scheduler->instance, scheduler->outputValueReferences, scheduler->nOutputClocks, scheduler->outputClockValues));
+
+        for (size_t i = 0; i < scheduler->nOutputClocks; i++) {
+            if (scheduler->outputClockValues[i] && scheduler->outputClockTicked) {
+                scheduler->outputClockTicked(scheduler, scheduler->outputValueReferences[i], currentTick * scheduler->resolution, scheduler->userData);
+            }
+        }
+    }
+
+TERMINATE:
+    return status;
+}
@@ -0,0 +1,1118 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "FMIModelDescription.h"
+
+
+#define MAX_ATTRIBUTES 64
+#define MAX_DEPTH 32
+
+/* element kinds of the ModelStructure */
+typedef enum {
+    UnknownOutput,
+    UnknownDerivative,
+    UnknownInitial,
+    UnknownEventIndicator
+} UnknownKind;
+
+typedef struct {
+    UnknownKind kind;
+    size_t reference;
+    size_t firstDependency;
+    size_t nDependencies;
+} ParsedUnknown;
+
+typedef struct {
+    FMIModelVariable variable;
+    size_t firstDimension;
+    const char* derivative;
+    const char* variability;
+} ParsedVariable;
+
+typedef struct {
+    FMIDimension dimension;
+    bool hasValueReference;
+} ParsedDimension;
+
+typedef struct {
+
+    FMIModelDescription* modelDescription;
+
+    FMIModelExchangeInterface modelExchange;
+    FMICoSimulationInterface coSimulation;
+    FMIScheduledExecutionInterface scheduledExecution;
+    FMIDefaultExperiment defaultExperiment;
+
+    bool hasModelExchange;
+    bool hasCoSimulation;
+    bool hasScheduledExecution;
+    bool hasDefaultExperiment;
+
+    size_t nVariables;
+    size_t variablesSize;
+    ParsedVariable* variables;
+
+    size_t nDimensions;
+    size_t dimensionsSize;
+    ParsedDimension* dimensions;
+
+    size_t nUnknowns;
+    size_t unknownsSize;
+    ParsedUnknown* unknowns;
+
+    size_t nDependencies;
+    size_t dependenciesSize;
+    size_t* dependencies;
+
+    // current element path
+    size_t depth;
+    const char* path[MAX_DEPTH];
+
+    // current FMI 2.0 section of the ModelStructure
+    UnknownKind section;
+
+    bool error;
+
+} Parser;
+
+static FMIStatus reserve(void** array, size_t* size, size_t count, size_t elementSize) {
+
+    if (count < *size) {
+        return FMIOK;
+    }
+
+    size_t newSize = *size ? *size * 2 : 64;
+
+    while (newSize <= count) {
+        newSize *= 2;
+    }
+
+    if (FMIRealloc(array, newSize * elementSize) != FMIOK) {
+        return FMIError;
+    }
+
+    *size = newSize;
+
+    return FMIOK;
+}
+
+static const char* getAttribute(const char** attributes, size_t nAttributes, const char* name) {
+
+    for (size_t i = 0; i < nAttributes; i++) {
+        if (!strcmp(attributes[2 * i], name)) {
+            return attributes[2 * i + 1];
+        }
+    }
+
+    return NULL;
+}
+
+static bool getBooleanAttribute(const char** attributes, size_t nAttributes, const char* name) {
+    const char* value = getAttribute(attributes, nAttributes, name);
+    return value && (!strcmp(value, "true") || !strcmp(value, "1"));
+}
+
+static size_t parseSize(const char* s, const char** end) {
+
+    size_t value = 0;
+
+    while (*s >= '0' && *s <= '9') {
+        value = value * 10 + (size_t)(*s - '0');
+        s++;
+    }
+
+    if (end) {
+        *end = s;
+    }
+
+    return value;
+}
+
+static bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static bool isNameEnd(char c) {
+    return c == '\0' || c == '/' || c == '>' || c == '=' || isSpace(c);
+}
+
+/* write the UTF-8 encoding of a code point and return the number of bytes */
+static size_t encodeUTF8(uint32_t c, char* s) {
+
+    if (c < 0x80) {
+        s[0] = (char)c;
+        return 1;
+    } else if (c < 0x800) {
+        s[0] = (char)(0xC0 | (c >> 6));
+        s[1] = (char)(0x80 | (c & 0x3F));
+        return 2;
+    } else if (c < 0x10000) {
+        s[0] = (char)(0xE0 | (c >> 12));
+        s[1] = (char)(0x80 | ((c >> 6) & 0x3F));
+        s[2] = (char)(0x80 | (c & 0x3F));
+        return 3;
+    } else {
+        s[0] = (char)(0xF0 | (c >> 18));
+        s[1] = (char)(0x80 | ((c >> 12) & 0x3F));
+        s[2] = (char)(0x80 | ((c >> 6) & 0x3F));
+        s[3] = (char)(0x80 | (c & 0x3F));
+        return 4;
+    }
+}
+
+/* replace entity and character references in place (the result is never longer than the input) */
+static void decodeEntities(char* s) {
+
+    char* w = s;
+
+    while (*s) {
+
+        if (*s != '&') {
+            *w++ = *s++;
+            continue;
+        }
+
+        const char* end = strchr(s, ';');
+
+        if (!end) {
+            *w++ = *s++;
+            continue;
+        }
+
+        if (s[1] == '#') {
+            const uint32_t c = (uint32_t)(s[2] == 'x' ? strtoul(s + 3, NULL, 16) : strtoul(s + 2, NULL, 10));
+            w += encodeUTF8(c, w);
+        } else if (!strncmp(s, "&amp;", 5)) {
+            *w++ = '&';
+        } else if (!strncmp(s, "&lt;", 4)) {
+            *w++ = '<';
+        } else if (!strncmp(s, "&gt;", 4)) {
+            *w++ = '>';
+        } else if (!strncmp(s, "&quot;", 6)) {
+            *w++ = '"';
+        } else if (!strncmp(s, "&apos;", 6)) {
+            *w++ = '\'';
+        } else {
+            // unknown entity
+            while (s <= end) {
+                *w++ = *s++;
+            }
+            continue;
+        }
+
+        s = (char*)end + 1;
+    }
+
+    *w = '\0';
+}
+
+static bool isVariableType(const char* name, FMIVariableType* type) {
+
+    static const char* names[] = {
+        "Float32", "Float64", "Int8", "UInt8", "Int16", "UInt16", "Int32", "UInt32", "Int64", "UInt64", "Boolean", "String", "Binary", "Clock"
+    };
+
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        if (!strcmp(name, names[i])) {
+            *type = (FMIVariableType)i;
+            return true;
+        }
+    }
+
+    if (!strcmp(name, "Enumeration")) {
+        *type = FMIInt64Type;
+        return true;
+    }
+
+    return false;
+}
+
+static FMICausality parseCausality(const char* value) {
+
+    if (!value) {
+        return FMILocal;
+    } else if (!strcmp(value, "parameter")) {
+        return FMIParameter;
+    } else if (!strcmp(value, "calculatedParameter")) {
+        return FMICalculatedParameter;
+    } else if (!strcmp(value, "structuralParameter")) {
+        return FMIStructuralParameter;
+    } else if (!strcmp(value, "input")) {
+        return FMIInput;
+    } else if (!strcmp(value, "output")) {
+        return FMIOutput;
+    } else if (!strcmp(value, "independent")) {
+        return FMIIndependent;
+    }
+
+    return FMILocal;
+}
+
+static FMIVariability parseVariability(const char* value, FMIVariability defaultVariability) {
+
+    if (!value) {
+        return defaultVariability;
+    } else if (!strcmp(value, "constant")) {
+        return FMIConstant;
+    } else if (!strcmp(value, "fixed")) {
+        return FMIFixed;
+    } else if (!strcmp(value, "tunable")) {
+        return FMITunable;
+    } else if (!strcmp(value, "discrete")) {
+        return FMIDiscrete;
+    }
+
+    return FMIContinuous;
+}
+
+static FMIInitial parseInitial(const char* value) {
+
+    if (!value) {
+        return FMIInitialUndefined;
+    } else if (!strcmp(value, "exact")) {
+        return FMIExact;
+    } else if (!strcmp(value, "approx")) {
+        return FMIApprox;
+    } else if (!strcmp(value, "calculated")) {
+        return FMICalculated;
+    }
+
+    return FMIInitialUndefined;
+}
+
+static void addVariable(Parser* parser, FMIVariableType type, const char** attributes, size_t nAttributes) {
+
+    if (reserve((void**)&parser->variables, &parser->variablesSize, parser->nVariables, sizeof(ParsedVariable)) != FMIOK) {
+        parser->error = true;
+        return;
+    }
+
+    ParsedVariable* v = &parser->variables[parser->nVariables++];
+
+    memset(v, 0, sizeof(ParsedVariable));
+
+    const bool continuous = type == FMIFloat32Type || type == FMIFloat64Type;
+
+    v->variable.type           = type;
+    v->variable.name           = getAttribute(attributes, nAttributes, "name");
+    v->variable.description    = getAttribute(attributes, nAttributes, "description");
+    v->variable.start          = getAttribute(attributes, nAttributes, "start");
+    v->variable.declaredType   = getAttribute(attributes, nAttributes, "declaredType");
+    v->variable.causality      = parseCausality(getAttribute(attributes, nAttributes, "causality"));
+    v->variability             = getAttribute(attributes, nAttributes, "variability");
+    v->variable.variability    = parseVariability(v->variability, continuous ? FMIContinuous : FMIDiscrete);
+    v->variable.initial        = parseInitial(getAttribute(attributes, nAttributes, "initial"));
+    v->derivative              = getAttribute(attributes, nAttributes, "derivative");
+    v->firstDimension          = parser->nDimensions;
+
+    const char* valueReference = getAttribute(attributes, nAttributes, "valueReference");
+
+    if (!v->variable.name || !valueReference) {
+        FMILogError("Model variable is missing the attribute name or valueReference.");
+        parser->error = true;
+        return;
+    }
+
+    v->variable.valueReference = (FMIValueReference)parseSize(valueReference, NULL);
+}
+
+static void addDimension(Parser* parser, const char** attributes, size_t nAttributes) {
+
+    if (parser->nVariables == 0) {
+        FMILogError("Dimension is not part of a model variable.");
+        parser->error = true;
+        return;
+    }
+
+    if (reserve((void**)&parser->dimensions, &parser->dimensionsSize, parser->nDimensions, sizeof(ParsedDimension)) != FMIOK) {
+        parser->error = true;
+        return;
+    }
+
+    ParsedDimension* d = &parser->dimensions[parser->nDimensions++];
+
+    memset(d, 0, sizeof(ParsedDimension));
+
+    const char* start = getAttribute(attributes, nAttributes, "start");
+    const char* valueReference = getAttribute(attributes, nAttributes, "valueReference");
+
+    d->dimension.start = start ? parseSize(start, NULL) : 0;
+    d->dimension.valueReference = valueReference ? (FMIValueReference)parseSize(valueReference, NULL) : 0;
+
+    // the variable is resolved after the model variables have been read
+    d->hasValueReference = valueReference != NULL;
+
+    parser->variables[parser->nVariables - 1].variable.nDimensions++;
+}
+
+static void addUnknown(Parser* parser, UnknownKind kind, const char* reference, const char* dependencies) {
+
+    if (!reference) {
+        FMILogError("Unknown is missing the attribute index or valueReference.");
+        parser->error = true;
+        return;
+    }
+
+    if (reserve((void**)&parser->unknowns, &parser->unknownsSize, parser->nUnknowns, sizeof(ParsedUnknown)) != FMIOK) {
+        parser->error = true;
+        return;
+    }
+
+    ParsedUnknown* unknown = &parser->unknowns[parser->nUnknowns++];
+
+    unknown->kind            = kind;
+    unknown->reference       = parseSize(reference, NULL);
+    unknown->firstDependency = parser->nDependencies;
+    unknown->nDependencies   = 0;
+
+    const char* s = dependencies;
+
+    while (s && *s) {
+
+        while (isSpace(*s)) {
+            s++;
+        }
+
+        if (!*s) {
+            break;
+        }
+
+        if (reserve((void**)&parser->dependencies, &parser->dependenciesSize, parser->nDependencies, sizeof(size_t)) != FMIOK) {
+            parser->error = true;
+            return;
+        }
+
+        const char* end;
+
+        parser->dependencies[parser->nDependencies++] = parseSize(s, &end);
+        unknown->nDependencies++;
+
+        if (end == s) {
+            FMILogError("Illegal dependencies \"%s\".", dependencies);
+            parser->error = true;
+            return;
+        }
+
+        s = end;
+    }
+}
+
+static void startElement(Parser* parser, const char* name, const char** attributes, size_t nAttributes) {
+
+    FMIModelDescription* modelDescription = parser->modelDescription;
+
+    const size_t depth = parser->depth;
+
+    const char* parent = depth > 0 ? parser->path[depth - 1] : "";
+
+    if (depth < MAX_DEPTH) {
+        parser->path[depth] = name;
+    }
+
+    parser->depth++;
+
+    if (depth == 0) {
+
+        if (strcmp(name, "fmiModelDescription")) {
+            FMILogError("Expected root element fmiModelDescription but was %s.", name);
+            parser->error = true;
+            return;
+        }
+
+        modelDescription->fmiVersion = getAttribute(attributes, nAttributes, "fmiVersion");
+
+        if (modelDescription->fmiVersion && !strncmp(modelDescription->fmiVersion, "2.", 2)) {
+            modelDescription->fmiMajorVersion = FMIMajorVersion2;
+            modelDescription->instantiationToken = getAttribute(attributes, nAttributes, "guid");
+        } else if (modelDescription->fmiVersion && !strncmp(modelDescription->fmiVersion, "3.", 2)) {
+            modelDescription->fmiMajorVersion = FMIMajorVersion3;
+            modelDescription->instantiationToken = getAttribute(attributes, nAttributes, "instantiationToken");
+        } else {
+            FMILogError("Unsupported FMI version %s.", modelDescription->fmiVersion ? modelDescription->fmiVersion : "");
+            parser->error = true;
+            return;
+        }
+
+        modelDescription->modelName      = getAttribute(attributes, nAttributes, "modelName");
+        modelDescription->description    = getAttribute(attributes, nAttributes, "description");
+        modelDescription->generationTool = getAttribute(attributes, nAttributes, "generationTool");
+
+        const char* numberOfEventIndicators = getAttribute(attributes, nAttributes, "numberOfEventIndicators");
+
+        if (numberOfEventIndicators) {
+            modelDescription->nEventIndicators = parseSize(numberOfEventIndicators, NULL);
+        }
+
+    } else if (depth == 1) {
+
+        if (!strcmp(name, "ModelExchange")) {
+            parser->hasModelExchange = true;
+            parser->modelExchange.modelIdentifier                = getAttribute(attributes, nAttributes, "modelIdentifier");
+            parser->modelExchange.providesDirectionalDerivatives = getBooleanAttribute(attributes, nAttributes, "providesDirectionalDerivative") ||
+                                                                   getBooleanAttribute(attributes, nAttributes, "providesDirectionalDerivatives");
+            parser->modelExchange.canGetAndSetFMUState           = getBooleanAttribute(attributes, nAttributes, "canGetAndSetFMUstate") ||
+                                                                   getBooleanAttribute(attributes, nAttributes, "canGetAndSetFMUState");
+            parser->modelExchange.needsCompletedIntegratorStep   = modelDescription->fmiMajorVersion == FMIMajorVersion2 ?
+                                                                   !getBooleanAttribute(attributes, nAttributes, "completedIntegratorStepNotNeeded") :
+                                                                   getBooleanAttribute(attributes, nAttributes, "needsCompletedIntegratorStep");
+        } else if (!strcmp(name, "CoSimulation")) {
+            const char* fixedInternalStepSize = getAttribute(attributes, nAttributes, "fixedInternalStepSize");
+            const char* maxOutputDerivativeOrder = getAttribute(attributes, nAttributes, "maxOutputDerivativeOrder");
+            parser->hasCoSimulation = true;
+            parser->coSimulation.modelIdentifier                        = getAttribute(attributes, nAttributes, "modelIdentifier");
+            parser->coSimulation.providesDirectionalDerivatives         = getBooleanAttribute(attributes, nAttributes, "providesDirectionalDerivative") ||
+                                                                          getBooleanAttribute(attributes, nAttributes, "providesDirectionalDerivatives");
+            parser->coSimulation.canGetAndSetFMUState                   = getBooleanAttribute(attributes, nAttributes, "canGetAndSetFMUstate") ||
+                                                                          getBooleanAttribute(attributes, nAttributes, "canGetAndSetFMUState");
+            parser->coSimulation.canHandleVariableCommunicationStepSize = getBooleanAttribute(attributes, nAttributes, "canHandleVariableCommunicationStepSize");
+            parser->coSimulation.canInterpolateInputs                   = getBooleanAttribute(attributes, nAttributes, "canInterpolateInputs");
+            parser->coSimulation.hasEventMode                           = getBooleanAttribute(attributes, nAttributes, "hasEventMode");
+            parser->coSimulation.providesIntermediateUpdate             = getBooleanAttribute(attributes, nAttributes, "providesIntermediateUpdate");
+            parser->coSimulation.canReturnEarlyAfterIntermediateUpdate  = getBooleanAttribute(attributes, nAttributes, "canReturnEarlyAfterIntermediateUpdate");
+            parser->coSimulation.fixedInternalStepSize                  = fixedInternalStepSize ? strtod(fixedInternalStepSize, NULL) : 0;
+            parser->coSimulation.maxOutputDerivativeOrder               = maxOutputDerivativeOrder ? (int)parseSize(maxOutputDerivativeOrder, NULL) : 0;
+        } else if (!strcmp(name, "ScheduledExecution")) {
+            parser->hasScheduledExecution = true;
+            parser->scheduledExecution.modelIdentifier = getAttribute(attributes, nAttributes, "modelIdentifier");
+        } else if (!strcmp(name, "DefaultExperiment")) {
+            parser->hasDefaultExperiment = true;
+            parser->defaultExperiment.startTime = getAttribute(attributes, nAttributes, "startTime");
+            parser->defaultExperiment.stopTime  = getAttribute(attributes, nAttributes, "stopTime");
+            parser->defaultExperiment.tolerance = getAttribute(attributes, nAttributes, "tolerance");
+            parser->defaultExperiment.stepSize  = getAttribute(attributes, nAttributes, "stepSize");
+        }
+
+    } else if (!strcmp(parent, "ModelVariables")) {
+
+        FMIVariableType type;
+
+        if (!strcmp(name, "ScalarVariable")) {
+            // the type is set by the type element
+            addVariable(parser, FMIFloat64Type, attributes, nAttributes);
+        } else if (modelDescription->fmiMajorVersion == FMIMajorVersion3 && isVariableType(name, &type)) {
+            addVariable(parser, type, attributes, nAttributes);
+        }
+
+    } else if (depth == 3 && !strcmp(parser->path[1], "ModelVariables") && parser->nVariables > 0) {
+
+        ParsedVariable* v = &parser->variables[parser->nVariables - 1];
+
+        if (!strcmp(parent, "ScalarVariable")) {
+
+            if (!strcmp(name, "Real")) {
+                v->variable.type = FMIRealType;
+            } else if (!strcmp(name, "Integer") || !strcmp(name, "Enumeration")) {
+                v->variable.type = FMIIntegerType;
+            } else if (!strcmp(name, "Boolean")) {
+                v->variable.type = FMIBooleanType;
+            } else if (!strcmp(name, "String")) {
+                v->variable.type = FMIStringType;
+            } else {
+                return;
+            }
+
+            // the default variability depends on the type element
+            v->variable.variability  = parseVariability(v->variability, v->variable.type == FMIRealType ? FMIContinuous : FMIDiscrete);
+            v->variable.start        = getAttribute(attributes, nAttributes, "start");
+            v->variable.declaredType = getAttribute(attributes, nAttributes, "declaredType");
+            v->derivative            = getAttribute(attributes, nAttributes, "derivative");
+
+        } else if (!strcmp(name, "Dimension")) {
+            addDimension(parser, attributes, nAttributes);
+        } else if (!strcmp(name, "Start") && !v->variable.start) {
+            v->variable.start = getAttribute(attributes, nAttributes, "value");
+        }
+
+    } else if (modelDescription->fmiMajorVersion == FMIMajorVersion2 && depth == 3 && !strcmp(parser->path[1], "ModelStructure")) {
+
+        if (!strcmp(name, "Unknown")) {
+            addUnknown(parser, parser->section, getAttribute(attributes, nAttributes, "index"), getAttribute(attributes, nAttributes, "dependencies"));
+        }
+
+    } else if (depth == 2 && !strcmp(parent, "ModelStructure")) {
+
+        if (!strcmp(name, "Outputs")) {
+            parser->section = UnknownOutput;
+        } else if (!strcmp(name, "Derivatives")) {
+            parser->section = UnknownDerivative;
+        } else if (!strcmp(name, "InitialUnknowns")) {
+            parser->section = UnknownInitial;
+        } else {
+
+            UnknownKind kind;
+
+            if (!strcmp(name, "Output")) {
+                kind = UnknownOutput;
+            } else if (!strcmp(name, "ContinuousStateDerivative")) {
+                kind = UnknownDerivative;
+            } else if (!strcmp(name, "InitialUnknown")) {
+                kind = UnknownInitial;
+            } else if (!strcmp(name, "EventIndicator")) {
+                kind = UnknownEventIndicator;
+            } else {
+                return;
+            }
+
+            addUnknown(parser, kind, getAttribute(attributes, nAttributes, "valueReference"), getAttribute(attributes, nAttributes, "dependencies"));
+        }
+    }
+}
+
+static void endElement(Parser* parser) {
+
+    if (parser->depth > 0) {
+        parser->depth--;
+    }
+}
+
+/* non-validating XML parser that modifies the buffer in place and calls startElement() and endElement() */
+static bool parseXML(Parser* parser, char* p) {
+
+    const char* attributes[2 * MAX_ATTRIBUTES];
+
+    while (!parser->error) {
+
+        p = strchr(p, '<');
+
+        if (!p) {
+            break;
+        }
+
+        if (!strncmp(p, "<?", 2)) {
+            p = strstr(p, "?>");
+        } else if (!strncmp(p, "<!--", 4)) {
+            p = strstr(p, "-->");
+        } else if (!strncmp(p, "<![CDATA[", 9)) {
+            p = strstr(p, "]]>");
+        } else if (!strncmp(p, "<!", 2)) {
+            p = strchr(p, '>');
+        } else if (p[1] == '/') {
+            endElement(parser);
+            p = strchr(p, '>');
+        } else {
+
+            char* name = ++p;
+
+            while (!isNameEnd(*p)) {
+                p++;
+            }
+
+            char c = *p;
+
+            *p = '\0';
+
+            size_t nAttributes = 0;
+            bool empty = false;
+
+            for (;;) {
+
+                while (isSpace(c)) {
+                    c = *++p;
+                }
+
+                if (c == '/') {
+                    empty = true;
+                    p = strchr(p + 1, '>');
+                    break;
+                } else if (c == '>') {
+                    break;
+                } else if (c == '\0') {
+                    FMILogError("Unexpected end of file.");
+                    return false;
+                }
+
+                char* attributeName = p;
+
+                while (!isNameEnd(*p)) {
+                    p++;
+                }
+
+                char* attributeNameEnd = p;
+
+                while (isSpace(*p)) {
+                    p++;
+                }
+
+                if (*p != '=') {
+                    FMILogError("Expected '=' after attribute %.*s.", (int)(attributeNameEnd - attributeName), attributeName);
+                    return false;
+                }
+
+                p++;
+
+                while (isSpace(*p)) {
+                    p++;
+                }
+
+                const char quote = *p;
+
+                if (quote != '"' && quote != '\'') {
+                    FMILogError("Expected quote after %.*s=.", (int)(attributeNameEnd - attributeName), attributeName);
+                    return false;
+                }
+
+                char* value = ++p;
+
+                p = strchr(p, quote);
+
+                if (!p) {
+                    FMILogError("Unterminated attribute value.");
+                    return false;
+                }
+
+                *attributeNameEnd = '\0';
+                *p = '\0';
+
+                decodeEntities(value);
+
+                if (nAttributes < MAX_ATTRIBUTES) {
+                    attributes[2 * nAttributes] = attributeName;
+                    attributes[2 * nAttributes + 1] = value;
+                    nAttributes++;
+                }
+
+                c = *++p;
+            }
+
+            startElement(parser, name, attributes, nAttributes);
+
+            if (empty) {
+                endElement(parser);
+            }
+        }
+
+        if (!p) {
+            FMILogError("Unexpected end of file.");
+            return false;
+        }
+
+        p++;
+    }
+
+    return !parser->error;
+}
+
+static size_t hashString(const char* s) {
+
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+
+    while (*s) {
+        hash ^= (unsigned char)*s++;
+        hash *= 1099511628211ULL;
+    }
+
+    return (size_t)hash;
+}
+
+static size_t hashValueReference(FMIValueReference valueReference) {
+    return (size_t)(valueReference * 2654435761U);
+}
+
+static bool sameValueReferenceSpace(const FMIModelDescription* modelDescription, FMIVariableType type1, FMIVariableType type2) {
+    return modelDescription->fmiMajorVersion == FMIMajorVersion3 || type1 == type2;
+}
+
+FMIModelVariable* FMIModelVariableForName(const FMIModelDescription* modelDescription, const char* name) {
+
+    if (!modelDescription || !name || modelDescription->nBuckets == 0) {
+        return NULL;
+    }
+
+    const size_t mask = modelDescription->nBuckets - 1;
+
+    for (size_t i = hashString(name) & mask;; i = (i + 1) & mask) {
+
+        const size_t index = modelDescription->nameBuckets[i];
+
+        if (index == 0) {
+            return NULL;
+        }
+
+        FMIModelVariable* variable = &modelDescription->modelVariables[index - 1];
+
+        if (!strcmp(variable->name, name)) {
+            return variable;
+        }
+    }
+}
+
+FMIModelVariable* FMIModelVariableForValueReference(const FMIModelDescription* modelDescription, FMIVariableType type, FMIValueReference valueReference) {
+
+    if (!modelDescription || modelDescription->nBuckets == 0) {
+        return NULL;
+    }
+
+    const size_t mask = modelDescription->nBuckets - 1;
+
+    for (size_t i = hashValueReference(valueReference) & mask;; i = (i + 1) & mask) {
+
+        const size_t index = modelDescription->valueReferenceBuckets[i];
+
+        if (index == 0) {
+            return NULL;
+        }
+
+        FMIModelVariable* variable = &modelDescription->modelVariables[index - 1];
+
+        if (variable->valueReference == valueReference && sameValueReferenceSpace(modelDescription, variable->type, type)) {
+            return variable;
+        }
+    }
+}
+
+static FMIModelVariable* resolveReference(const FMIModelDescription* modelDescription, size_t reference) {
+
+    if (modelDescription->fmiMajorVersion == FMIMajorVersion2) {
+        // 1-based index
+        return reference > 0 && reference <= modelDescription->nModelVariables ? &modelDescription->modelVariables[reference - 1] : NULL;
+    }
+
+    return FMIModelVariableForValueReference(modelDescription, FMIFloat64Type, (FMIValueReference)reference);
+}
+
+/* move the parsed data into a single block of memory and resolve the references */
+static FMIStatus finalize(Parser* parser) {
+
+    FMIModelDescription* modelDescription = parser->modelDescription;
+
+    const size_t nVariables = parser->nVariables;
+
+    size_t nBuckets = 16;
+
+    while (nBuckets < 2 * nVariables) {
+        nBuckets *= 2;
+    }
+
+    const size_t size =
+        sizeof(FMIModelExchangeInterface) +
+        sizeof(FMICoSimulationInterface) +
+        sizeof(FMIScheduledExecutionInterface) +
+        sizeof(FMIDefaultExperiment) +
+        nVariables * sizeof(FMIModelVariable) +
+        parser->nDimensions * sizeof(FMIDimension) +
+        parser->nUnknowns * sizeof(FMIUnknown) +
+        parser->nDependencies * sizeof(FMIModelVariable*) +
+        2 * nBuckets * sizeof(size_t);
+
+    if (FMICalloc(&modelDescription->memory, 1, size) != FMIOK) {
+        return FMIError;
+    }
+
+    char* p = (char*)modelDescription->memory;
+
+#define ALLOCATE(type, count) (type*)p; p += (count) * sizeof(type)
+
+    FMIModelExchangeInterface* modelExchange      = ALLOCATE(FMIModelExchangeInterface, 1);
+    FMICoSimulationInterface* coSimulation        = ALLOCATE(FMICoSimulationInterface, 1);
+    FMIScheduledExecutionInterface* scheduled     = ALLOCATE(FMIScheduledExecutionInterface, 1);
+    FMIDefaultExperiment* defaultExperiment       = ALLOCATE(FMIDefaultExperiment, 1);
+    FMIModelVariable* variables                   = ALLOCATE(FMIModelVariable, nVariables);
+    FMIDimension* dimensions                      = ALLOCATE(FMIDimension, parser->nDimensions);
+    FMIUnknown* unknowns                          = ALLOCATE(FMIUnknown, parser->nUnknowns);
+    FMIModelVariable** dependencies               = ALLOCATE(FMIModelVariable*, parser->nDependencies);
+    size_t* nameBuckets                           = ALLOCATE(size_t, nBuckets);
+    size_t* valueReferenceBuckets                 = ALLOCATE(size_t, nBuckets);
+
+#undef ALLOCATE
+
+    *modelExchange     = parser->modelExchange;
+    *coSimulation      = parser->coSimulation;
+    *scheduled         = parser->scheduledExecution;
+    *defaultExperiment = parser->defaultExperiment;
+
+    modelDescription->modelExchange      = parser->hasModelExchange      ? modelExchange     : NULL;
+    modelDescription->coSimulation       = parser->hasCoSimulation       ? coSimulation      : NULL;
+    modelDescription->scheduledExecution = parser->hasScheduledExecution ? scheduled         : NULL;
+    modelDescription->defaultExperiment  = parser->hasDefaultExperiment  ? defaultExperiment : NULL;
+
+    modelDescription->nModelVariables       = nVariables;
+    modelDescription->modelVariables        = variables;
+    modelDescription->nBuckets              = nBuckets;
+    modelDescription->nameBuckets           = nameBuckets;
+    modelDescription->valueReferenceBuckets = valueReferenceBuckets;
+
+    for (size_t i = 0; i < parser->nDimensions; i++) {
+        dimensions[i] = parser->dimensions[i].dimension;
+    }
+
+    const size_t mask = nBuckets - 1;
+
+    for (size_t i = 0; i < nVariables; i++) {
+
+        FMIModelVariable* variable = &variables[i];
+
+        *variable = parser->variables[i].variable;
+
+        variable->dimensions = variable->nDimensions > 0 ? &dimensions[parser->variables[i].firstDimension] : NULL;
+
+        size_t j = hashString(variable->name) & mask;
+
+        while (nameBuckets[j]) {
+
+            if (!strcmp(variables[nameBuckets[j] - 1].name, variable->name)) {
+                FMILogError("Variable name \"%s\" is not unique.", variable->name);
+                return FMIError;
+            }
+
+            j = (j + 1) & mask;
+        }
+
+        nameBuckets[j] = i + 1;
+
+        j = hashValueReference(variable->valueReference) & mask;
+
+        while (valueReferenceBuckets[j]) {
+            j = (j + 1) & mask;
+        }
+
+        valueReferenceBuckets[j] = i + 1;
+    }
+
+    // resolve the derivatives and dimensions
+    for (size_t i = 0; i < nVariables; i++) {
+
+        FMIModelVariable* variable = &variables[i];
+
+        const char* derivative = parser->variables[i].derivative;
+
+        if (derivative) {
+
+            variable->derivative = resolveReference(modelDescription, parseSize(derivative, NULL));
+
+            if (!variable->derivative) {
+                FMILogError("Failed to resolve the derivative attribute of variable %s.", variable->name);
+                return FMIError;
+            }
+        }
+
+        for (size_t j = 0; j < variable->nDimensions; j++) {
+
+            FMIDimension* dimension = &variable->dimensions[j];
+
+            if (parser->dimensions[parser->variables[i].firstDimension + j].hasValueReference) {
+
+                dimension->variable = FMIModelVariableForValueReference(modelDescription, FMIUInt64Type, dimension->valueReference);
+
+                if (!dimension->variable) {
+                    FMILogError("Failed to resolve the dimension of variable %s.", variable->name);
+                    return FMIError;
+                }
+            }
+        }
+    }
+
+    // resolve the ModelStructure
+    size_t counts[4] = { 0 };
+
+    for (size_t i = 0; i < parser->nUnknowns; i++) {
+        counts[parser->unknowns[i].kind]++;
+    }
+
+    FMIUnknown* sections[4];
+
+    sections[UnknownOutput]         = unknowns;
+    sections[UnknownDerivative]     = sections[UnknownOutput] + counts[UnknownOutput];
+    sections[UnknownInitial]        = sections[UnknownDerivative] + counts[UnknownDerivative];
+    sections[UnknownEventIndicator] = sections[UnknownInitial] + counts[UnknownInitial];
+
+    modelDescription->nOutputs          = counts[UnknownOutput];
+    modelDescription->outputs           = counts[UnknownOutput] ? sections[UnknownOutput] : NULL;
+    modelDescription->nDerivatives = counts[UnknownDerivative];
+    modelDescription->derivatives       = counts[UnknownDerivative] ? sections[UnknownDerivative] : NULL;
+    modelDescription->nInitialUnknowns  = counts[UnknownInitial];
+    modelDescription->initialUnknowns   = counts[UnknownInitial] ? sections[UnknownInitial] : NULL;
+
+    if (modelDescription->fmiMajorVersion == FMIMajorVersion3) {
+        modelDescription->nEventIndicators = counts[UnknownEventIndicator];
+        modelDescription->eventIndicators  = counts[UnknownEventIndicator] ? sections[UnknownEventIndicator] : NULL;
+    }
+
+    for (size_t i = 0; i < parser->nUnknowns; i++) {
+
+        const ParsedUnknown* parsed = &parser->unknowns[i];
+
+        FMIUnknown* unknown = sections[parsed->kind]++;
+
+        unknown->modelVariable = resolveReference(modelDescription, parsed->reference);
+
+        if (!unknown->modelVariable) {
+            FMILogError("Failed to resolve unknown %zu in the ModelStructure.", parsed->reference);
+            return FMIError;
+        }
+
+        unknown->nDependencies = parsed->nDependencies;
+        unknown->dependencies = parsed->nDependencies > 0 ? &dependencies[parsed->firstDependency] : NULL;
+
+        for (size_t j = 0; j < parsed->nDependencies; j++) {
+
+            unknown->dependencies[j] = resolveReference(modelDescription, parser->dependencies[parsed->firstDependency + j]);
+
+            if (!unknown->dependencies[j]) {
+                FMILogError("Failed to resolve the dependencies of %s.", unknown->modelVariable->name);
+                return FMIError;
+            }
+        }
+    }
+
+    return FMIOK;
+}
+
+static FMIModelDescription* parseBuffer(char* buffer) {
+
+    FMIModelDescription* modelDescription = NULL;
+    Parser parser;
+
+    memset(&parser, 0, sizeof(Parser));
+
+    if (FMICalloc((void**)&modelDescription, 1, sizeof(FMIModelDescription)) != FMIOK) {
+        FMIFree((void**)&buffer);
+        return NULL;
+    }
+
+    modelDescription->buffer = buffer;
+
+    parser.modelDescription = modelDescription;
+
+    FMIStatus status = parseXML(&parser, buffer) ? FMIOK : FMIError;
+
+    if (status == FMIOK) {
+        status = finalize(&parser);
+    }
+
+    FMIFree((void**)&parser.variables);
+    FMIFree((void**)&parser.dimensions);
+    FMIFree((void**)&parser.unknowns);
+    FMIFree((void**)&parser.dependencies);
+
+    if (status != FMIOK) {
+        FMIFreeModelDescription(modelDescription);
+        return NULL;
+    }
+
+    return modelDescription;
+}
+
+FMIModelDescription* FMIParseModelDescription(const char* xml, size_t length) {
+
+    char* buffer = NULL;
+
+    if (FMICalloc((void**)&buffer, length + 1, sizeof(char)) != FMIOK) {
+        return NULL;
+    }
+
+    memcpy(buffer, xml, length);
+
+    return parseBuffer(buffer);
+}
+
+FMIModelDescription* FMIReadModelDescription(const char* filename) {
+
+    FILE* file = fopen(filename, "rb");
+
+    if (!file) {
+        FMILogError("Failed to open %s.", filename);
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+
+    const long length = ftell(file);
+
+    fseek(file, 0, SEEK_SET);
+
+    char* buffer = NULL;
+
+    if (length < 0 || FMICalloc((void**)&buffer, (size_t)length + 1, sizeof(char)) != FMIOK) {
+        fclose(file);
+        return NULL;
+    }
+
+    const size_t read = fread(buffer, 1, (size_t)length, file);
+
+    fclose(file);
+
+    if (read != (size_t)length) {
+        FMILogError("Failed to read %s.", filename);
+        FMIFree((void**)&buffer);
+        return NULL;
+    }
+
+    return parseBuffer(buffer);
+}
+
+void FMIFreeModelDescription(FMIModelDescription* modelDescription) {
+
+    if (!modelDescription) {
+        return;
+    }
+
+    FMIFree((void**)&modelDescription->buffer);
+    FMIFree(&modelDescription->memory);
+    FMIFree((void**)&modelDescription);
+}
+
+size_t FMIModelVariableSize(const FMIModelVariable* variable) {
+
+    size_t size = 1;
+
+    for (size_t i = 0; i < variable->nDimensions; i++) {
+
+        const FMIDimension* dimension = &variable->dimensions[i];
+
+        if (dimension->variable) {
+            size *= dimension->variable->start ? parseSize(dimension->variable->start, NULL) : 0;
+        } else {
+            size *= dimension->start;
+        }
+    }
+
+    return size;
+}
+
+const char* FMIVariableTypeToString(FMIVariableType type) {
+
+    switch (type) {
+        case FMIFloat32Type:  return "Float32";
+        case FMIFloat64Type:  return "Float64";
+        case FMIInt8Type:     return "Int8";
+        case FMIUInt8Type:    return "UInt8";
+        case FMIInt16Type:    return "Int16";
+        case FMIUInt16Type:   return "UInt16";
+        case FMIInt32Type:    return "Int32";
+        case FMIUInt32Type:   return "UInt32";
+        case FMIInt64Type:    return "Int64";
+        case FMIUInt64Type:   return "UInt64";
+        case FMIBooleanType:  return "Boolean";
+        case FMIStringType:   return "String";
+        case FMIBinaryType:   return "Binary";
+        case FMIClockType:    return "Clock";
+        default:              return "Unknown";
+    }
+}
+
+const char* FMICausalityToString(FMICausality causality) {
+
+    switch (causality) {
+        case FMIParameter:           return "parameter";
+        case FMICalculatedParameter: return "calculatedParameter";
+        case FMIStructuralParameter: return "structuralParameter";
+        case FMIInput:               return "input";
+        case FMIOutput:              return "output";
+        case FMIIndependent:         return "independent";
+        default:                     return "local";
+    }
+}
+
+const char* FMIVariabilityToString(FMIVariability variability) {
+
+    switch (variability) {
+        case FMIConstant: return "constant";
+        case FMIFixed:    return "fixed";
+        case FMITunable:  return "tunable";
+        case FMIDiscrete: return "discrete";
+        default:          return "continuous";
+    }
+}
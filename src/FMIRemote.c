@@ -0,0 +1,1545 @@
+#ifdef __linux__
+#define _GNU_SOURCE
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#endif
+
+#include "FMI3.h"
+#include "FMIRemote.h"
+
+
+#ifdef __linux__
+
+/***************************************************
+Rings
+****************************************************/
+
+// number of checks before the waiting side sleeps
+#ifndef FMI_REMOTE_SPIN_COUNT
+#define FMI_REMOTE_SPIN_COUNT 4096
+#endif
+
+// interval to check whether the peer is still alive (in nanoseconds)
+#define WAIT_TIMEOUT 10000000
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CPU_RELAX() __builtin_ia32_pause()
+#elif defined(__aarch64__)
+#define CPU_RELAX() __asm__ __volatile__("yield")
+#else
+#define CPU_RELAX()
+#endif
+
+// waits until *word != value
+static bool waitForChange(uint32_t *word, uint32_t value, uint32_t *waiting, FMIRemotePeerAlive *peerAlive, void *context) {
+
+    static long spinCount = -1;
+
+    // spinning only helps if the peer runs on another CPU
+    if (spinCount < 0) {
+        spinCount = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? FMI_REMOTE_SPIN_COUNT : 0;
+    }
+
+    for (long i = 0; i < spinCount; i++) {
+
+        if (__atomic_load_n(word, __ATOMIC_ACQUIRE) != value) {
+            return true;
+        }
+
+        CPU_RELAX();
+    }
+
+    const struct timespec timeout = { 0, WAIT_TIMEOUT };
+
+    for (;;) {
+
+        // announce the waiter before the last check, so the peer either sees the flag or we see the new value
+        __atomic_store_n(waiting, 1, __ATOMIC_SEQ_CST);
+
+        if (__atomic_load_n(word, __ATOMIC_SEQ_CST) != value) {
+            __atomic_store_n(waiting, 0, __ATOMIC_RELAXED);
+            return true;
+        }
+
+        if (syscall(SYS_futex, word, FUTEX_WAIT, value, &timeout, NULL, 0) == -1 && errno == ETIMEDOUT && !peerAlive(context)) {
+            __atomic_store_n(waiting, 0, __ATOMIC_RELAXED);
+            return false;
+        }
+    }
+}
+
+static void wake(uint32_t *word, uint32_t *waiting) {
+
+    if (__atomic_load_n(waiting, __ATOMIC_SEQ_CST)) {
+        syscall(SYS_futex, word, FUTEX_WAKE, 1, NULL, NULL, 0);
+    }
+}
+
+FMIRemoteMessage *FMIRemoteReserveMessage(FMIRemoteRing *ring, FMIRemotePeerAlive *peerAlive, void *context) {
+
+    const uint32_t tail = ring->tail;
+
+    uint32_t head;
+
+    while (tail - (head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE)) >= FMI_REMOTE_RING_SIZE) {
+        if (!waitForChange(&ring->head, head, &ring->producerWaiting, peerAlive, context)) {
+            return NULL;
+        }
+    }
+
+    return &ring->messages[tail % FMI_REMOTE_RING_SIZE];
+}
+
+void FMIRemoteSendMessage(FMIRemoteRing *ring) {
+    __atomic_store_n(&ring->tail, ring->tail + 1, __ATOMIC_SEQ_CST);
+    wake(&ring->tail, &ring->consumerWaiting);
+}
+
+FMIRemoteMessage *FMIRemoteReceiveMessage(FMIRemoteRing *ring, FMIRemotePeerAlive *peerAlive, void *context) {
+
+    const uint32_t head = ring->head;
+
+    if (!waitForChange(&ring->tail, head, &ring->consumerWaiting, peerAlive, context)) {
+        return NULL;
+    }
+
+    return &ring->messages[head % FMI_REMOTE_RING_SIZE];
+}
+
+void FMIRemoteReleaseMessage(FMIRemoteRing *ring) {
+    __atomic_store_n(&ring->head, ring->head + 1, __ATOMIC_SEQ_CST);
+    wake(&ring->head, &ring->producerWaiting);
+}
+
+/***************************************************
+Importer
+****************************************************/
+
+typedef struct {
+
+    FMIInstance *instance;
+
+    FMIRemoteChannel *channel;
+
+    pid_t pid;
+
+    bool terminated;
+
+    // first free byte of the data area
+    size_t top;
+
+    bool overflow;
+
+    fmi3InstanceEnvironment instanceEnvironment;
+    fmi3LogMessageCallback logMessage;
+    fmi3IntermediateUpdateCallback intermediateUpdate;
+
+    // strings and binaries returned by the host
+    char *strings;
+    size_t stringsSize;
+    char *binaries;
+    size_t binariesSize;
+
+} FMIRemote;
+
+static void logError(FMIRemote *remote, const char *format, ...) {
+
+    char message[FMI_MAX_MESSAGE_LENGTH];
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+
+    FMIInstance *instance = remote->instance;
+
+    if (instance->logMessage) {
+        instance->logMessage(instance, FMIFatal, "fatal", message);
+    } else {
+        FMILogError("%s", message);
+    }
+}
+
+static bool hostAlive(void *context) {
+
+    FMIRemote *remote = context;
+
+    if (remote->terminated) {
+        return false;
+    }
+
+    int status;
+
+    if (waitpid(remote->pid, &status, WNOHANG) == 0) {
+        return true;
+    }
+
+    remote->terminated = true;
+
+    if (WIFSIGNALED(status)) {
+        logError(remote, "The host process of %s was terminated by signal %d (%s).", remote->instance->name, WTERMSIG(status), strsignal(WTERMSIG(status)));
+    } else {
+        logError(remote, "The host process of %s exited with status %d.", remote->instance->name, WEXITSTATUS(status));
+    }
+
+    return false;
+}
+
+static uint64_t fromFloat64(fmi3Float64 value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// reserves size bytes in the data area and returns the offset
+static uint64_t allocate(FMIRemote *remote, size_t size) {
+
+    const size_t offset = remote->top;
+
+    size = (size + 7) & ~(size_t)7;
+
+    if (size > FMI_REMOTE_DATA_SIZE - offset) {
+        remote->overflow = true;
+        return FMI_REMOTE_NULL;
+    }
+
+    remote->top += size;
+
+    return offset;
+}
+
+static uint64_t input(FMIRemote *remote, const void *values, size_t size) {
+
+    if (!values) {
+        return FMI_REMOTE_NULL;
+    }
+
+    const uint64_t offset = allocate(remote, size);
+
+    if (offset != FMI_REMOTE_NULL) {
+        memcpy(&remote->channel->data[offset], values, size);
+    }
+
+    return offset;
+}
+
+static uint64_t output(FMIRemote *remote, const void *values, size_t size) {
+    return values ? allocate(remote, size) : FMI_REMOTE_NULL;
+}
+
+static void copyOutput(FMIRemote *remote, void *values, uint64_t offset, size_t size) {
+    if (values && offset != FMI_REMOTE_NULL) {
+        memcpy(values, &remote->channel->data[offset], size);
+    }
+}
+
+static uint64_t inputString(FMIRemote *remote, const char *value) {
+    return input(remote, value, value ? strlen(value) + 1 : 0);
+}
+
+// copies the strings (sizes == NULL) or binaries to the data area and returns the offset of their offsets
+static uint64_t inputValues(FMIRemote *remote, const void *const values[], const size_t sizes[], size_t nValues) {
+
+    if (!values) {
+        return FMI_REMOTE_NULL;
+    }
+
+    const uint64_t offset = allocate(remote, nValues * sizeof(uint64_t));
+
+    for (size_t i = 0; i < nValues && !remote->overflow; i++) {
+
+        const uint64_t value = sizes ? input(remote, values[i], sizes[i]) : inputString(remote, values[i]);
+
+        memcpy(&remote->channel->data[offset + i * sizeof(uint64_t)], &value, sizeof(value));
+    }
+
+    return offset;
+}
+
+// copies the strings (sizes == NULL) or binaries returned by the host to their buffer
+static fmi3Status outputValues(FMIRemote *remote, const void *values[], const size_t sizes[], uint64_t offset, size_t nValues) {
+
+    char **buffer = sizes ? &remote->binaries : &remote->strings;
+    size_t *bufferSize = sizes ? &remote->binariesSize : &remote->stringsSize;
+
+    if (!values || offset == FMI_REMOTE_NULL) {
+        return fmi3OK;
+    }
+
+    const char *data = remote->channel->data;
+
+    const uint64_t *offsets = (const uint64_t*)&data[offset];
+
+    size_t size = 0;
+
+    for (size_t i = 0; i < nValues; i++) {
+        if (offsets[i] != FMI_REMOTE_NULL) {
+            size += sizes ? sizes[i] : strlen(&data[offsets[i]]) + 1;
+        }
+    }
+
+    if (size > *bufferSize) {
+
+        if (FMIRealloc((void**)buffer, size) != FMIOK) {
+            return fmi3Error;
+        }
+
+        *bufferSize = size;
+    }
+
+    char *p = *buffer;
+
+    for (size_t i = 0; i < nValues; i++) {
+
+        if (offsets[i] == FMI_REMOTE_NULL) {
+            values[i] = NULL;
+            continue;
+        }
+
+        const size_t n = sizes ? sizes[i] : strlen(&data[offsets[i]]) + 1;
+
+        memcpy(p, &data[offsets[i]], n);
+
+        values[i] = p;
+
+        p += n;
+    }
+
+    return fmi3OK;
+}
+
+static void intermediateUpdate(FMIRemote *remote, const FMIRemoteMessage *message) {
+
+    fmi3Float64 intermediateUpdateTime;
+
+    memcpy(&intermediateUpdateTime, &message->arguments[0], sizeof(intermediateUpdateTime));
+
+    fmi3Boolean earlyReturnRequested = fmi3False;
+    fmi3Float64 earlyReturnTime = 0;
+
+    if (remote->intermediateUpdate) {
+        remote->intermediateUpdate(remote->instanceEnvironment,
+            intermediateUpdateTime,
+            (fmi3Boolean)message->arguments[1],
+            (fmi3Boolean)message->arguments[2],
+            (fmi3Boolean)message->arguments[3],
+            (fmi3Boolean)message->arguments[4],
+            &earlyReturnRequested,
+            &earlyReturnTime);
+    }
+
+    FMIRemoteMessage *response = FMIRemoteReserveMessage(&remote->channel->requests, hostAlive, remote);
+
+    if (!response) {
+        return;
+    }
+
+    response->type = FMIRemoteReturn;
+    response->status = fmi3OK;
+    response->arguments[0] = earlyReturnRequested;
+    response->arguments[1] = fromFloat64(earlyReturnTime);
+
+    FMIRemoteSendMessage(&remote->channel->requests);
+}
+
+// waits for the result of a call and handles the callbacks of the host
+static fmi3Status receiveReturn(FMIRemote *remote) {
+
+    FMIRemoteRing *responses = &remote->channel->responses;
+
+    for (;;) {
+
+        FMIRemoteMessage *message = FMIRemoteReceiveMessage(responses, hostAlive, remote);
+
+        if (!message) {
+            return fmi3Fatal;
+        }
+
+        if (message->type == FMIRemoteReturn) {
+            const fmi3Status status = (fmi3Status)message->status;
+            FMIRemoteReleaseMessage(responses);
+            return status;
+        }
+
+        if (message->type == FMIRemoteLogMessage) {
+
+            if (remote->logMessage) {
+                const char *category = message->text;
+                const char *text = &message->text[strlen(category) + 1];
+                remote->logMessage(remote->instanceEnvironment, (fmi3Status)message->status, category, text);
+            }
+
+            FMIRemoteReleaseMessage(responses);
+
+        } else if (message->type == FMIRemoteIntermediateUpdate) {
+
+            // release the message before the callback, so it can call the FMU
+            FMIRemoteMessage callback;
+
+            memcpy(&callback, message, offsetof(FMIRemoteMessage, text));
+
+            FMIRemoteReleaseMessage(responses);
+
+            intermediateUpdate(remote, &callback);
+        }
+    }
+}
+
+static fmi3Status call(FMIRemote *remote, FMIRemoteFunction function, size_t nArguments, const uint64_t arguments[]) {
+
+    if (remote->overflow) {
+        remote->overflow = false;
+        logError(remote, "The arguments exceed the data area of %d bytes.", FMI_REMOTE_DATA_SIZE);
+        return fmi3Error;
+    }
+
+    if (remote->terminated) {
+        return fmi3Fatal;
+    }
+
+    FMIRemoteMessage *request = FMIRemoteReserveMessage(&remote->channel->requests, hostAlive, remote);
+
+    if (!request) {
+        return fmi3Fatal;
+    }
+
+    request->type = FMIRemoteCall;
+    request->function = function;
+    request->top = remote->top;
+
+    if (nArguments > 0) {
+        memcpy(request->arguments, arguments, nArguments * sizeof(uint64_t));
+    }
+
+    FMIRemoteSendMessage(&remote->channel->requests);
+
+    return receiveReturn(remote);
+}
+
+/* Inquire version numbers and set debug logging */
+
+static const char* remoteGetVersion(void) {
+    // the host only loads FMI 3.0 platform binaries
+    return "3.0";
+}
+
+static fmi3Status remoteSetDebugLogging(fmi3Instance instance,
+    fmi3Boolean loggingOn,
+    size_t nCategories,
+    const fmi3String categories[]) {
+
+    FMIRemote *remote = instance;
+    const size_t top = remote->top;
+
+    const uint64_t arguments[] = {
+        loggingOn,
+        nCategories,
+        inputValues(remote, (const void* const*)categories, NULL, nCategories)
+    };
+
+    const fmi3Status status = call(remote, FMIRemoteSetDebugLogging, 3, arguments);
+
+    remote->top = top;
+
+    return status;
+}
+
+/* Creation and destruction of FMU instances */
+
+static fmi3Instance remoteInstantiateModelExchange(
+    fmi3String                 instanceName,
+    fmi3String                 instantiationToken,
+    fmi3String                 resourcePath,
+    fmi3Boolean                visible,
+    fmi3Boolean                loggingOn,
+    fmi3InstanceEnvironment    instanceEnvironment,
+    fmi3LogMessageCallback     logMessage) {
+
+    // FMI3InstantiateModelExchange() passes the FMIInstance as instance environment
+    FMIRemote *remote = ((FMIInstance*)instanceEnvironment)->backend;
+    const size_t top = remote->top;
+
+    remote->instanceEnvironment = instanceEnvironment;
+    remote->logMessage = logMessage;
+    remote->intermediateUpdate = NULL;
+
+    const uint64_t arguments[] = {
+        inputString(remote, instanceName),
+        inputString(remote, instantiationToken),
+        inputString(remote, resourcePath),
+        visible,
+        loggingOn
+    };
+
+    const fmi3Status status = call(remote, FMIRemoteInstantiateModelExchange, 5, arguments);
+
+    remote->top = top;
+
+    return status <= fmi3Warning ? remote : NULL;
+}
+
+static fmi3Instance remoteInstantiateCoSimulation(
+    fmi3String                     instanceName,
+    fmi3String                     instantiationToken,
+    fmi3String                     resourcePath,
+    fmi3Boolean                    visible,
+    fmi3Boolean                    loggingOn,
+    fmi3Boolean                    eventModeUsed,
+    fmi3Boolean                    earlyReturnAllowed,
+    const fmi3ValueReference       requiredIntermediateVariables[],
+    size_t                         nRequiredIntermediateVariables,
+    fmi3InstanceEnvironment        instanceEnvironment,
+    fmi3LogMessageCallback         logMessage,
+    fmi3IntermediateUpdateCallback intermediateUpdate) {
+
+    // FMI3InstantiateCoSimulation() passes the FMIInstance as instance environment
+    FMIRemote *remote = ((FMIInstance*)instanceEnvironment)->backend;
+    const size_t top = remote->top;
+
+    remote->instanceEnvironment = instanceEnvironment;
+    remote->logMessage = logMessage;
+    remote->intermediateUpdate = intermediateUpdate;
+
+    const uint64_t arguments[] = {
+        inputString(remote, instanceName),
+        inputString(remote, instantiationToken),
+        inputString(remote, resourcePath),
+        visible,
+        loggingOn,
+        eventModeUsed,
+        earlyReturnAllowed,
+        input(remote, requiredIntermediateVariables, nRequiredIntermediateVariables * sizeof(fmi3ValueReference)),
+        nRequiredIntermediateVariables,
+        intermediateUpdate != NULL
+    };
+
+    const fmi3Status status = call(remote, FMIRemoteInstantiateCoSimulation, 10, arguments);
+
+    remote->top = top;
+
+    return status <= fmi3Warning ? remote : NULL;
+}
+
+static fmi3Instance remoteInstantiateScheduledExecution(
+    fmi3String                     instanceName,
+    fmi3String                     instantiationToken,
+    fmi3String                     resourcePath,
+    fmi3Boolean                    visible,
+    fmi3Boolean                    loggingOn,
+    fmi3InstanceEnvironment        instanceEnvironment,
+    fmi3LogMessageCallback         logMessage,
+    fmi3ClockUpdateCallback        clockUpdate,
+    fmi3LockPreemptionCallback     lockPreemption,
+    fmi3UnlockPreemptionCallback   unlockPreemption) {
+
+    FMIRemote *remote = ((FMIInstance*)instanceEnvironment)->backend;
+
+    // the preemption callbacks can not be called across processes
+    logError(remote, "Scheduled Execution is not supported in a host process.");
+
+    return NULL;
+}
+
+static void remoteFreeInstance(fmi3Instance instance) {
+    call(instance, FMIRemoteFreeInstance, 0, NULL);
+}
+
+/* Enter and exit initialization mode, terminate and reset */
+
+static fmi3Status remoteEnterInitializationMode(fmi3Instance instance,
+    fmi3Boolean toleranceDefined,
+    fmi3Float64 tolerance,
+    fmi3Float64 startTime,
+    fmi3Boolean stopTimeDefined,
+    fmi3Float64 stopTime) {
+
+    const uint64_t arguments[] = {
+        toleranceDefined,
+        fromFloat64(tolerance),
+        fromFloat64(startTime),
+        stopTimeDefined,
+        fromFloat64(stopTime)
+    };
+
+    return call(instance, FMIRemoteEnterInitializationMode, 5, arguments);
+}
+
+#define REMOTE_FUNCTION(f) \
+static fmi3Status remote ## f(fmi3Instance instance) { \
+    return call(instance, FMIRemote ## f, 0, NULL); \
+}
+
+REMOTE_FUNCTION(ExitInitializationMode)
+REMOTE_FUNCTION(EnterEventMode)
+REMOTE_FUNCTION(Terminate)
+REMOTE_FUNCTION(Reset)
+
+/* Getting and setting variable values */
+
+static fmi3Status getValues(FMIRemote *remote, FMIRemoteFunction function,
+    const fmi3ValueReference valueReferences[], size_t nValueReferences, void *values, size_t nValues, size_t size) {
+
+    const size_t top = remote->top;
+
+    const uint64_t arguments[] = {
+        input(remote, valueReferences, nValueReferences * sizeof(fmi3ValueReference)),
+        nValueReferences,
+        output(remote, values, nValues * size),
+        nValues
+    };
+
+    const fmi3Status status = call(remote, function, 4, arguments);
+
+    copyOutput(remote, values, arguments[2], nValues * size);
+
+    remote->top = top;
+
+    return status;
+}
+
+static fmi3Status setValues(FMIRemote *remote, FMIRemoteFunction function,
+    const fmi3ValueReference valueReferences[], size_t nValueReferences, const void *values, size_t nValues, size_t size) {
+
+    const size_t top = remote->top;
+
+    const uint64_t arguments[] = {
+        input(remote, valueReferences, nValueReferences * sizeof(fmi3ValueReference)),
+        nValueReferences,
+        input(remote, values, nValues * size),
+        nValues
+    };
+
+    const fmi3Status status = call(remote, function, 4, arguments);
+
+    remote->top = top;
+
+    return status;
+}
+
+#define REMOTE_GET_SET(t) \
+static fmi3Status remoteGet ## t(fmi3Instance instance, const fmi3ValueReference valueReferences[], size_t nValueReferences, fmi3 ## t values[], size_t nValues) { \
+    return getValues(instance, FMIRemoteGet ## t, valueReferences, nValueReferences, values, nValues, sizeof(fmi3 ## t)); \
+} \
+static fmi3Status remoteSet ## t(fmi3Instance instance, const fmi3ValueReference valueReferences[], size_t nValueReferences, const fmi3 ## t values[], size_t nValues) { \
+    return setValues(instance, FMIRemoteSet ## t, valueReferences, nValueReferences, values, nValues, sizeof(fmi3 ## t)); \
+}
+
+REMOTE_GET_SET(Float32)
+REMOTE_GET_SET(Float64)
+REMOTE_GET_SET(Int8)
+REMOTE_GET_SET(UInt8)
+REMOTE_GET_SET(Int16)
+REMOTE_GET_SET(UInt16)
+REMOTE_GET_SET(Int32)
+REMOTE_GET_SET(UInt32)
+REMOTE_GET_SET(Int64)
+REMOTE_GET_SET(UInt64)
+REMOTE_GET_SET(Boolean)
+
+static fmi3Status remoteGetString(fmi3Instance instance,
+    const fmi3ValueReference valueReferences[],
+    size_t nValueReferences,
+    fmi3String values[],
+    size_t nValues) {
+
+    FMIRemote *remote = instance;
+    const size_t top = remote->top;
+
+    const uint64_t arguments[] = {
+        input(remote, valueReferences, nValueReferences * sizeof(fmi3ValueReference)),
+        nValueReferences,
+        output(remote, values, nValues * sizeof(uint64_t)),
+        nValues
+    };
+
+    fmi3Status status = call(remote, FMIRemoteGetString, 4, arguments);
+
+    if (status <= fmi3Warning) {
+        status = outputValues(remote, (const void**)values, NULL, arguments[2], nValues);
+    }
+
+    remote->top = top;
+
+    return status;
+}
+
+static fmi3Status remoteGetBinary(fmi3Instance instance,
+    const fmi3ValueReference valueReferences[],
+    size_t nValueReferences,
+    size_t valueSizes[],
+    fmi3Binary values[],
+    size_t nValues) {
+
+    FMIRemote *remote = instance;
+    const size_t top = remote->top;
+
+    const uint64_t arguments[] = {
+        input(remote, valueReferences, nValueReferences * sizeof(fmi3ValueReference)),
+        nValueReferences,
+        output(remote, valueSizes, nValues * sizeof(size_t)),
+        output(remote, values, nValues * sizeof(uint64_t)),
+        nValues
+    };
+
+    fmi3Status status = call(remote, FMIRemoteGetBinary, 5, arguments);
+
+    copyOutput(remote, valueSizes, arguments[2], nValues * sizeof(size_t));
+
+    if (status <= fmi3Warning) {
+        status = outputValues(remote, (const void**)values, valueSizes, arguments[3], nValues);
+    }
+
+    remote->top = top;
+
+    return status;
+}
+
+static fmi3Status remoteGetClock(fmi3Instance instance,
+    const fmi3ValueReference valueReferences[],
+    size_t nValueReferences,
+    fmi3Clock values[]) {
+    return getValues(instance, FMIRemoteGetClock, valueReferences, nValueReferences, values, nValueReferences, sizeof(fmi3Clock));
+}
+
+static fmi3Status remoteSetString(fmi3Instance instance,
+    const fmi3ValueReference valueReferences[],
+    size_t nValueReferences,
+    const fmi3String values[],
+    size_t nValues) {
+
+    FMIRemote *remote = instance;
+    const size_t top = remote->top;
+
+    const uint64_t arguments[] = {
+        input(remote, valueReferences, nValueReferences * sizeof(fmi3ValueReference)),
+        nValueReferences,
+        inputValues(remote, (const void* const*)values, NULL, nValues),
+        nValues
+    };
+
+    const fmi3Status status = call(remote, FMIRemoteSetString, 4, arguments);
+
+    remote->top = top;
+
+    return status;
+}
+
+static fmi3Status remoteSetBinary(fmi3Instance instance,
+    const fmi3ValueReference valueReferences[],
+    size_t nValueReferences,
+    const size_t valueSizes[],
+    const fmi3Binary values[],
+    size_t nValues) {
+
+    FMIRemote *remote = instance;
+    const size_t top = remote->top;
+
+    const uint64_t arguments[] = {
+        input(remote, valueReferences, nValueReferences * sizeof(fmi3ValueReference)),
+        nValueReferences,
+        input(remote, valueSizes, nValues * sizeof(size_t)),
+        inputValues(remote, (const void* const*)values, valueSizes, nValues),
+        nValues
+    };
+
+    const fmi3Status status = call(remote, FMIRemoteSetBinary, 5, arguments);
+
+    remote->top = top;
+
+    return status;
+}
+
+static fmi3Status remoteSetClock(fmi3Instance instance,
+    const fmi3ValueReference valueReferences[],
+    size_t nValueReferences,
+    const fmi3Clock values[]) {
+    return setValues(instance, FMIRemoteSetClock, valueReferences, nValueReferences, values, nValueReferences, sizeof(fmi3Clock));
+}
+
+/* Getting Variable Dependency Information */
+
+static fmi3Status remoteGetNumberOfVariableDependencies(fmi3Instance instance,
+    fmi3ValueReference valueReference,
+    size_t* nDependencies) {
+
+    FMIRemote *remote = instance;
+    const size_t top = remote->top;
+
+    const uint64_t arguments[] = {
+        valueReference,
+        output(remote, nDependencies, sizeof(size_t))
+    };
+
+    const fmi3Status status = call(remote, FMIRemoteGetNumberOfVariableDependencies, 2, arguments);
+
+    copyOutput(remote, nDependencies, arguments[1], sizeof(size_t));
+
+    remote->top = top;
+
+    return status;
+}
+
+static fmi3Status remoteGetVariableDependencies(fmi3Instance instance,
+    fmi3ValueReference dependent,
+    size_t elementIndicesOfDependent[],
+    fmi3ValueReference independents[],
+    size_t elementIndicesOfIndependents[],
+    fmi3DependencyKind dependencyKinds[],
+    size_t nDependencies) {
+
+    FMIRemote *remote = instance;
+    const size_t top = remote->top;
+
+    const uint64_t arguments[] = {
+        dependent,
+        output(remote, elementIndicesOfDependent, nDependencies * sizeof(size_t)),
+        output(remote, independents, nDependencies * sizeof(fmi3ValueReference)),
+        output(remote, elementIndicesOfIndependents, nDependencies * sizeof(size_t)),
+        output(remote, dependencyKinds, nDependencies * sizeof(fmi3DependencyKind)),
+        nDependencies
+    };
+
+    const fmi3Status status = call(remote, FMIRemoteGetVariableDependencies, 6, arguments);
+
+    copyOutput(remote, elementIndicesOfDependent, arguments[1], nDependencies * sizeof(size_t));
+    copyOutput(remote, independents, arguments[2], nDependencies * sizeof(fmi3ValueReference));
+    copyOutput(remote, elementIndicesOfIndependents, arguments[3], nDependencies * sizeof(size_t));
+    copyOutput(remote, dependencyKinds, arguments[4], nDependencies * sizeof(fmi3DependencyKind));
+
+    remote->top = top;
+
+    return status;
+}
+
+/* Getting and setting the internal FMU state (the FMU states are handles of the host process) */
+
+static fmi3Status remoteGetFMUState(fmi3Instance instance, fmi3FMUState* FMUState) {
+
+    FMIRemote *remote = instance;
+    const size_t top = remote->top;
+
+    const uint64_t arguments[] = {
+        input(remote, FMUState, sizeof(fmi3FMUState))
+    };
+
+    const fmi3Status status = call(remote, FMIRemoteGetFMUState, 1, arguments);
+
+    copyOutput(remote, FMUState, arguments[0], sizeof(fmi3FMUState));
+
+    remote->top = top;
+
+    return status;
+}
+
+static fmi3Status remoteSetFMUState(fmi3Instance instance, fmi3FMUState FMUState) {
+
+    const uint64_t arguments[] = {
+        (uintptr_t)FMUState
+    };
+
+    return call(instance, FMIRemoteSetFMUState, 1, arguments);
+}
+
+static fmi3Status remoteFreeFMUState(fmi3Instance instance, fmi3FMUState* FMUState) {
+
+    FMIRemote *remote = instance;
+    const size_t top = remote->top;
+
+    const uint64_t arguments[] = {
+        input(remote, FMUState, sizeof(fmi3FMUState))
+    };
+
+    const fmi3Status status = call(remote, FMIRemoteFreeFMUState, 1, arguments);
+
+    copyOutput(remote, FMUState, arguments[0], sizeof(fmi3FMUState));
+
+    remote->top = top;
+
+    return status;
+}
+
+static fmi3Status remoteSerializedFMUStateSize(fmi3Instance instance,
+    fmi3FMUState FMUState,
+    size_t* size) {
+
+    FMIRemote *remote = instance;
+    const size_t top = remote->top;
+
+    const uint64_t arguments[] = {
+        (uintptr_t)FMUState,
+        output(remote, size, sizeof(size_t))
+    };
+
+    const fmi3Status status = call(remote, FMIRemoteSerializedFMUStateSize, 2, arguments);
+
+    copyOutput(remote, size, arguments[1], sizeof(size_t));
+
+    remote->top = top;
+
+    return status;
+}
+
+static fmi3Status remoteSerializeFMUState(fmi3Instance instance,
+    fmi3FMUState FMUState,
+    fmi3Byte serializedState[],
+    size_t size) {
+
+    FMIRemote *remote = instance;
+    const size_t top = remote->top;
+
+    const uint64_t arguments[] = {
+        (uintptr_t)FMUState,
+        output(remote, serializedState, size),
+        size
+    };
+
+    const fmi3Status status = call(remote, FMIRemoteSerializeFMUState, 3, arguments);
+
+    copyOutput(remote, serializedState, arguments[1], size);
+
+    remote->top = top;
+
+    return status;
+}
+
+static fmi3Status remoteDeserializeFMUState(fmi3Instance instance,
+    const fmi3Byte serializedState[],
+    size_t size,
+    fmi3FMUState* FMUState) {
+
+    FMIRemote *remote = instance;
+    const size_t top = remote->top;
+
+    const uint64_t arguments[] = {
+        input(remote, serializedState, size),
+        size,
+        input(remote, FMUState, sizeof(fmi3FMUState))
+    };
+
+    const fmi3Status status = call(remote, FMIRemoteDeserializeFMUState, 3, arguments);
+
+    copyOutput(remote, FMUState, arguments[2], sizeof(fmi3FMUState));
+
+    remote->top = top;
+
+    return status;
+}
+
+/* Getting partial derivatives */
+
+static fmi3Status getDerivative(FMIRemote *remote, FMIRemoteFunction function,
+    const fmi3ValueReference unknowns[],
+    size_t nUnknowns,
+    const fmi3ValueReference knowns[],
+    size_t nKnowns,
+    const fmi3Float64 seed[],
+    size_t nSeed,
+    fmi3Float64 sensitivity[],
+    size_t nSensitivity) {
+
+    const size_t top = remote->top;
+
+    const uint64_t arguments[] = {
+        input(remote, unknowns, nUnknowns * sizeof(fmi3ValueReference)),
+        nUnknowns,
+        input(remote, knowns, nKnowns * sizeof(fmi3ValueReference)),
+        nKnowns,
+        input(remote, seed, nSeed * sizeof(fmi3Float64)),
+        nSeed,
+        output(remote, sensitivity, nSensitivity * sizeof(fmi3Float64)),
+        nSensitivity
+    };
+
+    const fmi3Status status = call(remote, function, 8, arguments);
+
+    copyOutput(remote, sensitivity, arguments[6], nSensitivity * sizeof(fmi3Float64));
+
+    remote->top = top;
+
+    return status;
+}
+
+static fmi3Status remoteGetDirectionalDerivative(fmi3Instance instance,
+    const fmi3ValueReference unknowns[],
+    size_t nUnknowns,
+    const fmi3ValueReference knowns[],
+    size_t nKnowns,
+    const fmi3Float64 seed[],
+    size_t nSeed,
+    fmi3Float64 sensitivity[],
+    size_t nSensitivity) {
+    return getDerivative(instance, FMIRemoteGetDirectionalDerivative, unknowns, nUnknowns, knowns, nKnowns, seed, nSeed, sensitivity, nSensitivity);
+}
+
+static fmi3Status remoteGetAdjointDerivative(fmi3Instance instance,
+    const fmi3ValueReference unknowns[],
+    size_t nUnknowns,
+    const fmi3ValueReference knowns[],
+    size_t nKnowns,
+    const fmi3Float64 seed[],
+    size_t nSeed,
+    fmi3Float64 sensitivity[],
+    size_t nSensitivity) {
+    return getDerivative(instance, FMIRemoteGetAdjointDerivative, unknowns, nUnknowns, knowns, nKnowns, seed, nSeed, sensitivity, nSensitivity);
+}
+
+/* Entering and exiting the Configuration or Reconfiguration Mode */
+
+REMOTE_FUNCTION(EnterConfigurationMode)
+REMOTE_FUNCTION(ExitConfigurationMode)
+
+/* Clock related functions */
+
+static fmi3Status remoteGetIntervalDecimal(fmi3Instance instance,
+    const fmi3ValueReference valueReferences[],
+    size_t nValueReferences,
+    fmi3Float64 intervals[],
+    fmi3IntervalQualifier qualifiers[]) {
+
+    FMIRemote *remote = instance;
+    const size_t top = remote->top;
+
+    const uint64_t arguments[] = {
+        input(remote, valueReferences, nValueReferences * sizeof(fmi3ValueReference)),
+        nValueReferences,
+        output(remote, intervals, nValueReferences * sizeof(fmi3Float64)),
+        output(remote, qualifiers, nValueReferences * sizeof(fmi3IntervalQualifier))
+    };
+
+    const fmi3Status status = call(remote, FMIRemoteGetIntervalDecimal, 4, arguments);
+
+    copyOutput(remote, intervals, arguments[2], nValueReferences * sizeof(fmi3Float64));
+    copyOutput(remote, qualifiers, arguments[3], nValueReferences * sizeof(fmi3IntervalQualifier));
+
+    remote->top = top;
+
+    return status;
+}
+
+static fmi3Status remoteGetIntervalFraction(fmi3Instance instance,
+    const fmi3ValueReference valueReferences[],
+    size_t nValueReferences,
+    fmi3UInt64 counters[],
+    fmi3UInt64 resolutions[],
+    fmi3IntervalQualifier qualifiers[]) {
+
+    FMIRemote *remote = instance;
+    const size_t top = remote->top;
+
+    const uint64_t arguments[] = {
+        input(remote, valueReferences, nValueReferences * sizeof(fmi3ValueReference)),
+        nValueReferences,
+        output(remote, counters, nValueReferences * sizeof(fmi3UInt64)),
+        output(remote, resolutions, nValueReferences * sizeof(fmi3UInt64)),
+        output(remote, qualifiers, nValueReferences * sizeof(fmi3IntervalQualifier))
+    };
+
+    const fmi3Status status = call(remote, FMIRemoteGetIntervalFraction, 5, arguments);
+
+    copyOutput(remote, counters, arguments[2], nValueReferences * sizeof(fmi3UInt64));
+    copyOutput(remote, resolutions, arguments[3], nValueReferences * sizeof(fmi3UInt64));
+    copyOutput(remote, qualifiers, arguments[4], nValueReferences * sizeof(fmi3IntervalQualifier));
+
+    remote->top = top;
+
+    return status;
+}
+
+static fmi3Status remoteGetShiftDecimal(fmi3Instance instance,
+    const fmi3ValueReference valueReferences[],
+    size_t nValueReferences,
+    fmi3Float64 shifts[]) {
+    return getValues(instance, FMIRemoteGetShiftDecimal, valueReferences, nValueReferences, shifts, nValueReferences, sizeof(fmi3Float64));
+}
+
+static fmi3Status remoteGetShiftFraction(fmi3Instance instance,
+    const fmi3ValueReference valueReferences[],
+    size_t nValueReferences,
+    fmi3UInt64 counters[],
+    fmi3UInt64 resolutions[]) {
+
+    FMIRemote *remote = instance;
+    const size_t top = remote->top;
+
+    const uint64_t arguments[] = {
+        input(remote, valueReferences, nValueReferences * sizeof(fmi3ValueReference)),
+        nValueReferences,
+        output(remote, counters, nValueReferences * sizeof(fmi3UInt64)),
+        output(remote, resolutions, nValueReferences * sizeof(fmi3UInt64))
+    };
+
+    const fmi3Status status = call(remote, FMIRemoteGetShiftFraction, 4, arguments);
+
+    copyOutput(remote, counters, arguments[2], nValueReferences * sizeof(fmi3UInt64));
+    copyOutput(remote, resolutions, arguments[3], nValueReferences * sizeof(fmi3UInt64));
+
+    remote->top = top;
+
+    return status;
+}
+
+static fmi3Status remoteSetIntervalDecimal(fmi3Instance instance,
+    const fmi3ValueReference valueReferences[],
+    size_t nValueReferences,
+    const fmi3Float64 intervals[]) {
+    return setValues(instance, FMIRemoteSetIntervalDecimal, valueReferences, nValueReferences, intervals, nValueReferences, sizeof(fmi3Float64));
+}
+
+static fmi3Status remoteSetIntervalFraction(fmi3Instance instance,
+    const fmi3ValueReference valueReferences[],
+    size_t nValueReferences,
+    const fmi3UInt64 counters[],
+    const fmi3UInt64 resolutions[]) {
+
+    FMIRemote *remote = instance;
+    const size_t top = remote->top;
+
+    const uint64_t arguments[] = {
+        input(remote, valueReferences, nValueReferences * sizeof(fmi3ValueReference)),
+        nValueReferences,
+        input(remote, counters, nValueReferences * sizeof(fmi3UInt64)),
+        input(remote, resolutions, nValueReferences * sizeof(fmi3UInt64))
+    };
+
+    const fmi3Status status = call(remote, FMIRemoteSetIntervalFraction, 4, arguments);
+
+    remote->top = top;
+
+    return status;
+}
+
+REMOTE_FUNCTION(EvaluateDiscreteStates)
+
+static fmi3Status remoteUpdateDiscreteStates(fmi3Instance instance,
+    fmi3Boolean* discreteStatesNeedUpdate,
+    fmi3Boolean* terminateSimulation,
+    fmi3Boolean* nominalsOfContinuousStatesChanged,
+    fmi3Boolean* valuesOfContinuousStatesChanged,
+    fmi3Boolean* nextEventTimeDefined,
+    fmi3Float64* nextEventTime) {
+
+    FMIRemote *remote = instance;
+    const size_t top = remote->top;
+
+    const uint64_t arguments[] = {
+        output(remote, discreteStatesNeedUpdate, sizeof(fmi3Boolean)),
+        output(remote, terminateSimulation, sizeof(fmi3Boolean)),
+        output(remote, nominalsOfContinuousStatesChanged, sizeof(fmi3Boolean)),
+        output(remote, valuesOfContinuousStatesChanged, sizeof(fmi3Boolean)),
+        output(remote, nextEventTimeDefined, sizeof(fmi3Boolean)),
+        output(remote, nextEventTime, sizeof(fmi3Float64))
+    };
+
+    const fmi3Status status = call(remote, FMIRemoteUpdateDiscreteStates, 6, arguments);
+
+    copyOutput(remote, discreteStatesNeedUpdate, arguments[0], sizeof(fmi3Boolean));
+    copyOutput(remote, terminateSimulation, arguments[1], sizeof(fmi3Boolean));
+    copyOutput(remote, nominalsOfContinuousStatesChanged, arguments[2], sizeof(fmi3Boolean));
+    copyOutput(remote, valuesOfContinuousStatesChanged, arguments[3], sizeof(fmi3Boolean));
+    copyOutput(remote, nextEventTimeDefined, arguments[4], sizeof(fmi3Boolean));
+    copyOutput(remote, nextEventTime, arguments[5], sizeof(fmi3Float64));
+
+    remote->top = top;
+
+    return status;
+}
+
+/* Functions for Model Exchange */
+
+REMOTE_FUNCTION(EnterContinuousTimeMode)
+
+static fmi3Status remoteCompletedIntegratorStep(fmi3Instance instance,
+    fmi3Boolean  noSetFMUStatePriorToCurrentPoint,
+    fmi3Boolean* enterEventMode,
+    fmi3Boolean* terminateSimulation) {
+
+    FMIRemote *remote = instance;
+    const size_t top = remote->top;
+
+    const uint64_t arguments[] = {
+        noSetFMUStatePriorToCurrentPoint,
+        output(remote, enterEventMode, sizeof(fmi3Boolean)),
+        output(remote, terminateSimulation, sizeof(fmi3Boolean))
+    };
+
+    const fmi3Status status = call(remote, FMIRemoteCompletedIntegratorStep, 3, arguments);
+
+    copyOutput(remote, enterEventMode, arguments[1], sizeof(fmi3Boolean));
+    copyOutput(remote, terminateSimulation, arguments[2], sizeof(fmi3Boolean));
+
+    remote->top = top;
+
+    return status;
+}
+
+static fmi3Status remoteSetTime(fmi3Instance instance, fmi3Float64 time) {
+
+    const uint64_t arguments[] = {
+        fromFloat64(time)
+    };
+
+    return call(instance, FMIRemoteSetTime, 1, arguments);
+}
+
+static fmi3Status remoteSetContinuousStates(fmi3Instance instance,
+    const fmi3Float64 continuousStates[],
+    size_t nContinuousStates) {
+
+    FMIRemote *remote = instance;
+    const size_t top = remote->top;
+
+    const uint64_t arguments[] = {
+        input(remote, continuousStates, nContinuousStates * sizeof(fmi3Float64)),
+        nContinuousStates
+    };
+
+    const fmi3Status status = call(remote, FMIRemoteSetContinuousStates, 2, arguments);
+
+    remote->top = top;
+
+    return status;
+}
+
+static fmi3Status getFloat64Array(FMIRemote *remote, FMIRemoteFunction function, fmi3Float64 values[], size_t nValues) {
+
+    const size_t top = remote->top;
+
+    const uint64_t arguments[] = {
+        output(remote, values, nValues * sizeof(fmi3Float64)),
+        nValues
+    };
+
+    const fmi3Status status = call(remote, function, 2, arguments);
+
+    copyOutput(remote, values, arguments[0], nValues * sizeof(fmi3Float64));
+
+    remote->top = top;
+
+    return status;
+}
+
+static fmi3Status remoteGetContinuousStateDerivatives(fmi3Instance instance, fmi3Float64 derivatives[], size_t nContinuousStates) {
+    return getFloat64Array(instance, FMIRemoteGetContinuousStateDerivatives, derivatives, nContinuousStates);
+}
+
+static fmi3Status remoteGetEventIndicators(fmi3Instance instance, fmi3Float64 eventIndicators[], size_t nEventIndicators) {
+    return getFloat64Array(instance, FMIRemoteGetEventIndicators, eventIndicators, nEventIndicators);
+}
+
+static fmi3Status remoteGetContinuousStates(fmi3Instance instance, fmi3Float64 continuousStates[], size_t nContinuousStates) {
+    return getFloat64Array(instance, FMIRemoteGetContinuousStates, continuousStates, nContinuousStates);
+}
+
+static fmi3Status remoteGetNominalsOfContinuousStates(fmi3Instance instance, fmi3Float64 nominals[], size_t nContinuousStates) {
+    return getFloat64Array(instance, FMIRemoteGetNominalsOfContinuousStates, nominals, nContinuousStates);
+}
+
+static fmi3Status getSize(FMIRemote *remote, FMIRemoteFunction function, size_t *size) {
+
+    const size_t top = remote->top;
+
+    const uint64_t arguments[] = {
+        output(remote, size, sizeof(size_t))
+    };
+
+    const fmi3Status status = call(remote, function, 1, arguments);
+
+    copyOutput(remote, size, arguments[0], sizeof(size_t));
+
+    remote->top = top;
+
+    return status;
+}
+
+static fmi3Status remoteGetNumberOfEventIndicators(fmi3Instance instance, size_t* nEventIndicators) {
+    return getSize(instance, FMIRemoteGetNumberOfEventIndicators, nEventIndicators);
+}
+
+static fmi3Status remoteGetNumberOfContinuousStates(fmi3Instance instance, size_t* nContinuousStates) {
+    return getSize(instance, FMIRemoteGetNumberOfContinuousStates, nContinuousStates);
+}
+
+/* Functions for Co-Simulation */
+
+REMOTE_FUNCTION(EnterStepMode)
+
+static fmi3Status remoteGetOutputDerivatives(fmi3Instance instance,
+    const fmi3ValueReference valueReferences[],
+    size_t nValueReferences,
+    const fmi3Int32 orders[],
+    fmi3Float64 values[],
+    size_t nValues) {
+
+    FMIRemote *remote = instance;
+    const size_t top = remote->top;
+
+    const uint64_t arguments[] = {
+        input(remote, valueReferences, nValueReferences * sizeof(fmi3ValueReference)),
+        nValueReferences,
+        input(remote, orders, nValueReferences * sizeof(fmi3Int32)),
+        output(remote, values, nValues * sizeof(fmi3Float64)),
+        nValues
+    };
+
+    const fmi3Status status = call(remote, FMIRemoteGetOutputDerivatives, 5, arguments);
+
+    copyOutput(remote, values, arguments[3], nValues * sizeof(fmi3Float64));
+
+    remote->top = top;
+
+    return status;
+}
+
+static fmi3Status remoteDoStep(fmi3Instance instance,
+    fmi3Float64 currentCommunicationPoint,
+    fmi3Float64 communicationStepSize,
+    fmi3Boolean noSetFMUStatePriorToCurrentPoint,
+    fmi3Boolean* eventHandlingNeeded,
+    fmi3Boolean* terminateSimulation,
+    fmi3Boolean* earlyReturn,
+    fmi3Float64* lastSuccessfulTime) {
+
+    FMIRemote *remote = instance;
+    const size_t top = remote->top;
+
+    const uint64_t arguments[] = {
+        fromFloat64(currentCommunicationPoint),
+        fromFloat64(communicationStepSize),
+        noSetFMUStatePriorToCurrentPoint,
+        output(remote, eventHandlingNeeded, sizeof(fmi3Boolean)),
+        output(remote, terminateSimulation, sizeof(fmi3Boolean)),
+        output(remote, earlyReturn, sizeof(fmi3Boolean)),
+        output(remote, lastSuccessfulTime, sizeof(fmi3Float64))
+    };
+
+    const fmi3Status status = call(remote, FMIRemoteDoStep, 7, arguments);
+
+    copyOutput(remote, eventHandlingNeeded, arguments[3], sizeof(fmi3Boolean));
+    copyOutput(remote, terminateSimulation, arguments[4], sizeof(fmi3Boolean));
+    copyOutput(remote, earlyReturn, arguments[5], sizeof(fmi3Boolean));
+    copyOutput(remote, lastSuccessfulTime, arguments[6], sizeof(fmi3Float64));
+
+    remote->top = top;
+
+    return status;
+}
+
+/* Functions for Scheduled Execution */
+
+static fmi3Status remoteActivateModelPartition(fmi3Instance instance,
+    fmi3ValueReference clockReference,
+    fmi3Float64 activationTime) {
+
+    logError(instance, "Scheduled Execution is not supported in a host process.");
+
+    return fmi3Error;
+}
+
+#undef REMOTE_FUNCTION
+#undef REMOTE_GET_SET
+
+static FMIFunction getFunction(FMIInstance *instance, const char *name) {
+
+#define REMOTE_FUNCTION(f) { "fmi3" #f, (FMIFunction)remote ## f },
+
+    static const struct {
+        const char *name;
+        FMIFunction function;
+    } functions[] = {
+        FMI_REMOTE_FUNCTIONS(REMOTE_FUNCTION)
+    };
+
+#undef REMOTE_FUNCTION
+
+    for (size_t i = 0; i < sizeof(functions) / sizeof(functions[0]); i++) {
+        if (!strcmp(functions[i].name, name)) {
+            return functions[i].function;
+        }
+    }
+
+    return NULL;
+}
+
+static void freeRemote(FMIInstance *instance) {
+
+    FMIRemote *remote = instance->backend;
+
+    if (!remote) {
+        return;
+    }
+
+    if (!remote->terminated) {
+
+        FMIRemoteMessage *request = FMIRemoteReserveMessage(&remote->channel->requests, hostAlive, remote);
+
+        if (request) {
+            request->type = FMIRemoteCall;
+            request->function = FMIRemoteExit;
+            FMIRemoteSendMessage(&remote->channel->requests);
+        }
+
+        bool exited = false;
+
+        // give the host one second to exit
+        for (int i = 0; i < 100 && !exited; i++) {
+
+            exited = waitpid(remote->pid, NULL, WNOHANG) == remote->pid;
+
+            if (!exited) {
+                const struct timespec interval = { 0, WAIT_TIMEOUT };
+                nanosleep(&interval, NULL);
+            }
+        }
+
+        if (!exited) {
+            kill(remote->pid, SIGKILL);
+            waitpid(remote->pid, NULL, 0);
+        }
+    }
+
+    munmap(remote->channel, sizeof(FMIRemoteChannel));
+
+    FMIFree((void**)&remote->strings);
+    FMIFree((void**)&remote->binaries);
+    FMIFree((void**)&remote);
+
+    instance->backend = NULL;
+    instance->getFunction = NULL;
+}
+
+FMIStatus FMILoadRemotePlatformBinary(FMIInstance *instance, const char *hostPath, const char *libraryPath) {
+
+    FMIRemote *remote = NULL;
+
+    char path[4096] = "";
+
+    if (!hostPath) {
+
+        // fmuhost in the directory of the current executable
+        const ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+
+        char *separator = length > 0 ? memrchr(path, '/', length) : NULL;
+
+        if (!separator || separator - path + sizeof("/fmuhost") > sizeof(path)) {
+            FMILogError("Failed to determine the path of the host executable.");
+            return FMIError;
+        }
+
+        strcpy(separator, "/fmuhost");
+
+        hostPath = path;
+    }
+
+    if (FMICalloc((void**)&remote, 1, sizeof(FMIRemote)) != FMIOK) {
+        return FMIError;
+    }
+
+    remote->instance = instance;
+
+    int fd = memfd_create("FMIRemoteChannel", MFD_CLOEXEC);
+
+    if (fd == -1 || ftruncate(fd, sizeof(FMIRemoteChannel)) != 0) {
+        FMILogError("Failed to create the shared memory. %s", strerror(errno));
+        goto FAIL;
+    }
+
+    remote->channel = mmap(NULL, sizeof(FMIRemoteChannel), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    if (remote->channel == MAP_FAILED) {
+        remote->channel = NULL;
+        FMILogError("Failed to map the shared memory. %s", strerror(errno));
+        goto FAIL;
+    }
+
+    char fdArgument[16];
+
+    snprintf(fdArgument, sizeof(fdArgument), "%d", fd);
+
+    const pid_t parent = getpid();
+
+    remote->pid = fork();
+
+    if (remote->pid == -1) {
+        FMILogError("Failed to start the host process. %s", strerror(errno));
+        goto FAIL;
+    }
+
+    if (remote->pid == 0) {
+
+        // terminate the host with the importer
+        prctl(PR_SET_PDEATHSIG, SIGKILL);
+
+        if (getppid() != parent) {
+            _exit(EXIT_FAILURE);
+        }
+
+        // inherit the shared memory
+        fcntl(fd, F_SETFD, 0);
+
+        execl(hostPath, hostPath, fdArgument, libraryPath, (char*)NULL);
+
+        _exit(127);
+    }
+
+    close(fd);
+
+    fd = -1;
+
+    // the host returns the status of FMILoadPlatformBinary()
+    if (receiveReturn(remote) > fmi3Warning) {
+
+        if (!remote->terminated) {
+            kill(remote->pid, SIGKILL);
+            waitpid(remote->pid, NULL, 0);
+            remote->terminated = true;
+        }
+
+        FMILogError("Failed to load %s in the host process %s.", libraryPath, hostPath);
+        goto FAIL;
+    }
+
+    instance->backend = remote;
+    instance->getFunction = getFunction;
+    instance->freeBackend = freeRemote;
+
+    return FMIOK;
+
+FAIL:
+
+    if (fd != -1) {
+        close(fd);
+    }
+
+    if (remote->channel) {
+        munmap(remote->channel, sizeof(FMIRemoteChannel));
+    }
+
+    FMIFree((void**)&remote);
+
+    return FMIError;
+}
+
+#else
+
+FMIStatus FMILoadRemotePlatformBinary(FMIInstance *instance, const char *hostPath, const char *libraryPath) {
+    FMILogError("Loading platform binaries in a host process is only supported on Linux.");
+    return FMIError;
+}
+
+#endif
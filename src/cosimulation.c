@@ -1,3 +1,7 @@
+#if !defined(_WIN32) && !defined(__APPLE__) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L  // for clock_gettime() with -std=c99
+#endif
+
 #include <stdlib.h>  // for calloc(), free()
 #include <float.h>   // for DBL_EPSILON
 #include <stdio.h>
@@ -6,12 +10,18 @@
 #include "config.h"
 #include "cosimulation.h"
 
-#if FMI_VERSION == 3
-#include "fmi3Functions.h"
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <sched.h>
+#include <time.h>
 #endif
 
-#ifdef _MSC_VER
-#define strdup _strdup
+#if FMI_VERSION == 3
+#include "fmi3Functions.h"
 #endif
 
 #ifdef CALL
@@ -21,8 +31,183 @@
 #define CALL(f) do { const Status status = f; if (status != OK) return status; } while (false)
 
 
+void acquireLock(ModelInstance *comp, int *lock) {
+
+    // a partition with a higher priority must not preempt the thread that holds the lock
+    if (comp->lockPreemption) {
+        comp->lockPreemption();
+    }
+
+    while (ATOMIC_EXCHANGE(lock, 1)) {
+#ifdef _WIN32
+        SwitchToThread();
+#else
+        sched_yield();
+#endif
+    }
+}
+
+void releaseLock(ModelInstance *comp, int *lock) {
+
+    ATOMIC_STORE(lock, 0);
+
+    if (comp->unlockPreemption) {
+        comp->unlockPreemption();
+    }
+}
+
+/* header of the memory blocks. The union aligns the memory after the header for any type. */
+typedef union {
+    struct {
+        size_t sizeClass;  // index of the size class or N_MEMORY_SIZE_CLASSES for blocks that are not pooled
+        size_t capacity;   // usable size in bytes
+    } block;
+    long double alignLongDouble;
+    long long alignLongLong;
+    void *alignPointer;
+} MemoryBlockHeader;
+
+static void *allocateBlock(allocateMemoryType cbAllocateMemory, size_t sizeClass, size_t capacity) {
+
+    MemoryBlockHeader *header;
+
+    if (cbAllocateMemory) {
+        header = (MemoryBlockHeader *)cbAllocateMemory(1, sizeof(MemoryBlockHeader) + capacity);
+    } else {
+        header = (MemoryBlockHeader *)calloc(1, sizeof(MemoryBlockHeader) + capacity);
+    }
+
+    if (!header) {
+        return NULL;
+    }
+
+    header->block.sizeClass = sizeClass;
+    header->block.capacity  = capacity;
+
+    return header + 1;
+}
+
+static void releaseBlock(freeMemoryType cbFreeMemory, void *memory) {
+
+    MemoryBlockHeader *header = (MemoryBlockHeader *)memory - 1;
+
+    if (cbFreeMemory) {
+        cbFreeMemory(header);
+    } else {
+        free(header);
+    }
+}
+
+static size_t getSizeClass(size_t size) {
+
+    size_t sizeClass = 0;
+
+    while (sizeClass < N_MEMORY_SIZE_CLASSES && ((size_t)MIN_MEMORY_BLOCK_SIZE << sizeClass) < size) {
+        sizeClass++;
+    }
+
+    return sizeClass;
+}
+
+void *allocateMemory(ModelInstance *comp, size_t size) {
+
+    const size_t sizeClass = getSizeClass(size);
+
+    if (sizeClass == N_MEMORY_SIZE_CLASSES) {
+        return allocateBlock(comp->cbAllocateMemory, sizeClass, size);
+    }
+
+    acquireLock(comp, &comp->memoryLock);
+
+    void *memory = comp->freeMemoryBlocks[sizeClass];
+
+    if (memory) {
+        // reuse a block from the pool
+        comp->freeMemoryBlocks[sizeClass] = *(void **)memory;
+    }
+
+    releaseLock(comp, &comp->memoryLock);
+
+    if (!memory) {
+        return allocateBlock(comp->cbAllocateMemory, sizeClass, (size_t)MIN_MEMORY_BLOCK_SIZE << sizeClass);
+    }
+
+    memset(memory, 0, size);
+
+    return memory;
+}
+
+Status reallocateMemory(ModelInstance *comp, void **memory, size_t size) {
+
+    if (size == 0) {
+        freeMemory(comp, *memory);
+        *memory = NULL;
+        return OK;
+    }
+
+    size_t capacity = 0;
+
+    if (*memory) {
+
+        capacity = ((MemoryBlockHeader *)*memory - 1)->block.capacity;
+
+        if (size <= capacity) {
+            return OK;
+        }
+    }
+
+    void *temp = allocateMemory(comp, size);
+
+    if (!temp) {
+        logError(comp, "Failed to allocate memory.");
+        return Error;
+    }
+
+    if (*memory) {
+        memcpy(temp, *memory, capacity);
+        freeMemory(comp, *memory);
+    }
+
+    *memory = temp;
+
+    return OK;
+}
+
+void freeMemory(ModelInstance *comp, void *memory) {
+
+    if (!memory) return;
+
+    const size_t sizeClass = ((MemoryBlockHeader *)memory - 1)->block.sizeClass;
+
+    if (sizeClass == N_MEMORY_SIZE_CLASSES) {
+        releaseBlock(comp->cbFreeMemory, memory);
+        return;
+    }
+
+    // return the block to the pool
+    acquireLock(comp, &comp->memoryLock);
+    *(void **)memory = comp->freeMemoryBlocks[sizeClass];
+    comp->freeMemoryBlocks[sizeClass] = memory;
+    releaseLock(comp, &comp->memoryLock);
+}
+
+static char *duplicateString(ModelInstance *comp, const char *string) {
+
+    const size_t size = strlen(string) + 1;
+
+    char *copy = (char *)allocateMemory(comp, size);
+
+    if (copy) {
+        memcpy(copy, string, size);
+    }
+
+    return copy;
+}
+
 ModelInstance *createModelInstance(
     loggerType cbLogger,
+    allocateMemoryType cbAllocateMemory,
+    freeMemoryType cbFreeMemory,
     intermediateUpdateType intermediateUpdate,
     void *componentEnvironment,
     const char *instanceName,
@@ -66,30 +251,37 @@ ModelInstance *createModelInstance(
         return NULL;
     }
 
-    comp = (ModelInstance *)calloc(1, sizeof(ModelInstance));
+    // the instance itself is not pooled
+    comp = (ModelInstance *)allocateBlock(cbAllocateMemory, N_MEMORY_SIZE_CLASSES, sizeof(ModelInstance));
 
     if (comp) {
         comp->componentEnvironment = componentEnvironment;
         comp->logger               = cbLogger;
+        comp->cbAllocateMemory     = cbAllocateMemory;
+        comp->cbFreeMemory         = cbFreeMemory;
         comp->intermediateUpdate   = intermediateUpdate;
         comp->lockPreemption        = NULL;
         comp->unlockPreemption      = NULL;
-        comp->instanceName         = strdup(instanceName);
-        comp->resourceLocation     = resourceLocation ? strdup(resourceLocation) : NULL;
         comp->status               = OK;
         comp->logEvents            = loggingOn;
         comp->logErrors            = true; // always log errors
+        comp->instanceName         = duplicateString(comp, instanceName);
+        comp->resourceLocation     = resourceLocation ? duplicateString(comp, resourceLocation) : NULL;
         comp->nSteps               = 0;
         comp->earlyReturnAllowed   = false;
         comp->eventModeUsed        = false;
     }
 
-    if (!comp || !comp->instanceName) {
+    if (!comp || !comp->instanceName || (resourceLocation && !comp->resourceLocation)) {
         logError(comp, "Out of memory.");
+        freeModelInstance(comp);
         return NULL;
     }
 
     comp->time                              = 0.0;  // overwrite in fmi*SetupExperiment, fmi*SetTime
+    comp->startTicks                        = 0;
+    comp->ticks                             = 0;
+    comp->nextCommunicationTicks            = 0;
     comp->type                              = interfaceType;
 
     comp->state                             = Instantiated;
@@ -101,7 +293,14 @@ ModelInstance *createModelInstance(
     comp->nextEventTimeDefined              = false;
     comp->nextEventTime                     = 0;
 
-    setStartValues(comp);
+#if N_INPUT_CLOCKS > 0
+    resetClockStatistics(comp);
+#endif
+
+    if (setStartValues(comp) > Warning) {
+        freeModelInstance(comp);
+        return NULL;
+    }
 
     comp->isDirtyValues = true;
 
@@ -112,35 +311,80 @@ void freeModelInstance(ModelInstance *comp) {
 
     if (!comp) return;
 
-    if (comp->instanceName) free((void*)comp->instanceName);
+    freeMemory(comp, (void*)comp->instanceName);
 
-    if (comp->resourceLocation) free((void*)comp->resourceLocation);
+    freeMemory(comp, (void*)comp->resourceLocation);
 
-    free(comp);
-}
+#if MAX_CONTINUOUS_STATES > 0
+    freeMemory(comp, comp->x);
+    freeMemory(comp, comp->dx);
+#endif
 
-static Status s_reallocate(ModelInstance* comp, void** memory, size_t size) {
+    freeMemory(comp, comp->arena);
 
-    if (size == 0) {
-        if (*memory) {
-            free(*memory);
+    // return the pooled blocks to the environment
+    for (size_t i = 0; i < N_MEMORY_SIZE_CLASSES; i++) {
+        while (comp->freeMemoryBlocks[i]) {
+            void *memory = comp->freeMemoryBlocks[i];
+            comp->freeMemoryBlocks[i] = *(void **)memory;
+            releaseBlock(comp->cbFreeMemory, memory);
         }
-        *memory = NULL;
+    }
+
+    releaseBlock(comp->cbFreeMemory, comp);
+}
+
+/* grow the memory to at least size bytes while preserving its content. The capacity is at least doubled, so
+   repeated growth costs amortized O(1) per byte, and it is never reduced. */
+static Status reserve(ModelInstance* comp, void** memory, size_t* capacity, size_t size) {
+
+    if (size <= *capacity) {
         return OK;
     }
 
-    void* temp = realloc(*memory, size);
+    size_t newCapacity = 2 * *capacity;
 
-    if (!temp) {
-        logError(comp, "Failed to allocate memory.");
-        return Error;
+    if (newCapacity < size) {
+        newCapacity = size;
     }
 
-    *memory = temp;
+    CALL(reallocateMemory(comp, memory, newCapacity));
+
+    *capacity = newCapacity;
 
     return OK;
 }
 
+Status resizeArena(ModelInstance* comp, size_t size) {
+
+    CALL(reserve(comp, &comp->arena, &comp->arenaCapacity, size));
+
+    comp->arenaSize = size;
+
+    return OK;
+}
+
+#if MAX_CONTINUOUS_STATES > 0
+/* allocate the work arrays of the solver for comp->nx continuous states */
+static Status reserveContinuousStates(ModelInstance* comp) {
+
+    const size_t size = comp->nx * sizeof(double);
+
+    // x and dx have the same capacity
+    size_t capacity = comp->nxCapacity;
+
+    CALL(reserve(comp, (void**)&comp->x, &capacity, size));
+
+    capacity = comp->nxCapacity;
+
+    CALL(reserve(comp, (void**)&comp->dx, &capacity, size));
+
+    comp->nxCapacity = capacity;
+
+    return OK;
+}
+#endif
+
 Status configurate(ModelInstance* comp) {
 
     (void)comp;
@@ -152,6 +396,7 @@ Status configurate(ModelInstance* comp) {
 
 #if MAX_CONTINUOUS_STATES > 0
     comp->nx = getNumberOfContinuousStates(comp);
+    CALL(reserveContinuousStates(comp));
 #endif
 
     return OK;
@@ -162,8 +407,19 @@ Status reset(ModelInstance* comp) {
     comp->state = Instantiated;
     comp->startTime = 0.0;
     comp->time = 0.0;
+    comp->startTicks = 0;
+    comp->ticks = 0;
+    comp->nextCommunicationTicks = 0;
     comp->nSteps = 0;
     comp->status = OK;
+    clearInputDerivatives(comp);
+#if MAX_TIME_EVENTS > 0
+    comp->nTimeEvents = 0;
+    comp->nextEventTimeDefined = false;
+#endif
+#if N_INPUT_CLOCKS > 0
+    resetClockStatistics(comp);
+#endif
     setStartValues(comp);
     comp->isDirtyValues = true;
 
@@ -189,6 +445,21 @@ bool isClose(double a, double b) {
     return fmiAbs(a - b) <= EPSILON * fmiMax(fmiAbs(a), fmiAbs(b));
 }
 
+Ticks timeToTicks(double time) {
+    // round to the nearest tick
+    const double ticks = time * TIME_RESOLUTION;
+    return ticks < 0 ? -(Ticks)(0.5 - ticks) : (Ticks)(ticks + 0.5);
+}
+
+double ticksToTime(Ticks ticks) {
+    return (double)ticks / TIME_RESOLUTION;
+}
+
+bool isNextCommunicationPoint(ModelInstance *comp, double time) {
+    const Ticks difference = timeToTicks(time) - comp->nextCommunicationTicks;
+    return difference >= -1 && difference <= 1;
+}
+
 bool invalidNumber(ModelInstance *comp, const char *f, const char *arg, size_t actual, size_t expected) {
 
     if (actual != expected) {
@@ -285,7 +556,13 @@ static void logMessage(ModelInstance *comp, int status, const char *category, co
     }
 
     va_copy(args1, args);
-    buf = (char *)calloc(len + 1, sizeof(char));
+    buf = (char *)allocateMemory(comp, len + 1);
+
+    if (!buf) {
+        va_end(args1);
+        return;
+    }
+
     len = vsnprintf(buf, len + 1, message, args);
     va_end(args1);
 
@@ -298,7 +575,7 @@ static void logMessage(ModelInstance *comp, int status, const char *category, co
 #endif
     }
 
-    free(buf);
+    freeMemory(comp, buf);
 }
 
 void logEvent(ModelInstance *comp, const char *message, ...) {
@@ -588,12 +865,432 @@ Status activateModelPartition(ModelInstance* comp, ValueReference vr, double act
 }
 #endif
 
+Status setInputDerivative(ModelInstance* comp, ValueReference vr, int order, double value) {
+
+#if MAX_INPUT_DERIVATIVES > 0
+    if (order < 1 || order > 2) {
+        logError(comp, "The input derivative order %d for value reference %u is not supported.", order, vr);
+        return Error;
+    }
+
+    size_t i = 0;
+
+    while (i < comp->nInputDerivatives && comp->inputDerivativeReferences[i] != vr) {
+        i++;
+    }
+
+    if (i == comp->nInputDerivatives) {
+
+        if (i == MAX_INPUT_DERIVATIVES) {
+            logError(comp, "Derivatives can be set for at most %d input variable(s).", MAX_INPUT_DERIVATIVES);
+            return Error;
+        }
+
+        // make sure the input can be set during the step
+        double u;
+        size_t index = 0;
+
+        CALL(getFloat64(comp, vr, &u, 1, &index));
+
+        index = 0;
+
+        CALL(setFloat64(comp, vr, &u, 1, &index));
+
+        comp->inputDerivativeReferences[i] = vr;
+        comp->inputDerivatives[i][0] = 0;
+        comp->inputDerivatives[i][1] = 0;
+        comp->nInputDerivatives++;
+    }
+
+    comp->inputDerivatives[i][order - 1] = value;
+
+    return OK;
+#else
+    UNUSED(vr);
+    UNUSED(order);
+    UNUSED(value);
+    logError(comp, "This model cannot interpolate inputs.");
+    return Error;
+#endif
+}
+
+double getInputDerivative(ModelInstance* comp, ValueReference vr, int order) {
+#if MAX_INPUT_DERIVATIVES > 0
+    for (size_t i = 0; i < comp->nInputDerivatives; i++) {
+        if (comp->inputDerivativeReferences[i] == vr) {
+            return comp->inputDerivatives[i][order - 1];
+        }
+    }
+#else
+    UNUSED(comp);
+    UNUSED(vr);
+    UNUSED(order);
+#endif
+    // inputs without derivatives are constant during the communication step
+    return 0;
+}
+
+void clearInputDerivatives(ModelInstance* comp) {
+#if MAX_INPUT_DERIVATIVES > 0
+    comp->nInputDerivatives = 0;
+#else
+    UNUSED(comp);
+#endif
+}
+
+#if MAX_INPUT_DERIVATIVES > 0
+/* advance the inputs from t0 to t1 along their Taylor polynomials at the current communication point */
+static Status extrapolateInputs(ModelInstance* comp, double t0, double t1) {
+
+    const double tc = comp->nextCommunicationPoint;
+
+    for (size_t i = 0; i < comp->nInputDerivatives; i++) {
+
+        const ValueReference vr = comp->inputDerivativeReferences[i];
+        const double* du = comp->inputDerivatives[i];
+
+        double u;
+        size_t index = 0;
+
+        CALL(getFloat64(comp, vr, &u, 1, &index));
+
+        u += du[0] * (t1 - t0) + 0.5 * du[1] * ((t1 - tc) * (t1 - tc) - (t0 - tc) * (t0 - tc));
+
+        index = 0;
+
+        CALL(setFloat64(comp, vr, &u, 1, &index));
+    }
+
+    return OK;
+}
+#endif
+
+#if MAX_TIME_EVENTS > 0
+static bool isEarlier(const TimeEvent* a, const TimeEvent* b) {
+    return a->ticks < b->ticks || (a->ticks == b->ticks && a->id < b->id);
+}
+
+static void swapTimeEvents(TimeEvent* a, TimeEvent* b) {
+    const TimeEvent t = *a;
+    *a = *b;
+    *b = t;
+}
+
+static void siftUp(TimeEvent events[], size_t i) {
+
+    while (i > 0) {
+
+        const size_t parent = (i - 1) / 2;
+
+        if (!isEarlier(&events[i], &events[parent])) {
+            break;
+        }
+
+        swapTimeEvents(&events[i], &events[parent]);
+        i = parent;
+    }
+}
+
+static void siftDown(TimeEvent events[], size_t n, size_t i) {
+
+    while (true) {
+
+        const size_t left  = 2 * i + 1;
+        const size_t right = left + 1;
+
+        size_t first = i;
+
+        if (left < n && isEarlier(&events[left], &events[first])) {
+            first = left;
+        }
+
+        if (right < n && isEarlier(&events[right], &events[first])) {
+            first = right;
+        }
+
+        if (first == i) {
+            break;
+        }
+
+        swapTimeEvents(&events[i], &events[first]);
+        i = first;
+    }
+}
+
+static void removeTimeEvent(ModelInstance* comp, size_t i) {
+
+    comp->nTimeEvents--;
+
+    // the second condition always holds but tells the compiler that the last event is within the array
+    if (i < comp->nTimeEvents && comp->nTimeEvents < MAX_TIME_EVENTS) {
+        comp->timeEvents[i] = comp->timeEvents[comp->nTimeEvents];
+        siftDown(comp->timeEvents, comp->nTimeEvents, i);
+        siftUp(comp->timeEvents, i);
+    }
+}
+
+/* the earliest scheduled time event is the next event time of the model */
+static void updateNextEventTime(ModelInstance* comp) {
+    comp->nextEventTimeDefined = comp->nTimeEvents > 0;
+    comp->nextEventTime = comp->nextEventTimeDefined ? ticksToTime(comp->timeEvents[0].ticks) : 0;
+}
+#endif
+
+Status scheduleTimeEvent(ModelInstance* comp, int id, double time, double interval) {
+
+#if MAX_TIME_EVENTS > 0
+    if (interval < 0) {
+        logError(comp, "The interval of time event %d must be >= 0 but was %.16g.", id, interval);
+        return Error;
+    }
+
+    // replace an event with the same id
+    CALL(cancelTimeEvent(comp, id));
+
+    if (comp->nTimeEvents == MAX_TIME_EVENTS) {
+        logError(comp, "At most %d time event(s) can be scheduled.", MAX_TIME_EVENTS);
+        return Error;
+    }
+
+    TimeEvent* event = &comp->timeEvents[comp->nTimeEvents];
+
+    event->id       = id;
+    event->ticks    = timeToTicks(time);
+    event->interval = timeToTicks(interval);
+
+    siftUp(comp->timeEvents, comp->nTimeEvents++);
+
+    updateNextEventTime(comp);
+
+    return OK;
+#else
+    UNUSED(id);
+    UNUSED(time);
+    UNUSED(interval);
+    logError(comp, "This model cannot schedule time events.");
+    return Error;
+#endif
+}
+
+Status cancelTimeEvent(ModelInstance* comp, int id) {
+
+#if MAX_TIME_EVENTS > 0
+    for (size_t i = 0; i < comp->nTimeEvents; i++) {
+        if (comp->timeEvents[i].id == id) {
+            removeTimeEvent(comp, i);
+            break;
+        }
+    }
+
+    updateNextEventTime(comp);
+
+    return OK;
+#else
+    UNUSED(id);
+    logError(comp, "This model cannot schedule time events.");
+    return Error;
+#endif
+}
+
+bool popTimeEvent(ModelInstance* comp, int* id) {
+
+#if MAX_TIME_EVENTS > 0
+    if (comp->nTimeEvents == 0) {
+        return false;
+    }
+
+    TimeEvent* event = &comp->timeEvents[0];
+
+    if (event->ticks > comp->ticks) {
+        return false;
+    }
+
+    *id = event->id;
+
+    if (event->interval > 0) {
+        // periodic events are re-scheduled exactly on the integer time base
+        event->ticks += event->interval;
+        siftDown(comp->timeEvents, comp->nTimeEvents, 0);
+    } else {
+        removeTimeEvent(comp, 0);
+    }
+
+    updateNextEventTime(comp);
+
+    return true;
+#else
+    UNUSED(comp);
+    UNUSED(id);
+    return false;
+#endif
+}
+
+#if N_INPUT_CLOCKS > 0
+double wallClockTime(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + 1e-9 * (double)t.tv_nsec;
+#endif
+}
+
+static const ValueReference inputClocks[N_INPUT_CLOCKS] = { INPUT_CLOCKS };
+
+static ClockStatistics* findClockStatistics(ModelInstance* comp, ValueReference vr) {
+
+    for (size_t i = 0; i < N_INPUT_CLOCKS; i++) {
+        if (comp->clockStatistics[i].clockReference == vr) {
+            return &comp->clockStatistics[i];
+        }
+    }
+
+    return NULL;
+}
+
+static size_t executionTimeBin(double executionTime) {
+
+    size_t bin = 0;
+
+    for (double limit = 1e-6; executionTime >= limit && bin < N_EXECUTION_TIME_BINS - 1; limit *= 2) {
+        bin++;
+    }
+
+    return bin;
+}
+
+void resetClockStatistics(ModelInstance* comp) {
+
+    // the entries are created before any partition is activated, so the partitions only update them
+    memset(comp->clockStatistics, 0, sizeof(comp->clockStatistics));
+
+    for (size_t i = 0; i < N_INPUT_CLOCKS; i++) {
+        comp->clockStatistics[i].clockReference = inputClocks[i];
+    }
+
+    comp->firstActivationLock = 0;
+    comp->firstActivationRecorded = false;
+}
+
+void recordClockActivation(ModelInstance* comp, ValueReference vr, double activationTime, double startTime, double endTime) {
+
+    ClockStatistics* statistics = findClockStatistics(comp, vr);
+
+    if (!statistics) {
+        return;
+    }
+
+    acquireLock(comp, &comp->firstActivationLock);
+
+    if (!comp->firstActivationRecorded) {
+        // the first activation relates the activation times to the wall clock
+        comp->firstActivationTime = activationTime;
+        comp->firstActivationWallClockTime = startTime;
+        comp->firstActivationRecorded = true;
+    }
+
+    const double firstActivationTime = comp->firstActivationTime;
+    const double firstActivationWallClockTime = comp->firstActivationWallClockTime;
+
+    releaseLock(comp, &comp->firstActivationLock);
+
+    const double executionTime = endTime - startTime;
+
+    // how much later than its activation time the partition has been activated (if the importer runs in real time)
+    const double latency = (startTime - firstActivationWallClockTime) - (activationTime - firstActivationTime);
+
+    acquireLock(comp, &statistics->lock);
+
+    statistics->nActivations++;
+    statistics->totalExecutionTime += executionTime;
+    statistics->executionTimeHistogram[executionTimeBin(executionTime)]++;
+
+    if (executionTime > statistics->maxExecutionTime) {
+        statistics->maxExecutionTime = executionTime;
+    }
+
+    if (latency > statistics->maxLatency) {
+        statistics->maxLatency = latency;
+    }
+
+    releaseLock(comp, &statistics->lock);
+}
+
+bool getClockStatistics(ModelInstance* comp, ValueReference vr, ClockStatistics* statistics) {
+
+    ClockStatistics* clockStatistics = findClockStatistics(comp, vr);
+
+    if (!clockStatistics) {
+        return false;
+    }
+
+    acquireLock(comp, &clockStatistics->lock);
+    *statistics = *clockStatistics;
+    releaseLock(comp, &clockStatistics->lock);
+
+    return true;
+}
+
+void logClockStatistics(ModelInstance* comp) {
+
+    for (size_t i = 0; i < N_INPUT_CLOCKS; i++) {
+
+        ClockStatistics statistics;
+
+        if (!getClockStatistics(comp, inputClocks[i], &statistics) || statistics.nActivations == 0) {
+            continue;
+        }
+
+        logEvent(comp, "Clock %u: %llu activations, mean execution time = %g s, max execution time = %g s, max latency = %g s.",
+            statistics.clockReference,
+            (unsigned long long)statistics.nActivations,
+            statistics.totalExecutionTime / statistics.nActivations,
+            statistics.maxExecutionTime,
+            statistics.maxLatency);
+    }
+}
+#endif
+
 Status getFMUState(ModelInstance* comp, void** FMUState) {
 
-    CALL(s_reallocate(comp, FMUState, sizeof(ModelInstance)));
+    // the arena is stored after the instance
+    CALL(reallocateMemory(comp, FMUState, sizeof(ModelInstance) + comp->arenaSize));
 
     memcpy(*FMUState, comp, sizeof(ModelInstance));
 
+    if (comp->arenaSize > 0) {
+        memcpy((char*)*FMUState + sizeof(ModelInstance), comp->arena, comp->arenaSize);
+    }
+
+    return OK;
+}
+
+size_t getSerializedFMUStateSize(const void* FMUState) {
+    return sizeof(ModelInstance) + ((const ModelInstance*)FMUState)->arenaSize;
+}
+
+Status deserializeFMUState(ModelInstance* comp, const void* serializedState, size_t size, void** FMUState) {
+
+    size_t arenaSize = 0;
+
+    // the serialized state may not be aligned
+    if (size >= sizeof(ModelInstance)) {
+        memcpy(&arenaSize, (const char*)serializedState + offsetof(ModelInstance, arenaSize), sizeof(size_t));
+    }
+
+    if (size < sizeof(ModelInstance) || size != sizeof(ModelInstance) + arenaSize) {
+        logError(comp, "Invalid size of the serialized FMU state: %zu.", size);
+        return Error;
+    }
+
+    CALL(reallocateMemory(comp, FMUState, size));
+
+    memcpy(*FMUState, serializedState, size);
+
     return OK;
 }
 
@@ -607,6 +1304,8 @@ Status setFMUState(ModelInstance* comp, void* FMUState) {
     comp->startTime = s->startTime;
     comp->stopTime = s->stopTime;
     comp->time = s->time;
+    comp->startTicks = s->startTicks;
+    comp->ticks = s->ticks;
     // instanceName
     // type
     // resourceLocation
@@ -638,11 +1337,18 @@ Status setFMUState(ModelInstance* comp, void* FMUState) {
 
     memcpy(& comp->modelData, & s->modelData, sizeof(ModelData));
 
+    CALL(resizeArena(comp, s->arenaSize));
+
+    if (s->arenaSize > 0) {
+        memcpy(comp->arena, (const char*)FMUState + sizeof(ModelInstance), s->arenaSize);
+    }
+
     comp->nSteps = s->nSteps;
 
     comp->earlyReturnAllowed = s->earlyReturnAllowed;
     comp->eventModeUsed = s->eventModeUsed;
     comp->nextCommunicationPoint = s->nextCommunicationPoint;
+    comp->nextCommunicationTicks = s->nextCommunicationTicks;
 
 #if MAX_EVENT_INDICATORS > 0
     comp->nz = s->nz;
@@ -651,9 +1357,20 @@ Status setFMUState(ModelInstance* comp, void* FMUState) {
 #endif
 
 #if MAX_CONTINUOUS_STATES > 0
+    // the work arrays of the solver are not part of the state
     comp->nx = s->nx;
-    memcpy(comp->x, s->x, s->nx * sizeof(double));
-    memcpy(comp->dx, s->dx, s->nx * sizeof(double));
+    CALL(reserveContinuousStates(comp));
+#endif
+
+#if MAX_TIME_EVENTS > 0
+    comp->nTimeEvents = s->nTimeEvents;
+    memcpy(comp->timeEvents, s->timeEvents, s->nTimeEvents * sizeof(TimeEvent));
+#endif
+
+#if MAX_INPUT_DERIVATIVES > 0
+    comp->nInputDerivatives = s->nInputDerivatives;
+    memcpy(comp->inputDerivativeReferences, s->inputDerivativeReferences, s->nInputDerivatives * sizeof(ValueReference));
+    memcpy(comp->inputDerivatives, s->inputDerivatives, s->nInputDerivatives * sizeof(comp->inputDerivatives[0]));
 #endif
 
     comp->nSteps = s->nSteps;
@@ -661,26 +1378,76 @@ Status setFMUState(ModelInstance* comp, void* FMUState) {
     return OK;
 }
 
+/* the next point of the fixed step grid */
+static Ticks nextGridTicks(ModelInstance* comp) {
+    return comp->startTicks + (Ticks)(comp->nSteps + 1) * timeToTicks(FIXED_SOLVER_STEP);
+}
+
+/* whether the next time event comes before the next point of the fixed step grid */
+static bool isStepToEvent(ModelInstance* comp, Ticks nextGridTicks) {
+#if MAX_TIME_EVENTS > 0
+    return comp->nTimeEvents > 0 && comp->timeEvents[0].ticks > comp->ticks && comp->timeEvents[0].ticks < nextGridTicks;
+#else
+    UNUSED(comp);
+    UNUSED(nextGridTicks);
+    return false;
+#endif
+}
+
+/* the next point of the fixed step grid or the next time event if it comes before */
+Ticks getNextSolverStepTicks(ModelInstance *comp) {
+
+    const Ticks gridTicks = nextGridTicks(comp);
+
+#if MAX_TIME_EVENTS > 0
+    return isStepToEvent(comp, gridTicks) ? comp->timeEvents[0].ticks : gridTicks;
+#else
+    return gridTicks;
+#endif
+}
+
 Status doFixedStep(ModelInstance *comp, bool* stateEvent, bool* timeEvent) {
 
+    const Ticks gridTicks = nextGridTicks(comp);
+
+    // shorten the step to end exactly at the next time event
+    const bool stepToEvent = isStepToEvent(comp, gridTicks);
+
+    const Ticks nextTicks = getNextSolverStepTicks(comp);
+    const double nextTime = ticksToTime(nextTicks);
+
 #if MAX_CONTINUOUS_STATES > 0
     if (comp->nx > 0) {
 
+        const double h = ticksToTime(nextTicks - comp->ticks);
+
         CALL(getContinuousStates(comp, comp->x, comp->nx));
         CALL(getDerivatives(comp, comp->dx, comp->nx));
 
         // forward Euler step
         for (size_t i = 0; i < comp->nx; i++) {
-            comp->x[i] += FIXED_SOLVER_STEP * comp->dx[i];
+            comp->x[i] += h * comp->dx[i];
         }
 
         CALL(setContinuousStates(comp, comp->x, comp->nx));
     }
 #endif
 
-    comp->nSteps++;
+#if MAX_INPUT_DERIVATIVES > 0
+    const double previousTime = comp->time;
+#endif
+
+    // steps to time events do not advance the fixed step grid
+    if (!stepToEvent) {
+        comp->nSteps++;
+    }
+
+    comp->ticks = nextTicks;
+    comp->time = nextTime;
 
-    comp->time = comp->startTime + comp->nSteps * FIXED_SOLVER_STEP;
+#if MAX_INPUT_DERIVATIVES > 0
+    CALL(extrapolateInputs(comp, previousTime, comp->time));
+#endif
 
     // state event
     *stateEvent = false;
@@ -703,7 +1470,11 @@ Status doFixedStep(ModelInstance *comp, bool* stateEvent, bool* timeEvent) {
 #endif
 
     // time event
-    *timeEvent = comp->nextEventTimeDefined && comp->time >= comp->nextEventTime;
+#if MAX_TIME_EVENTS > 0
+    *timeEvent = comp->nTimeEvents > 0 && comp->timeEvents[0].ticks <= comp->ticks;
+#else
+    *timeEvent = false;
+#endif
 
     bool earlyReturnRequested;
     double earlyReturnTime;
@@ -8,6 +8,15 @@
 #include <assert.h>
 #include <math.h>
 
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
 #include "config.h"
 #include "model.h"
 #include "cosimulation.h"
@@ -165,10 +174,12 @@ do { \
 #define MASK_fmi2GetBooleanStatus        MASK_fmi2GetStatus
 #define MASK_fmi2GetStringStatus         MASK_fmi2GetStatus
 
+// functions that are not allowed during an asynchronous step first check whether it has finished
 #define BEGIN_FUNCTION(F) \
 Status status = OK; \
 if (!c) return fmi2Error; \
 ModelInstance *S = (ModelInstance *)c; \
+if (S->state == StepInProgress && !(MASK_fmi2##F & StepInProgress)) updateAsynchronousStep(S); \
 if (!allowedState(S, MASK_fmi2##F, #F)) CALL(Error);
 
 #define END_FUNCTION() \
@@ -206,6 +217,311 @@ static bool allowedState(ModelInstance *instance, int statesExpected, char *name
 
 }
 
+// ---------------------------------------------------------------------------
+// Asynchronous Co-Simulation steps
+// ---------------------------------------------------------------------------
+
+#ifdef _WIN32
+typedef HANDLE Thread;
+typedef CRITICAL_SECTION Mutex;
+typedef CONDITION_VARIABLE Condition;
+#else
+typedef pthread_t Thread;
+typedef pthread_mutex_t Mutex;
+typedef pthread_cond_t Condition;
+#endif
+
+/* If the environment provides the stepFinished callback, fmi2DoStep() hands the step to a worker thread of the
+   instance and returns fmi2Pending. The worker thread does not change the state of the instance. The calling
+   thread changes it in updateAsynchronousStep() when it calls a function after the step has finished. */
+typedef struct {
+    ModelInstance *instance;
+    Thread thread;
+    Mutex mutex;
+    Condition condition;
+    bool running;          // the step is in progress
+    bool cancelRequested;  // fmi2CancelStep() has been called
+    bool terminate;        // stop the worker thread
+    double nextCommunicationPoint;
+    Ticks nextCommunicationTicks;
+    double lastSuccessfulTime;
+    Status status;         // status of the last step
+} AsynchronousStep;
+
+static void lockMutex(Mutex *mutex) {
+#ifdef _WIN32
+    EnterCriticalSection(mutex);
+#else
+    pthread_mutex_lock(mutex);
+#endif
+}
+
+static void unlockMutex(Mutex *mutex) {
+#ifdef _WIN32
+    LeaveCriticalSection(mutex);
+#else
+    pthread_mutex_unlock(mutex);
+#endif
+}
+
+static void waitCondition(Condition *condition, Mutex *mutex) {
+#ifdef _WIN32
+    SleepConditionVariableCS(condition, mutex, INFINITE);
+#else
+    pthread_cond_wait(condition, mutex);
+#endif
+}
+
+static void broadcastCondition(Condition *condition) {
+#ifdef _WIN32
+    WakeAllConditionVariable(condition);
+#else
+    pthread_cond_broadcast(condition);
+#endif
+}
+
+/* run the solver until the next communication point. If step is not NULL, the step is run asynchronously and
+   the progress is reported to the calling thread. */
+static Status doStep(ModelInstance *S, double nextCommunicationPoint, Ticks nextCommunicationTicks, AsynchronousStep *step) {
+
+    Status status = OK;
+
+    while (true) {
+
+        if (getNextSolverStepTicks(S) > nextCommunicationTicks) {
+            break;  // next communcation point reached
+        }
+
+        bool stateEvent, timeEvent;
+
+        const Status stepStatus = doFixedStep(S, &stateEvent, &timeEvent);
+
+        if (stepStatus > status) {
+            status = stepStatus;
+        }
+
+#ifdef EVENT_UPDATE
+        if (status <= Warning && (stateEvent || timeEvent)) {
+
+            const Status eventStatus = eventUpdate(S);
+
+            if (eventStatus > status) {
+                status = eventStatus;
+            }
+        }
+#endif
+
+        if (status > Warning) {
+            return status;
+        }
+
+        if (S->terminateSimulation) {
+            return Discard;
+        }
+
+        if (step) {
+
+            lockMutex(&step->mutex);
+
+            step->lastSuccessfulTime = S->time;
+
+            const bool cancelRequested = step->cancelRequested;
+
+            unlockMutex(&step->mutex);
+
+            if (cancelRequested) {
+                return Discard;
+            }
+        }
+    }
+
+    S->nextCommunicationPoint = nextCommunicationPoint;
+    S->nextCommunicationTicks = nextCommunicationTicks;
+
+    // the input derivatives are only valid for the current step
+    clearInputDerivatives(S);
+
+    return status;
+}
+
+#ifdef _WIN32
+static DWORD WINAPI runAsynchronousSteps(LPVOID arg) {
+#else
+static void *runAsynchronousSteps(void *arg) {
+#endif
+
+    AsynchronousStep *step = (AsynchronousStep *)arg;
+    ModelInstance *S = step->instance;
+
+    lockMutex(&step->mutex);
+
+    while (true) {
+
+        while (!step->running && !step->terminate) {
+            waitCondition(&step->condition, &step->mutex);
+        }
+
+        if (step->terminate) {
+            break;
+        }
+
+        unlockMutex(&step->mutex);
+
+        const Status status = doStep(S, step->nextCommunicationPoint, step->nextCommunicationTicks, step);
+
+        lockMutex(&step->mutex);
+
+        step->status = status;
+        step->running = false;
+
+        broadcastCondition(&step->condition);
+
+        unlockMutex(&step->mutex);
+
+        S->stepFinished(S->componentEnvironment, status);
+
+        lockMutex(&step->mutex);
+    }
+
+    unlockMutex(&step->mutex);
+
+    return 0;
+}
+
+static Status startAsynchronousStep(ModelInstance *S, double nextCommunicationPoint, Ticks nextCommunicationTicks) {
+
+    AsynchronousStep *step = (AsynchronousStep *)S->asynchronousStep;
+
+    if (!step) {
+
+        // start the worker thread with the first asynchronous step
+        step = (AsynchronousStep *)allocateMemory(S, sizeof(AsynchronousStep));
+
+        if (!step) {
+            logError(S, "Failed to allocate memory.");
+            return Error;
+        }
+
+        step->instance = S;
+
+#ifdef _WIN32
+        InitializeCriticalSection(&step->mutex);
+        InitializeConditionVariable(&step->condition);
+        step->thread = CreateThread(NULL, 0, runAsynchronousSteps, step, 0, NULL);
+        const bool threadCreated = step->thread != NULL;
+#else
+        pthread_mutex_init(&step->mutex, NULL);
+        pthread_cond_init(&step->condition, NULL);
+        const bool threadCreated = pthread_create(&step->thread, NULL, runAsynchronousSteps, step) == 0;
+#endif
+
+        if (!threadCreated) {
+            logError(S, "Failed to create the thread for the asynchronous step.");
+#ifdef _WIN32
+            DeleteCriticalSection(&step->mutex);
+#else
+            pthread_mutex_destroy(&step->mutex);
+            pthread_cond_destroy(&step->condition);
+#endif
+            freeMemory(S, step);
+            return Error;
+        }
+
+        S->asynchronousStep = step;
+    }
+
+    lockMutex(&step->mutex);
+
+    step->running                = true;
+    step->cancelRequested        = false;
+    step->nextCommunicationPoint = nextCommunicationPoint;
+    step->nextCommunicationTicks = nextCommunicationTicks;
+    step->lastSuccessfulTime     = S->time;
+    step->status                 = Pending;
+
+    broadcastCondition(&step->condition);
+
+    unlockMutex(&step->mutex);
+
+    return OK;
+}
+
+/* change the state of the instance if the asynchronous step has finished */
+static void updateAsynchronousStep(ModelInstance *S) {
+
+    AsynchronousStep *step = (AsynchronousStep *)S->asynchronousStep;
+
+    lockMutex(&step->mutex);
+
+    const bool running = step->running;
+    const bool cancelRequested = step->cancelRequested;
+    const Status status = step->status;
+
+    unlockMutex(&step->mutex);
+
+    if (running) {
+        return;
+    }
+
+    if (cancelRequested) {
+        S->state = StepCanceled;
+    } else if (status == Error) {
+        S->state = Terminated;
+    } else if (status == Fatal) {
+        S->state = StartAndEnd;
+    } else {
+        S->state = StepComplete;
+    }
+}
+
+/* cancel the asynchronous step and wait until the worker thread has stopped it */
+static void cancelAsynchronousStep(ModelInstance *S) {
+
+    AsynchronousStep *step = (AsynchronousStep *)S->asynchronousStep;
+
+    lockMutex(&step->mutex);
+
+    step->cancelRequested = true;
+
+    while (step->running) {
+        waitCondition(&step->condition, &step->mutex);
+    }
+
+    unlockMutex(&step->mutex);
+}
+
+static void freeAsynchronousStep(ModelInstance *S) {
+
+    AsynchronousStep *step = (AsynchronousStep *)S->asynchronousStep;
+
+    if (!step) {
+        return;
+    }
+
+    lockMutex(&step->mutex);
+
+    step->cancelRequested = true;
+    step->terminate = true;
+
+    broadcastCondition(&step->condition);
+
+    unlockMutex(&step->mutex);
+
+#ifdef _WIN32
+    WaitForSingleObject(step->thread, INFINITE);
+    CloseHandle(step->thread);
+    DeleteCriticalSection(&step->mutex);
+#else
+    pthread_join(step->thread, NULL);
+    pthread_mutex_destroy(&step->mutex);
+    pthread_cond_destroy(&step->condition);
+#endif
+
+    freeMemory(S, step);
+
+    S->asynchronousStep = NULL;
+}
+
 // ---------------------------------------------------------------------------
 // FMI functions
 // ---------------------------------------------------------------------------
@@ -220,8 +536,10 @@ fmi2Component fmi2Instantiate(fmi2String instanceName, fmi2Type fmuType, fmi2Str
         return NULL;
     }
 
-    return createModelInstance(
+    ModelInstance *instance = createModelInstance(
         (loggerType)functions->logger,
+        (allocateMemoryType)functions->allocateMemory,
+        (freeMemoryType)functions->freeMemory,
         NULL,
         functions->componentEnvironment,
         instanceName,
@@ -229,6 +547,13 @@ fmi2Component fmi2Instantiate(fmi2String instanceName, fmi2Type fmuType, fmi2Str
         fmuResourceLocation,
         loggingOn,
         (InterfaceType)fmuType);
+
+    if (instance) {
+        // run fmi2DoStep() asynchronously
+        instance->stepFinished = (stepFinishedType)functions->stepFinished;
+    }
+
+    return instance;
 }
 
 fmi2Status fmi2SetupExperiment(fmi2Component c, fmi2Boolean toleranceDefined, fmi2Real tolerance,
@@ -242,7 +567,10 @@ fmi2Status fmi2SetupExperiment(fmi2Component c, fmi2Boolean toleranceDefined, fm
     S->startTime = startTime;
     S->stopTime = stopTimeDefined ? stopTime : INFINITY;
     S->time = startTime;
+    S->startTicks = timeToTicks(startTime);
+    S->ticks = S->startTicks;
     S->nextCommunicationPoint = startTime;
+    S->nextCommunicationTicks = S->startTicks;
 
     END_FUNCTION();
 }
@@ -289,7 +617,14 @@ fmi2Status fmi2Reset(fmi2Component c) {
 }
 
 void fmi2FreeInstance(fmi2Component c) {
-    freeModelInstance((ModelInstance*)c);
+
+    ModelInstance *S = (ModelInstance *)c;
+
+    if (!S) return;
+
+    freeAsynchronousStep(S);
+
+    freeModelInstance(S);
 }
 
 // ---------------------------------------------------------------------------
@@ -379,16 +714,17 @@ fmi2Status fmi2SetFMUstate(fmi2Component c, fmi2FMUstate FMUstate) {
 
 fmi2Status fmi2FreeFMUstate(fmi2Component c, fmi2FMUstate* FMUstate) {
     BEGIN_FUNCTION(FreeFMUstate);
-    free(*FMUstate);
+    freeMemory(S, *FMUstate);
     *FMUstate = NULL;
     END_FUNCTION();
 }
 
 fmi2Status fmi2SerializedFMUstateSize(fmi2Component c, fmi2FMUstate FMUstate, size_t *size) {
-    UNUSED(c);
-    UNUSED(FMUstate);
     BEGIN_FUNCTION(SerializedFMUstateSize);
-    *size = sizeof(ModelInstance);
+    if (nullPointer(S, "fmi2SerializedFMUstateSize", "FMUstate", FMUstate)) {
+        return fmi2Error;
+    }
+    *size = getSerializedFMUStateSize(FMUstate);
     END_FUNCTION();
 }
 
@@ -399,11 +735,11 @@ fmi2Status fmi2SerializeFMUstate(fmi2Component c, fmi2FMUstate FMUstate, fmi2Byt
         return fmi2Error;
     }
 
-    if (invalidNumber(S, "fmi2SerializeFMUstate", "size", size, sizeof(ModelInstance))) {
+    if (invalidNumber(S, "fmi2SerializeFMUstate", "size", size, getSerializedFMUStateSize(FMUstate))) {
         return fmi2Error;
     }
 
-    memcpy(serializedState, FMUstate, sizeof(ModelInstance));
+    memcpy(serializedState, FMUstate, size);
 
     END_FUNCTION();
 }
@@ -411,15 +747,7 @@ fmi2Status fmi2SerializeFMUstate(fmi2Component c, fmi2FMUstate FMUstate, fmi2Byt
 fmi2Status fmi2DeSerializeFMUstate (fmi2Component c, const fmi2Byte serializedState[], size_t size, fmi2FMUstate* FMUstate) {
     BEGIN_FUNCTION(DeSerializeFMUstate);
 
-    if (invalidNumber(S, "fmi2DeSerializeFMUstate", "size", size, sizeof(ModelInstance))) {
-        return fmi2Error;
-    }
-
-    if (*FMUstate == NULL) {
-        *FMUstate = calloc(1, sizeof(ModelInstance));
-    }
-
-    memcpy(*FMUstate, serializedState, sizeof(ModelInstance));
+    CALL(deserializeFMUState(S, serializedState, size, FMUstate));
 
     END_FUNCTION();
 }
@@ -451,16 +779,11 @@ fmi2Status fmi2GetDirectionalDerivative(fmi2Component c, const fmi2ValueReferenc
 /* Simulating the slave */
 fmi2Status fmi2SetRealInputDerivatives(fmi2Component c, const fmi2ValueReference vr[], size_t nvr,
                                      const fmi2Integer order[], const fmi2Real value[]) {
-    UNUSED(vr);
-    UNUSED(nvr);
-    UNUSED(order);
-    UNUSED(value);
-
     BEGIN_FUNCTION(SetRealInputDerivatives);
 
-    logError(S, "fmi2SetRealInputDerivatives: ignoring function call."
-            " This model cannot interpolate inputs: canInterpolateInputs=\"fmi2False\"");
-    CALL(Error);
+    for (size_t i = 0; i < nvr; i++) {
+        CALL(setInputDerivative(S, vr[i], order[i], value[i]));
+    }
 
     END_FUNCTION();
 }
@@ -490,9 +813,9 @@ fmi2Status fmi2GetRealOutputDerivatives(fmi2Component c, const fmi2ValueReferenc
 fmi2Status fmi2CancelStep(fmi2Component c) {
     BEGIN_FUNCTION(CancelStep);
 
-    logError(S, "fmi2CancelStep: Can be called when fmi2DoStep returned fmi2Pending."
-        " This is not the case.");
-    CALL(Error);
+    cancelAsynchronousStep(S);
+
+    S->state = StepCanceled;
 
     END_FUNCTION();
 }
@@ -503,7 +826,7 @@ fmi2Status fmi2DoStep(fmi2Component c, fmi2Real currentCommunicationPoint,
 
     BEGIN_FUNCTION(DoStep);
 
-    if (!isClose(currentCommunicationPoint, S->nextCommunicationPoint)) {
+    if (!isNextCommunicationPoint(S, currentCommunicationPoint)) {
         logError(S, "Expected currentCommunicationPoint = %.16g but was %.16g.",
             S->nextCommunicationPoint, currentCommunicationPoint);
         S->state = Terminated;
@@ -516,6 +839,7 @@ fmi2Status fmi2DoStep(fmi2Component c, fmi2Real currentCommunicationPoint,
     }
 
     const fmi2Real nextCommunicationPoint = currentCommunicationPoint + communicationStepSize;
+    const Ticks nextCommunicationTicks = timeToTicks(currentCommunicationPoint + communicationStepSize);
 
     if (nextCommunicationPoint > S->stopTime && !isClose(nextCommunicationPoint, S->stopTime)) {
         logError(S, "At communication point %.16g a step size of %.16g was requested but stop time is %.16g.",
@@ -523,31 +847,17 @@ fmi2Status fmi2DoStep(fmi2Component c, fmi2Real currentCommunicationPoint,
         CALL(Error);
     }
 
-    while (true) {
-
-        const double nextSolverStepTime = S->time + FIXED_SOLVER_STEP;
-
-        if (nextSolverStepTime > nextCommunicationPoint && !isClose(nextSolverStepTime, nextCommunicationPoint)) {
-            break;  // next communcation point reached
-        }
-
-        bool stateEvent, timeEvent;
+    if (S->stepFinished) {
 
-        CALL(doFixedStep(S, &stateEvent, &timeEvent));
+        CALL(startAsynchronousStep(S, nextCommunicationPoint, nextCommunicationTicks));
 
-#ifdef EVENT_UPDATE
-        if (stateEvent || timeEvent) {
-            CALL(eventUpdate(S));
-        }
-#endif
+        S->state = StepInProgress;
+        status = Pending;
 
-        if (S->terminateSimulation) {
-            status = Discard;
-            goto TERMINATE;
-        }
+        goto TERMINATE;
     }
 
-    S->nextCommunicationPoint = nextCommunicationPoint;
+    CALL(doStep(S, nextCommunicationPoint, nextCommunicationTicks, NULL));
 
     END_FUNCTION();
 }
@@ -578,8 +888,24 @@ static Status getStatus(char* fname, ModelInstance* S, const fmi2StatusKind s) {
 }
 
 fmi2Status fmi2GetStatus(fmi2Component c, const fmi2StatusKind s, fmi2Status *value) {
-    UNUSED(value);
     BEGIN_FUNCTION(GetStatus);
+
+    if (s == fmi2DoStepStatus && S->asynchronousStep) {
+
+        AsynchronousStep *step = (AsynchronousStep *)S->asynchronousStep;
+
+        if (S->state == StepInProgress) {
+            updateAsynchronousStep(S);
+        }
+
+        // fmi2Pending until the step has finished
+        lockMutex(&step->mutex);
+        *value = (fmi2Status)step->status;
+        unlockMutex(&step->mutex);
+
+        goto TERMINATE;
+    }
+
     CALL(getStatus("fmi2GetStatus", S, s));
     END_FUNCTION();
 }
@@ -587,6 +913,18 @@ fmi2Status fmi2GetStatus(fmi2Component c, const fmi2StatusKind s, fmi2Status *va
 fmi2Status fmi2GetRealStatus(fmi2Component c, const fmi2StatusKind s, fmi2Real *value) {
     BEGIN_FUNCTION(GetRealStatus);
 
+    if (s == fmi2LastSuccessfulTime && S->state == StepInProgress) {
+
+        AsynchronousStep *step = (AsynchronousStep *)S->asynchronousStep;
+
+        // the time of the last solver step of the asynchronous step
+        lockMutex(&step->mutex);
+        *value = step->lastSuccessfulTime;
+        unlockMutex(&step->mutex);
+
+        goto TERMINATE;
+    }
+
     if (s == fmi2LastSuccessfulTime) {
         *value = S->time;
         goto TERMINATE;
@@ -610,7 +948,7 @@ fmi2Status fmi2GetIntegerStatus(fmi2Component c, const fmi2StatusKind s, fmi2Int
 fmi2Status fmi2GetBooleanStatus(fmi2Component c, const fmi2StatusKind s, fmi2Boolean *value) {
     BEGIN_FUNCTION(GetBooleanStatus);
 
-    if (s == fmi2Terminated) {
+    if (s == fmi2Terminated && S->state != StepInProgress) {
         *value = S->terminateSimulation;
         goto TERMINATE;
     }
@@ -621,10 +959,18 @@ fmi2Status fmi2GetBooleanStatus(fmi2Component c, const fmi2StatusKind s, fmi2Boo
 }
 
 fmi2Status fmi2GetStringStatus(fmi2Component c, const fmi2StatusKind s, fmi2String *value) {
-    UNUSED(value);
 
     BEGIN_FUNCTION(GetStringStatus);
 
+    if (s == fmi2PendingStatus && S->state == StepInProgress) {
+
+        updateAsynchronousStep(S);
+
+        *value = S->state == StepInProgress ? "fmi2DoStep is in progress." : "fmi2DoStep has finished.";
+
+        goto TERMINATE;
+    }
+
     CALL(getStatus("fmi2GetStringStatus", c, s));
 
     END_FUNCTION();
@@ -689,6 +1035,7 @@ fmi2Status fmi2CompletedIntegratorStep(fmi2Component c, fmi2Boolean noSetFMUStat
 fmi2Status fmi2SetTime(fmi2Component c, fmi2Real time) {
     BEGIN_FUNCTION(SetTime);
     S->time = time;
+    S->ticks = timeToTicks(time);
     END_FUNCTION();
 }
 
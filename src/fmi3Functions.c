@@ -20,6 +20,11 @@
 #define FMI3_FUNCTION_PREFIX pasteB(MODEL_IDENTIFIER, _)
 #endif
 #include "fmi3Functions.h"
+#include "fmi3Extensions.h"
+
+#if N_INPUT_CLOCKS > 0 && N_EXECUTION_TIME_BINS != fmi3ExecutionTimeHistogramBins
+#error "N_EXECUTION_TIME_BINS must be equal to fmi3ExecutionTimeHistogramBins"
+#endif
 
 #define ASSERT_NOT_NULL(p) \
 do { \
@@ -195,6 +200,8 @@ END_FUNCTION()
 #define MASK_fmi3SetInputDerivatives      (Instantiated | InitializationMode | StepMode)
 #define MASK_fmi3GetOutputDerivatives     (StepMode | StepDiscarded | Terminated)
 #define MASK_fmi3DoStep                   StepMode
+#define MASK_fmi3DoSteps                  StepMode
+#define MASK_fmi3GetClockStatistics       MASK_AnyState
 #define MASK_fmi3ActivateModelPartition   ClockActivationMode
 #define MASK_fmi3DoEarlyReturn            IntermediateUpdateMode
 #define MASK_fmi3GetDoStepDiscardedStatus StepMode
@@ -275,6 +282,8 @@ fmi3Instance fmi3InstantiateModelExchange(
     return createModelInstance(
         (loggerType)logMessage,
         NULL,
+        NULL,
+        NULL,
         instanceEnvironment,
         instanceName,
         instantiationToken,
@@ -313,6 +322,8 @@ fmi3Instance fmi3InstantiateCoSimulation(
 
     ModelInstance *instance = createModelInstance(
         (loggerType)logMessage,
+        NULL,
+        NULL,
         (intermediateUpdateType)intermediateUpdate,
         instanceEnvironment,
         instanceName,
@@ -361,6 +372,8 @@ fmi3Instance fmi3InstantiateScheduledExecution(
     ModelInstance *instance = createModelInstance(
         (loggerType)logMessage,
         NULL,
+        NULL,
+        NULL,
         instanceEnvironment,
         instanceName,
         instantiationToken,
@@ -398,7 +411,10 @@ fmi3Status fmi3EnterInitializationMode(fmi3Instance instance,
     S->startTime = startTime;
     S->stopTime = stopTimeDefined ? stopTime : INFINITY;
     S->time = startTime;
+    S->startTicks = timeToTicks(startTime);
+    S->ticks = S->startTicks;
     S->nextCommunicationPoint = startTime;
+    S->nextCommunicationTicks = S->startTicks;
     S->state = InitializationMode;
 
     END_FUNCTION();
@@ -439,6 +455,9 @@ fmi3Status fmi3EnterEventMode(fmi3Instance instance) {
 
 fmi3Status fmi3Terminate(fmi3Instance instance) {
     BEGIN_FUNCTION(Terminate);
+#if N_INPUT_CLOCKS > 0
+    logClockStatistics(S);
+#endif
     S->state = Terminated;
     END_FUNCTION();
 }
@@ -775,7 +794,7 @@ fmi3Status fmi3SetFMUState(fmi3Instance instance, fmi3FMUState FMUState) {
 
 fmi3Status fmi3FreeFMUState(fmi3Instance instance, fmi3FMUState* FMUState) {
     BEGIN_FUNCTION(FreeFMUState);
-    free(*FMUState);
+    freeMemory(S, *FMUState);
     *FMUState = NULL;
     END_FUNCTION();
 }
@@ -783,12 +802,11 @@ fmi3Status fmi3FreeFMUState(fmi3Instance instance, fmi3FMUState* FMUState) {
 fmi3Status fmi3SerializedFMUStateSize(fmi3Instance instance,
     fmi3FMUState  FMUState,
     size_t* size) {
-    UNUSED(instance);
-    UNUSED(FMUState);
-
     BEGIN_FUNCTION(SerializedFMUStateSize);
 
-    *size = sizeof(ModelInstance);
+    ASSERT_NOT_NULL(FMUState);
+
+    *size = getSerializedFMUStateSize(FMUState);
 
     END_FUNCTION();
 }
@@ -803,11 +821,11 @@ fmi3Status fmi3SerializeFMUState(fmi3Instance instance,
         return fmi3Error;
     }
 
-    if (invalidNumber(S, "fmi3SerializeFMUState", "size", size, sizeof(ModelInstance))) {
+    if (invalidNumber(S, "fmi3SerializeFMUState", "size", size, getSerializedFMUStateSize(FMUState))) {
         return fmi3Error;
     }
 
-    memcpy(serializedState, FMUState, sizeof(ModelInstance));
+    memcpy(serializedState, FMUState, size);
 
     END_FUNCTION();
 }
@@ -818,19 +836,7 @@ fmi3Status fmi3DeserializeFMUState(fmi3Instance instance,
     fmi3FMUState* FMUState) {
     BEGIN_FUNCTION(DeserializeFMUState);
 
-    if (invalidNumber(S, "fmi3DeserializeFMUState", "size", size, sizeof(ModelInstance))) {
-        return fmi3Error;
-    }
-
-    if (*FMUState == NULL) {
-        *FMUState = calloc(1, sizeof(ModelInstance));
-        if (*FMUState == NULL) {
-            printf("Failed to allocate memory for FMUState.\n");
-            return fmi3Error;
-        }
-    }
-
-    memcpy(*FMUState, serializedState, sizeof(ModelInstance));
+    CALL(deserializeFMUState(S, serializedState, size, FMUState));
 
     END_FUNCTION();
 }
@@ -1097,6 +1103,7 @@ fmi3Status fmi3CompletedIntegratorStep(fmi3Instance instance,
 fmi3Status fmi3SetTime(fmi3Instance instance, fmi3Float64 time) {
     BEGIN_FUNCTION(SetTime);
     S->time = time;
+    S->ticks = timeToTicks(time);
     END_FUNCTION();
 }
 
@@ -1191,37 +1198,40 @@ fmi3Status fmi3GetOutputDerivatives(fmi3Instance instance,
     END_FUNCTION();
 }
 
-fmi3Status fmi3DoStep(fmi3Instance instance,
-    fmi3Float64 currentCommunicationPoint,
-    fmi3Float64 communicationStepSize,
-    fmi3Boolean noSetFMUStatePriorToCurrentPoint,
-    fmi3Boolean* eventHandlingNeeded,
-    fmi3Boolean* terminateSimulation,
-    fmi3Boolean* earlyReturn,
-    fmi3Float64* lastSuccessfulTime) {
-    UNUSED(noSetFMUStatePriorToCurrentPoint);
+/* check the arguments of a communication step from currentCommunicationPoint to nextCommunicationPoint */
+static Status checkCommunicationStep(ModelInstance* S, double currentCommunicationPoint, double communicationStepSize, double nextCommunicationPoint) {
 
-    BEGIN_FUNCTION(DoStep);
-
-    if (!isClose(currentCommunicationPoint, S->nextCommunicationPoint)) {
+    if (!isNextCommunicationPoint(S, currentCommunicationPoint)) {
         logError(S, "Expected currentCommunicationPoint = %.16g but was %.16g.",
             S->nextCommunicationPoint, currentCommunicationPoint);
-        CALL(Error);
+        return Error;
     }
 
     if (communicationStepSize <= 0) {
         logError(S, "Communication step size must be > 0 but was %.16g.", communicationStepSize);
-        CALL(Error);
+        return Error;
     }
 
-    const fmi3Float64 nextCommunicationPoint = currentCommunicationPoint + communicationStepSize;
-
     if (nextCommunicationPoint > S->stopTime && !isClose(nextCommunicationPoint, S->stopTime)) {
         logError(S, "At communication point %.16g a step size of %.16g was requested but stop time is %.16g.",
-            currentCommunicationPoint, communicationStepSize, S->stopTime);
-        CALL(Error);
+            currentCommunicationPoint, nextCommunicationPoint - currentCommunicationPoint, S->stopTime);
+        return Error;
     }
 
+    return OK;
+}
+
+static Status doCommunicationStep(ModelInstance* S,
+    fmi3Float64 currentCommunicationPoint,
+    fmi3Float64 communicationStepSize,
+    fmi3Boolean* eventHandlingNeeded,
+    fmi3Boolean* terminateSimulation,
+    fmi3Boolean* earlyReturn) {
+
+    Status status = OK;
+
+    const Ticks nextCommunicationTicks = timeToTicks(currentCommunicationPoint + communicationStepSize);
+
     bool nextCommunicationPointReached;
 
     *eventHandlingNeeded = fmi3False;
@@ -1230,9 +1240,7 @@ fmi3Status fmi3DoStep(fmi3Instance instance,
 
     while (true) {
 
-        const fmi3Float64 nextSolverStepTime = S->time + FIXED_SOLVER_STEP;
-
-        nextCommunicationPointReached = nextSolverStepTime > nextCommunicationPoint && !isClose(nextSolverStepTime, nextCommunicationPoint);
+        nextCommunicationPointReached = getNextSolverStepTicks(S) > nextCommunicationTicks;
 
         if (nextCommunicationPointReached || (*eventHandlingNeeded && S->earlyReturnAllowed)) {
             break;
@@ -1274,14 +1282,122 @@ fmi3Status fmi3DoStep(fmi3Instance instance,
 
     *terminateSimulation = S->terminateSimulation;
     *earlyReturn         = S->earlyReturnAllowed && !nextCommunicationPointReached;
-    *lastSuccessfulTime  = S->time;
 
     if (nextCommunicationPointReached) {
         S->nextCommunicationPoint = currentCommunicationPoint + communicationStepSize;
+        S->nextCommunicationTicks = nextCommunicationTicks;
     } else {
         S->nextCommunicationPoint = S->time;
+        S->nextCommunicationTicks = S->ticks;
+    }
+
+TERMINATE:
+    return status;
+}
+
+fmi3Status fmi3DoStep(fmi3Instance instance,
+    fmi3Float64 currentCommunicationPoint,
+    fmi3Float64 communicationStepSize,
+    fmi3Boolean noSetFMUStatePriorToCurrentPoint,
+    fmi3Boolean* eventHandlingNeeded,
+    fmi3Boolean* terminateSimulation,
+    fmi3Boolean* earlyReturn,
+    fmi3Float64* lastSuccessfulTime) {
+    UNUSED(noSetFMUStatePriorToCurrentPoint);
+
+    BEGIN_FUNCTION(DoStep);
+
+    CALL(checkCommunicationStep(S, currentCommunicationPoint, communicationStepSize, currentCommunicationPoint + communicationStepSize));
+
+    CALL(doCommunicationStep(S, currentCommunicationPoint, communicationStepSize, eventHandlingNeeded, terminateSimulation, earlyReturn));
+
+    *lastSuccessfulTime = S->time;
+
+    END_FUNCTION();
+}
+
+fmi3Status fmi3DoSteps(fmi3Instance instance,
+    fmi3Float64 currentCommunicationPoint,
+    fmi3Float64 communicationStepSize,
+    size_t nSteps,
+    const fmi3ValueReference inputValueReferences[],
+    size_t nInputValueReferences,
+    const fmi3Float64 inputValues[],
+    const fmi3ValueReference outputValueReferences[],
+    size_t nOutputValueReferences,
+    fmi3Float64 outputValues[],
+    size_t* nStepsCompleted,
+    fmi3Boolean* eventHandlingNeeded,
+    fmi3Boolean* terminateSimulation,
+    fmi3Boolean* earlyReturn,
+    fmi3Float64* lastSuccessfulTime) {
+
+    BEGIN_FUNCTION(DoSteps);
+
+    *nStepsCompleted = 0;
+
+    if (nSteps == 0) {
+        goto TERMINATE;
+    }
+
+    if (nInputValueReferences > 0) {
+        ASSERT_NOT_NULL(inputValueReferences);
+        ASSERT_NOT_NULL(inputValues);
+    }
+
+    if (nOutputValueReferences > 0) {
+        ASSERT_NOT_NULL(outputValueReferences);
+        ASSERT_NOT_NULL(outputValues);
+    }
+
+    // the arguments are checked once for all steps
+    CALL(checkCommunicationStep(S, currentCommunicationPoint, communicationStepSize, currentCommunicationPoint + nSteps * communicationStepSize));
+
+    for (size_t k = 0; k < nSteps; k++) {
+
+        // the same communication points as in a loop that calls fmi3DoStep()
+        const fmi3Float64 time = k == 0 ? currentCommunicationPoint : S->nextCommunicationPoint;
+
+        if (nInputValueReferences > 0) {
+
+            const fmi3Float64* values = &inputValues[k * nInputValueReferences];
+
+            size_t index = 0;
+
+            for (size_t i = 0; i < nInputValueReferences; i++) {
+                CALL(setFloat64(S, (ValueReference)inputValueReferences[i], values, nInputValueReferences, &index));
+            }
+
+            S->isDirtyValues = true;
+        }
+
+        CALL(doCommunicationStep(S, time, communicationStepSize, eventHandlingNeeded, terminateSimulation, earlyReturn));
+
+        if (nOutputValueReferences > 0) {
+
+            if (S->isDirtyValues) {
+                CALL(calculateValues(S));
+                S->isDirtyValues = false;
+            }
+
+            fmi3Float64* values = &outputValues[k * nOutputValueReferences];
+
+            size_t index = 0;
+
+            for (size_t i = 0; i < nOutputValueReferences; i++) {
+                CALL(getFloat64(S, (ValueReference)outputValueReferences[i], values, nOutputValueReferences, &index));
+            }
+        }
+
+        (*nStepsCompleted)++;
+
+        if (*eventHandlingNeeded || *terminateSimulation || *earlyReturn) {
+            break;
+        }
     }
 
+    *lastSuccessfulTime = S->time;
+
     END_FUNCTION();
 }
 
@@ -1289,6 +1405,45 @@ fmi3Status fmi3ActivateModelPartition(fmi3Instance instance,
     fmi3ValueReference clockReference,
     fmi3Float64 activationTime) {
     BEGIN_FUNCTION(ActivateModelPartition);
+#if N_INPUT_CLOCKS > 0
+    const double startTime = wallClockTime();
+    const Status partitionStatus = activateModelPartition(S, (ValueReference)clockReference, activationTime);
+    recordClockActivation(S, (ValueReference)clockReference, activationTime, startTime, wallClockTime());
+    CALL(partitionStatus);
+#else
     CALL(activateModelPartition(S, (ValueReference)clockReference, activationTime));
+#endif
+    END_FUNCTION();
+}
+
+fmi3Status fmi3GetClockStatistics(fmi3Instance instance,
+    fmi3ValueReference clockReference,
+    fmi3ClockStatistics* statistics) {
+
+    BEGIN_FUNCTION(GetClockStatistics);
+
+    ASSERT_NOT_NULL(statistics);
+
+    memset(statistics, 0, sizeof(fmi3ClockStatistics));
+
+#if N_INPUT_CLOCKS > 0
+    ClockStatistics clockStatistics;
+
+    if (!getClockStatistics(S, (ValueReference)clockReference, &clockStatistics)) {
+        logError(S, "Value reference %u is not an input clock.", clockReference);
+        CALL(Error);
+    }
+
+    statistics->nActivations       = clockStatistics.nActivations;
+    statistics->totalExecutionTime = clockStatistics.totalExecutionTime;
+    statistics->maxExecutionTime   = clockStatistics.maxExecutionTime;
+    statistics->maxLatency         = clockStatistics.maxLatency;
+    memcpy(statistics->executionTimeHistogram, clockStatistics.executionTimeHistogram, sizeof(statistics->executionTimeHistogram));
+#else
+    UNUSED(clockReference);
+    logError(S, "The model has no input clocks.");
+    CALL(Error);
+#endif
+
     END_FUNCTION();
 }
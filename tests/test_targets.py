@@ -1,3 +1,4 @@
+import math
 import os
 import subprocess
 from pathlib import Path
@@ -58,6 +59,8 @@ def test_fmi2(arch, platform):
         for interface_type in ['cs', 'me']:
             run_example(build_dir / 'temp' / f'{model}_{interface_type}')
 
+    run_example(build_dir / 'temp' / 'cs_asynchronous')
+
 
 def test_fmi3(arch, platform):
 
@@ -76,10 +79,468 @@ def test_fmi3(arch, platform):
     assert not validate_fmu(build_dir / 'install' / 'Clocks.fmu')
 
 
+def test_model_description(platform):
+    run_example(root / 'build' / f'fmi3-{platform}' / 'temp' / 'model_description')
+
+
+@pytest.mark.parametrize('interface_type', ['cs', 'me'])
+def test_fmusim(platform, interface_type):
+
+    build_dir = root / 'build' / f'fmi3-{platform}' / 'temp'
+
+    output_file = build_dir / f'BouncingBall_{interface_type}_out.csv'
+
+    subprocess.check_call([
+        build_dir / 'fmusim',
+        '--interface-type', interface_type,
+        '--stop-time', '3',
+        '--output-interval', '0.01',
+        '--output-file', output_file,
+        'BouncingBall'
+    ], cwd=build_dir)
+
+    with open(output_file) as f:
+        lines = f.read().splitlines()
+
+    assert lines[0] == 'time,h,v'
+    assert lines[1] == '0,1,0'
+    assert float(lines[-1].split(',')[0]) == 3
+
+
+@pytest.mark.parametrize('solver', ['rk45', 'bdf'])
+def test_fmusim_variable_step(platform, solver):
+
+    build_dir = root / 'build' / f'fmi3-{platform}' / 'temp'
+
+    output_file = build_dir / f'Dahlquist_{solver}_out.csv'
+
+    subprocess.check_call([
+        build_dir / 'fmusim',
+        '--interface-type', 'me',
+        '--solver', solver,
+        '--stop-time', '10',
+        '--output-interval', '0.1',
+        '--output-file', output_file,
+        'Dahlquist'
+    ], cwd=build_dir)
+
+    with open(output_file) as f:
+        lines = f.read().splitlines()
+
+    assert lines[0] == 'time,x'
+
+    # the dense output is evaluated at the communication points
+    for line in lines[1:]:
+        time, x = map(float, line.split(','))
+        assert abs(x - math.exp(-time)) < 1e-3
+
+
+@pytest.mark.parametrize('solver', ['rk45', 'bdf'])
+def test_fmusim_root_finding(platform, solver):
+
+    build_dir = root / 'build' / f'fmi3-{platform}' / 'temp'
+
+    output_file = build_dir / f'BouncingBall_{solver}_out.csv'
+
+    subprocess.check_call([
+        build_dir / 'fmusim',
+        '--interface-type', 'me',
+        '--solver', solver,
+        '--stop-time', '1',
+        '--output-interval', '0.1',
+        '--output-file', output_file,
+        'BouncingBall'
+    ], cwd=build_dir)
+
+    with open(output_file) as f:
+        lines = f.read().splitlines()
+
+    # the event is located between the communication points
+    time, h, v = map(float, lines[6].split(','))
+
+    assert abs(time - math.sqrt(2 / 9.81)) < 1e-5
+    assert abs(h) < 1e-10
+
+
+def test_fmusim_time_event_between_solver_steps(platform):
+
+    build_dir = root / 'build' / f'fmi3-{platform}' / 'temp'
+
+    output_file = build_dir / 'Stair_time_events_out.csv'
+
+    # the fixed solver steps of Stair (0.1, 0.3, ...) do not hit the time events at 1, 2, ...
+    subprocess.check_call([
+        build_dir / 'fmusim',
+        '--interface-type', 'cs',
+        '--start-time', '0.1',
+        '--stop-time', '2.5',
+        '--output-interval', '0.1',
+        '--output-file', output_file,
+        'Stair'
+    ], cwd=build_dir)
+
+    with open(output_file) as f:
+        rows = [tuple(map(float, line.split(','))) for line in f.read().splitlines()[1:]]
+
+    for time, counter in rows:
+        assert counter == 1 + math.floor(time + 1e-8)
+
+
+def test_fmusim_state_space_dimensions(platform):
+
+    build_dir = root / 'build' / f'fmi3-{platform}' / 'temp'
+
+    output_file = build_dir / 'StateSpace_dimensions_out.csv'
+
+    # the dimensions are not limited by the size of the model data
+    subprocess.check_call([
+        build_dir / 'fmusim',
+        '--interface-type', 'cs',
+        '--start-value', 'm', '8',
+        '--start-value', 'n', '8',
+        '--start-value', 'r', '8',
+        '--output-file', output_file,
+        'StateSpace'
+    ], cwd=build_dir)
+
+    with open(output_file) as f:
+        lines = f.read().splitlines()
+
+    assert lines[0] == 'time,y'
+    assert lines[1] == '0,1 2 3 0 0 0 0 0'
+
+
+def test_fmusim_input(platform):
+
+    build_dir = root / 'build' / f'fmi3-{platform}' / 'temp'
+
+    output = subprocess.check_output([
+        build_dir / 'fmusim',
+        '--interface-type', 'me',
+        '--input-file', root / 'tests' / 'resources' / 'Feedthrough_in.csv',
+        '--stop-time', '4',
+        '--output-interval', '1',
+        '--output-variable', 'Float64_continuous_output',
+        '--output-variable', 'Int32_output',
+        'Feedthrough'
+    ], cwd=build_dir)
+
+    # the events at t = 1 and t = 3 are recorded before and after the event
+    assert output.decode().splitlines() == [
+        'time,Float64_continuous_output,Int32_output',
+        '0,3,1',
+        '1,3,1',
+        '1,2,1',
+        '2,3,1',
+        '2,3,1',
+        '3,3,1',
+        '3,3,2',
+        '4,3,2',
+    ]
+
+
+def test_fmusim_input_derivatives(platform):
+
+    if not platform.startswith('x86'):
+        pytest.skip(f"FMI 2.0 is not supported on {platform}")
+
+    build_dir = root / 'build' / f'fmi2-{platform}' / 'temp'
+
+    output = subprocess.check_output([
+        build_dir / 'fmusim',
+        '--interface-type', 'cs',
+        '--input-file', root / 'tests' / 'resources' / 'Feedthrough_ramp.csv',
+        '--stop-time', '2',
+        '--output-interval', '0.5',
+        '--output-variable', 'Float64_continuous_output',
+        'Feedthrough'
+    ], cwd=build_dir)
+
+    # the input is extrapolated with its derivative during the communication step
+    assert output.decode().splitlines() == [
+        'time,Float64_continuous_output',
+        '0,0',
+        '0.5,1',
+        '1,2',
+        '1.5,3',
+        '2,4',
+    ]
+
+
+def test_fmusim_binary_output(platform):
+
+    build_dir = root / 'build' / f'fmi3-{platform}' / 'temp'
+
+    def simulate(*args):
+        subprocess.check_call([build_dir / 'fmusim', '--interface-type', 'me', '--stop-time', '3', '--output-interval', '0.1', '--step-size', '0.001', *args, 'BouncingBall'], cwd=build_dir)
+
+    simulate('--output-file', 'BouncingBall_out.csv')
+    simulate('--output-format', 'binary', '--output-file', 'BouncingBall_out.bin')
+
+    subprocess.check_call([build_dir / 'result2csv', 'BouncingBall_out.bin', 'BouncingBall_out2.csv'], cwd=build_dir)
+
+    with open(build_dir / 'BouncingBall_out.csv') as f:
+        expected = f.read()
+
+    with open(build_dir / 'BouncingBall_out2.csv') as f:
+        actual = f.read()
+
+    assert actual == expected
+
+    # the output is decimated to the output interval but the events are recorded
+    assert '0.1,' in expected and '0.001,' not in expected
+
+
+@pytest.mark.parametrize('fmi_version', [2, 3])
+def test_fmusim_static(platform, fmi_version):
+
+    if fmi_version == 2 and not platform.startswith('x86'):
+        pytest.skip(f"FMI 2.0 is not supported on {platform}")
+
+    build_dir = root / 'build' / f'fmi{fmi_version}-{platform}' / 'temp'
+
+    if not (build_dir / 'fmusim_BouncingBall').exists() and not (build_dir / 'fmusim_BouncingBall.exe').exists():
+        pytest.skip("The static models have not been built (build/build.py --static-models)")
+
+    for interface_type in ['cs', 'me']:
+
+        def simulate(executable):
+            return subprocess.check_output([build_dir / executable, '--interface-type', interface_type, '--stop-time', '3', 'BouncingBall'], cwd=build_dir)
+
+        # the statically linked model gives the same result as the shared library
+        assert simulate('fmusim_BouncingBall') == simulate('fmusim')
+
+
+@pytest.mark.parametrize('interface_type', ['cs', 'me'])
+def test_fmusim_out_of_process(platform, interface_type):
+
+    if not platform.endswith('linux'):
+        pytest.skip(f"Host processes are not supported on {platform}")
+
+    build_dir = root / 'build' / f'fmi3-{platform}' / 'temp'
+
+    for model in ['BouncingBall', 'Feedthrough']:
+
+        def simulate(*args):
+            return subprocess.check_output([build_dir / 'fmusim', '--interface-type', interface_type, '--stop-time', '3', *args, model], cwd=build_dir)
+
+        # the FMU in the host process gives the same result as the shared library
+        assert simulate('--out-of-process') == simulate()
+
+
+@pytest.mark.parametrize('algorithm', ['jacobi', 'gauss-seidel'])
+def test_fmucosim(platform, algorithm):
+
+    build_dir = root / 'build' / f'fmi3-{platform}' / 'temp'
+
+    output = subprocess.check_output([
+        build_dir / 'fmucosim',
+        '--algorithm', algorithm,
+        '--stop-time', '3',
+        '--step-size', '0.5',
+        root / 'tests' / 'resources' / 'Feedthrough_StateSpace.txt'
+    ], cwd=build_dir)
+
+    lines = output.decode().splitlines()
+
+    assert lines[0] == 'time,source.Float64_continuous_output,plant.y'
+    assert lines[1] == '0,1,0'
+
+    # step response of the first order lag
+    time, u, y = map(float, lines[-1].split(','))
+    assert time == 3
+    assert abs(y - (1 - math.exp(-3))) < 1e-3
+
+
+def test_fmucosim_variable_step(platform):
+
+    build_dir = root / 'build' / f'fmi3-{platform}' / 'temp'
+
+    result = subprocess.run([
+        build_dir / 'fmucosim',
+        '--variable-step',
+        '--tolerance', '1e-2',
+        '--stop-time', '5',
+        '--step-size', '0.01',
+        root / 'tests' / 'resources' / 'Feedthrough_StateSpace.txt'
+    ], cwd=build_dir, check=True, capture_output=True)
+
+    assert b'rejected steps' in result.stderr
+
+    lines = result.stdout.decode().splitlines()
+
+    # the step size increases as the output converges
+    assert len(lines) < 100
+
+    for line in lines[1:]:
+        time, u, y = map(float, line.split(','))
+        assert abs(y - (1 - math.exp(-time))) < 1e-2
+
+
+@pytest.mark.parametrize('algorithm', ['jacobi', 'gauss-seidel'])
+def test_fmucosim_connection_types(platform, algorithm):
+
+    build_dir = root / 'build' / f'fmi3-{platform}' / 'temp'
+
+    output = subprocess.check_output([
+        build_dir / 'fmucosim',
+        '--algorithm', algorithm,
+        '--stop-time', '1',
+        '--step-size', '0.5',
+        root / 'tests' / 'resources' / 'Feedthrough_chain.txt'
+    ], cwd=build_dir)
+
+    lines = output.decode().splitlines()
+
+    assert len(lines) == 4
+
+    # the values pass through the chain unchanged
+    for line in lines[1:]:
+        assert line.split(',')[1:] == ['2', '3', '0', '0', '1', '"FMI"', '0a0b0c', '0', '2', '3', '"FMI"', '0a0b0c']
+
+
+@pytest.mark.parametrize('algorithm', ['jacobi', 'gauss-seidel'])
+def test_fmucosim_algebraic_loop(platform, algorithm):
+
+    build_dir = root / 'build' / f'fmi3-{platform}' / 'temp'
+
+    result = subprocess.run([
+        build_dir / 'fmucosim',
+        '--algorithm', algorithm,
+        '--solve-loops',
+        '--stop-time', '1',
+        '--step-size', '0.01',
+        root / 'tests' / 'resources' / 'Feedthrough_StateSpace_loop.txt'
+    ], cwd=build_dir, check=True, capture_output=True)
+
+    lines = result.stdout.decode().splitlines()
+
+    assert lines[0] == 'time,plant.y,gain.Float64_continuous_output'
+
+    # the loop is consistent at every communication point
+    assert lines[1] == '0,2,2'
+
+    time, y, u = map(float, lines[-1].split(','))
+    assert time == 1
+    assert abs(y - 2 * math.exp(-1)) < 1e-2
+
+    # Broyden's method converges in a few iterations per communication point
+    iterations = int(result.stderr.decode().split('Algebraic loop iterations: ')[1].split()[0])
+    assert iterations <= 5 * len(lines)
+
+
+def test_fmuserver(platform):
+
+    if 'windows' in platform:
+        pytest.skip(f"UNIX domain sockets are not supported on {platform}")
+
+    import socket
+    import struct
+
+    build_dir = root / 'build' / f'fmi3-{platform}' / 'temp'
+
+    socket_path = build_dir / 'fmuserver.sock'
+
+    # the components of the system file
+    source, plant = 0, 1
+
+    SET_FLOAT64, GET_FLOAT64, DO_STEP, RESET = 1, 2, 3, 4
+
+    def call(function, component, value_references=(), arguments=()):
+        n = len(value_references)
+        return struct.pack(f'=3I{n}I{len(arguments)}d', function, component, n, *value_references, *arguments)
+
+    def send(client, *calls):
+
+        body = struct.pack('=I', len(calls)) + b''.join(calls)
+        client.sendall(struct.pack('=I', len(body)) + body)
+
+        def receive(size):
+            data = b''
+            while len(data) < size:
+                chunk = client.recv(size - len(data))
+                assert chunk
+                data += chunk
+            return data
+
+        size, = struct.unpack('=I', receive(4))
+        response = receive(size)
+
+        n_results, = struct.unpack_from('=I', response)
+        offset = 4
+        results = []
+
+        for _ in range(n_results):
+            status, n_values = struct.unpack_from('=iI', response, offset)
+            values = struct.unpack_from(f'={n_values}d', response, offset + 8)
+            offset += 8 + 8 * n_values
+            results.append((status, values))
+
+        assert offset == len(response)
+
+        return results
+
+    def steps(start_time, n):
+        return [call(DO_STEP, plant, arguments=(start_time + i * 0.1, 0.1)) for i in range(n)]
+
+    server = subprocess.Popen([
+        build_dir / 'fmuserver',
+        '--socket', socket_path,
+        root / 'tests' / 'resources' / 'Feedthrough_StateSpace.txt'
+    ], cwd=build_dir, stdout=subprocess.PIPE)
+
+    try:
+        assert server.stdout.readline().startswith(b'Listening')
+
+        with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as client:
+
+            client.connect(str(socket_path))
+
+            # exchange the values and step the plant in a single request
+            results = send(client,
+                call(GET_FLOAT64, source, [8]),
+                call(SET_FLOAT64, plant, [9], [1.0]),
+                *steps(0, 10),
+                call(GET_FLOAT64, plant, [10])
+            )
+
+            assert len(results) == 13
+            assert all(status == 0 for status, _ in results)
+            assert results[0][1] == (1.0,)
+            assert results[-2][1][0] == pytest.approx(1)
+            assert results[-1][1][0] == pytest.approx(1 - math.exp(-1), abs=1e-3)
+
+            # calls for a component that does not exist fail without affecting the others
+            results = send(client, call(GET_FLOAT64, 7, [10]), call(GET_FLOAT64, plant, [10]))
+            assert results[0] == (3, ())
+            assert results[1][0] == 0
+
+        # the instances are shared by the clients
+        with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as client:
+
+            client.connect(str(socket_path))
+
+            results = send(client, *steps(1, 10), call(GET_FLOAT64, plant, [10]))
+            assert results[-1][1][0] == pytest.approx(1 - math.exp(-2), abs=1e-3)
+
+            results = send(client, call(RESET, plant, arguments=(0,)), call(GET_FLOAT64, plant, [10]))
+            assert results == [(0, ()), (0, (0.0,))]
+
+    finally:
+        server.terminate()
+        assert server.wait(timeout=10) == 0
+
+    assert not socket_path.exists()
+
+
 def test_cs_early_return(platform):
     run_example(root / 'build' / f'fmi3-{platform}' / 'temp' / 'cs_early_return')
 
 
+def test_cs_batched_steps(platform):
+    run_example(root / 'build' / f'fmi3-{platform}' / 'temp' / 'cs_batched_steps')
+
+
 def test_cs_event_mode(platform):
     run_example(root / 'build' / f'fmi3-{platform}' / 'temp' / 'cs_event_mode')
 
@@ -106,3 +567,46 @@ def test_cs_reconfiguration(platform):
 0.9,0.9 1.9 2.9
 1,1 2 3
 '''
+
+
+def test_scs_synchronous(platform):
+
+    build_dir = root / 'build' / f'fmi3-{platform}' / 'temp'
+
+    run_example(build_dir / 'scs_synchronous')
+
+    with open(build_dir / 'scs_synchronous_out.csv') as f:
+        file = f.read()
+
+    assert file == '''time,inClock1Ticks,inClock2Ticks,inClock3Ticks,totalInClockTicks
+0,1,1,0,2
+1,2,2,0,4
+2,3,2,0,5
+3,4,2,0,6
+4,5,2,1,8
+5,6,2,1,9
+6,7,2,1,10
+7,8,2,1,11
+8,9,3,1,13
+9,10,4,1,15
+'''
+
+
+def test_scs_threaded(platform):
+
+    if platform.endswith('windows'):
+        pytest.skip("The threaded Scheduled Execution example is only tested on POSIX platforms.")
+
+    build_dir = root / 'build' / f'fmi3-{platform}' / 'temp'
+
+    run_example(build_dir / 'scs_threaded')
+
+    with open(build_dir / 'scs_threaded_out.csv') as f:
+        lines = f.read().splitlines()
+
+    # time, inClock1Ticks, inClock2Ticks, inClock3Ticks, totalInClockTicks
+    assert lines[-1] == '9,10,4,1,15'
+
+
+def test_scs_parallel(platform):
+    run_example(root / 'build' / f'fmi3-{platform}' / 'temp' / 'scs_parallel')